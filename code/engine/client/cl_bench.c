@@ -0,0 +1,331 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// cl_bench.c -- timedemo frame time statistics
+
+#include "client.h"
+
+/*
+==============================================================================
+
+						TIMEDEMO BENCHMARK
+
+While a timedemo plays every client frame is timed, along with the time
+spent parsing the demo, in cgame, in the renderer front end, in the back end
+and the ray tracing setup inside it, and in sound. When the demo completes
+the frame time percentiles are printed and, if cl_timedemoLog names a file,
+written to it as JSON together with the per subsystem breakdown.
+
+"benchmark <demo> [file]" runs a timedemo and writes the report, with
+r_noGPU 1 the renderer still does all of its CPU work but never submits
+anything to the GPU, so the numbers don't depend on the video card.
+==============================================================================
+*/
+
+#define BENCH_INITIAL_SAMPLES 4096
+
+typedef struct
+{
+	int frame;					 // usec for the whole frame
+	int times[BENCH_NUM_TIMES]; // usec per subsystem
+} benchSample_t;
+
+static const char* benchTimeNames[BENCH_NUM_TIMES] = {
+	"demo",
+	"cgame",
+	"frontend",
+	"backend",
+	"raytrace",
+	"sound",
+};
+
+static benchSample_t* benchSamples;
+static int			  numBenchSamples;
+static int			  maxBenchSamples;
+
+static qboolean		  benchActive;
+static long long	  benchFrameStart;
+static long long	  benchTimes[BENCH_NUM_TIMES];
+
+static cvar_t*		  cl_timedemoLog;
+
+/*
+=================
+CL_BenchAddTime
+=================
+*/
+void CL_BenchAddTime( benchTime_t which, long long nsec )
+{
+	benchTimes[which] += nsec;
+}
+
+/*
+=================
+CL_BenchRecord
+=================
+*/
+static void CL_BenchRecord( long long frameNsec )
+{
+	benchSample_t* sample;
+	benchSample_t* old;
+	long long	   frontEnd, backEnd, raytrace;
+	int			   i;
+
+	if( numBenchSamples == maxBenchSamples )
+	{
+		old				= benchSamples;
+		maxBenchSamples = maxBenchSamples ? maxBenchSamples * 2 : BENCH_INITIAL_SAMPLES;
+		benchSamples	= Z_Malloc( maxBenchSamples * sizeof( *benchSamples ) );
+		if( old )
+		{
+			Com_Memcpy( benchSamples, old, numBenchSamples * sizeof( *benchSamples ) );
+			Z_Free( old );
+		}
+	}
+
+	// the renderer reports the frame that just ended
+	if( re.GetFrameTimes )
+	{
+		re.GetFrameTimes( &frontEnd, &backEnd, &raytrace );
+		benchTimes[BENCH_FRONTEND] = frontEnd;
+		benchTimes[BENCH_BACKEND]  = backEnd;
+		benchTimes[BENCH_RAYTRACE] = raytrace;
+	}
+
+	// the scene is rendered from inside cgame
+	benchTimes[BENCH_CGAME] -= benchTimes[BENCH_FRONTEND];
+	if( benchTimes[BENCH_CGAME] < 0 )
+	{
+		benchTimes[BENCH_CGAME] = 0;
+	}
+
+	sample		  = &benchSamples[numBenchSamples++];
+	sample->frame = frameNsec / 1000;
+	for( i = 0; i < BENCH_NUM_TIMES; i++ )
+	{
+		sample->times[i] = benchTimes[i] / 1000;
+	}
+}
+
+/*
+=================
+CL_BenchFrame
+
+Called at the top of every client frame, closes the sample of the last one
+=================
+*/
+void CL_BenchFrame()
+{
+	long long now;
+
+	if( !cl_timedemo->integer || !clc.demoplaying || !clc.timeDemoStart )
+	{
+		benchActive		= qfalse;
+		benchFrameStart = 0;
+		return;
+	}
+
+	now = Sys_Nanoseconds();
+
+	if( !benchActive )
+	{
+		// the first frame of a new timedemo
+		benchActive		= qtrue;
+		numBenchSamples = 0;
+	}
+	else if( benchFrameStart )
+	{
+		CL_BenchRecord( now - benchFrameStart );
+	}
+
+	benchFrameStart = now;
+	Com_Memset( benchTimes, 0, sizeof( benchTimes ) );
+}
+
+/*
+=================
+CL_BenchCompareInts
+=================
+*/
+static int CL_BenchCompareInts( const void* a, const void* b )
+{
+	return *( const int* )a - *( const int* )b;
+}
+
+/*
+=================
+CL_BenchPercentile
+
+Nearest rank of a sorted array
+=================
+*/
+static int CL_BenchPercentile( const int* sorted, int count, int percent )
+{
+	int rank;
+
+	rank = ( count * percent + 99 ) / 100;
+	if( rank < 1 )
+	{
+		rank = 1;
+	}
+	return sorted[rank - 1];
+}
+
+/*
+=================
+CL_BenchSummarize
+
+Sorts the given column of the samples into values and writes its
+statistics, column -1 is the whole frame
+=================
+*/
+static void CL_BenchSummarize( int column, int* values, char* json, int jsonSize, int* p50, int* p95, int* p99 )
+{
+	long long total;
+	int		  i;
+
+	total = 0;
+	for( i = 0; i < numBenchSamples; i++ )
+	{
+		values[i] = column < 0 ? benchSamples[i].frame : benchSamples[i].times[column];
+		total += values[i];
+	}
+	qsort( values, numBenchSamples, sizeof( int ), CL_BenchCompareInts );
+
+	*p50 = CL_BenchPercentile( values, numBenchSamples, 50 );
+	*p95 = CL_BenchPercentile( values, numBenchSamples, 95 );
+	*p99 = CL_BenchPercentile( values, numBenchSamples, 99 );
+
+	Com_sprintf( json,
+		jsonSize,
+		"{\"mean\":%.3f,\"min\":%.3f,\"max\":%.3f,\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f}",
+		total / ( double )numBenchSamples / 1000.0,
+		values[0] / 1000.0,
+		values[numBenchSamples - 1] / 1000.0,
+		*p50 / 1000.0,
+		*p95 / 1000.0,
+		*p99 / 1000.0 );
+}
+
+/*
+=================
+CL_BenchFinish
+
+The timedemo completed, report on it
+=================
+*/
+void CL_BenchFinish( int msec )
+{
+	fileHandle_t f;
+	char		 filename[MAX_QPATH];
+	char		 stats[256];
+	char		 line[512];
+	int*		 values;
+	int			 i, p50, p95, p99;
+
+	if( !benchActive || !numBenchSamples )
+	{
+		return;
+	}
+	benchActive = qfalse;
+
+	values = Z_Malloc( numBenchSamples * sizeof( int ) );
+
+	CL_BenchSummarize( -1, values, stats, sizeof( stats ), &p50, &p95, &p99 );
+	Com_Printf( "frame msec: p50 %.2f  p95 %.2f  p99 %.2f\n", p50 / 1000.0, p95 / 1000.0, p99 / 1000.0 );
+
+	f = 0;
+	if( cl_timedemoLog->string[0] )
+	{
+		Q_strncpyz( filename, cl_timedemoLog->string, sizeof( filename ) );
+		COM_DefaultExtension( filename, sizeof( filename ), ".json" );
+		f = FS_FOpenFileWrite( filename );
+		if( !f )
+		{
+			Com_Printf( "Couldn't write %s\n", filename );
+		}
+	}
+
+	if( f )
+	{
+		Com_sprintf( line,
+			sizeof( line ),
+			"{\n\"demo\":\"%s\",\n\"frames\":%i,\n\"seconds\":%.3f,\n\"fps\":%.2f,\n\"noGPU\":%i,\n\"frameMsec\":%s,\n\"subsystemMsec\":{\n",
+			clc.demoName,
+			numBenchSamples,
+			msec / 1000.0,
+			msec > 0 ? clc.timeDemoFrames * 1000.0 / msec : 0.0,
+			Cvar_VariableIntegerValue( "r_noGPU" ),
+			stats );
+		FS_Write( line, strlen( line ), f );
+	}
+
+	for( i = 0; i < BENCH_NUM_TIMES; i++ )
+	{
+		CL_BenchSummarize( i, values, stats, sizeof( stats ), &p50, &p95, &p99 );
+		Com_Printf( "%10s: p50 %.2f  p95 %.2f  p99 %.2f\n", benchTimeNames[i], p50 / 1000.0, p95 / 1000.0, p99 / 1000.0 );
+
+		if( f )
+		{
+			Com_sprintf( line, sizeof( line ), "\"%s\":%s%s\n", benchTimeNames[i], stats, i < BENCH_NUM_TIMES - 1 ? "," : "" );
+			FS_Write( line, strlen( line ), f );
+		}
+	}
+
+	if( f )
+	{
+		FS_Write( "}\n}\n", 4, f );
+		FS_FCloseFile( f );
+		Com_Printf( "wrote %s\n", filename );
+	}
+
+	Z_Free( values );
+}
+
+/*
+=================
+CL_Benchmark_f
+=================
+*/
+static void CL_Benchmark_f()
+{
+	if( Cmd_Argc() < 2 )
+	{
+		Com_Printf( "usage: benchmark <demo> [file]\n" );
+		return;
+	}
+
+	Cvar_Set( "cl_timedemoLog", Cmd_Argc() > 2 ? Cmd_Argv( 2 ) : "benchmark" );
+	Cvar_Set( "timedemo", "1" );
+	Cbuf_ExecuteText( EXEC_APPEND, va( "demo %s\n", Cmd_Argv( 1 ) ) );
+}
+
+/*
+=================
+CL_InitBench
+=================
+*/
+void CL_InitBench()
+{
+	cl_timedemoLog = Cvar_Get( "cl_timedemoLog", "", 0 );
+
+	Cmd_AddCommand( "benchmark", CL_Benchmark_f );
+}
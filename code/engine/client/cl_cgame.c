@@ -450,6 +450,22 @@ static int FloatAsInt( float f )
 	return temp;
 }
 
+/*
+====================
+CL_CgameNativeJobs
+
+The job functions and counters are native pointers, a qvm could make a
+worker jump anywhere
+====================
+*/
+static void CL_CgameNativeJobs( const char* call )
+{
+	if( !VM_IsNative( cgvm ) )
+	{
+		Com_Error( ERR_DROP, "%s: only a native cgame can use jobs", call );
+	}
+}
+
 /*
 ====================
 CL_CgameSystemCalls
@@ -526,6 +542,35 @@ int CL_CgameSystemCalls( intptr_t* args )
 		case CG_R_REGISTERCUSTOMMODEL:
 			return re.RegisterCustomModel( VMA( 1 ), args[2], VMA( 3 ), args[4] );
 
+		case CG_CVAR_SET_HANDLE:
+			Cvar_SetHandle( args[1], VMA( 2 ) );
+			return 0;
+		case CG_CVAR_MODIFICATION_COUNT:
+			return cvar_modificationCount;
+
+		case CG_PROFILE_BEGIN:
+			Com_ProfileBeginCopy( VMA( 1 ) );
+			return 0;
+		case CG_PROFILE_END:
+			Com_ProfileEnd();
+			return 0;
+
+		// the names are copied, the module can be unloaded before a capture is written
+		case CG_JOB_ADD:
+			CL_CgameNativeJobs( "CG_JOB_ADD" );
+			Job_Add( Com_ProfileInternName( VMA( 1 ) ), ( jobFunc_t )args[2], VMA( 3 ), VMA( 4 ) );
+			return 0;
+		case CG_JOB_WAIT:
+			CL_CgameNativeJobs( "CG_JOB_WAIT" );
+			Job_Wait( VMA( 1 ) );
+			return 0;
+		case CG_JOB_PARALLEL_FOR:
+			CL_CgameNativeJobs( "CG_JOB_PARALLEL_FOR" );
+			Job_ParallelFor( Com_ProfileInternName( VMA( 1 ) ), args[2], args[3], ( jobRangeFunc_t )args[4], VMA( 5 ) );
+			return 0;
+		case CG_JOB_NUM_WORKERS:
+			return Job_NumWorkers();
+
 		case CG_CM_LOADMAP:
 			CL_CM_LoadMap( VMA( 1 ) );
 			return 0;
@@ -788,7 +833,7 @@ void CL_InitCGame()
 
 	// load the dll or bytecode
 	interpret = Cvar_VariableValue( "vm_cgame" );
-	cgvm	  = VM_Create( "cgame", CL_CgameSystemCalls, interpret );
+	cgvm	  = VM_Create( "cgame", CL_CgameSystemCalls, NULL, interpret );
 	if( !cgvm )
 	{
 		Com_Error( ERR_DROP, "VM_Create on cgame failed" );
@@ -846,8 +891,12 @@ CL_CGameRendering
 */
 void CL_CGameRendering( stereoFrame_t stereo )
 {
+	long long start;
+
+	start = Sys_Nanoseconds();
 	VM_Call( cgvm, CG_DRAW_ACTIVE_FRAME, cl.serverTime, stereo, clc.demoplaying );
 	VM_Debug( 0 );
+	CL_BenchAddTime( BENCH_CGAME, Sys_Nanoseconds() - start );
 }
 
 /*
@@ -429,6 +429,7 @@ void CL_DemoCompleted()
 		{
 			Com_Printf( "%i frames, %3.1f seconds: %3.1f fps\n", clc.timeDemoFrames, time / 1000.0, clc.timeDemoFrames * 1000.0 / time );
 		}
+		CL_BenchFinish( time );
 	}
 
 	CL_Disconnect( qtrue );
@@ -442,10 +443,13 @@ CL_ReadDemoMessage
 */
 void CL_ReadDemoMessage()
 {
-	int	  r;
-	msg_t buf;
-	byte  bufData[MAX_MSGLEN];
-	int	  s;
+	int		  r;
+	msg_t	  buf;
+	byte	  bufData[MAX_MSGLEN];
+	int		  s;
+	long long start;
+
+	start = Sys_Nanoseconds();
 
 	if( !clc.demofile )
 	{
@@ -493,6 +497,8 @@ void CL_ReadDemoMessage()
 	clc.lastPacketTime = cls.realtime;
 	buf.readcount	   = 0;
 	CL_ParseServerMessage( &buf );
+
+	CL_BenchAddTime( BENCH_DEMO, Sys_Nanoseconds() - start );
 }
 
 /*
@@ -2186,11 +2192,17 @@ CL_Frame
 */
 void CL_Frame( int msec )
 {
+	long long start;
+
 	if( !com_cl_running->integer )
 	{
 		return;
 	}
 
+	PROFILE_BEGIN( "CL_Frame" );
+
+	CL_BenchFrame();
+
 	if( cls.cddialog )
 	{
 		// bring up the cd error dialog if needed
@@ -2250,10 +2262,14 @@ void CL_Frame( int msec )
 	CL_SetCGameTime();
 
 	// update the screen
+	PROFILE_BEGIN( "SCR_UpdateScreen" );
 	SCR_UpdateScreen();
+	PROFILE_END();
 
 	// update audio
+	start = Sys_Nanoseconds();
 	S_Update();
+	CL_BenchAddTime( BENCH_SOUND, Sys_Nanoseconds() - start );
 
 	// advance local effects for next frame
 	SCR_RunCinematic();
@@ -2261,6 +2277,8 @@ void CL_Frame( int msec )
 	Con_RunConsole();
 
 	cls.framecount++;
+
+	PROFILE_END();
 }
 
 //============================================================================
@@ -2383,6 +2401,35 @@ void* CL_RefMalloc( int size )
 	return Z_TagMalloc( size, TAG_RENDERER );
 }
 
+/*
+============
+CL_RefHunkAlloc
+
+Charges the renderer's hunk use to the "hunk renderer" stat
+============
+*/
+#ifdef HUNK_DEBUG
+void* CL_RefHunkAllocDebug( int size, ha_pref pref, char* label, char* file, int line )
+{
+	void* buf;
+
+	Hunk_SetLabel( "renderer" );
+	buf = Hunk_AllocDebug( size, pref, label, file, line );
+	Hunk_SetLabel( NULL );
+	return buf;
+}
+#else
+void* CL_RefHunkAlloc( int size, ha_pref pref )
+{
+	void* buf;
+
+	Hunk_SetLabel( "renderer" );
+	buf = Hunk_Alloc( size, pref );
+	Hunk_SetLabel( NULL );
+	return buf;
+}
+#endif
+
 int CL_ScaledMilliseconds()
 {
 	return Sys_Milliseconds() * com_timescale->value;
@@ -2411,13 +2458,19 @@ void CL_InitRef()
 	ri.Malloc			 = CL_RefMalloc;
 	ri.Free				 = Z_Free;
 #ifdef HUNK_DEBUG
-	ri.Hunk_AllocDebug = Hunk_AllocDebug;
+	ri.Hunk_AllocDebug = CL_RefHunkAllocDebug;
 #else
-	ri.Hunk_Alloc = Hunk_Alloc;
+	ri.Hunk_Alloc = CL_RefHunkAlloc;
 #endif
 	ri.Hunk_AllocateTempMemory = Hunk_AllocateTempMemory;
 	ri.Hunk_FreeTempMemory	   = Hunk_FreeTempMemory;
 	ri.CM_DrawDebugSurface	   = CM_DrawDebugSurface;
+	ri.RegisterMemStat		   = Com_RegisterMemStat;
+	ri.MemStatSet			   = Com_MemStatSet;
+	ri.JobAdd				   = Job_Add;
+	ri.JobWait				   = Job_Wait;
+	ri.JobParallelFor		   = Job_ParallelFor;
+	ri.JobNumWorkers		   = Job_NumWorkers;
 	ri.FS_ReadFile			   = FS_ReadFile;
 	ri.FS_FreeFile			   = FS_FreeFile;
 	ri.FS_WriteFile			   = FS_WriteFile;
@@ -2607,6 +2660,7 @@ void CL_Init()
 	Cmd_AddCommand( "fs_openedList", CL_OpenedPK3List_f );
 	Cmd_AddCommand( "fs_referencedList", CL_ReferencedPK3List_f );
 	Cmd_AddCommand( "model", CL_SetModel_f );
+	CL_InitBench();
 	CL_InitRef();
 
 	SCR_Init();
@@ -1137,6 +1137,13 @@ int CL_UISystemCalls( intptr_t* args )
 		case UI_SET_PBCLSTATUS:
 			return 0;
 
+		case UI_CVAR_SET_HANDLE:
+			Cvar_SetHandle( args[1], VMA( 2 ) );
+			return 0;
+
+		case UI_CVAR_MODIFICATION_COUNT:
+			return cvar_modificationCount;
+
 		case UI_R_REGISTERFONT:
 			re.RegisterFont( VMA( 1 ), args[2], VMA( 3 ) );
 			return 0;
@@ -1255,7 +1262,7 @@ void CL_InitUI()
 
 	// load the dll or bytecode
 	interpret = Cvar_VariableValue( "vm_ui" );
-	uivm	  = VM_Create( "ui", CL_UISystemCalls, interpret );
+	uivm	  = VM_Create( "ui", CL_UISystemCalls, NULL, interpret );
 	if( !uivm )
 	{
 		Com_Error( ERR_FATAL, "VM_Create on UI failed" );
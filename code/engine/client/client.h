@@ -508,6 +508,25 @@ void			 Key_SetCatcher( int catcher );
 void			 LAN_LoadCachedServers();
 void			 LAN_SaveServersToCache();
 
+//
+// cl_bench.c
+//
+typedef enum
+{
+	BENCH_DEMO,
+	BENCH_CGAME,
+	BENCH_FRONTEND,
+	BENCH_BACKEND,
+	BENCH_RAYTRACE,
+	BENCH_SOUND,
+	BENCH_NUM_TIMES
+} benchTime_t;
+
+void			 CL_InitBench();
+void			 CL_BenchFrame();
+void			 CL_BenchAddTime( benchTime_t which, long long nsec );
+void			 CL_BenchFinish( int msec );
+
 //
 // cl_net_chan.c
 //
@@ -65,12 +65,9 @@ cvar_t* cm_noCurves;
 cvar_t* cm_playerCurveClip;
 #endif
 
-cmodel_t  box_model;
-cplane_t* box_planes;
-cbrush_t* box_brush;
+Q_THREADLOCAL cmTempBox_t cm_tempBox;
 
-void	  CM_InitBoxHull();
-void	  CM_FloodAreaConnections();
+void					  CM_FloodAreaConnections();
 
 /*
 ===============================================================================
@@ -688,6 +685,10 @@ void CM_LoadMap( const char* name, qboolean clientload, int* checksum )
 
 	cmod_base = ( byte* )buf;
 
+#ifndef BSPC
+	Hunk_SetLabel( "clipmap" );
+#endif
+
 	// load into heap
 	CMod_LoadShaders( &header.lumps[LUMP_SHADERS] );
 	CMod_LoadLeafs( &header.lumps[LUMP_LEAFS] );
@@ -705,10 +706,12 @@ void CM_LoadMap( const char* name, qboolean clientload, int* checksum )
 	// we are NOT freeing the file, because it is cached for the ref
 	FS_FreeFile( buf );
 
-	CM_InitBoxHull();
-
 	CM_FloodAreaConnections();
 
+#ifndef BSPC
+	Hunk_SetLabel( NULL );
+#endif
+
 	// allow this to be cached if it is loaded by the server
 	if( !clientload )
 	{
@@ -744,7 +747,7 @@ cmodel_t* CM_ClipHandleToModel( clipHandle_t handle )
 	}
 	if( handle == BOX_MODEL_HANDLE )
 	{
-		return &box_model;
+		return &cm_tempBox.model;
 	}
 	if( handle < MAX_SUBMODELS )
 	{
@@ -812,42 +815,37 @@ Set up the planes and nodes so that the six floats of a bounding box
 can just be stored out and get a proper clipping hull structure.
 ===================
 */
-void CM_InitBoxHull()
+static void CM_InitBoxHull( cmTempBox_t* box )
 {
 	int			  i;
 	int			  side;
 	cplane_t*	  p;
 	cbrushside_t* s;
 
-	box_planes = &cm.planes[cm.numPlanes];
+	box->brush.numsides = 6;
+	box->brush.sides	= box->sides;
+	box->brush.contents = CONTENTS_BODY;
 
-	box_brush			= &cm.brushes[cm.numBrushes];
-	box_brush->numsides = 6;
-	box_brush->sides	= cm.brushsides + cm.numBrushSides;
-	box_brush->contents = CONTENTS_BODY;
-
-	box_model.leaf.numLeafBrushes = 1;
-	//	box_model.leaf.firstLeafBrush = cm.numBrushes;
-	box_model.leaf.firstLeafBrush	  = cm.numLeafBrushes;
-	cm.leafbrushes[cm.numLeafBrushes] = cm.numBrushes;
+	box->model.leaf.numLeafBrushes = 1;
+	box->model.leaf.firstLeafBrush = -1; // see CM_LeafBrush
 
 	for( i = 0; i < 6; i++ )
 	{
 		side = i & 1;
 
 		// brush sides
-		s				= &cm.brushsides[cm.numBrushSides + i];
-		s->plane		= cm.planes + ( cm.numPlanes + i * 2 + side );
+		s				= &box->sides[i];
+		s->plane		= &box->planes[i * 2 + side];
 		s->surfaceFlags = 0;
 
 		// planes
-		p			= &box_planes[i * 2];
+		p			= &box->planes[i * 2];
 		p->type		= i >> 1;
 		p->signbits = 0;
 		VectorClear( p->normal );
 		p->normal[i >> 1] = 1;
 
-		p			= &box_planes[i * 2 + 1];
+		p			= &box->planes[i * 2 + 1];
 		p->type		= 3 + ( i >> 1 );
 		p->signbits = 0;
 		VectorClear( p->normal );
@@ -855,6 +853,8 @@ void CM_InitBoxHull()
 
 		SetPlaneSignbits( p );
 	}
+
+	box->initialized = qtrue;
 }
 
 /*
@@ -864,33 +864,44 @@ CM_TempBoxModel
 To keep everything totally uniform, bounding boxes are turned into small
 BSP trees instead of being compared directly.
 Capsules are handled differently though.
+
+The box belongs to the calling thread and stays valid until that thread
+asks for the next one.
 ===================
 */
 clipHandle_t CM_TempBoxModel( const vec3_t mins, const vec3_t maxs, int capsule )
 {
-	VectorCopy( mins, box_model.mins );
-	VectorCopy( maxs, box_model.maxs );
+	cmTempBox_t* box;
+
+	box = &cm_tempBox;
+	if( !box->initialized )
+	{
+		CM_InitBoxHull( box );
+	}
+
+	VectorCopy( mins, box->model.mins );
+	VectorCopy( maxs, box->model.maxs );
 
 	if( capsule )
 	{
 		return CAPSULE_MODEL_HANDLE;
 	}
 
-	box_planes[0].dist	= maxs[0];
-	box_planes[1].dist	= -maxs[0];
-	box_planes[2].dist	= mins[0];
-	box_planes[3].dist	= -mins[0];
-	box_planes[4].dist	= maxs[1];
-	box_planes[5].dist	= -maxs[1];
-	box_planes[6].dist	= mins[1];
-	box_planes[7].dist	= -mins[1];
-	box_planes[8].dist	= maxs[2];
-	box_planes[9].dist	= -maxs[2];
-	box_planes[10].dist = mins[2];
-	box_planes[11].dist = -mins[2];
-
-	VectorCopy( mins, box_brush->bounds[0] );
-	VectorCopy( maxs, box_brush->bounds[1] );
+	box->planes[0].dist	 = maxs[0];
+	box->planes[1].dist	 = -maxs[0];
+	box->planes[2].dist	 = mins[0];
+	box->planes[3].dist	 = -mins[0];
+	box->planes[4].dist	 = maxs[1];
+	box->planes[5].dist	 = -maxs[1];
+	box->planes[6].dist	 = mins[1];
+	box->planes[7].dist	 = -mins[1];
+	box->planes[8].dist	 = maxs[2];
+	box->planes[9].dist	 = -maxs[2];
+	box->planes[10].dist = mins[2];
+	box->planes[11].dist = -mins[2];
+
+	VectorCopy( mins, box->brush.bounds[0] );
+	VectorCopy( maxs, box->brush.bounds[1] );
 
 	return BOX_MODEL_HANDLE;
 }
@@ -130,7 +130,7 @@ typedef struct
 	cPatch_t**	  surfaces; // non-patches will be NULL
 
 	int			  floodvalid;
-	int			  checkcount; // incremented on each trace
+	volatile int  checkcount; // each trace takes the next one, see CM_Trace
 } clipMap_t;
 
 // keep 1/8 unit away to keep the position valid before network snapping
@@ -169,6 +169,7 @@ typedef struct
 	qboolean isPoint;	  // optimized case
 	trace_t	 trace;		  // returned from trace call
 	sphere_t sphere;	  // sphere for oriendted capsule collision
+	int		 checkcount;  // brushes and patches already tested by this trace
 } traceWork_t;
 
 typedef struct leafList_s
@@ -179,6 +180,7 @@ typedef struct leafList_s
 	int*	 list;
 	vec3_t	 bounds[2];
 	int		 lastLeaf; // for overflows where each leaf can't be stored individually
+	int		 checkcount;
 	void ( *storeLeafs )( struct leafList_s* ll, int nodenum );
 } leafList_t;
 
@@ -191,6 +193,28 @@ void				   CM_BoxLeafnums_r( leafList_t* ll, int nodenum );
 
 cmodel_t*			   CM_ClipHandleToModel( clipHandle_t handle );
 
+// every thread has its own temp box model, so bots can trace from job
+// workers, its leaf is marked with a firstLeafBrush of -1
+typedef struct
+{
+	cmodel_t	 model;
+	cbrush_t	 brush;
+	cbrushside_t sides[6];
+	cplane_t	 planes[12];
+	qboolean	 initialized;
+} cmTempBox_t;
+
+extern Q_THREADLOCAL cmTempBox_t cm_tempBox;
+
+static ID_INLINE cbrush_t* CM_LeafBrush( const cLeaf_t* leaf, int k )
+{
+	if( leaf->firstLeafBrush < 0 )
+	{
+		return &cm_tempBox.brush;
+	}
+	return &cm.brushes[cm.leafbrushes[leaf->firstLeafBrush + k]];
+}
+
 // cm_patch.c
 
 struct patchCollide_s* CM_GeneratePatchCollide( int width, int height, vec3_t* points );
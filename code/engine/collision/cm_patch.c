@@ -88,16 +88,22 @@ static const patchCollide_t* debugPatchCollide;
 static const facet_t*		 debugFacet;
 static qboolean				 debugBlock;
 static vec3_t				 debugBlockPoints[4];
+#ifndef BSPC
+static cvar_t* cm_debugSurfaceUpdate; // looked up here, traces may run on job workers
+#endif
 
 /*
 =================
 CM_ClearLevelPatches
 =================
 */
-void						 CM_ClearLevelPatches()
+void CM_ClearLevelPatches()
 {
 	debugPatchCollide = NULL;
 	debugFacet		  = NULL;
+#ifndef BSPC
+	cm_debugSurfaceUpdate = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
+#endif
 }
 
 /*
@@ -1411,9 +1417,6 @@ void CM_TracePointThroughPatchCollide( traceWork_t* tw, const struct patchCollid
 	int					i, j, k;
 	float				offset;
 	float				d1, d2;
-#ifndef BSPC
-	static cvar_t* cv;
-#endif // BSPC
 
 #ifndef BSPC
 	if( !cm_playerCurveClip->integer || !tw->isPoint )
@@ -1490,11 +1493,7 @@ void CM_TracePointThroughPatchCollide( traceWork_t* tw, const struct patchCollid
 		{
 			// we hit this facet
 #ifndef BSPC
-			if( !cv )
-			{
-				cv = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
-			}
-			if( cv->integer )
+			if( cm_debugSurfaceUpdate->integer )
 			{
 				debugPatchCollide = pc;
 				debugFacet		  = facet;
@@ -1590,9 +1589,6 @@ void CM_TraceThroughPatchCollide( traceWork_t* tw, const struct patchCollide_s*
 	facet_t*	  facet;
 	float		  plane[4], bestplane[4];
 	vec3_t		  startp, endp;
-#ifndef BSPC
-	static cvar_t* cv;
-#endif // BSPC
 
 	if( tw->isPoint )
 	{
@@ -1714,11 +1710,7 @@ void CM_TraceThroughPatchCollide( traceWork_t* tw, const struct patchCollide_s*
 					enterFrac = 0;
 				}
 #ifndef BSPC
-				if( !cv )
-				{
-					cv = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
-				}
-				if( cv && cv->integer )
+				if( cm_debugSurfaceUpdate && cm_debugSurfaceUpdate->integer )
 				{
 					debugPatchCollide = pc;
 					debugFacet		  = facet;
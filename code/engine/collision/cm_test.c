@@ -115,11 +115,11 @@ void CM_StoreBrushes( leafList_t* ll, int nodenum )
 	{
 		brushnum = cm.leafbrushes[leaf->firstLeafBrush + k];
 		b		 = &cm.brushes[brushnum];
-		if( b->checkcount == cm.checkcount )
+		if( b->checkcount == ll->checkcount )
 		{
 			continue; // already checked this brush in another leaf
 		}
-		b->checkcount = cm.checkcount;
+		b->checkcount = ll->checkcount;
 		for( i = 0; i < 3; i++ )
 		{
 			if( b->bounds[0][i] >= ll->bounds[1][i] || b->bounds[1][i] <= ll->bounds[0][i] )
@@ -201,8 +201,6 @@ int CM_BoxLeafnums( const vec3_t mins, const vec3_t maxs, int* list, int listsiz
 {
 	leafList_t ll;
 
-	cm.checkcount++;
-
 	VectorCopy( mins, ll.bounds[0] );
 	VectorCopy( maxs, ll.bounds[1] );
 	ll.count	  = 0;
@@ -211,6 +209,7 @@ int CM_BoxLeafnums( const vec3_t mins, const vec3_t maxs, int* list, int listsiz
 	ll.storeLeafs = CM_StoreLeafs;
 	ll.lastLeaf	  = 0;
 	ll.overflowed = qfalse;
+	ll.checkcount = Com_AtomicAdd( &cm.checkcount, 1 );
 
 	CM_BoxLeafnums_r( &ll, 0 );
 
@@ -227,8 +226,6 @@ int CM_BoxBrushes( const vec3_t mins, const vec3_t maxs, cbrush_t** list, int li
 {
 	leafList_t ll;
 
-	cm.checkcount++;
-
 	VectorCopy( mins, ll.bounds[0] );
 	VectorCopy( maxs, ll.bounds[1] );
 	ll.count	  = 0;
@@ -237,6 +234,7 @@ int CM_BoxBrushes( const vec3_t mins, const vec3_t maxs, cbrush_t** list, int li
 	ll.storeLeafs = CM_StoreBrushes;
 	ll.lastLeaf	  = 0;
 	ll.overflowed = qfalse;
+	ll.checkcount = Com_AtomicAdd( &cm.checkcount, 1 );
 
 	CM_BoxLeafnums_r( &ll, 0 );
 
@@ -255,7 +253,6 @@ int CM_PointContents( const vec3_t p, clipHandle_t model )
 {
 	int		  leafnum;
 	int		  i, k;
-	int		  brushnum;
 	cLeaf_t*  leaf;
 	cbrush_t* b;
 	int		  contents;
@@ -282,8 +279,7 @@ int CM_PointContents( const vec3_t p, clipHandle_t model )
 	contents = 0;
 	for( k = 0; k < leaf->numLeafBrushes; k++ )
 	{
-		brushnum = cm.leafbrushes[leaf->firstLeafBrush + k];
-		b		 = &cm.brushes[brushnum];
+		b = CM_LeafBrush( leaf, k );
 
 		// see if the point is in the brush
 		for( i = 0; i < b->numsides; i++ )
@@ -261,20 +261,18 @@ CM_TestInLeaf
 void CM_TestInLeaf( traceWork_t* tw, cLeaf_t* leaf )
 {
 	int		  k;
-	int		  brushnum;
 	cbrush_t* b;
 	cPatch_t* patch;
 
 	// test box position against all brushes in the leaf
 	for( k = 0; k < leaf->numLeafBrushes; k++ )
 	{
-		brushnum = cm.leafbrushes[leaf->firstLeafBrush + k];
-		b		 = &cm.brushes[brushnum];
-		if( b->checkcount == cm.checkcount )
+		b = CM_LeafBrush( leaf, k );
+		if( b->checkcount == tw->checkcount )
 		{
 			continue; // already checked this brush in another leaf
 		}
-		b->checkcount = cm.checkcount;
+		b->checkcount = tw->checkcount;
 
 		if( !( b->contents & tw->contents ) )
 		{
@@ -303,11 +301,11 @@ void CM_TestInLeaf( traceWork_t* tw, cLeaf_t* leaf )
 			{
 				continue;
 			}
-			if( patch->checkcount == cm.checkcount )
+			if( patch->checkcount == tw->checkcount )
 			{
 				continue; // already checked this brush in another leaf
 			}
-			patch->checkcount = cm.checkcount;
+			patch->checkcount = tw->checkcount;
 
 			if( !( patch->contents & tw->contents ) )
 			{
@@ -469,12 +467,11 @@ void CM_PositionTest( traceWork_t* tw )
 	ll.storeLeafs = CM_StoreLeafs;
 	ll.lastLeaf	  = 0;
 	ll.overflowed = qfalse;
-
-	cm.checkcount++;
+	ll.checkcount = Com_AtomicAdd( &cm.checkcount, 1 );
 
 	CM_BoxLeafnums_r( &ll, 0 );
 
-	cm.checkcount++;
+	tw->checkcount = Com_AtomicAdd( &cm.checkcount, 1 );
 
 	// test the contents of the leafs
 	for( i = 0; i < ll.count; i++ )
@@ -748,21 +745,18 @@ CM_TraceThroughLeaf
 void CM_TraceThroughLeaf( traceWork_t* tw, cLeaf_t* leaf )
 {
 	int		  k;
-	int		  brushnum;
 	cbrush_t* b;
 	cPatch_t* patch;
 
 	// trace line against all brushes in the leaf
 	for( k = 0; k < leaf->numLeafBrushes; k++ )
 	{
-		brushnum = cm.leafbrushes[leaf->firstLeafBrush + k];
-
-		b = &cm.brushes[brushnum];
-		if( b->checkcount == cm.checkcount )
+		b = CM_LeafBrush( leaf, k );
+		if( b->checkcount == tw->checkcount )
 		{
 			continue; // already checked this brush in another leaf
 		}
-		b->checkcount = cm.checkcount;
+		b->checkcount = tw->checkcount;
 
 		if( !( b->contents & tw->contents ) )
 		{
@@ -791,11 +785,11 @@ void CM_TraceThroughLeaf( traceWork_t* tw, cLeaf_t* leaf )
 			{
 				continue;
 			}
-			if( patch->checkcount == cm.checkcount )
+			if( patch->checkcount == tw->checkcount )
 			{
 				continue; // already checked this patch in another leaf
 			}
-			patch->checkcount = cm.checkcount;
+			patch->checkcount = tw->checkcount;
 
 			if( !( patch->contents & tw->contents ) )
 			{
@@ -1288,12 +1282,11 @@ void CM_Trace( trace_t* results, const vec3_t start, const vec3_t end, vec3_t mi
 
 	cmod = CM_ClipHandleToModel( model );
 
-	cm.checkcount++; // for multi-check avoidance
-
 	c_traces++; // for statistics, may be zeroed
 
 	// fill in a default trace
 	Com_Memset( &tw, 0, sizeof( tw ) );
+	tw.checkcount = Com_AtomicAdd( &cm.checkcount, 1 ); // for multi-check avoidance
 	tw.trace.fraction = 1; // assume it goes the entire distance until shown otherwise
 	VectorCopy( origin, tw.modelOrigin );
 
@@ -0,0 +1,340 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// arena.c -- per thread frame arenas for temporary memory
+
+#include <q_shared.h>
+#include "qcommon.h"
+
+/*
+==============================================================================
+
+						FRAME ARENA ALLOCATION
+
+Every thread that asks for frame memory gets its own bump allocator, so
+there is no lock and no zone or hunk traffic on the allocation path.
+Everything allocated during a frame stays valid until the next call to
+Com_AdvanceFrameArenas at the top of Com_Frame; an arena notices the new
+frame number the next time its thread allocates and rewinds itself.
+
+Unlike Hunk_AllocateTempMemory there is no free, so order doesn't matter.
+Frame_Mark / Frame_FreeToMark can rewind nested scratch use early.
+
+If an arena runs dry the request is satisfied from malloc and the block
+is released at the next rewind, the overflow is counted so the arena
+size (com_frameArenaMegs) can be raised.
+==============================================================================
+*/
+
+#define MAX_FRAME_ARENAS 64
+#define ARENA_ALIGN		 16
+
+typedef struct arenaOverflow_s
+{
+	struct arenaOverflow_s* next;
+} arenaOverflow_t;
+
+typedef struct
+{
+	byte*			 base;
+	int				 size;
+	int				 used;
+	int				 frame; // com_arenaFrame this arena was last rewound at
+
+	arenaOverflow_t* overflow;
+
+	int				 highwater;		// most bytes used in a single frame
+	int				 overflowBytes; // bytes handed out by malloc in the current frame
+	int				 overflowHighwater;
+	int				 overflowCount; // lifetime number of overflowed allocations
+} frameArena_t;
+
+static frameArena_t				frameArenas[MAX_FRAME_ARENAS];
+static volatile int				numFrameArenas;
+static volatile int				com_arenaFrame;
+static int						frameArenaSize;
+
+static Q_THREADLOCAL frameArena_t* threadArena;
+
+static cvar_t*					com_frameArenaMegs;
+
+/*
+=================
+Frame_FreeOverflow
+=================
+*/
+static void Frame_FreeOverflow( frameArena_t* arena )
+{
+	arenaOverflow_t* o;
+
+	while( arena->overflow )
+	{
+		o				= arena->overflow;
+		arena->overflow = o->next;
+		free( o );
+	}
+	arena->overflowBytes = 0;
+}
+
+/*
+=================
+Frame_Rewind
+=================
+*/
+static void Frame_Rewind( frameArena_t* arena, int frame )
+{
+	if( arena->used > arena->highwater )
+	{
+		arena->highwater = arena->used;
+	}
+	if( arena->overflowBytes > arena->overflowHighwater )
+	{
+		arena->overflowHighwater = arena->overflowBytes;
+	}
+	Frame_FreeOverflow( arena );
+
+	arena->used	 = 0;
+	arena->frame = frame;
+}
+
+/*
+=================
+Frame_GetArena
+
+Returns the calling thread's arena, claiming and rewinding it as needed
+=================
+*/
+static frameArena_t* Frame_GetArena()
+{
+	frameArena_t* arena;
+	int			  index;
+
+	arena = threadArena;
+	if( !arena )
+	{
+		index = Com_AtomicAdd( &numFrameArenas, 1 ) - 1;
+		if( index >= MAX_FRAME_ARENAS )
+		{
+			Com_Error( ERR_FATAL, "Frame_GetArena: more than %i threads", MAX_FRAME_ARENAS );
+		}
+
+		arena		= &frameArenas[index];
+		arena->base = malloc( frameArenaSize );
+		if( !arena->base )
+		{
+			Com_Error( ERR_FATAL, "Frame_GetArena: failed to allocate %i bytes", frameArenaSize );
+		}
+		arena->size	 = frameArenaSize;
+		arena->frame = com_arenaFrame;
+		threadArena	 = arena;
+	}
+
+	if( arena->frame != com_arenaFrame )
+	{
+		Frame_Rewind( arena, com_arenaFrame );
+	}
+
+	return arena;
+}
+
+/*
+=================
+Frame_Alloc
+
+Memory is 16 byte aligned and NOT 0 filled.
+Valid until the next frame boundary.
+=================
+*/
+void* Frame_Alloc( int size )
+{
+	frameArena_t*	 arena;
+	arenaOverflow_t* o;
+	byte*			 buf;
+
+	if( size < 0 )
+	{
+		Com_Error( ERR_FATAL, "Frame_Alloc: negative size %i", size );
+	}
+
+	arena = Frame_GetArena();
+
+	size = ( size + ARENA_ALIGN - 1 ) & ~( ARENA_ALIGN - 1 );
+
+	if( arena->used + size <= arena->size )
+	{
+		buf = arena->base + arena->used;
+		arena->used += size;
+		return buf;
+	}
+
+	// out of arena space, spill into a malloc block that lives until the rewind
+	o = malloc( ARENA_ALIGN + size );
+	if( !o )
+	{
+		Com_Error( ERR_FATAL, "Frame_Alloc: failed on allocation of %i bytes", size );
+	}
+	o->next			= arena->overflow;
+	arena->overflow = o;
+	arena->overflowBytes += size;
+	arena->overflowCount++;
+
+	return ( byte* )o + ARENA_ALIGN;
+}
+
+/*
+=================
+Frame_ClearedAlloc
+=================
+*/
+void* Frame_ClearedAlloc( int size )
+{
+	void* buf;
+
+	buf = Frame_Alloc( size );
+	Com_Memset( buf, 0, size );
+	return buf;
+}
+
+/*
+=================
+Frame_Mark
+=================
+*/
+int Frame_Mark()
+{
+	return Frame_GetArena()->used;
+}
+
+/*
+=================
+Frame_FreeToMark
+
+Releases everything the calling thread allocated since Frame_Mark.
+Overflow blocks are kept until the frame ends.
+=================
+*/
+void Frame_FreeToMark( int mark )
+{
+	frameArena_t* arena;
+
+	arena = Frame_GetArena();
+	if( mark < 0 || mark > arena->used )
+	{
+		Com_Error( ERR_FATAL, "Frame_FreeToMark: bad mark %i", mark );
+	}
+
+	if( arena->used > arena->highwater )
+	{
+		arena->highwater = arena->used;
+	}
+	arena->used = mark;
+}
+
+/*
+=================
+Com_AdvanceFrameArenas
+
+The frame boundary, must not be called while any other thread
+is still using memory from the frame that is ending
+=================
+*/
+void Com_AdvanceFrameArenas()
+{
+	Com_AtomicAdd( &com_arenaFrame, 1 );
+
+	// the calling thread rewinds right away, the others on their next allocation
+	Frame_GetArena();
+}
+
+/*
+=================
+Com_FrameArenaInfo_f
+=================
+*/
+static void Com_FrameArenaInfo_f()
+{
+	frameArena_t* arena;
+	int			  i, count;
+
+	count = numFrameArenas;
+	if( count > MAX_FRAME_ARENAS )
+	{
+		count = MAX_FRAME_ARENAS;
+	}
+
+	Com_Printf( "%i frame arenas of %i bytes\n", count, frameArenaSize );
+	for( i = 0; i < count; i++ )
+	{
+		arena = &frameArenas[i];
+		Com_Printf( "%2i: %8i used %8i highwater", i, arena->used, arena->highwater );
+		if( arena->overflowCount )
+		{
+			Com_Printf( " %8i overflow highwater in %i allocs", arena->overflowHighwater, arena->overflowCount );
+		}
+		Com_Printf( "%s\n", arena == threadArena ? " (this thread)" : "" );
+	}
+}
+
+/*
+=================
+Com_InitFrameArenas
+=================
+*/
+void Com_InitFrameArenas()
+{
+	com_frameArenaMegs = Cvar_Get( "com_frameArenaMegs", "4", CVAR_LATCH | CVAR_ARCHIVE );
+
+	frameArenaSize = com_frameArenaMegs->integer * 1024 * 1024;
+	if( frameArenaSize < 256 * 1024 )
+	{
+		frameArenaSize = 256 * 1024;
+	}
+
+	Cmd_AddCommand( "arenainfo", Com_FrameArenaInfo_f );
+
+	// claim the main thread's arena
+	Frame_GetArena();
+}
+
+/*
+=================
+Com_ShutdownFrameArenas
+=================
+*/
+void Com_ShutdownFrameArenas()
+{
+	int i, count;
+
+	count = numFrameArenas;
+	if( count > MAX_FRAME_ARENAS )
+	{
+		count = MAX_FRAME_ARENAS;
+	}
+
+	for( i = 0; i < count; i++ )
+	{
+		Frame_FreeOverflow( &frameArenas[i] );
+		free( frameArenas[i].base );
+	}
+	Com_Memset( frameArenas, 0, sizeof( frameArenas ) );
+	numFrameArenas = 0;
+	threadArena	   = NULL;
+}
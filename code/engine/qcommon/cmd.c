@@ -329,16 +329,20 @@ void Cmd_Echo_f()
 typedef struct cmd_function_s
 {
 	struct cmd_function_s* next;
+	struct cmd_function_s* hashNext;
 	char*				   name;
 	xcommand_t			   function;
 } cmd_function_t;
 
+#define CMD_HASH_SIZE 1024
+
 static int			   cmd_argc;
 static char*		   cmd_argv[MAX_STRING_TOKENS];						   // points into cmd_tokenized
 static char			   cmd_tokenized[BIG_INFO_STRING + MAX_STRING_TOKENS]; // will have 0 bytes inserted
 static char			   cmd_cmd[BIG_INFO_STRING];						   // the original command we received (no token processing)
 
 static cmd_function_t* cmd_functions; // possible commands to execute
+static cmd_function_t* cmd_hashTable[CMD_HASH_SIZE];
 
 /*
 ============
@@ -592,6 +596,47 @@ void Cmd_TokenizeString( const char* text_in )
 	}
 }
 
+/*
+============
+Cmd_HashValue
+
+Case insensitive, like the lookups
+============
+*/
+static long Cmd_HashValue( const char* name )
+{
+	int	 i;
+	long hash;
+
+	hash = 0;
+	for( i = 0; name[i]; i++ )
+	{
+		hash += ( long )( tolower( name[i] ) ) * ( i + 119 );
+	}
+	hash = ( hash ^ ( hash >> 10 ) ^ ( hash >> 20 ) );
+	hash &= ( CMD_HASH_SIZE - 1 );
+	return hash;
+}
+
+/*
+============
+Cmd_FindCommand
+============
+*/
+static cmd_function_t* Cmd_FindCommand( const char* cmd_name )
+{
+	cmd_function_t* cmd;
+
+	for( cmd = cmd_hashTable[Cmd_HashValue( cmd_name )]; cmd; cmd = cmd->hashNext )
+	{
+		if( !Q_stricmp( cmd_name, cmd->name ) )
+		{
+			return cmd;
+		}
+	}
+	return NULL;
+}
+
 /*
 ============
 Cmd_AddCommand
@@ -600,19 +645,17 @@ Cmd_AddCommand
 void Cmd_AddCommand( const char* cmd_name, xcommand_t function )
 {
 	cmd_function_t* cmd;
+	long			hash;
 
 	// fail if the command already exists
-	for( cmd = cmd_functions; cmd; cmd = cmd->next )
+	if( Cmd_FindCommand( cmd_name ) )
 	{
-		if( !strcmp( cmd_name, cmd->name ) )
+		// allow completion-only commands to be silently doubled
+		if( function != NULL )
 		{
-			// allow completion-only commands to be silently doubled
-			if( function != NULL )
-			{
-				Com_Printf( "Cmd_AddCommand: %s already defined\n", cmd_name );
-			}
-			return;
+			Com_Printf( "Cmd_AddCommand: %s already defined\n", cmd_name );
 		}
+		return;
 	}
 
 	// use a small malloc to avoid zone fragmentation
@@ -621,6 +664,10 @@ void Cmd_AddCommand( const char* cmd_name, xcommand_t function )
 	cmd->function = function;
 	cmd->next	  = cmd_functions;
 	cmd_functions = cmd;
+
+	hash				= Cmd_HashValue( cmd_name );
+	cmd->hashNext		= cmd_hashTable[hash];
+	cmd_hashTable[hash] = cmd;
 }
 
 /*
@@ -632,27 +679,28 @@ void Cmd_RemoveCommand( const char* cmd_name )
 {
 	cmd_function_t *cmd, **back;
 
-	back = &cmd_functions;
-	while( 1 )
+	cmd = Cmd_FindCommand( cmd_name );
+	if( !cmd )
 	{
-		cmd = *back;
-		if( !cmd )
-		{
-			// command wasn't active
-			return;
-		}
-		if( !strcmp( cmd_name, cmd->name ) )
-		{
-			*back = cmd->next;
-			if( cmd->name )
-			{
-				Z_Free( cmd->name );
-			}
-			Z_Free( cmd );
-			return;
-		}
-		back = &cmd->next;
+		// command wasn't active
+		return;
+	}
+
+	for( back = &cmd_hashTable[Cmd_HashValue( cmd_name )]; *back != cmd; back = &( *back )->hashNext )
+	{
+	}
+	*back = cmd->hashNext;
+
+	for( back = &cmd_functions; *back != cmd; back = &( *back )->next )
+	{
+	}
+	*back = cmd->next;
+
+	if( cmd->name )
+	{
+		Z_Free( cmd->name );
 	}
+	Z_Free( cmd );
 }
 
 /*
@@ -679,7 +727,7 @@ A complete command line has been parsed, so try to execute it
 */
 void Cmd_ExecuteString( const char* text )
 {
-	cmd_function_t *cmd, **prev;
+	cmd_function_t* cmd;
 
 	// execute the command line
 	Cmd_TokenizeString( text );
@@ -689,30 +737,14 @@ void Cmd_ExecuteString( const char* text )
 	}
 
 	// check registered command functions
-	for( prev = &cmd_functions; *prev; prev = &cmd->next )
+	cmd = Cmd_FindCommand( cmd_argv[0] );
+	if( cmd && cmd->function )
 	{
-		cmd = *prev;
-		if( !Q_stricmp( cmd_argv[0], cmd->name ) )
-		{
-			// rearrange the links so that the command will be
-			// near the head of the list next time it is used
-			*prev		  = cmd->next;
-			cmd->next	  = cmd_functions;
-			cmd_functions = cmd;
-
-			// perform the action
-			if( !cmd->function )
-			{
-				// let the cgame or game handle it
-				break;
-			}
-			else
-			{
-				cmd->function();
-			}
-			return;
-		}
+		// perform the action
+		cmd->function();
+		return;
 	}
+	// commands without a function are completion only, let the cgame or game handle them
 
 	// check cvars
 	if( Cvar_Command() )
@@ -50,6 +50,14 @@ char*				com_argv[MAX_NUM_ARGVS + 1];
 
 jmp_buf				abortframe; // an ERR_DROP occured, exit the entire frame
 
+// compiled qvm code has no unwind data, so the longjmp out of an error
+// inside it must restore the registers instead of unwinding the stack
+#if defined( _MSC_VER ) && defined( _WIN64 )
+	#define Com_NoUnwind( buf ) ( ( ( _JUMP_BUFFER* )( buf ) )->Frame = 0 )
+#else
+	#define Com_NoUnwind( buf )
+#endif
+
 FILE*				debuglogfile;
 static fileHandle_t logfile;
 fileHandle_t		com_journalFile;	 // events are written here
@@ -199,7 +207,7 @@ void QDECL Com_Printf( const char* fmt, ... )
 		}
 		if( logfile && FS_Initialized() )
 		{
-			FS_Write( msg, strlen( msg ), logfile );
+			Com_LogWrite( msg, strlen( msg ), logfile );
 		}
 	}
 }
@@ -280,6 +288,7 @@ void QDECL Com_Error( int code, const char* fmt, ... )
 
 	if( com_errorEntered )
 	{
+		Com_LogFlush();
 		Sys_Error( "recursive error after: %s", com_errorMessage );
 	}
 	com_errorEntered = qtrue;
@@ -303,6 +312,7 @@ void QDECL Com_Error( int code, const char* fmt, ... )
 	else if( code == ERR_DROP || code == ERR_DISCONNECT )
 	{
 		Com_Printf( "********************\nERROR: %s\n********************\n", com_errorMessage );
+		Com_LogFlush();
 		SV_Shutdown( va( "Server crashed: %s\n", com_errorMessage ) );
 		CL_Disconnect( qtrue );
 		CL_FlushMemory();
@@ -827,15 +837,28 @@ int Com_RealTime( qtime_t* qtime )
 There is never any space between memblocks, and there will never be two
 contiguous free memblocks.
 
-The rover can be left pointing at a non-empty block
+Small allocations are served from size class slabs. A slab is a regular
+zone block (TAG_SLAB) carved into equally sized chunks, each chunk carries
+its own memblock_t header with a ZONESLABID id and a back pointer to the
+slab block, so Z_Free can tell the two kinds apart.
+
+Everything else is best-fit out of free lists binned by power of two size,
+which keeps the CopyString / cvar / botlib churn from shredding the zone
+the way the old first-fit rover did on long running servers.
 
 The zone calls are pretty much only used for small strings and structures,
 all big things are allocated on the hunk.
 ==============================================================================
 */
 
-#define ZONEID		0x1d4a11
-#define MINFRAGMENT 64
+#define ZONEID				0x1d4a11
+#define ZONESLABID			0x1d4a12 // chunk inside a slab
+#define MINFRAGMENT			64
+
+#define ZONE_FREE_BINS		32	 // one free list per power of two
+#define ZONE_SLAB_SIZE		8192 // bytes per slab, including the slab block header
+#define ZONE_SLAB_CLASSES	10
+#define ZONE_SLAB_MAXALLOC	512 // largest request that goes to a slab
 
 typedef struct zonedebug_s
 {
@@ -850,36 +873,150 @@ typedef struct memblock_s
 	int				   size; // including the header and possibly tiny fragments
 	int				   tag;	 // a tag of 0 is a free block
 	struct memblock_s *next, *prev;
-	int				   id; // should be ZONEID
+	int				   id; // should be ZONEID or ZONESLABID
 #ifdef ZONE_DEBUG
 	zonedebug_t d;
 #endif
 } memblock_t;
 
+// free list links, stored in the body of free blocks
+typedef struct
+{
+	memblock_t* nextFree;
+	memblock_t* prevFree;
+} memfree_t;
+
+#define FREELINKS( block ) ( ( memfree_t* )( ( block ) + 1 ) )
+#define ZONE_MINBLOCK	   ( int )( ( sizeof( memblock_t ) + sizeof( memfree_t ) + 4 + 3 ) & ~3 )
+
+// lives right behind the memblock_t of a TAG_SLAB block, followed by the chunks
+typedef struct memslab_s
+{
+	struct memslab_s *nextPartial, *prevPartial; // slabs of the same class with free chunks
+	memblock_t*		  freeChunks;				 // linked through memblock_t->next
+	int				  sizeClass;
+	int				  numChunks;
+	int				  numUsed;
+} memslab_t;
+
+#define SLABFORBLOCK( block ) ( ( memslab_t* )( ( block ) + 1 ) )
+
+typedef struct
+{
+	int		   chunkSize; // including the header and memory trash tester
+	memslab_t* partial;
+	int		   numSlabs;
+	int		   chunksUsed;
+	int		   chunksTotal;
+} memclass_t;
+
 typedef struct
 {
 	int			size;	   // total bytes malloced, including header
-	int			used;	   // total bytes used
+	int			used;	   // total bytes used, slabs count as a whole
 	memblock_t	blocklist; // start / end cap for linked list
-	memblock_t* rover;
+	memblock_t* freeBins[ZONE_FREE_BINS];
+	memclass_t	classes[ZONE_SLAB_CLASSES];
 } memzone_t;
 
+// payload sizes of the slab classes
+static const int zoneSlabPayloads[ZONE_SLAB_CLASSES] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, ZONE_SLAB_MAXALLOC };
+
+// request size rounded up to 16 bytes -> slab class
+static byte		 zoneSlabClassForSize[( ZONE_SLAB_MAXALLOC >> 4 ) + 1];
+
+// always on per tag accounting, see mem_stats
+static memStat_t* zoneTagStats[TAG_COUNT];
+
 // main zone for all "dynamic" memory allocation
-memzone_t* mainzone;
+memzone_t*		 mainzone;
 // we also have a small zone for small allocations that would only
 // fragment the main zone (think of cvar and cmd strings)
-memzone_t* smallzone;
+memzone_t*		 smallzone;
+
+void			 Z_CheckHeap();
+
+/*
+========================
+Z_FreeBin
+========================
+*/
+static int		 Z_FreeBin( int size )
+{
+	int bin;
+
+	for( bin = 0; size > 1 && bin < ZONE_FREE_BINS - 1; bin++ )
+	{
+		size >>= 1;
+	}
+	return bin;
+}
+
+/*
+========================
+Z_LinkFree
+========================
+*/
+static void Z_LinkFree( memzone_t* zone, memblock_t* block )
+{
+	memblock_t** head;
+
+	head = &zone->freeBins[Z_FreeBin( block->size )];
+
+	FREELINKS( block )->prevFree = NULL;
+	FREELINKS( block )->nextFree = *head;
+	if( *head )
+	{
+		FREELINKS( *head )->prevFree = block;
+	}
+	*head = block;
+}
+
+/*
+========================
+Z_UnlinkFree
+========================
+*/
+static void Z_UnlinkFree( memzone_t* zone, memblock_t* block )
+{
+	memfree_t* links;
 
-void	   Z_CheckHeap();
+	links = FREELINKS( block );
+	if( links->prevFree )
+	{
+		FREELINKS( links->prevFree )->nextFree = links->nextFree;
+	}
+	else
+	{
+		zone->freeBins[Z_FreeBin( block->size )] = links->nextFree;
+	}
+	if( links->nextFree )
+	{
+		FREELINKS( links->nextFree )->prevFree = links->prevFree;
+	}
+}
 
 /*
 ========================
 Z_ClearZone
 ========================
 */
-void	   Z_ClearZone( memzone_t* zone, int size )
+void Z_ClearZone( memzone_t* zone, int size )
 {
 	memblock_t* block;
+	int			i, c;
+
+	// build the request size to slab class table
+	for( i = 0, c = 0; i <= ( ZONE_SLAB_MAXALLOC >> 4 ); i++ )
+	{
+		while( zoneSlabPayloads[c] < ( i << 4 ) )
+		{
+			c++;
+		}
+		zoneSlabClassForSize[i] = c;
+	}
+
+	Com_Memset( zone, 0, sizeof( *zone ) );
 
 	// set the entire zone to one free block
 
@@ -887,14 +1024,19 @@ void	   Z_ClearZone( memzone_t* zone, int size )
 	zone->blocklist.tag									= 1; // in use block
 	zone->blocklist.id									= 0;
 	zone->blocklist.size								= 0;
-	zone->rover											= block;
 	zone->size											= size;
 	zone->used											= 0;
 
+	for( i = 0; i < ZONE_SLAB_CLASSES; i++ )
+	{
+		zone->classes[i].chunkSize = ( sizeof( memblock_t ) + zoneSlabPayloads[i] + 4 + 7 ) & ~7;
+	}
+
 	block->prev = block->next = &zone->blocklist;
 	block->tag				  = 0; // free block
 	block->id				  = ZONEID;
 	block->size				  = size - sizeof( memzone_t );
+	Z_LinkFree( zone, block );
 }
 
 /*
@@ -919,53 +1061,89 @@ int Z_AvailableMemory()
 
 /*
 ========================
-Z_Free
+Z_ZoneForTag
 ========================
 */
-void Z_Free( void* ptr )
+static memzone_t* Z_ZoneForTag( int tag )
 {
-	memblock_t *block, *other;
-	memzone_t*	zone;
+	return ( tag == TAG_SMALL ) ? smallzone : mainzone;
+}
 
-	if( !ptr )
-	{
-		Com_Error( ERR_DROP, "Z_Free: NULL pointer" );
-	}
+/*
+========================
+Z_AllocBlock
 
-	block = ( memblock_t* )( ( byte* )ptr - sizeof( memblock_t ) );
-	if( block->id != ZONEID )
-	{
-		Com_Error( ERR_FATAL, "Z_Free: freed a pointer without ZONEID" );
-	}
-	if( block->tag == 0 )
-	{
-		Com_Error( ERR_FATAL, "Z_Free: freed a freed pointer" );
-	}
-	// if static memory
-	if( block->tag == TAG_STATIC )
+Takes the smallest free block that can hold size bytes,
+returns NULL if there is none
+========================
+*/
+static memblock_t* Z_AllocBlock( memzone_t* zone, int size )
+{
+	memblock_t *block, *best, *new;
+	int			bin, extra;
+
+	if( size < ZONE_MINBLOCK )
 	{
-		return;
+		size = ZONE_MINBLOCK;
 	}
 
-	// check the memory trash tester
-	if( *( int* )( ( byte* )block + block->size - 4 ) != ZONEID )
+	best = NULL;
+	for( bin = Z_FreeBin( size ); bin < ZONE_FREE_BINS && !best; bin++ )
 	{
-		Com_Error( ERR_FATAL, "Z_Free: memory block wrote past end" );
+		for( block = zone->freeBins[bin]; block; block = FREELINKS( block )->nextFree )
+		{
+			if( block->size >= size && ( !best || block->size < best->size ) )
+			{
+				best = block;
+				if( block->size == size )
+				{
+					break;
+				}
+			}
+		}
 	}
 
-	if( block->tag == TAG_SMALL )
+	if( !best )
 	{
-		zone = smallzone;
+		return NULL;
 	}
-	else
+
+	Z_UnlinkFree( zone, best );
+
+	extra = best->size - size;
+	if( extra > MINFRAGMENT && extra >= ZONE_MINBLOCK )
 	{
-		zone = mainzone;
+		// there will be a free fragment after the allocated block
+		new				= ( memblock_t* )( ( byte* )best + size );
+		new->size		= extra;
+		new->tag		= 0; // free block
+		new->prev		= best;
+		new->id			= ZONEID;
+		new->next		= best->next;
+		new->next->prev = new;
+		best->next		= new;
+		best->size		= size;
+		Z_LinkFree( zone, new );
 	}
 
+	best->id = ZONEID;
+	zone->used += best->size;
+
+	return best;
+}
+
+/*
+========================
+Z_FreeBlock
+
+Returns the free block the freed memory ended up in after merging
+========================
+*/
+static memblock_t* Z_FreeBlock( memzone_t* zone, memblock_t* block )
+{
+	memblock_t* other;
+
 	zone->used -= block->size;
-	// set the block to something that should cause problems
-	// if it is referenced...
-	Com_Memset( ptr, 0xaa, block->size - sizeof( *block ) );
 
 	block->tag = 0; // mark as free
 
@@ -973,64 +1151,299 @@ void Z_Free( void* ptr )
 	if( !other->tag )
 	{
 		// merge with previous free block
+		Z_UnlinkFree( zone, other );
 		other->size += block->size;
 		other->next		  = block->next;
 		other->next->prev = other;
-		if( block == zone->rover )
-		{
-			zone->rover = other;
-		}
-		block = other;
+		block			  = other;
 	}
 
-	zone->rover = block;
-
 	other = block->next;
 	if( !other->tag )
 	{
 		// merge the next free block onto the end
+		Z_UnlinkFree( zone, other );
 		block->size += other->size;
 		block->next		  = other->next;
 		block->next->prev = block;
-		if( other == zone->rover )
+	}
+
+	Z_LinkFree( zone, block );
+
+	return block;
+}
+
+/*
+========================
+Z_NewSlab
+========================
+*/
+static memslab_t* Z_NewSlab( memzone_t* zone, int sizeClass )
+{
+	memclass_t* cls;
+	memblock_t *block, *chunk;
+	memslab_t*	slab;
+	byte*		base;
+	int			i;
+
+	block = Z_AllocBlock( zone, ZONE_SLAB_SIZE );
+	if( !block )
+	{
+		return NULL;
+	}
+	block->tag = TAG_SLAB;
+	*( int* )( ( byte* )block + block->size - 4 ) = ZONEID;
+	Com_MemStatAlloc( zoneTagStats[TAG_SLAB], block->size );
+
+	cls	 = &zone->classes[sizeClass];
+	slab = SLABFORBLOCK( block );
+	base = ( byte* )( slab + 1 );
+
+	slab->sizeClass	 = sizeClass;
+	slab->numUsed	 = 0;
+	slab->numChunks	 = ( block->size - sizeof( memblock_t ) - sizeof( memslab_t ) - 4 ) / cls->chunkSize;
+	slab->freeChunks = NULL;
+
+	// thread the chunks back to front so they are handed out in address order
+	for( i = slab->numChunks - 1; i >= 0; i-- )
+	{
+		chunk			 = ( memblock_t* )( base + i * cls->chunkSize );
+		chunk->size		 = cls->chunkSize;
+		chunk->tag		 = 0;
+		chunk->id		 = ZONESLABID;
+		chunk->prev		 = block;
+		chunk->next		 = slab->freeChunks;
+		slab->freeChunks = chunk;
+	}
+
+	slab->prevPartial = NULL;
+	slab->nextPartial = cls->partial;
+	if( cls->partial )
+	{
+		cls->partial->prevPartial = slab;
+	}
+	cls->partial = slab;
+
+	cls->numSlabs++;
+	cls->chunksTotal += slab->numChunks;
+
+	return slab;
+}
+
+/*
+========================
+Z_UnlinkPartial
+========================
+*/
+static void Z_UnlinkPartial( memclass_t* cls, memslab_t* slab )
+{
+	if( slab->prevPartial )
+	{
+		slab->prevPartial->nextPartial = slab->nextPartial;
+	}
+	else
+	{
+		cls->partial = slab->nextPartial;
+	}
+	if( slab->nextPartial )
+	{
+		slab->nextPartial->prevPartial = slab->prevPartial;
+	}
+	slab->nextPartial = slab->prevPartial = NULL;
+}
+
+/*
+========================
+Z_AllocChunk
+========================
+*/
+static memblock_t* Z_AllocChunk( memzone_t* zone, int sizeClass )
+{
+	memclass_t* cls;
+	memslab_t*	slab;
+	memblock_t* chunk;
+
+	cls	 = &zone->classes[sizeClass];
+	slab = cls->partial;
+	if( !slab )
+	{
+		slab = Z_NewSlab( zone, sizeClass );
+		if( !slab )
 		{
-			zone->rover = block;
+			return NULL;
 		}
 	}
+
+	chunk			 = slab->freeChunks;
+	slab->freeChunks = chunk->next;
+	chunk->next		 = NULL;
+	slab->numUsed++;
+	cls->chunksUsed++;
+
+	if( !slab->freeChunks )
+	{
+		// full, stop handing it out
+		Z_UnlinkPartial( cls, slab );
+	}
+
+	return chunk;
 }
 
 /*
-================
-Z_FreeTags
-================
+========================
+Z_FreeChunk
+
+Returns the merged free block if the slab was given back to the zone
+========================
 */
-void Z_FreeTags( int tag )
+static memblock_t* Z_FreeChunk( memzone_t* zone, memblock_t* chunk )
+{
+	memclass_t* cls;
+	memslab_t*	slab;
+
+	slab = SLABFORBLOCK( chunk->prev );
+	cls	 = &zone->classes[slab->sizeClass];
+
+	chunk->tag = 0;
+
+	if( !slab->freeChunks )
+	{
+		// was full, make it available again
+		slab->prevPartial = NULL;
+		slab->nextPartial = cls->partial;
+		if( cls->partial )
+		{
+			cls->partial->prevPartial = slab;
+		}
+		cls->partial = slab;
+	}
+	chunk->next		 = slab->freeChunks;
+	slab->freeChunks = chunk;
+	slab->numUsed--;
+	cls->chunksUsed--;
+
+	// keep the last slab of a class around so we don't thrash
+	if( slab->numUsed == 0 && cls->numSlabs > 1 )
+	{
+		Z_UnlinkPartial( cls, slab );
+		cls->numSlabs--;
+		cls->chunksTotal -= slab->numChunks;
+		Com_MemStatFree( zoneTagStats[TAG_SLAB], chunk->prev->size );
+		return Z_FreeBlock( zone, chunk->prev );
+	}
+
+	return NULL;
+}
+
+/*
+========================
+Z_Release
+
+Frees a validated block, returns the block the iteration in Z_FreeTags
+should continue from or NULL if the block list did not change
+========================
+*/
+static memblock_t* Z_Release( memblock_t* block )
 {
-	int		   count;
 	memzone_t* zone;
 
-	if( tag == TAG_SMALL )
+	if( block->id != ZONEID && block->id != ZONESLABID )
 	{
-		zone = smallzone;
+		Com_Error( ERR_FATAL, "Z_Free: freed a pointer without ZONEID" );
 	}
-	else
+	if( block->tag == 0 )
 	{
-		zone = mainzone;
+		Com_Error( ERR_FATAL, "Z_Free: freed a freed pointer" );
 	}
-	count = 0;
-	// use the rover as our pointer, because
-	// Z_Free automatically adjusts it
-	zone->rover = zone->blocklist.next;
-	do
+	// if static memory
+	if( block->tag == TAG_STATIC )
 	{
-		if( zone->rover->tag == tag )
+		return NULL;
+	}
+
+	// check the memory trash tester
+	if( *( int* )( ( byte* )block + block->size - 4 ) != ZONEID )
+	{
+		Com_Error( ERR_FATAL, "Z_Free: memory block wrote past end" );
+	}
+
+	zone = Z_ZoneForTag( block->tag );
+
+	Com_MemStatFree( zoneTagStats[block->tag], block->size );
+
+	// set the block to something that should cause problems
+	// if it is referenced...
+	Com_Memset( block + 1, 0xaa, block->size - sizeof( *block ) );
+
+	if( block->id == ZONESLABID )
+	{
+		return Z_FreeChunk( zone, block );
+	}
+	return Z_FreeBlock( zone, block );
+}
+
+/*
+========================
+Z_Free
+========================
+*/
+void Z_Free( void* ptr )
+{
+	if( !ptr )
+	{
+		Com_Error( ERR_DROP, "Z_Free: NULL pointer" );
+	}
+
+	Z_Release( ( memblock_t* )( ( byte* )ptr - sizeof( memblock_t ) ) );
+}
+
+/*
+================
+Z_FreeTags
+================
+*/
+void Z_FreeTags( int tag )
+{
+	memzone_t*	zone;
+	memblock_t *block, *chunk, *merged;
+	memslab_t*	slab;
+	byte*		base;
+	int			i, chunkSize;
+
+	zone = Z_ZoneForTag( tag );
+
+	for( block = zone->blocklist.next; block != &zone->blocklist; block = block->next )
+	{
+		if( block->tag == TAG_SLAB )
 		{
-			count++;
-			Z_Free( ( void* )( zone->rover + 1 ) );
-			continue;
+			slab	  = SLABFORBLOCK( block );
+			base	  = ( byte* )( slab + 1 );
+			chunkSize = zone->classes[slab->sizeClass].chunkSize;
+			for( i = 0; i < slab->numChunks; i++ )
+			{
+				chunk = ( memblock_t* )( base + i * chunkSize );
+				if( chunk->tag == tag )
+				{
+					merged = Z_Release( chunk );
+					if( merged )
+					{
+						// the slab went back to the zone
+						block = merged;
+						break;
+					}
+				}
+			}
+		}
+		else if( block->tag == tag )
+		{
+			// Z_Release may merge us into the previous free block
+			merged = Z_Release( block );
+			if( merged )
+			{
+				block = merged;
+			}
 		}
-		zone->rover = zone->rover->next;
-	} while( zone->rover != &zone->blocklist );
+	}
 }
 
 /*
@@ -1045,8 +1458,8 @@ void* Z_TagMallocDebug( int size, int tag, char* label, char* file, int line )
 void* Z_TagMalloc( int size, int tag )
 {
 #endif
-	int			extra, allocSize;
-	memblock_t *start, *rover, *new, *base;
+	int			allocSize;
+	memblock_t* base;
 	memzone_t*	zone;
 
 	if( !tag )
@@ -1054,72 +1467,36 @@ void* Z_TagMalloc( int size, int tag )
 		Com_Error( ERR_FATAL, "Z_TagMalloc: tried to use a 0 tag" );
 	}
 
-	if( tag == TAG_SMALL )
-	{
-		zone = smallzone;
-	}
-	else
-	{
-		zone = mainzone;
-	}
+	zone = Z_ZoneForTag( tag );
 
 	allocSize = size;
-	//
-	// scan through the block list looking for the first free block
-	// of sufficient size
-	//
-	size += sizeof( memblock_t ); // account for size of block header
-	size += 4;					  // space for memory trash tester
-	size = ( size + 3 ) & ~3;	  // align to 32 bit boundary
 
-	base = rover = zone->rover;
-	start		 = base->prev;
+	base = NULL;
+	if( size <= ZONE_SLAB_MAXALLOC )
+	{
+		base = Z_AllocChunk( zone, zoneSlabClassForSize[( size + 15 ) >> 4] );
+	}
 
-	do
+	if( !base )
 	{
-		if( rover == start )
+		size += sizeof( memblock_t ); // account for size of block header
+		size += 4;					  // space for memory trash tester
+		size = ( size + 3 ) & ~3;	  // align to 32 bit boundary
+
+		base = Z_AllocBlock( zone, size );
+		if( !base )
 		{
 #ifdef ZONE_DEBUG
 			Z_LogHeap();
 #endif
-			// scaned all the way around the list
 			Com_Error( ERR_FATAL, "Z_Malloc: failed on allocation of %i bytes from the %s zone", size, zone == smallzone ? "small" : "main" );
 			return NULL;
 		}
-		if( rover->tag )
-		{
-			base = rover = rover->next;
-		}
-		else
-		{
-			rover = rover->next;
-		}
-	} while( base->tag || base->size < size );
-
-	//
-	// found a block big enough
-	//
-	extra = base->size - size;
-	if( extra > MINFRAGMENT )
-	{
-		// there will be a free fragment after the allocated block
-		new				= ( memblock_t* )( ( byte* )base + size );
-		new->size		= extra;
-		new->tag		= 0; // free block
-		new->prev		= base;
-		new->id			= ZONEID;
-		new->next		= base->next;
-		new->next->prev = new;
-		base->next		= new;
-		base->size		= size;
 	}
 
 	base->tag = tag; // no longer a free block
 
-	zone->rover = base->next; // next allocation will start looking here
-	zone->used += base->size; //
-
-	base->id = ZONEID;
+	Com_MemStatAlloc( zoneTagStats[tag], base->size );
 
 #ifdef ZONE_DEBUG
 	base->d.label	  = label;
@@ -1174,16 +1551,43 @@ void* S_Malloc( int size )
 
 /*
 ========================
-Z_CheckHeap
+Z_CheckZone
 ========================
 */
-void Z_CheckHeap()
+static void Z_CheckZone( memzone_t* zone )
 {
-	memblock_t* block;
+	memblock_t *block, *chunk;
+	memslab_t*	slab;
+	byte*		base;
+	int			i, used, chunkSize;
 
-	for( block = mainzone->blocklist.next;; block = block->next )
+	for( block = zone->blocklist.next;; block = block->next )
 	{
-		if( block->next == &mainzone->blocklist )
+		if( block->tag == TAG_SLAB )
+		{
+			slab	  = SLABFORBLOCK( block );
+			base	  = ( byte* )( slab + 1 );
+			chunkSize = zone->classes[slab->sizeClass].chunkSize;
+			used	  = 0;
+			for( i = 0; i < slab->numChunks; i++ )
+			{
+				chunk = ( memblock_t* )( base + i * chunkSize );
+				if( chunk->id != ZONESLABID || chunk->prev != block || chunk->size != chunkSize )
+				{
+					Com_Error( ERR_FATAL, "Z_CheckHeap: trashed slab chunk header" );
+				}
+				if( chunk->tag )
+				{
+					used++;
+				}
+			}
+			if( used != slab->numUsed )
+			{
+				Com_Error( ERR_FATAL, "Z_CheckHeap: slab use count mismatch" );
+			}
+		}
+
+		if( block->next == &zone->blocklist )
 		{
 			break; // all blocks have been hit
 		}
@@ -1204,18 +1608,61 @@ void Z_CheckHeap()
 
 /*
 ========================
-Z_LogZoneHeap
+Z_CheckHeap
 ========================
 */
-void Z_LogZoneHeap( memzone_t* zone, char* name )
+void Z_CheckHeap()
+{
+	Z_CheckZone( mainzone );
+	Z_CheckZone( smallzone );
+}
+
+/*
+========================
+Z_LogBlock
+========================
+*/
+static void Z_LogBlock( memblock_t* block, int* size, int* allocSize, int* numBlocks )
 {
 #ifdef ZONE_DEBUG
-	char dump[32], *ptr;
-	int	 i, j;
+	char  dump[32], *ptr;
+	int	  i, j;
+	char  buf[4096];
+
+	ptr = ( ( char* )block ) + sizeof( memblock_t );
+	j	= 0;
+	for( i = 0; i < 20 && i < block->d.allocSize; i++ )
+	{
+		if( ptr[i] >= 32 && ptr[i] < 127 )
+		{
+			dump[j++] = ptr[i];
+		}
+		else
+		{
+			dump[j++] = '_';
+		}
+	}
+	dump[j] = '\0';
+	Com_sprintf( buf, sizeof( buf ), "size = %8d: %s, line: %d (%s) [%s]\r\n", block->d.allocSize, block->d.file, block->d.line, block->d.label, dump );
+	FS_Write( buf, strlen( buf ), logfile );
+	*allocSize += block->d.allocSize;
 #endif
-	memblock_t* block;
+	*size += block->size;
+	( *numBlocks )++;
+}
+
+/*
+========================
+Z_LogZoneHeap
+========================
+*/
+void Z_LogZoneHeap( memzone_t* zone, char* name )
+{
+	memblock_t *block, *chunk;
+	memslab_t*	slab;
+	byte*		base;
 	char		buf[4096];
-	int			size, allocSize, numBlocks;
+	int			i, size, allocSize, numBlocks, chunkSize;
 
 	if( !logfile || !FS_Initialized() )
 	{
@@ -1226,29 +1673,23 @@ void Z_LogZoneHeap( memzone_t* zone, char* name )
 	FS_Write( buf, strlen( buf ), logfile );
 	for( block = zone->blocklist.next; block->next != &zone->blocklist; block = block->next )
 	{
-		if( block->tag )
+		if( block->tag == TAG_SLAB )
 		{
-#ifdef ZONE_DEBUG
-			ptr = ( ( char* )block ) + sizeof( memblock_t );
-			j	= 0;
-			for( i = 0; i < 20 && i < block->d.allocSize; i++ )
+			slab	  = SLABFORBLOCK( block );
+			base	  = ( byte* )( slab + 1 );
+			chunkSize = zone->classes[slab->sizeClass].chunkSize;
+			for( i = 0; i < slab->numChunks; i++ )
 			{
-				if( ptr[i] >= 32 && ptr[i] < 127 )
+				chunk = ( memblock_t* )( base + i * chunkSize );
+				if( chunk->tag )
 				{
-					dump[j++] = ptr[i];
-				}
-				else
-				{
-					dump[j++] = '_';
+					Z_LogBlock( chunk, &size, &allocSize, &numBlocks );
 				}
 			}
-			dump[j] = '\0';
-			Com_sprintf( buf, sizeof( buf ), "size = %8d: %s, line: %d (%s) [%s]\r\n", block->d.allocSize, block->d.file, block->d.line, block->d.label, dump );
-			FS_Write( buf, strlen( buf ), logfile );
-			allocSize += block->d.allocSize;
-#endif
-			size += block->size;
-			numBlocks++;
+		}
+		else if( block->tag )
+		{
+			Z_LogBlock( block, &size, &allocSize, &numBlocks );
 		}
 	}
 #ifdef ZONE_DEBUG
@@ -1274,6 +1715,56 @@ void Z_LogHeap()
 	Z_LogZoneHeap( smallzone, "SMALL" );
 }
 
+/*
+========================
+Z_PrintZoneStats
+
+Free space fragmentation and slab class usage for Com_Meminfo_f
+========================
+*/
+static void Z_PrintZoneStats( memzone_t* zone, const char* name )
+{
+	memblock_t* block;
+	memclass_t* cls;
+	int			i, freeBytes, freeBlocks, largestFree;
+
+	freeBytes = freeBlocks = largestFree = 0;
+	for( i = 0; i < ZONE_FREE_BINS; i++ )
+	{
+		for( block = zone->freeBins[i]; block; block = FREELINKS( block )->nextFree )
+		{
+			freeBytes += block->size;
+			freeBlocks++;
+			if( block->size > largestFree )
+			{
+				largestFree = block->size;
+			}
+		}
+	}
+
+	Com_Printf( "%s zone: %i bytes free in %i blocks, largest %i, %.1f%% fragmented\n",
+		name,
+		freeBytes,
+		freeBlocks,
+		largestFree,
+		freeBytes ? 100.0f * ( 1.0f - ( float )largestFree / freeBytes ) : 0.0f );
+
+	for( i = 0; i < ZONE_SLAB_CLASSES; i++ )
+	{
+		cls = &zone->classes[i];
+		if( !cls->numSlabs )
+		{
+			continue;
+		}
+		Com_Printf( "        %4i byte class: %3i slabs %6i / %6i chunks (%3i%%)\n",
+			zoneSlabPayloads[i],
+			cls->numSlabs,
+			cls->chunksUsed,
+			cls->chunksTotal,
+			cls->chunksTotal ? 100 * cls->chunksUsed / cls->chunksTotal : 0 );
+	}
+}
+
 // static mem blocks to reduce a lot of small zone overhead
 typedef struct memstatic_s
 {
@@ -1394,6 +1885,10 @@ static int			s_hunkTotal;
 static int			s_zoneTotal;
 static int			s_smallZoneTotal;
 
+static memStat_t*	hunkLabelStat; // who the next Hunk_Alloc is charged to
+static memStat_t*	hunkOtherStat;
+static memStat_t*	hunkTempStat;
+
 /*
 =================
 Com_Meminfo_f
@@ -1406,30 +1901,14 @@ void				Com_Meminfo_f()
 	int			smallZoneBytes, smallZoneBlocks;
 	int			botlibBytes, rendererBytes;
 	int			unused;
+	int			i;
 
-	zoneBytes	  = 0;
-	botlibBytes	  = 0;
-	rendererBytes = 0;
-	zoneBlocks	  = 0;
 	for( block = mainzone->blocklist.next;; block = block->next )
 	{
 		if( Cmd_Argc() != 1 )
 		{
 			Com_Printf( "block:%p    size:%7i    tag:%3i\n", block, block->size, block->tag );
 		}
-		if( block->tag )
-		{
-			zoneBytes += block->size;
-			zoneBlocks++;
-			if( block->tag == TAG_BOTLIB )
-			{
-				botlibBytes += block->size;
-			}
-			else if( block->tag == TAG_RENDERER )
-			{
-				rendererBytes += block->size;
-			}
-		}
 
 		if( block->next == &mainzone->blocklist )
 		{
@@ -1449,21 +1928,22 @@ void				Com_Meminfo_f()
 		}
 	}
 
-	smallZoneBytes	= 0;
-	smallZoneBlocks = 0;
-	for( block = smallzone->blocklist.next;; block = block->next )
+	// slab chunks don't show up in the block list, so use the per tag counters
+	zoneBytes  = 0;
+	zoneBlocks = 0;
+	for( i = TAG_GENERAL; i < TAG_COUNT; i++ )
 	{
-		if( block->tag )
+		if( i == TAG_SMALL || i == TAG_SLAB )
 		{
-			smallZoneBytes += block->size;
-			smallZoneBlocks++;
-		}
-
-		if( block->next == &smallzone->blocklist )
-		{
-			break; // all blocks have been hit
+			continue;
 		}
+		zoneBytes += zoneTagStats[i]->bytes;
+		zoneBlocks += zoneTagStats[i]->allocs - zoneTagStats[i]->frees;
 	}
+	botlibBytes		= zoneTagStats[TAG_BOTLIB]->bytes;
+	rendererBytes	= zoneTagStats[TAG_RENDERER]->bytes;
+	smallZoneBytes	= zoneTagStats[TAG_SMALL]->bytes;
+	smallZoneBlocks = zoneTagStats[TAG_SMALL]->allocs - zoneTagStats[TAG_SMALL]->frees;
 
 	Com_Printf( "%8i bytes total hunk\n", s_hunkTotal );
 	Com_Printf( "%8i bytes total zone\n", s_zoneTotal );
@@ -1500,7 +1980,10 @@ void				Com_Meminfo_f()
 	Com_Printf( "        %8i bytes in dynamic botlib\n", botlibBytes );
 	Com_Printf( "        %8i bytes in dynamic renderer\n", rendererBytes );
 	Com_Printf( "        %8i bytes in dynamic other\n", zoneBytes - ( botlibBytes + rendererBytes ) );
-	Com_Printf( "        %8i bytes in small Zone memory\n", smallZoneBytes );
+	Com_Printf( "        %8i bytes in small Zone memory (%i blocks)\n", smallZoneBytes, smallZoneBlocks );
+	Com_Printf( "\n" );
+	Z_PrintZoneStats( mainzone, "main" );
+	Z_PrintZoneStats( smallzone, "small" );
 }
 
 /*
@@ -1567,6 +2050,14 @@ Com_InitZoneMemory
 */
 void Com_InitSmallZoneMemory()
 {
+	// the small zone comes first, register the zone stats before anything allocates
+	zoneTagStats[TAG_GENERAL]  = Com_RegisterMemStat( "zone general", 0 );
+	zoneTagStats[TAG_BOTLIB]   = Com_RegisterMemStat( "zone botlib", 0 );
+	zoneTagStats[TAG_RENDERER] = Com_RegisterMemStat( "zone renderer", 0 );
+	zoneTagStats[TAG_SMALL]	   = Com_RegisterMemStat( "zone small", 0 );
+	zoneTagStats[TAG_STATIC]   = Com_RegisterMemStat( "zone static", 0 );
+	zoneTagStats[TAG_SLAB]	   = Com_RegisterMemStat( "zone slabs", 0 );
+
 	s_smallZoneTotal = 512 * 1024;
 	// bk001205 - was malloc
 	smallzone = calloc( s_smallZoneTotal, 1 );
@@ -1747,6 +2238,10 @@ void Com_InitHunkMemory()
 	}
 	// cacheline align
 	s_hunkData = ( byte* )( ( ( intptr_t )s_hunkData + 31 ) & ~31 );
+
+	hunkOtherStat = hunkLabelStat = Com_RegisterMemStat( "hunk other", MEMSTAT_HUNK );
+	hunkTempStat				  = Com_RegisterMemStat( "hunk temp", 0 );
+
 	Hunk_Clear();
 
 	Cmd_AddCommand( "meminfo", Com_Meminfo_f );
@@ -1785,6 +2280,25 @@ void Hunk_SetMark()
 {
 	hunk_low.mark  = hunk_low.permanent;
 	hunk_high.mark = hunk_high.permanent;
+	Com_MemStatsMark();
+}
+
+/*
+=================
+Hunk_SetLabel
+
+Charges following Hunk_Alloc calls to the "hunk <label>" stat,
+NULL goes back to "hunk other"
+=================
+*/
+void Hunk_SetLabel( const char* label )
+{
+	if( !label )
+	{
+		hunkLabelStat = hunkOtherStat;
+		return;
+	}
+	hunkLabelStat = Com_RegisterMemStat( va( "hunk %s", label ), MEMSTAT_HUNK );
 }
 
 /*
@@ -1798,6 +2312,8 @@ void Hunk_ClearToMark()
 {
 	hunk_low.permanent = hunk_low.temp = hunk_low.mark;
 	hunk_high.permanent = hunk_high.temp = hunk_high.mark;
+	Com_MemStatsClearToMark( qfalse );
+	Com_MemStatSet( hunkTempStat, 0 );
 }
 
 /*
@@ -1848,6 +2364,9 @@ void Hunk_Clear()
 	hunk_permanent = &hunk_low;
 	hunk_temp	   = &hunk_high;
 
+	Com_MemStatsClearToMark( qtrue );
+	Com_MemStatSet( hunkTempStat, 0 );
+
 	Com_Printf( "Hunk_Clear: reset the hunk ok\n" );
 	VM_Clear();
 #ifdef HUNK_DEBUG
@@ -1945,6 +2464,8 @@ void* Hunk_Alloc( int size, ha_pref preference )
 
 	hunk_permanent->temp = hunk_permanent->permanent;
 
+	Com_MemStatAlloc( hunkLabelStat, size );
+
 	Com_Memset( buf, 0, size );
 
 #ifdef HUNK_DEBUG
@@ -2011,6 +2532,7 @@ void* Hunk_AllocateTempMemory( int size )
 	{
 		hunk_temp->tempHighwater = hunk_temp->temp;
 	}
+	Com_MemStatSet( hunkTempStat, hunk_temp->temp - hunk_temp->permanent );
 
 	hdr = ( hunkHeader_t* )buf;
 	buf = ( void* )( hdr + 1 );
@@ -2073,6 +2595,7 @@ void Hunk_FreeTempMemory( void* buf )
 			Com_Printf( "Hunk_FreeTempMemory: not the final block\n" );
 		}
 	}
+	Com_MemStatSet( hunkTempStat, hunk_temp->temp - hunk_temp->permanent );
 }
 
 /*
@@ -2089,6 +2612,7 @@ void Hunk_ClearTempMemory()
 	if( s_hunkData != NULL )
 	{
 		hunk_temp->temp = hunk_temp->permanent;
+		Com_MemStatSet( hunkTempStat, 0 );
 	}
 }
 
@@ -2160,42 +2684,6 @@ static int		  com_pushedEventsTail = 0;
 // bk001129 - static
 static sysEvent_t com_pushedEvents[MAX_PUSHED_EVENTS];
 
-/*
-=================
-Com_InitJournaling
-=================
-*/
-void			  Com_InitJournaling()
-{
-	Com_StartupVariable( "journal" );
-	com_journal = Cvar_Get( "journal", "0", CVAR_INIT );
-	if( !com_journal->integer )
-	{
-		return;
-	}
-
-	if( com_journal->integer == 1 )
-	{
-		Com_Printf( "Journaling events\n" );
-		com_journalFile		= FS_FOpenFileWrite( "journal.dat" );
-		com_journalDataFile = FS_FOpenFileWrite( "journaldata.dat" );
-	}
-	else if( com_journal->integer == 2 )
-	{
-		Com_Printf( "Replaying journaled events\n" );
-		FS_FOpenFileRead( "journal.dat", &com_journalFile, qtrue );
-		FS_FOpenFileRead( "journaldata.dat", &com_journalDataFile, qtrue );
-	}
-
-	if( !com_journalFile || !com_journalDataFile )
-	{
-		Cvar_Set( "com_journal", "0" );
-		com_journalFile		= 0;
-		com_journalDataFile = 0;
-		Com_Printf( "Couldn't open journal files\n" );
-	}
-}
-
 /*
 =================
 Com_GetRealEvent
@@ -2203,26 +2691,12 @@ Com_GetRealEvent
 */
 sysEvent_t Com_GetRealEvent()
 {
-	int		   r;
 	sysEvent_t ev;
 
 	// either get an event from the system or the journal file
-	if( com_journal->integer == 2 )
+	if( com_journal->integer >= 2 )
 	{
-		r = FS_Read( &ev, sizeof( ev ), com_journalFile );
-		if( r != sizeof( ev ) )
-		{
-			Com_Error( ERR_FATAL, "Error reading from journal file" );
-		}
-		if( ev.evPtrLength )
-		{
-			ev.evPtr = Z_Malloc( ev.evPtrLength );
-			r		 = FS_Read( ev.evPtr, ev.evPtrLength, com_journalFile );
-			if( r != ev.evPtrLength )
-			{
-				Com_Error( ERR_FATAL, "Error reading from journal file" );
-			}
-		}
+		Com_JournalReadEvent( &ev );
 	}
 	else
 	{
@@ -2231,19 +2705,7 @@ sysEvent_t Com_GetRealEvent()
 		// write the journal value out if needed
 		if( com_journal->integer == 1 )
 		{
-			r = FS_Write( &ev, sizeof( ev ), com_journalFile );
-			if( r != sizeof( ev ) )
-			{
-				Com_Error( ERR_FATAL, "Error writing to journal file" );
-			}
-			if( ev.evPtrLength )
-			{
-				r = FS_Write( ev.evPtr, ev.evPtrLength, com_journalFile );
-				if( r != ev.evPtrLength )
-				{
-					Com_Error( ERR_FATAL, "Error writing to journal file" );
-				}
-			}
+			Com_JournalWriteEvent( &ev );
 		}
 	}
 
@@ -2325,7 +2787,8 @@ Com_RunAndTimeServerPacket
 */
 void Com_RunAndTimeServerPacket( netadr_t* evFrom, msg_t* buf )
 {
-	int t1, t2, msec;
+	int		  t1, t2, msec;
+	long long start;
 
 	t1 = 0;
 
@@ -2334,8 +2797,15 @@ void Com_RunAndTimeServerPacket( netadr_t* evFrom, msg_t* buf )
 		t1 = Sys_Milliseconds();
 	}
 
+	start = Sys_Nanoseconds();
+
 	SV_PacketEvent( *evFrom, buf );
 
+	if( com_journal->integer == 3 )
+	{
+		Com_ReplayPacketTime( Sys_Nanoseconds() - start );
+	}
+
 	if( com_speeds->integer )
 	{
 		t2	 = Sys_Milliseconds();
@@ -2683,6 +3153,7 @@ void Com_Init( char* commandLine )
 	{
 		Sys_Error( "Error during initialization" );
 	}
+	Com_NoUnwind( abortframe );
 
 	// bk001129 - do this before anything else decides to push events
 	Com_InitPushEvent();
@@ -2737,6 +3208,14 @@ void Com_Init( char* commandLine )
 	// allocate the stack based hunk allocator
 	Com_InitHunkMemory();
 
+	// per thread scratch memory
+	Com_InitFrameArenas();
+
+	Com_InitMemStats();
+	Com_InitProfiler();
+	Com_InitJobs();
+	Com_InitLogSink();
+
 	// if any archived cvars are modified after this, we will trigger a writing
 	// of the config file
 	cvar_modifiedFlags &= ~CVAR_ARCHIVE;
@@ -3002,6 +3481,14 @@ void Com_Frame()
 	{
 		return; // an ERR_DROP was thrown
 	}
+	Com_NoUnwind( abortframe );
+
+	// everything Frame_Alloc'ed last frame is released now
+	Com_AdvanceFrameArenas();
+
+	// starts, feeds or finishes a profile_capture
+	Com_ProfileFrame();
+	PROFILE_BEGIN( "Com_Frame" );
 
 	// bk001204 - init to zero.
 	//  also:  might be clobbered by `longjmp' or `vfork'
@@ -3061,6 +3548,12 @@ void Com_Frame()
 	com_frameMsec = msec;
 	msec		  = Com_ModifyMsec( msec );
 
+	// frame markers keep a journal replay in step with its recording
+	if( com_journal->integer )
+	{
+		msec = Com_JournalFrame( com_frameTime, msec );
+	}
+
 	//
 	// server side
 	//
@@ -3156,9 +3649,14 @@ void Com_Frame()
 		c_pointcontents = 0;
 	}
 
+	// periodic memory stats sink
+	Com_MemStatsFrame();
+
 	// old net chan encryption key
 	key = lastTime * 0x87243987;
 
+	PROFILE_END();
+
 	com_frameNumber++;
 }
 
@@ -3169,17 +3667,20 @@ Com_Shutdown
 */
 void Com_Shutdown()
 {
+	Com_ShutdownLogSink();
+
 	if( logfile )
 	{
 		FS_FCloseFile( logfile );
 		logfile = 0;
 	}
 
-	if( com_journalFile )
-	{
-		FS_FCloseFile( com_journalFile );
-		com_journalFile = 0;
-	}
+	Com_JournalClose();
+
+	Com_ShutdownJobs();
+	Com_ShutdownProfiler();
+	Com_ShutdownMemStats();
+	Com_ShutdownFrameArenas();
 }
 
 void Com_Memcpy( void* dest, const void* src, const size_t count )
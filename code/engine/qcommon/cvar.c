@@ -27,15 +27,17 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 cvar_t* cvar_vars;
 cvar_t* cvar_cheats;
 int		cvar_modifiedFlags;
+int		cvar_modificationCount; // bumped whenever a cvar is created or its value or flags change
 
 #define MAX_CVARS 1024
 cvar_t cvar_indexes[MAX_CVARS];
 int	   cvar_numIndexes;
 
-#define FILE_HASH_SIZE 256
-static cvar_t* hashTable[FILE_HASH_SIZE];
+#define CVAR_HASH_SIZE 2048
+static cvar_t* hashTable[CVAR_HASH_SIZE];
 
 cvar_t*		   Cvar_Set2( const char* var_name, const char* value, qboolean force );
+static void	   Cvar_SetVar( cvar_t* var, const char* value, qboolean force );
 
 /*
 ================
@@ -56,7 +58,8 @@ static long	   generateHashValue( const char* fname )
 		hash += ( long )( letter ) * ( i + 119 );
 		i++;
 	}
-	hash &= ( FILE_HASH_SIZE - 1 );
+	hash = ( hash ^ ( hash >> 10 ) ^ ( hash >> 20 ) );
+	hash &= ( CVAR_HASH_SIZE - 1 );
 	return hash;
 }
 
@@ -243,6 +246,11 @@ cvar_t* Cvar_Get( const char* var_name, const char* var_value, int flags )
 			cvar_modifiedFlags |= flags;
 		}
 
+		// new flags change what the flag based caches see, see cvar_modificationCount
+		if( ( var->flags | flags ) != var->flags )
+		{
+			cvar_modificationCount++;
+		}
 		var->flags |= flags;
 		// only allow one non-empty reset string without a warning
 		if( !var->resetString[0] )
@@ -304,6 +312,8 @@ cvar_t* Cvar_Get( const char* var_name, const char* var_value, int flags )
 	var->hashNext	= hashTable[hash];
 	hashTable[hash] = var;
 
+	cvar_modificationCount++;
+
 	return var;
 }
 
@@ -350,6 +360,19 @@ cvar_t* Cvar_Set2( const char* var_name, const char* value, qboolean force )
 		}
 	}
 
+	Cvar_SetVar( var, value, force );
+	return var;
+}
+
+/*
+============
+Cvar_SetVar
+
+Cvar_Set2 for a variable that has already been looked up
+============
+*/
+static void Cvar_SetVar( cvar_t* var, const char* value, qboolean force )
+{
 	if( !value )
 	{
 		value = var->resetString;
@@ -357,7 +380,7 @@ cvar_t* Cvar_Set2( const char* var_name, const char* value, qboolean force )
 
 	if( !strcmp( value, var->string ) )
 	{
-		return var;
+		return;
 	}
 	// note what types of cvars have been modified (userinfo, archive, serverinfo, systeminfo)
 	cvar_modifiedFlags |= var->flags;
@@ -366,14 +389,14 @@ cvar_t* Cvar_Set2( const char* var_name, const char* value, qboolean force )
 	{
 		if( var->flags & CVAR_ROM )
 		{
-			Com_Printf( "%s is read only.\n", var_name );
-			return var;
+			Com_Printf( "%s is read only.\n", var->name );
+			return;
 		}
 
 		if( var->flags & CVAR_INIT )
 		{
-			Com_Printf( "%s is write protected.\n", var_name );
-			return var;
+			Com_Printf( "%s is write protected.\n", var->name );
+			return;
 		}
 
 		if( var->flags & CVAR_LATCH )
@@ -382,7 +405,7 @@ cvar_t* Cvar_Set2( const char* var_name, const char* value, qboolean force )
 			{
 				if( strcmp( value, var->latchedString ) == 0 )
 				{
-					return var;
+					return;
 				}
 				Z_Free( var->latchedString );
 			}
@@ -390,21 +413,22 @@ cvar_t* Cvar_Set2( const char* var_name, const char* value, qboolean force )
 			{
 				if( strcmp( value, var->string ) == 0 )
 				{
-					return var;
+					return;
 				}
 			}
 
-			Com_Printf( "%s will be changed upon restarting.\n", var_name );
+			Com_Printf( "%s will be changed upon restarting.\n", var->name );
 			var->latchedString = CopyString( value );
 			var->modified	   = qtrue;
 			var->modificationCount++;
-			return var;
+			cvar_modificationCount++;
+			return;
 		}
 
 		if( ( var->flags & CVAR_CHEAT ) && !cvar_cheats->integer )
 		{
-			Com_Printf( "%s is cheat protected.\n", var_name );
-			return var;
+			Com_Printf( "%s is cheat protected.\n", var->name );
+			return;
 		}
 	}
 	else
@@ -418,19 +442,18 @@ cvar_t* Cvar_Set2( const char* var_name, const char* value, qboolean force )
 
 	if( !strcmp( value, var->string ) )
 	{
-		return var; // not changed
+		return; // not changed
 	}
 
 	var->modified = qtrue;
 	var->modificationCount++;
+	cvar_modificationCount++;
 
 	Z_Free( var->string ); // free the old value string
 
 	var->string	 = CopyString( value );
 	var->value	 = atof( var->string );
 	var->integer = atoi( var->string );
-
-	return var;
 }
 
 /*
@@ -632,6 +655,10 @@ void Cvar_SetU_f()
 	{
 		return;
 	}
+	if( !( v->flags & CVAR_USERINFO ) )
+	{
+		cvar_modificationCount++;
+	}
 	v->flags |= CVAR_USERINFO;
 }
 
@@ -657,6 +684,10 @@ void Cvar_SetS_f()
 	{
 		return;
 	}
+	if( !( v->flags & CVAR_SERVERINFO ) )
+	{
+		cvar_modificationCount++;
+	}
 	v->flags |= CVAR_SERVERINFO;
 }
 
@@ -682,6 +713,10 @@ void Cvar_SetA_f()
 	{
 		return;
 	}
+	if( !( v->flags & CVAR_ARCHIVE ) )
+	{
+		cvar_modificationCount++;
+	}
 	v->flags |= CVAR_ARCHIVE;
 }
 
@@ -879,6 +914,8 @@ void Cvar_Restart_f()
 			// clear the var completely, since we
 			// can't remove the index from the list
 			Com_Memset( var, 0, sizeof( var ) );
+			// the flag based caches must not keep serving it
+			cvar_modificationCount++;
 			continue;
 		}
 
@@ -1009,6 +1046,59 @@ void Cvar_Update( vmCvar_t* vmCvar )
 	vmCvar->integer = cv->integer;
 }
 
+/*
+=====================
+Cvar_FindHandle
+
+Looks a variable up once so it can be read and written without
+hashing its name again, -1 if it doesn't exist
+=====================
+*/
+cvarHandle_t Cvar_FindHandle( const char* var_name )
+{
+	cvar_t* var;
+
+	var = Cvar_FindVar( var_name );
+	if( !var )
+	{
+		return -1;
+	}
+	return var - cvar_indexes;
+}
+
+/*
+=====================
+Cvar_FromHandle
+=====================
+*/
+cvar_t* Cvar_FromHandle( cvarHandle_t handle )
+{
+	if( ( unsigned )handle >= cvar_numIndexes )
+	{
+		Com_Error( ERR_DROP, "Cvar_FromHandle: handle out of range" );
+	}
+	return cvar_indexes + handle;
+}
+
+/*
+=====================
+Cvar_SetHandle
+
+Cvar_Set without the name lookup
+=====================
+*/
+void Cvar_SetHandle( cvarHandle_t handle, const char* value )
+{
+	cvar_t* var;
+
+	var = Cvar_FromHandle( handle );
+	if( !var->name )
+	{
+		return; // cleared by a cvar_restart
+	}
+	Cvar_SetVar( var, value, qtrue );
+}
+
 /*
 ============
 Cvar_Init
@@ -233,6 +233,11 @@ typedef struct
 	int			   hashSize;				// hash table size (power of 2)
 	fileInPack_t** hashTable;				// hash table
 	fileInPack_t*  buildBuffer;				// buffer with the filenames etc.
+	int*		   headerLongs;				// crcs of the non empty files, kept to re-mix pure_checksum
+	int			   numHeaderLongs;
+	int			   pakSize;					// file size and mtime for the checksum cache, -1 if unknown
+	int			   pakTime;
+	qboolean	   checksumValid;			// checksum is known, only pure_checksum needs the feed
 } pack_t;
 
 typedef struct
@@ -244,6 +249,7 @@ typedef struct
 typedef struct searchpath_s
 {
 	struct searchpath_s* next;
+	int					 order; // load order, to undo FS_ReorderPurePaks
 
 	pack_t*				 pack; // only one of pack / dir will be non NULL
 	directory_t*		 dir;
@@ -266,6 +272,7 @@ static int			 fs_packFiles; // total number of files in packs
 
 static int			 fs_fakeChkSum;
 static int			 fs_checksumFeed;
+static int			 fs_searchOrder;
 
 typedef union qfile_gus
 {
@@ -1037,6 +1044,9 @@ void FS_FCloseFile( fileHandle_t f )
 		Com_Error( ERR_FATAL, "Filesystem call made without initialization\n" );
 	}
 
+	// anything still queued for it has to be written first
+	Com_LogFlushFile( f );
+
 	if( fsh[f].streamed )
 	{
 		Sys_EndStreamedFile( f );
@@ -1844,7 +1854,7 @@ int FS_ReadFile( const char* qpath, void** buffer )
 	if( strstr( qpath, ".cfg" ) )
 	{
 		isConfig = qtrue;
-		if( com_journal && com_journal->integer == 2 )
+		if( com_journal && com_journal->integer >= 2 )
 		{
 			int r;
 
@@ -1976,6 +1986,145 @@ void FS_FreeFile( void* buffer )
 	}
 }
 
+#define MAX_MAPPED_FILES 16
+
+typedef struct
+{
+	void*	 buffer;
+	int		 length;
+	qboolean mapped; // from Sys_MapFile, else a zone copy
+} mappedFile_t;
+
+static mappedFile_t fs_mappedFiles[MAX_MAPPED_FILES];
+
+/*
+=============
+FS_MapFile
+
+Maps the file if the first place it is found in is a directory, a file in
+a pk3 or one that can't be mapped is read into the zone instead
+=============
+*/
+int FS_MapFile( const char* qpath, void** buffer )
+{
+	searchpath_t* search;
+	fileInPack_t* pakFile;
+	mappedFile_t* slot;
+	fileHandle_t  f;
+	void*		  data;
+	int			  len, i;
+
+	if( !fs_searchpaths )
+	{
+		Com_Error( ERR_FATAL, "Filesystem call made without initialization\n" );
+	}
+	*buffer = NULL;
+
+	for( i = 0, slot = fs_mappedFiles; i < MAX_MAPPED_FILES; i++, slot++ )
+	{
+		if( !slot->buffer )
+		{
+			break;
+		}
+	}
+	if( i == MAX_MAPPED_FILES )
+	{
+		Com_Printf( "FS_MapFile: too many mapped files\n" );
+		return -1;
+	}
+
+	// FS_FOpenFileRead doesn't read these from directories either
+	data = NULL;
+	if( !fs_restrict->integer && !fs_numServerPaks && !strstr( qpath, ".." ) && !strstr( qpath, "::" ) )
+	{
+		for( search = fs_searchpaths; search; search = search->next )
+		{
+			if( search->pack )
+			{
+				if( !FS_PakIsPure( search->pack ) )
+				{
+					continue;
+				}
+				for( pakFile = search->pack->hashTable[FS_HashFileName( qpath, search->pack->hashSize )]; pakFile; pakFile = pakFile->next )
+				{
+					if( !FS_FilenameCompare( pakFile->name, qpath ) )
+					{
+						break;
+					}
+				}
+				if( pakFile )
+				{
+					break;
+				}
+			}
+			else if( search->dir )
+			{
+				data = Sys_MapFile( FS_BuildOSPath( search->dir->path, search->dir->gamedir, qpath ), &len );
+				if( data )
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	slot->mapped = ( data != NULL );
+	if( !data )
+	{
+		len = FS_FOpenFileRead( qpath, &f, qfalse );
+		if( len < 0 || !f )
+		{
+			return -1;
+		}
+		data = Z_Malloc( len + 1 );
+		FS_Read( data, len, f );
+		FS_FCloseFile( f );
+	}
+
+	if( fs_debug->integer )
+	{
+		Com_Printf( "FS_MapFile: %s (%s)\n", qpath, slot->mapped ? "mapped" : "copied" );
+	}
+
+	slot->buffer = data;
+	slot->length = len;
+	*buffer		 = data;
+	return len;
+}
+
+/*
+=============
+FS_UnmapFile
+=============
+*/
+void FS_UnmapFile( void* buffer )
+{
+	mappedFile_t* slot;
+	int			  i;
+
+	for( i = 0, slot = fs_mappedFiles; i < MAX_MAPPED_FILES; i++, slot++ )
+	{
+		if( slot->buffer == buffer )
+		{
+			break;
+		}
+	}
+	if( !buffer || i == MAX_MAPPED_FILES )
+	{
+		Com_Error( ERR_FATAL, "FS_UnmapFile: buffer wasn't returned by FS_MapFile" );
+	}
+
+	if( slot->mapped )
+	{
+		Sys_UnmapFile( slot->buffer, slot->length );
+	}
+	else
+	{
+		Z_Free( slot->buffer );
+	}
+	Com_Memset( slot, 0, sizeof( *slot ) );
+}
+
 /*
 ============
 FS_WriteFile
@@ -2017,6 +2166,385 @@ ZIP FILE LOADING
 ==========================================================================
 */
 
+/*
+=================================================================================
+
+PAK CHECKSUM CACHE
+
+The checksum of a pk3 is a MD4 over the crcs of its files, the pure checksum
+the same with the server's checksum feed mixed in. The crc vector of every
+loaded pak stays in memory so a new feed only needs the keyed pass again, and
+both the vector and the plain checksum are kept in a sidecar file keyed by
+size and mtime so a pak that didn't change is never checksummed twice.
+
+Whatever has to be computed is spread over a few threads, one pak at a time.
+
+=================================================================================
+*/
+
+#define PAKCACHE_FILE		 "pakchecksums.dat"
+#define PAKCACHE_IDENT		 ( ( 'C' << 24 ) + ( 'K' << 16 ) + ( 'A' << 8 ) + 'P' )
+#define PAKCACHE_VERSION	 1
+#define MAX_CHECKSUM_THREADS 16
+
+typedef struct
+{
+	char*	 path;
+	int		 size;
+	int		 time;
+	int		 checksum;
+	int		 numLongs;
+	int*	 longs;
+	qboolean used; // matched a loaded pak, which will be written instead
+} pakCacheEntry_t;
+
+typedef struct
+{
+	pack_t**	 packs;
+	int			 numPacks;
+	volatile int next;
+} pakChecksumWork_t;
+
+static pakCacheEntry_t* fs_pakCache;
+static int				fs_numPakCache;
+static byte*			fs_pakCacheData;
+static qboolean			fs_pakCacheDirty;
+
+/*
+=================
+FS_LoadPakChecksumCache
+=================
+*/
+static void FS_LoadPakChecksumCache()
+{
+	pakCacheEntry_t* e;
+	FILE*			 f;
+	byte *			 p, *end;
+	int				 len, count, pathLen;
+
+	fs_pakCacheDirty = qfalse;
+
+	f = fopen( FS_BuildOSPath( fs_homepath->string, BASEGAME, PAKCACHE_FILE ), "rb" );
+	if( !f )
+	{
+		fs_pakCacheDirty = qtrue;
+		return;
+	}
+
+	fseek( f, 0, SEEK_END );
+	len = ftell( f );
+	fseek( f, 0, SEEK_SET );
+
+	if( len < 12 )
+	{
+		fclose( f );
+		fs_pakCacheDirty = qtrue;
+		return;
+	}
+
+	fs_pakCacheData = Z_Malloc( len );
+	if( fread( fs_pakCacheData, 1, len, f ) != len )
+	{
+		len = 0;
+	}
+	fclose( f );
+
+	p	  = fs_pakCacheData;
+	end	  = p + len;
+	count = len ? LittleLong( ( ( int* )p )[2] ) : 0;
+	if( !len || LittleLong( ( ( int* )p )[0] ) != PAKCACHE_IDENT || LittleLong( ( ( int* )p )[1] ) != PAKCACHE_VERSION || count < 0 || count > len / 20 )
+	{
+		Com_DPrintf( "ignoring bad %s\n", PAKCACHE_FILE );
+		Z_Free( fs_pakCacheData );
+		fs_pakCacheData	 = NULL;
+		fs_pakCacheDirty = qtrue;
+		return;
+	}
+	p += 12;
+
+	fs_pakCache = Z_Malloc( count * sizeof( *fs_pakCache ) + 1 );
+	for( fs_numPakCache = 0; fs_numPakCache < count; fs_numPakCache++ )
+	{
+		if( end - p < 20 )
+		{
+			break;
+		}
+		e			= &fs_pakCache[fs_numPakCache];
+		pathLen		= LittleLong( ( ( int* )p )[0] );
+		e->size		= LittleLong( ( ( int* )p )[1] );
+		e->time		= LittleLong( ( ( int* )p )[2] );
+		e->checksum = LittleLong( ( ( int* )p )[3] );
+		e->numLongs = LittleLong( ( ( int* )p )[4] );
+		p += 20;
+
+		// the crcs are stored the way they are hashed, no swapping
+		if( pathLen <= 0 || pathLen > MAX_OSPATH || e->numLongs < 0 || ( end - p ) / 4 < e->numLongs + ( pathLen + 3 ) / 4 )
+		{
+			break;
+		}
+		e->path			   = ( char* )p;
+		e->path[pathLen - 1] = 0;
+		p += ( pathLen + 3 ) & ~3;
+		e->longs = ( int* )p;
+		p += e->numLongs * 4;
+	}
+
+	if( fs_numPakCache != count )
+	{
+		fs_pakCacheDirty = qtrue;
+	}
+}
+
+/*
+=================
+FS_LookupPakChecksum
+
+Fills in the checksum if the cache knows this exact pak
+=================
+*/
+static qboolean FS_LookupPakChecksum( pack_t* pack )
+{
+	pakCacheEntry_t* e;
+	int				 i;
+
+	if( pack->pakSize < 0 )
+	{
+		return qfalse;
+	}
+
+	for( i = 0, e = fs_pakCache; i < fs_numPakCache; i++, e++ )
+	{
+		if( Q_stricmp( e->path, pack->pakFilename ) )
+		{
+			continue;
+		}
+		e->used = qtrue;
+
+		// the crc vector was read from the zip directory anyway,
+		// comparing it is far cheaper than hashing it
+		if( e->size == pack->pakSize && e->time == pack->pakTime && e->numLongs == pack->numHeaderLongs &&
+			!memcmp( e->longs, pack->headerLongs, 4 * e->numLongs ) )
+		{
+			pack->checksum = e->checksum;
+			return qtrue;
+		}
+		break;
+	}
+
+	fs_pakCacheDirty = qtrue;
+	return qfalse;
+}
+
+/*
+=================
+FS_WritePakCacheEntry
+=================
+*/
+static void FS_WritePakCacheEntry( FILE* f, const char* path, int size, int time, int checksum, int numLongs, const int* longs )
+{
+	static const byte pad[4] = { 0, 0, 0, 0 };
+	int				  header[5];
+	int				  pathLen;
+
+	pathLen	  = strlen( path ) + 1;
+	header[0] = LittleLong( pathLen );
+	header[1] = LittleLong( size );
+	header[2] = LittleLong( time );
+	header[3] = LittleLong( checksum );
+	header[4] = LittleLong( numLongs );
+
+	fwrite( header, sizeof( header ), 1, f );
+	fwrite( path, pathLen, 1, f );
+	fwrite( pad, ( ( pathLen + 3 ) & ~3 ) - pathLen, 1, f );
+	fwrite( longs, 4, numLongs, f );
+}
+
+/*
+=================
+FS_WritePakChecksumCache
+
+Writes the loaded paks plus every older entry whose pak still exists,
+then drops the in memory copy
+=================
+*/
+static void FS_WritePakChecksumCache()
+{
+	searchpath_t*	 sp;
+	pakCacheEntry_t* e;
+	FILE*			 f;
+	char*			 ospath;
+	int				 header[3];
+	int				 i, count, size, time;
+
+	if( fs_pakCacheDirty )
+	{
+		ospath = FS_BuildOSPath( fs_homepath->string, BASEGAME, PAKCACHE_FILE );
+		FS_CreatePath( ospath );
+
+		f = fopen( ospath, "wb" );
+		if( f )
+		{
+			count = 0;
+			fwrite( header, sizeof( header ), 1, f );
+
+			for( sp = fs_searchpaths; sp; sp = sp->next )
+			{
+				if( sp->pack && sp->pack->pakSize >= 0 )
+				{
+					FS_WritePakCacheEntry( f,
+						sp->pack->pakFilename,
+						sp->pack->pakSize,
+						sp->pack->pakTime,
+						sp->pack->checksum,
+						sp->pack->numHeaderLongs,
+						sp->pack->headerLongs );
+					count++;
+				}
+			}
+
+			// keep paks of other mods around
+			for( i = 0, e = fs_pakCache; i < fs_numPakCache; i++, e++ )
+			{
+				if( !e->used && Sys_StatFile( e->path, &size, &time ) && size == e->size && time == e->time )
+				{
+					FS_WritePakCacheEntry( f, e->path, e->size, e->time, e->checksum, e->numLongs, e->longs );
+					count++;
+				}
+			}
+
+			header[0] = LittleLong( PAKCACHE_IDENT );
+			header[1] = LittleLong( PAKCACHE_VERSION );
+			header[2] = LittleLong( count );
+			fseek( f, 0, SEEK_SET );
+			fwrite( header, sizeof( header ), 1, f );
+			fclose( f );
+		}
+		else
+		{
+			Com_DPrintf( "couldn't write %s\n", ospath );
+		}
+	}
+
+	if( fs_pakCache )
+	{
+		Z_Free( fs_pakCache );
+		fs_pakCache = NULL;
+	}
+	if( fs_pakCacheData )
+	{
+		Z_Free( fs_pakCacheData );
+		fs_pakCacheData = NULL;
+	}
+	fs_numPakCache	 = 0;
+	fs_pakCacheDirty = qfalse;
+}
+
+/*
+=================
+FS_ChecksumPakWorker
+
+Runs on the main thread and on the helper threads, MD4 only touches
+the stack so paks can be hashed side by side
+=================
+*/
+static void FS_ChecksumPakWorker( void* data )
+{
+	pakChecksumWork_t* work = data;
+	pack_t*			   pack;
+	int				   i;
+
+	while( ( i = Com_AtomicAdd( &work->next, 1 ) - 1 ) < work->numPacks )
+	{
+		pack = work->packs[i];
+		if( !pack->checksumValid )
+		{
+			pack->checksum = LittleLong( Com_BlockChecksum( pack->headerLongs, 4 * pack->numHeaderLongs ) );
+		}
+		pack->pure_checksum = LittleLong( Com_BlockChecksumKey( pack->headerLongs, 4 * pack->numHeaderLongs, LittleLong( fs_checksumFeed ) ) );
+	}
+}
+
+/*
+=================
+FS_ChecksumPaks
+
+Computes every missing checksum and the pure checksums for the current feed
+=================
+*/
+static void FS_ChecksumPaks()
+{
+	pakChecksumWork_t work;
+	searchpath_t*	  sp;
+	void*			  threads[MAX_CHECKSUM_THREADS];
+	int				  i, numThreads, numHashed, numLongs;
+
+	work.numPacks = 0;
+	for( sp = fs_searchpaths; sp; sp = sp->next )
+	{
+		if( sp->pack )
+		{
+			work.numPacks++;
+		}
+	}
+	if( !work.numPacks )
+	{
+		return;
+	}
+
+	work.packs = Z_Malloc( work.numPacks * sizeof( pack_t* ) );
+	work.next  = 0;
+
+	numHashed = 0;
+	numLongs  = 0;
+	for( i = 0, sp = fs_searchpaths; sp; sp = sp->next )
+	{
+		if( sp->pack )
+		{
+			work.packs[i++] = sp->pack;
+			numHashed += !sp->pack->checksumValid;
+			numLongs += sp->pack->numHeaderLongs;
+		}
+	}
+
+	// a thread is not worth it for a handful of small paks
+	numThreads = 0;
+	if( numLongs > 16384 )
+	{
+		numThreads = Sys_ProcessorCount() - 1;
+		if( numThreads > work.numPacks - 1 )
+		{
+			numThreads = work.numPacks - 1;
+		}
+		if( numThreads > MAX_CHECKSUM_THREADS )
+		{
+			numThreads = MAX_CHECKSUM_THREADS;
+		}
+	}
+
+	for( i = 0; i < numThreads; i++ )
+	{
+		threads[i] = Sys_CreateThread( FS_ChecksumPakWorker, &work );
+		if( !threads[i] )
+		{
+			numThreads = i;
+			break;
+		}
+	}
+	FS_ChecksumPakWorker( &work );
+	for( i = 0; i < numThreads; i++ )
+	{
+		Sys_JoinThread( threads[i] );
+	}
+
+	for( i = 0; i < work.numPacks; i++ )
+	{
+		work.packs[i]->checksumValid = qtrue;
+	}
+	Z_Free( work.packs );
+
+	Com_DPrintf( "checksummed %i of %i paks on %i threads\n", numHashed, work.numPacks, numThreads + 1 );
+}
+
 /*
 =================
 FS_LoadZipFile
@@ -2124,12 +2652,14 @@ static pack_t* FS_LoadZipFile( char* zipfile, const char* basename )
 		unzGoToNextFile( uf );
 	}
 
-	pack->checksum		= Com_BlockChecksum( fs_headerLongs, 4 * fs_numHeaderLongs );
-	pack->pure_checksum = Com_BlockChecksumKey( fs_headerLongs, 4 * fs_numHeaderLongs, LittleLong( fs_checksumFeed ) );
-	pack->checksum		= LittleLong( pack->checksum );
-	pack->pure_checksum = LittleLong( pack->pure_checksum );
-
-	Z_Free( fs_headerLongs );
+	// the checksums themselves are done for all paks at once in FS_ChecksumPaks
+	pack->headerLongs	 = fs_headerLongs;
+	pack->numHeaderLongs = fs_numHeaderLongs;
+	if( !Sys_StatFile( zipfile, &pack->pakSize, &pack->pakTime ) )
+	{
+		pack->pakSize = -1;
+	}
+	pack->checksumValid = FS_LookupPakChecksum( pack );
 
 	pack->buildBuffer = buildBuffer;
 	return pack;
@@ -2951,6 +3481,7 @@ static void FS_AddGameDirectory( const char* path, const char* dir )
 
 	Q_strncpyz( search->dir->path, path, sizeof( search->dir->path ) );
 	Q_strncpyz( search->dir->gamedir, dir, sizeof( search->dir->gamedir ) );
+	search->order  = fs_searchOrder++;
 	search->next   = fs_searchpaths;
 	fs_searchpaths = search;
 
@@ -2985,6 +3516,7 @@ static void FS_AddGameDirectory( const char* path, const char* dir )
 
 		search		   = Z_Malloc( sizeof( searchpath_t ) );
 		search->pack   = pak;
+		search->order  = fs_searchOrder++;
 		search->next   = fs_searchpaths;
 		fs_searchpaths = search;
 	}
@@ -3155,6 +3687,7 @@ void FS_Shutdown( qboolean closemfp )
 		{
 			unzClose( p->pack->handle );
 			Z_Free( p->pack->buildBuffer );
+			Z_Free( p->pack->headerLongs );
 			Z_Free( p->pack );
 		}
 		if( p->dir )
@@ -3228,6 +3761,125 @@ static void FS_ReorderPurePaks()
 	}
 }
 
+/*
+================
+FS_RestoreSearchOrder
+
+Undoes FS_ReorderPurePaks
+================
+*/
+static int QDECL FS_SearchOrderCompare( const void* a, const void* b )
+{
+	// later additions come first
+	return ( *( searchpath_t** )b )->order - ( *( searchpath_t** )a )->order;
+}
+
+static void FS_RestoreSearchOrder()
+{
+	searchpath_t*  s;
+	searchpath_t** list;
+	int			   i, count;
+
+	count = 0;
+	for( s = fs_searchpaths; s; s = s->next )
+	{
+		count++;
+	}
+
+	list = Z_Malloc( count * sizeof( *list ) );
+	for( i = 0, s = fs_searchpaths; s; s = s->next )
+	{
+		list[i++] = s;
+	}
+
+	qsort( list, count, sizeof( *list ), FS_SearchOrderCompare );
+
+	for( i = 0; i < count - 1; i++ )
+	{
+		list[i]->next = list[i + 1];
+	}
+	list[count - 1]->next = NULL;
+	fs_searchpaths		  = list[0];
+
+	Z_Free( list );
+
+	fs_reordered = qfalse;
+}
+
+/*
+================
+FS_PakSetUnchanged
+
+True if a restart would load exactly the paks that are loaded now
+================
+*/
+static qboolean FS_PakSetUnchanged()
+{
+	searchpath_t *sp, *p;
+	char*		  path;
+	char**		  pakfiles;
+	int			  i, numfiles, numPacks, numListed, size, time;
+	qboolean	  found;
+
+	if( !fs_searchpaths || fs_gamedirvar->modified || fs_cdpath->modified || fs_basepath->modified || fs_homepath->modified ||
+		fs_basegame->modified )
+	{
+		return qfalse;
+	}
+
+	numPacks = 0;
+	for( sp = fs_searchpaths; sp; sp = sp->next )
+	{
+		if( sp->pack )
+		{
+			numPacks++;
+		}
+	}
+
+	// every pk3 in the game directories must be loaded with the same size and time
+	numListed = 0;
+	for( sp = fs_searchpaths; sp; sp = sp->next )
+	{
+		if( !sp->dir )
+		{
+			continue;
+		}
+
+		path					 = FS_BuildOSPath( sp->dir->path, sp->dir->gamedir, "" );
+		path[strlen( path ) - 1] = 0;
+
+		pakfiles = Sys_ListFiles( path, ".pk3", NULL, &numfiles, qfalse );
+		if( numfiles > MAX_PAKFILES )
+		{
+			numfiles = MAX_PAKFILES;
+		}
+		numListed += numfiles;
+
+		for( i = 0; i < numfiles; i++ )
+		{
+			path  = FS_BuildOSPath( sp->dir->path, sp->dir->gamedir, pakfiles[i] );
+			found = qfalse;
+			for( p = fs_searchpaths; p; p = p->next )
+			{
+				if( p->pack && !Q_stricmp( p->pack->pakFilename, path ) )
+				{
+					found = Sys_StatFile( path, &size, &time ) && size == p->pack->pakSize && time == p->pack->pakTime;
+					break;
+				}
+			}
+			if( !found )
+			{
+				Sys_FreeFileList( pakfiles );
+				return qfalse;
+			}
+		}
+
+		Sys_FreeFileList( pakfiles );
+	}
+
+	return numListed == numPacks;
+}
+
 /*
 ================
 FS_Startup
@@ -3254,6 +3906,14 @@ static void FS_Startup( const char* gameName )
 	fs_gamedirvar = Cvar_Get( "fs_game", "", CVAR_INIT | CVAR_SYSTEMINFO );
 	fs_restrict	  = Cvar_Get( "fs_restrict", "", CVAR_INIT );
 
+	// FS_Restart looks at these to see if the paks can be kept
+	fs_cdpath->modified	  = qfalse;
+	fs_basepath->modified = qfalse;
+	fs_homepath->modified = qfalse;
+	fs_basegame->modified = qfalse;
+
+	FS_LoadPakChecksumCache();
+
 	// add search path elements in reverse priority order
 	if( fs_cdpath->string[0] )
 	{
@@ -3304,6 +3964,9 @@ static void FS_Startup( const char* gameName )
 		}
 	}
 
+	FS_ChecksumPaks();
+	FS_WritePakChecksumCache();
+
 	Com_ReadCDKey( "baseq3" );
 	fs = Cvar_Get( "fs_game", "", CVAR_INIT | CVAR_SYSTEMINFO );
 	if( fs && fs->string[0] != 0 )
@@ -3791,6 +4454,22 @@ FS_Restart
 */
 void FS_Restart( int checksumFeed )
 {
+	// usually only the feed changed, then the loaded paks just need new pure checksums
+	if( FS_PakSetUnchanged() )
+	{
+		fs_checksumFeed = checksumFeed;
+
+		FS_ClearPakReferences( 0 );
+
+		if( fs_reordered )
+		{
+			FS_RestoreSearchOrder();
+		}
+		FS_ChecksumPaks();
+		FS_ReorderPurePaks();
+		return;
+	}
+
 	// free anything we currently have loaded
 	FS_Shutdown( qfalse );
 
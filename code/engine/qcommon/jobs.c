@@ -0,0 +1,662 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// jobs.c -- work stealing job system
+
+#include <q_shared.h>
+#include "qcommon.h"
+
+/*
+==============================================================================
+
+						JOB SYSTEM
+
+Every worker thread, and the main thread as worker 0, owns a deque of jobs.
+A thread pushes and pops its own jobs at the bottom, an idle thread steals
+the oldest job from the top of someone else's deque. Each deque has its own
+spin lock, which is only contended when somebody steals.
+
+Completion is tracked with a jobCounter_t: Job_Add raises it, the finished
+job lowers it, Job_Wait runs other jobs until it reaches 0. A job added with
+Job_AddAfter stays parked on the dependency counter until that counter
+reaches 0.
+
+Threads that are not workers queue on the main thread's deque.
+
+Jobs must not use anything that isn't thread safe: no zone or hunk
+allocation, no cvars and no Com_Printf. Frame_Alloc is fine. A job runs with
+the module that added it as the current VM, so a native module's job can make
+the syscalls that are safe off the main thread, such as the ones the bot think
+jobs make between SV_BotParallelFrame( qtrue ) and ( qfalse ).
+
+com_jobWorkers sets the number of extra threads, -1 picks one less than the
+number of processors, 0 runs every job in Job_Wait on the waiting thread.
+==============================================================================
+*/
+
+#define MAX_JOB_WORKERS 32 // including the main thread
+#define JOB_QUEUE_SIZE	1024
+#define MAX_JOBS		8192
+
+typedef struct job_s
+{
+	const char*	   name;
+	jobFunc_t	   func;
+	jobRangeFunc_t rangeFunc;
+	void*		   data;
+	int			   start, end;
+	jobCounter_t*  signal;
+	vm_t*		   vm;	 // current while it runs
+	struct job_s*  next; // free list or the waiters of a dependency
+} job_t;
+
+typedef struct
+{
+	volatile int lock;
+	job_t*		 jobs[JOB_QUEUE_SIZE];
+	volatile int top;	 // stolen from here
+	volatile int bottom; // pushed and popped here by the owner
+
+	void*		 thread;
+
+	volatile int executed;
+	volatile int stolen;
+	volatile int inlined; // ran on the spot because the pool or deque was full
+} jobWorker_t;
+
+static jobWorker_t			jobWorkers[MAX_JOB_WORKERS];
+static int					numJobWorkers;
+
+static job_t				jobPool[MAX_JOBS];
+static job_t*				jobFreeList;
+static volatile int			jobPoolLock;
+
+static volatile int			jobsPending; // queued and not yet taken
+static volatile int			idleWorkers;
+static volatile int			jobsShutdown;
+static void*				jobSemaphore;
+
+static Q_THREADLOCAL int	jobWorkerIndex;
+
+static cvar_t*				com_jobWorkers;
+
+/*
+=================
+Job_Lock
+=================
+*/
+static void Job_Lock( volatile int* lock )
+{
+	int spins;
+
+	spins = 0;
+	while( Com_AtomicCompareExchange( lock, 1, 0 ) != 0 )
+	{
+		if( ++spins > 64 )
+		{
+			Sys_Yield();
+			spins = 0;
+		}
+	}
+}
+
+/*
+=================
+Job_Unlock
+=================
+*/
+static void Job_Unlock( volatile int* lock )
+{
+	Com_AtomicCompareExchange( lock, 0, 1 );
+}
+
+/*
+=================
+Job_Alloc
+=================
+*/
+static job_t* Job_Alloc()
+{
+	job_t* job;
+
+	Job_Lock( &jobPoolLock );
+	job = jobFreeList;
+	if( job )
+	{
+		jobFreeList = job->next;
+	}
+	Job_Unlock( &jobPoolLock );
+
+	return job;
+}
+
+/*
+=================
+Job_Free
+=================
+*/
+static void Job_Free( job_t* job )
+{
+	Job_Lock( &jobPoolLock );
+	job->next	= jobFreeList;
+	jobFreeList = job;
+	Job_Unlock( &jobPoolLock );
+}
+
+/*
+=================
+Job_Push
+
+Returns qfalse if the calling thread's deque is full
+=================
+*/
+static qboolean Job_Push( job_t* job )
+{
+	jobWorker_t* w;
+
+	w = &jobWorkers[jobWorkerIndex];
+
+	Job_Lock( &w->lock );
+	if( w->bottom - w->top >= JOB_QUEUE_SIZE )
+	{
+		Job_Unlock( &w->lock );
+		return qfalse;
+	}
+	w->jobs[w->bottom & ( JOB_QUEUE_SIZE - 1 )] = job;
+	w->bottom++;
+	Job_Unlock( &w->lock );
+
+	// pairs with the idle check in Job_WorkerThread, both sides
+	// change their own counter before looking at the other one
+	Com_AtomicAdd( &jobsPending, 1 );
+	if( idleWorkers )
+	{
+		Sys_SemaphorePost( jobSemaphore, 1 );
+	}
+
+	return qtrue;
+}
+
+/*
+=================
+Job_Take
+
+Own jobs newest first, then steal the oldest job of another worker
+=================
+*/
+static job_t* Job_Take()
+{
+	jobWorker_t* w;
+	job_t*		 job;
+	int			 i, self;
+
+	self = jobWorkerIndex;
+	job	 = NULL;
+
+	w = &jobWorkers[self];
+	Job_Lock( &w->lock );
+	if( w->bottom != w->top )
+	{
+		w->bottom--;
+		job = w->jobs[w->bottom & ( JOB_QUEUE_SIZE - 1 )];
+	}
+	Job_Unlock( &w->lock );
+
+	for( i = 1; !job && i < numJobWorkers; i++ )
+	{
+		w = &jobWorkers[( self + i ) % numJobWorkers];
+		if( w->bottom == w->top )
+		{
+			continue; // racy peek, the lock decides
+		}
+
+		Job_Lock( &w->lock );
+		if( w->bottom != w->top )
+		{
+			job = w->jobs[w->top & ( JOB_QUEUE_SIZE - 1 )];
+			w->top++;
+		}
+		Job_Unlock( &w->lock );
+
+		if( job )
+		{
+			jobWorkers[self].stolen++;
+		}
+	}
+
+	if( job )
+	{
+		Com_AtomicAdd( &jobsPending, -1 );
+	}
+
+	return job;
+}
+
+static void Job_Run( job_t* job );
+
+/*
+=================
+Job_Enqueue
+=================
+*/
+static void Job_Enqueue( job_t* job )
+{
+	if( !Job_Push( job ) )
+	{
+		jobWorkers[jobWorkerIndex].inlined++;
+		Job_Run( job );
+	}
+}
+
+/*
+=================
+Job_Signal
+
+A job for this counter has finished. The counter isn't touched after the
+lock is dropped, Job_Wait can return and the owner reuse it right away.
+=================
+*/
+static void Job_Signal( jobCounter_t* counter )
+{
+	job_t *job, *next;
+
+	if( !counter )
+	{
+		return;
+	}
+
+	job = NULL;
+	Job_Lock( &counter->lock );
+	if( Com_AtomicAdd( &counter->count, -1 ) == 0 )
+	{
+		// release everything that waited on this counter
+		job				 = counter->waiters;
+		counter->waiters = NULL;
+	}
+	Job_Unlock( &counter->lock );
+
+	for( ; job; job = next )
+	{
+		next = job->next;
+		Job_Enqueue( job );
+	}
+}
+
+/*
+=================
+Job_Run
+=================
+*/
+static void Job_Run( job_t* job )
+{
+	jobCounter_t* signal;
+	vm_t*		  oldVM;
+
+	oldVM = VM_SetCurrent( job->vm );
+
+	// the job level profiling hook, every job is a zone named after it
+	PROFILE_BEGIN( job->name );
+	if( job->rangeFunc )
+	{
+		job->rangeFunc( job->data, job->start, job->end );
+	}
+	else
+	{
+		job->func( job->data );
+	}
+	PROFILE_END();
+
+	VM_SetCurrent( oldVM );
+
+	jobWorkers[jobWorkerIndex].executed++;
+
+	signal = job->signal;
+	Job_Free( job );
+	Job_Signal( signal );
+}
+
+/*
+=================
+Job_Submit
+=================
+*/
+static void Job_Submit( job_t* job, jobCounter_t* dependency )
+{
+	if( dependency )
+	{
+		Job_Lock( &dependency->lock );
+		if( dependency->count > 0 )
+		{
+			job->next			  = dependency->waiters;
+			dependency->waiters = job;
+			Job_Unlock( &dependency->lock );
+			return;
+		}
+		Job_Unlock( &dependency->lock );
+	}
+
+	Job_Enqueue( job );
+}
+
+/*
+=================
+Job_AddAfter
+
+Runs func( data ) once dependency (if not NULL) is done,
+signal (if not NULL) is raised now and lowered when the job is done
+=================
+*/
+void Job_AddAfter( const char* name, jobFunc_t func, void* data, jobCounter_t* signal, jobCounter_t* dependency )
+{
+	job_t* job;
+
+	if( signal )
+	{
+		Com_AtomicAdd( &signal->count, 1 );
+	}
+
+	job = Job_Alloc();
+	if( !job )
+	{
+		// out of jobs, do it right here
+		Job_Wait( dependency );
+		jobWorkers[jobWorkerIndex].inlined++;
+		PROFILE_BEGIN( name );
+		func( data );
+		PROFILE_END();
+		Job_Signal( signal );
+		return;
+	}
+
+	job->name	   = name;
+	job->func	   = func;
+	job->rangeFunc = NULL;
+	job->data	   = data;
+	job->signal	   = signal;
+	job->vm		   = VM_Current();
+	job->next	   = NULL;
+
+	Job_Submit( job, dependency );
+}
+
+/*
+=================
+Job_Add
+=================
+*/
+void Job_Add( const char* name, jobFunc_t func, void* data, jobCounter_t* signal )
+{
+	Job_AddAfter( name, func, data, signal, NULL );
+}
+
+/*
+=================
+Job_Wait
+
+Helps out with any queued job until the counter is 0
+=================
+*/
+void Job_Wait( jobCounter_t* counter )
+{
+	job_t* job;
+
+	if( !counter )
+	{
+		return;
+	}
+
+	while( counter->count > 0 )
+	{
+		job = Job_Take();
+		if( job )
+		{
+			Job_Run( job );
+		}
+		else
+		{
+			// the remaining jobs are running on other threads
+			Sys_Yield();
+		}
+	}
+
+	// let the last Job_Signal leave the counter
+	Job_Lock( &counter->lock );
+	Job_Unlock( &counter->lock );
+}
+
+/*
+=================
+Job_ParallelFor
+
+Calls func( data, start, end ) on slices of [0, count) that are at least
+minBatch long and waits for all of them
+=================
+*/
+void Job_ParallelFor( const char* name, int count, int minBatch, jobRangeFunc_t func, void* data )
+{
+	jobCounter_t counter;
+	job_t*		 job;
+	int			 start, batch;
+
+	if( count <= 0 )
+	{
+		return;
+	}
+
+	// a few slices per thread so uneven work still balances
+	batch = ( count + numJobWorkers * 4 - 1 ) / ( numJobWorkers * 4 );
+	if( batch < minBatch )
+	{
+		batch = minBatch;
+	}
+
+	if( numJobWorkers == 1 || batch >= count )
+	{
+		PROFILE_BEGIN( name );
+		func( data, 0, count );
+		PROFILE_END();
+		return;
+	}
+
+	Com_Memset( &counter, 0, sizeof( counter ) );
+
+	for( start = 0; start < count; start += batch )
+	{
+		Com_AtomicAdd( &counter.count, 1 );
+
+		job = Job_Alloc();
+		if( !job )
+		{
+			jobWorkers[jobWorkerIndex].inlined++;
+			func( data, start, start + batch < count ? start + batch : count );
+			Job_Signal( &counter );
+			continue;
+		}
+
+		job->name	   = name;
+		job->func	   = NULL;
+		job->rangeFunc = func;
+		job->data	   = data;
+		job->start	   = start;
+		job->end	   = start + batch < count ? start + batch : count;
+		job->signal	   = &counter;
+		job->vm		   = VM_Current();
+		job->next	   = NULL;
+
+		Job_Enqueue( job );
+	}
+
+	Job_Wait( &counter );
+}
+
+/*
+=================
+Job_NumWorkers
+
+Threads that run jobs, the main thread included
+=================
+*/
+int Job_NumWorkers()
+{
+	return numJobWorkers;
+}
+
+/*
+=================
+Job_WorkerThread
+=================
+*/
+static void Job_WorkerThread( void* data )
+{
+	job_t* job;
+
+	jobWorkerIndex = ( intptr_t )data;
+	Com_ProfileThreadName( va( "job worker %i", jobWorkerIndex ) );
+
+	while( !jobsShutdown )
+	{
+		job = Job_Take();
+		if( job )
+		{
+			Job_Run( job );
+			continue;
+		}
+
+		Com_AtomicAdd( &idleWorkers, 1 );
+		if( jobsPending > 0 || jobsShutdown )
+		{
+			Com_AtomicAdd( &idleWorkers, -1 );
+			continue;
+		}
+		Sys_SemaphoreWait( jobSemaphore );
+		Com_AtomicAdd( &idleWorkers, -1 );
+	}
+}
+
+/*
+=================
+Com_JobInfo_f
+=================
+*/
+static void Com_JobInfo_f()
+{
+	jobWorker_t* w;
+	int			 i;
+
+	Com_Printf( "%i job threads, %i jobs pending, %i idle\n", numJobWorkers, jobsPending, idleWorkers );
+	for( i = 0; i < numJobWorkers; i++ )
+	{
+		w = &jobWorkers[i];
+		Com_Printf( "%2i: %9i run %8i stolen %6i inlined%s\n", i, w->executed, w->stolen, w->inlined, i ? "" : " (main)" );
+	}
+}
+
+/*
+=================
+Com_InitJobs
+=================
+*/
+void Com_InitJobs()
+{
+	int i, numThreads;
+
+	com_jobWorkers = Cvar_Get( "com_jobWorkers", "-1", CVAR_ARCHIVE | CVAR_LATCH );
+
+	numThreads = com_jobWorkers->integer;
+	if( numThreads < 0 )
+	{
+		numThreads = Sys_ProcessorCount() - 1;
+	}
+	if( numThreads > MAX_JOB_WORKERS - 1 )
+	{
+		numThreads = MAX_JOB_WORKERS - 1;
+	}
+	if( numThreads < 0 )
+	{
+		numThreads = 0;
+	}
+
+	for( i = 0; i < MAX_JOBS - 1; i++ )
+	{
+		jobPool[i].next = &jobPool[i + 1];
+	}
+	jobPool[MAX_JOBS - 1].next = NULL;
+	jobFreeList				   = jobPool;
+
+	jobWorkerIndex = 0;
+	numJobWorkers  = 1;
+	jobsShutdown   = 0;
+
+	if( numThreads )
+	{
+		jobSemaphore = Sys_CreateSemaphore();
+	}
+
+	for( i = 1; jobSemaphore && i <= numThreads; i++ )
+	{
+		// count it before it runs, it may start stealing right away
+		numJobWorkers++;
+		jobWorkers[i].thread = Sys_CreateThread( Job_WorkerThread, ( void* )( intptr_t )i );
+		if( !jobWorkers[i].thread )
+		{
+			numJobWorkers--;
+			Com_Printf( "WARNING: could only start %i job workers\n", i - 1 );
+			break;
+		}
+	}
+
+	Cmd_AddCommand( "jobinfo", Com_JobInfo_f );
+
+	Com_Printf( "%i job threads\n", numJobWorkers );
+}
+
+/*
+=================
+Com_ShutdownJobs
+
+All jobs must have been waited for
+=================
+*/
+void Com_ShutdownJobs()
+{
+	int i;
+
+	jobsShutdown = 1;
+	for( i = 1; i < numJobWorkers; i++ )
+	{
+		Sys_SemaphorePost( jobSemaphore, 1 );
+	}
+	for( i = 1; i < numJobWorkers; i++ )
+	{
+		Sys_JoinThread( jobWorkers[i].thread );
+	}
+
+	if( jobSemaphore )
+	{
+		Sys_DestroySemaphore( jobSemaphore );
+		jobSemaphore = NULL;
+	}
+
+	Com_Memset( jobWorkers, 0, sizeof( jobWorkers ) );
+	numJobWorkers = 1;
+
+	Cmd_RemoveCommand( "jobinfo" );
+}
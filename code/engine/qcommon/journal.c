@@ -0,0 +1,630 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// journal.c -- event journal recording and replay
+
+#include <q_shared.h>
+#include "qcommon.h"
+
+/*
+==============================================================================
+
+						EVENT JOURNAL
+
+"journal 1" records every system event into journal.dat and every .cfg file
+into journaldata.dat, "journal 2" plays them back. Because the server only
+ever sees the world through events, a recorded dedicated server session
+replays exactly, usercmds included, as long as the same command line is used.
+
+"journal 3" replays a dedicated server journal as a benchmark: nothing waits
+for the recorded wall clock, outgoing packets are dropped, and the time
+spent in every server tick and in the packets received since the previous
+one is measured. When the journal ends the percentiles are printed and
+written as JSON to com_replayLog, then the server quits.
+
+The file is little endian: a header, then records that each start with a
+type byte, a frame marker after the events of every frame, and at the end
+an index of every JOURNAL_INDEX_INTERVAL'th frame marker followed by a
+trailer pointing at it. Journals from before the header was added are raw
+sysEvent_t dumps and still play back.
+==============================================================================
+*/
+
+#define JOURNAL_IDENT		   ( ( 'L' << 24 ) + ( 'N' << 16 ) + ( 'J' << 8 ) + 'Q' )
+#define JOURNAL_INDEX_IDENT	   ( ( 'I' << 24 ) + ( 'N' << 16 ) + ( 'J' << 8 ) + 'Q' )
+#define JOURNAL_VERSION		   2
+#define JOURNAL_INDEX_INTERVAL 256
+
+#define REPLAY_BUCKET_USEC	   10	 // histogram resolution
+#define REPLAY_BUCKETS		   20000 // 200 msec, longer goes into the last bucket
+
+typedef enum
+{
+	JR_TIME,  // int time, an SE_NONE event
+	JR_EVENT, // int time, byte type, int value, int value2, int length, length bytes
+	JR_FRAME, // int frame, int frameTime, int msec
+	JR_END	  // int frames, int indexed, indexed * { int frame, int offset }
+} journalRecord_t;
+
+typedef struct
+{
+	int frame;
+	int offset;
+} journalIndex_t;
+
+typedef struct
+{
+	int		  buckets[REPLAY_BUCKETS];
+	int		  count;
+	int		  max; // usec
+	long long total;
+} replayHistogram_t;
+
+static cvar_t*			 com_replayLog;
+
+static qboolean			 journalLegacy; // raw sysEvent_t records
+static int				 journalFrames; // frame markers written or read so far
+static int				 journalTotalFrames;
+static qboolean			 journalFinished;
+
+static journalIndex_t*	 journalIndex;
+static int				 numJournalIndex;
+static int				 maxJournalIndex;
+
+static replayHistogram_t replayTicks;
+static replayHistogram_t replayPackets;
+static long long		 replayPacketNsec; // since the last tick
+static int				 replayStartTime;
+static int				 replayProgress;
+
+/*
+=================
+Com_JournalWrite
+=================
+*/
+static void Com_JournalWrite( const void* data, int length )
+{
+	if( FS_Write( data, length, com_journalFile ) != length )
+	{
+		Com_Error( ERR_FATAL, "Error writing to journal file" );
+	}
+}
+
+static void Com_JournalWriteByte( int value )
+{
+	byte b;
+
+	b = value;
+	Com_JournalWrite( &b, 1 );
+}
+
+static void Com_JournalWriteInt( int value )
+{
+	value = LittleLong( value );
+	Com_JournalWrite( &value, 4 );
+}
+
+/*
+=================
+Com_JournalRead
+=================
+*/
+static void Com_JournalRead( void* data, int length )
+{
+	if( FS_Read( data, length, com_journalFile ) != length )
+	{
+		Com_Error( ERR_FATAL, "Error reading from journal file" );
+	}
+}
+
+static int Com_JournalReadByte()
+{
+	byte b;
+
+	Com_JournalRead( &b, 1 );
+	return b;
+}
+
+static int Com_JournalReadInt()
+{
+	int value;
+
+	Com_JournalRead( &value, 4 );
+	return LittleLong( value );
+}
+
+/*
+=================
+Com_JournalReadIndex
+
+Finds the frame count of a finished journal through its trailer, the frame
+markers themselves are still checked while replaying
+=================
+*/
+static void Com_JournalReadIndex()
+{
+	int start, end, offset, ident;
+
+	start = FS_FTell( com_journalFile );
+
+	FS_Seek( com_journalFile, -8, FS_SEEK_END );
+	end	   = FS_FTell( com_journalFile );
+	offset = Com_JournalReadInt();
+	ident  = Com_JournalReadInt();
+
+	if( ident != JOURNAL_INDEX_IDENT || offset < start || offset >= end )
+	{
+		// the recording was never shut down cleanly
+		Com_Printf( "journal has no index, it will play until it runs out\n" );
+	}
+	else
+	{
+		FS_Seek( com_journalFile, offset, FS_SEEK_SET );
+		if( Com_JournalReadByte() == JR_END )
+		{
+			journalTotalFrames = Com_JournalReadInt();
+			Com_Printf( "journal holds %i frames\n", journalTotalFrames );
+		}
+	}
+
+	FS_Seek( com_journalFile, start, FS_SEEK_SET );
+}
+
+/*
+=================
+Com_InitJournaling
+=================
+*/
+void Com_InitJournaling()
+{
+	int ident;
+
+	Com_StartupVariable( "journal" );
+	com_journal = Cvar_Get( "journal", "0", CVAR_INIT );
+	if( !com_journal->integer )
+	{
+		return;
+	}
+
+	if( com_journal->integer == 1 )
+	{
+		Com_Printf( "Journaling events\n" );
+		com_journalFile		= FS_FOpenFileWrite( "journal.dat" );
+		com_journalDataFile = FS_FOpenFileWrite( "journaldata.dat" );
+	}
+	else if( com_journal->integer == 2 || com_journal->integer == 3 )
+	{
+		Com_Printf( com_journal->integer == 3 ? "Benchmarking journaled events\n" : "Replaying journaled events\n" );
+		FS_FOpenFileRead( "journal.dat", &com_journalFile, qtrue );
+		FS_FOpenFileRead( "journaldata.dat", &com_journalDataFile, qtrue );
+	}
+
+	if( !com_journalFile || !com_journalDataFile )
+	{
+		Cvar_Set( "journal", "0" );
+		com_journalFile		= 0;
+		com_journalDataFile = 0;
+		Com_Printf( "Couldn't open journal files\n" );
+		return;
+	}
+
+	com_replayLog = Cvar_Get( "com_replayLog", "replay", 0 );
+
+	if( com_journal->integer == 1 )
+	{
+		Com_JournalWriteInt( JOURNAL_IDENT );
+		Com_JournalWriteInt( JOURNAL_VERSION );
+		return;
+	}
+
+	if( FS_Read( &ident, 4, com_journalFile ) == 4 && LittleLong( ident ) == JOURNAL_IDENT )
+	{
+		if( Com_JournalReadInt() != JOURNAL_VERSION )
+		{
+			Com_Error( ERR_FATAL, "journal.dat is not version %i", JOURNAL_VERSION );
+		}
+		Com_JournalReadIndex();
+	}
+	else
+	{
+		Com_Printf( "journal.dat is an old unindexed journal\n" );
+		journalLegacy = qtrue;
+		FS_Seek( com_journalFile, 0, FS_SEEK_SET );
+	}
+
+	replayStartTime = Sys_Milliseconds();
+}
+
+/*
+=================
+Com_JournalWriteEvent
+=================
+*/
+void Com_JournalWriteEvent( const sysEvent_t* ev )
+{
+	if( ev->evType == SE_NONE )
+	{
+		Com_JournalWriteByte( JR_TIME );
+		Com_JournalWriteInt( ev->evTime );
+		return;
+	}
+
+	Com_JournalWriteByte( JR_EVENT );
+	Com_JournalWriteInt( ev->evTime );
+	Com_JournalWriteByte( ev->evType );
+	Com_JournalWriteInt( ev->evValue );
+	Com_JournalWriteInt( ev->evValue2 );
+	Com_JournalWriteInt( ev->evPtrLength );
+	if( ev->evPtrLength )
+	{
+		Com_JournalWrite( ev->evPtr, ev->evPtrLength );
+	}
+}
+
+/*
+=================
+Com_JournalReadEvent
+=================
+*/
+void Com_JournalReadEvent( sysEvent_t* ev )
+{
+	int type;
+
+	Com_Memset( ev, 0, sizeof( *ev ) );
+
+	if( journalLegacy )
+	{
+		Com_JournalRead( ev, sizeof( *ev ) );
+		if( ev->evPtrLength )
+		{
+			ev->evPtr = Z_Malloc( ev->evPtrLength );
+			Com_JournalRead( ev->evPtr, ev->evPtrLength );
+		}
+		return;
+	}
+
+	type = Com_JournalReadByte();
+	if( type == JR_END )
+	{
+		Com_JournalFinished();
+		return;
+	}
+	if( type != JR_TIME && type != JR_EVENT )
+	{
+		Com_Error( ERR_FATAL, "journal out of sync at frame %i: expected an event, found record %i", journalFrames, type );
+	}
+
+	ev->evTime = Com_JournalReadInt();
+	if( type == JR_TIME )
+	{
+		return;
+	}
+
+	ev->evType		= Com_JournalReadByte();
+	ev->evValue		= Com_JournalReadInt();
+	ev->evValue2	= Com_JournalReadInt();
+	ev->evPtrLength = Com_JournalReadInt();
+	if( ev->evPtrLength < 0 || ev->evPtrLength > ( int )sizeof( netadr_t ) + MAX_MSGLEN + MAX_STRING_CHARS )
+	{
+		Com_Error( ERR_FATAL, "journal out of sync at frame %i: bad event length %i", journalFrames, ev->evPtrLength );
+	}
+	if( ev->evPtrLength )
+	{
+		ev->evPtr = Z_Malloc( ev->evPtrLength );
+		Com_JournalRead( ev->evPtr, ev->evPtrLength );
+	}
+}
+
+/*
+=================
+Com_JournalFrame
+
+Called once the events of a frame have been run and its msec is known.
+Recording writes a frame marker, replay checks that the recording reached
+the same point and returns the msec it used
+=================
+*/
+int Com_JournalFrame( int frameTime, int msec )
+{
+	int frame, time, recorded, percent;
+
+	if( com_journal->integer == 1 )
+	{
+		if( !( journalFrames % JOURNAL_INDEX_INTERVAL ) )
+		{
+			if( numJournalIndex == maxJournalIndex )
+			{
+				journalIndex_t* old = journalIndex;
+
+				maxJournalIndex = maxJournalIndex ? maxJournalIndex * 2 : 256;
+				journalIndex	= Z_Malloc( maxJournalIndex * sizeof( *journalIndex ) );
+				if( old )
+				{
+					Com_Memcpy( journalIndex, old, numJournalIndex * sizeof( *journalIndex ) );
+					Z_Free( old );
+				}
+			}
+			journalIndex[numJournalIndex].frame	 = journalFrames;
+			journalIndex[numJournalIndex].offset = FS_FTell( com_journalFile );
+			numJournalIndex++;
+		}
+
+		Com_JournalWriteByte( JR_FRAME );
+		Com_JournalWriteInt( journalFrames );
+		Com_JournalWriteInt( frameTime );
+		Com_JournalWriteInt( msec );
+		journalFrames++;
+		return msec;
+	}
+
+	if( com_journal->integer < 2 || journalLegacy )
+	{
+		return msec;
+	}
+
+	if( Com_JournalReadByte() != JR_FRAME )
+	{
+		Com_Error( ERR_FATAL, "journal out of sync at frame %i: the recording ran more events", journalFrames );
+	}
+	frame	 = Com_JournalReadInt();
+	time	 = Com_JournalReadInt();
+	recorded = Com_JournalReadInt();
+	if( frame != journalFrames || time != frameTime )
+	{
+		Com_Error( ERR_FATAL, "journal out of sync at frame %i: recorded frame %i at time %i, replayed at %i", journalFrames, frame, time, frameTime );
+	}
+	journalFrames++;
+
+	if( journalTotalFrames )
+	{
+		percent = journalFrames * 10 / journalTotalFrames;
+		if( percent > replayProgress )
+		{
+			replayProgress = percent;
+			Com_Printf( "journal replay %i%%\n", percent * 10 );
+		}
+	}
+
+	return recorded;
+}
+
+/*
+=================
+Com_JournalClose
+
+Ends a recording with the frame index
+=================
+*/
+void Com_JournalClose()
+{
+	int offset, i;
+
+	if( !com_journalFile )
+	{
+		return;
+	}
+
+	if( com_journal->integer == 1 )
+	{
+		offset = FS_FTell( com_journalFile );
+
+		Com_JournalWriteByte( JR_END );
+		Com_JournalWriteInt( journalFrames );
+		Com_JournalWriteInt( numJournalIndex );
+		for( i = 0; i < numJournalIndex; i++ )
+		{
+			Com_JournalWriteInt( journalIndex[i].frame );
+			Com_JournalWriteInt( journalIndex[i].offset );
+		}
+
+		Com_JournalWriteInt( offset );
+		Com_JournalWriteInt( JOURNAL_INDEX_IDENT );
+	}
+
+	FS_FCloseFile( com_journalFile );
+	com_journalFile = 0;
+
+	if( journalIndex )
+	{
+		Z_Free( journalIndex );
+		journalIndex = NULL;
+	}
+	numJournalIndex = maxJournalIndex = 0;
+}
+
+/*
+=================
+Com_ReplayAddTime
+=================
+*/
+static void Com_ReplayAddTime( replayHistogram_t* h, long long nsec )
+{
+	int usec, bucket;
+
+	usec   = ( int )( nsec / 1000 );
+	bucket = usec / REPLAY_BUCKET_USEC;
+	if( bucket >= REPLAY_BUCKETS )
+	{
+		bucket = REPLAY_BUCKETS - 1;
+	}
+
+	h->buckets[bucket]++;
+	h->count++;
+	h->total += usec;
+	if( usec > h->max )
+	{
+		h->max = usec;
+	}
+}
+
+/*
+=================
+Com_ReplayPacketTime
+=================
+*/
+void Com_ReplayPacketTime( long long nsec )
+{
+	replayPacketNsec += nsec;
+}
+
+/*
+=================
+Com_ReplayServerTick
+
+A server frame that ran the game, packets are charged to the next tick
+=================
+*/
+void Com_ReplayServerTick( long long nsec )
+{
+	Com_ReplayAddTime( &replayTicks, nsec );
+	Com_ReplayAddTime( &replayPackets, replayPacketNsec );
+	replayPacketNsec = 0;
+}
+
+/*
+=================
+Com_ReplayPercentile
+
+Upper edge of the bucket holding the nearest rank, in usec
+=================
+*/
+static int Com_ReplayPercentile( const replayHistogram_t* h, int percent )
+{
+	int rank, count, i;
+
+	rank = ( h->count * percent + 99 ) / 100;
+	if( rank < 1 )
+	{
+		rank = 1;
+	}
+
+	count = 0;
+	for( i = 0; i < REPLAY_BUCKETS - 1; i++ )
+	{
+		count += h->buckets[i];
+		if( count >= rank )
+		{
+			return ( i + 1 ) * REPLAY_BUCKET_USEC;
+		}
+	}
+	return h->max;
+}
+
+/*
+=================
+Com_ReplaySummarize
+=================
+*/
+static void Com_ReplaySummarize( const char* name, const replayHistogram_t* h, char* json, int jsonSize )
+{
+	int p50, p95, p99;
+
+	p50 = Com_ReplayPercentile( h, 50 );
+	p95 = Com_ReplayPercentile( h, 95 );
+	p99 = Com_ReplayPercentile( h, 99 );
+
+	Com_Printf( "%8s msec: p50 %.2f  p95 %.2f  p99 %.2f  max %.2f\n", name, p50 / 1000.0, p95 / 1000.0, p99 / 1000.0, h->max / 1000.0 );
+
+	Com_sprintf( json,
+		jsonSize,
+		"{\"mean\":%.3f,\"max\":%.3f,\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f}",
+		h->count ? h->total / ( double )h->count / 1000.0 : 0.0,
+		h->max / 1000.0,
+		p50 / 1000.0,
+		p95 / 1000.0,
+		p99 / 1000.0 );
+}
+
+/*
+=================
+Com_ReplayReport
+=================
+*/
+static void Com_ReplayReport()
+{
+	fileHandle_t f;
+	char		 filename[MAX_QPATH];
+	char		 ticks[256];
+	char		 packets[256];
+	char		 line[1024];
+	int			 msec;
+
+	msec = Sys_Milliseconds() - replayStartTime;
+
+	Com_Printf( "replayed %i frames, %i server ticks in %.2f seconds\n", journalFrames, replayTicks.count, msec / 1000.0 );
+	if( !replayTicks.count )
+	{
+		return;
+	}
+
+	Com_ReplaySummarize( "tick", &replayTicks, ticks, sizeof( ticks ) );
+	Com_ReplaySummarize( "packets", &replayPackets, packets, sizeof( packets ) );
+
+	if( !com_replayLog->string[0] )
+	{
+		return;
+	}
+
+	Q_strncpyz( filename, com_replayLog->string, sizeof( filename ) );
+	COM_DefaultExtension( filename, sizeof( filename ), ".json" );
+	f = FS_FOpenFileWrite( filename );
+	if( !f )
+	{
+		Com_Printf( "Couldn't write %s\n", filename );
+		return;
+	}
+
+	Com_sprintf( line,
+		sizeof( line ),
+		"{\n\"frames\":%i,\n\"ticks\":%i,\n\"seconds\":%.3f,\n\"tickMsec\":%s,\n\"packetMsec\":%s\n}\n",
+		journalFrames,
+		replayTicks.count,
+		msec / 1000.0,
+		ticks,
+		packets );
+	FS_Write( line, strlen( line ), f );
+	FS_FCloseFile( f );
+	Com_Printf( "wrote %s\n", filename );
+}
+
+/*
+=================
+Com_JournalFinished
+
+The replay reached the end of the recording
+=================
+*/
+void Com_JournalFinished()
+{
+	if( journalFinished )
+	{
+		return;
+	}
+	journalFinished = qtrue;
+
+	Com_Printf( "journal replay complete\n" );
+	if( com_journal->integer == 3 )
+	{
+		Com_ReplayReport();
+	}
+
+	Com_Quit_f();
+}
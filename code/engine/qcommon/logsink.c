@@ -0,0 +1,370 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// logsink.c -- log file writes moved off the calling thread
+
+#include <q_shared.h>
+#include "qcommon.h"
+
+/*
+==============================================================================
+
+						ASYNC LOG SINK
+
+Com_LogWrite queues text for a file instead of writing it, a writer thread
+does the FS_Write. qconsole.log and the game's games.log go through here, so
+a "logfile 2" or g_logSync server no longer waits on the disk in the frame.
+
+The queue is a fixed ring of slots, any thread may add to it without a lock:
+a write claims as many consecutive slots as its text needs by moving the
+head with a compare exchange, fills them and marks each one written. Text
+that would need more than LOG_MAX_RESERVE slots is copied to the heap and
+queued in a single slot instead, so a write never interleaves with text from
+other threads. The
+writer takes them in order and frees them. When the ring is full the text
+is dropped and counted, the count is written into the log the next time
+there is room.
+
+Com_LogFlush waits until everything queued so far is on disk, it runs on
+Com_Error, before a file that was written through the sink is closed and
+when the sink shuts down. With com_asyncLog 0 or when the thread can't be
+started Com_LogWrite is a plain FS_Write.
+==============================================================================
+*/
+
+#define LOG_RING_SLOTS		 4096 // power of 2
+#define LOG_SLOT_TEXT		 248
+#define LOG_MAX_RESERVE		 32 // slots claimed at once, longer text is queued as a heap copy
+#define LOG_MAX_FILE_HANDLES 64
+
+typedef struct
+{
+	volatile int sequence; // the ring position while free, position + 1 once written
+	fileHandle_t f;
+	int			 length;
+	qboolean	 continued; // the next slot holds more of the same write
+	char*		 heap;		// text that didn't fit LOG_MAX_RESERVE slots, freed by the writer
+	char		 text[LOG_SLOT_TEXT];
+} logSlot_t;
+
+static logSlot_t		 logRing[LOG_RING_SLOTS];
+static volatile int		 logHead; // next position to claim
+static volatile int		 logTail; // next position to write, moved by the writer only
+
+static volatile int		 logDropped;
+static int				 logReportedDrops;
+static volatile int		 logUsedHandles[LOG_MAX_FILE_HANDLES];
+
+static qboolean			 logRunning;
+static volatile int		 logShutdown;
+static volatile int		 logSleeping;
+static void*			 logThread;
+static void*			 logSemaphore;
+static Q_THREADLOCAL int logIsWriter;
+
+static cvar_t*			 com_asyncLog;
+
+/*
+=================
+Com_LogWake
+=================
+*/
+static void Com_LogWake()
+{
+	if( logSleeping && Com_AtomicCompareExchange( &logSleeping, 0, 1 ) == 1 )
+	{
+		Sys_SemaphorePost( logSemaphore, 1 );
+	}
+}
+
+/*
+=================
+Com_LogWrite
+
+Thread safe, the text is copied
+=================
+*/
+void Com_LogWrite( const void* buffer, int len, fileHandle_t f )
+{
+	const char* text;
+	char*		heap;
+	logSlot_t*	slot;
+	int			pos, count, chunk, i, n;
+
+	if( !f || len <= 0 )
+	{
+		return;
+	}
+
+	if( !logRunning || logIsWriter )
+	{
+		FS_Write( buffer, len, f );
+		return;
+	}
+
+	if( f > 0 && f < LOG_MAX_FILE_HANDLES )
+	{
+		logUsedHandles[f] = 1;
+	}
+
+	text = ( const char* )buffer;
+	heap = NULL;
+	count = ( len + LOG_SLOT_TEXT - 1 ) / LOG_SLOT_TEXT;
+	if( count > LOG_MAX_RESERVE )
+	{
+		heap = malloc( len );
+		if( !heap )
+		{
+			Com_AtomicAdd( &logDropped, 1 );
+			Com_LogWake();
+			return;
+		}
+		Com_Memcpy( heap, text, len );
+		count = 1;
+	}
+
+	// the writer frees slots in order, so if the last one is free
+	// the ones before it are as well
+	while( 1 )
+	{
+		pos	 = logHead;
+		slot = &logRing[( pos + count - 1 ) & ( LOG_RING_SLOTS - 1 )];
+		n	 = slot->sequence - ( pos + count - 1 );
+		if( n < 0 )
+		{
+			free( heap );
+			Com_AtomicAdd( &logDropped, 1 );
+			Com_LogWake();
+			return;
+		}
+		if( n == 0 && Com_AtomicCompareExchange( &logHead, pos + count, pos ) == pos )
+		{
+			break;
+		}
+	}
+
+	if( heap )
+	{
+		slot			= &logRing[pos & ( LOG_RING_SLOTS - 1 )];
+		slot->f			= f;
+		slot->length	= len;
+		slot->continued = qfalse;
+		slot->heap		= heap;
+		Com_AtomicAdd( &slot->sequence, 1 );
+		Com_LogWake();
+		return;
+	}
+
+	for( i = 0; i < count; i++ )
+	{
+		chunk = len < LOG_SLOT_TEXT ? len : LOG_SLOT_TEXT;
+
+		slot			= &logRing[( pos + i ) & ( LOG_RING_SLOTS - 1 )];
+		slot->f			= f;
+		slot->length	= chunk;
+		slot->continued = len > chunk;
+		slot->heap		= NULL;
+		Com_Memcpy( slot->text, text, chunk );
+		Com_AtomicAdd( &slot->sequence, 1 );
+
+		text += chunk;
+		len -= chunk;
+	}
+
+	Com_LogWake();
+}
+
+/*
+=================
+Com_LogWriterThread
+=================
+*/
+static void Com_LogWriterThread( void* data )
+{
+	logSlot_t* slot;
+	char	   note[64];
+	int		   dropped;
+
+	logIsWriter = 1;
+	Com_ProfileThreadName( "log writer" );
+
+	while( 1 )
+	{
+		slot = &logRing[logTail & ( LOG_RING_SLOTS - 1 )];
+		if( slot->sequence == logTail + 1 )
+		{
+			if( slot->heap )
+			{
+				FS_Write( slot->heap, slot->length, slot->f );
+				free( slot->heap );
+				slot->heap = NULL;
+			}
+			else
+			{
+				FS_Write( slot->text, slot->length, slot->f );
+			}
+
+			// don't split a line with the note
+			dropped = logDropped;
+			if( dropped != logReportedDrops && !slot->continued )
+			{
+				Com_sprintf( note, sizeof( note ), "WARNING: %i log writes dropped\n", dropped - logReportedDrops );
+				FS_Write( note, strlen( note ), slot->f );
+				logReportedDrops = dropped;
+			}
+
+			Com_AtomicAdd( &slot->sequence, LOG_RING_SLOTS - 1 );
+			Com_AtomicAdd( &logTail, 1 );
+			continue;
+		}
+
+		if( logShutdown )
+		{
+			break;
+		}
+
+		// producers check the flag after publishing, so look again once it is up
+		Com_AtomicCompareExchange( &logSleeping, 1, 0 );
+		if( slot->sequence == logTail + 1 || logShutdown )
+		{
+			Com_AtomicCompareExchange( &logSleeping, 0, 1 );
+			continue;
+		}
+		Sys_SemaphoreWait( logSemaphore );
+	}
+}
+
+/*
+=================
+Com_LogFlush
+
+Returns once everything queued before the call has been written
+=================
+*/
+void Com_LogFlush()
+{
+	int target;
+
+	if( !logRunning || logIsWriter )
+	{
+		return;
+	}
+
+	target = logHead;
+	while( logTail - target < 0 )
+	{
+		Com_LogWake();
+		Sys_Yield();
+	}
+}
+
+/*
+=================
+Com_LogFlushFile
+
+The file is about to be closed
+=================
+*/
+void Com_LogFlushFile( fileHandle_t f )
+{
+	if( f <= 0 || f >= LOG_MAX_FILE_HANDLES || !logUsedHandles[f] )
+	{
+		return;
+	}
+
+	Com_LogFlush();
+	logUsedHandles[f] = 0;
+}
+
+/*
+=================
+Com_InitLogSink
+=================
+*/
+void Com_InitLogSink()
+{
+	int i;
+
+	com_asyncLog = Cvar_Get( "com_asyncLog", "1", CVAR_ARCHIVE | CVAR_LATCH );
+	if( !com_asyncLog->integer )
+	{
+		return;
+	}
+
+	for( i = 0; i < LOG_RING_SLOTS; i++ )
+	{
+		logRing[i].sequence = i;
+	}
+	logHead			 = 0;
+	logTail			 = 0;
+	logDropped		 = 0;
+	logReportedDrops = 0;
+	logShutdown		 = 0;
+	logSleeping		 = 0;
+
+	logSemaphore = Sys_CreateSemaphore();
+	if( !logSemaphore )
+	{
+		return;
+	}
+
+	logThread = Sys_CreateThread( Com_LogWriterThread, NULL );
+	if( !logThread )
+	{
+		Sys_DestroySemaphore( logSemaphore );
+		logSemaphore = NULL;
+		Com_Printf( "WARNING: couldn't start the log writer, logging synchronously\n" );
+		return;
+	}
+
+	logRunning = qtrue;
+}
+
+/*
+=================
+Com_ShutdownLogSink
+=================
+*/
+void Com_ShutdownLogSink()
+{
+	if( !logRunning )
+	{
+		return;
+	}
+
+	Com_LogFlush();
+
+	logShutdown = 1;
+	Sys_SemaphorePost( logSemaphore, 1 );
+	Sys_JoinThread( logThread );
+	logThread = NULL;
+
+	Sys_DestroySemaphore( logSemaphore );
+	logSemaphore = NULL;
+
+	logRunning = qfalse;
+	Com_Memset( ( void* )logUsedHandles, 0, sizeof( logUsedHandles ) );
+
+	if( logDropped != logReportedDrops )
+	{
+		Com_Printf( "WARNING: %i log writes dropped\n", logDropped - logReportedDrops );
+	}
+}
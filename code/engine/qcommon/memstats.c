@@ -0,0 +1,351 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// memstats.c -- always on memory counters
+
+#include <q_shared.h>
+#include "qcommon.h"
+
+/*
+==============================================================================
+
+						MEMORY TELEMETRY
+
+Every allocator that wants to be seen registers a named memStat_t once and
+bumps it on allocation and free. The counters are plain ints updated with
+atomics, so they stay on in release builds.
+
+Stats come from the zone (one per tag), the hunk (one per hunk label, see
+Hunk_SetLabel), sound buffers and whatever the renderer registers through
+refimport_t.
+
+"mem_stats" prints them, com_memStatsLog > 0 samples them every that many
+seconds into memstats.csv or memstats.json (com_memStatsFormat) so leaks
+and peaks can be followed over a long map rotation.
+==============================================================================
+*/
+
+#define MAX_MEMSTATS 64
+
+static memStat_t	memStats[MAX_MEMSTATS];
+static int			numMemStats;
+
+static cvar_t*		com_memStatsLog;
+static cvar_t*		com_memStatsFormat;
+
+static fileHandle_t memStatsFile;
+static qboolean		memStatsJSON;
+static int			memStatsNextSample;
+
+/*
+=================
+Com_RegisterMemStat
+
+Returns the existing stat if the name is already known.
+Not thread safe, register during initialization.
+=================
+*/
+memStat_t*			Com_RegisterMemStat( const char* name, int flags )
+{
+	memStat_t* stat;
+	int		   i;
+
+	for( i = 0; i < numMemStats; i++ )
+	{
+		if( !Q_stricmp( memStats[i].name, name ) )
+		{
+			return &memStats[i];
+		}
+	}
+
+	if( numMemStats == MAX_MEMSTATS )
+	{
+		Com_Error( ERR_FATAL, "Com_RegisterMemStat: MAX_MEMSTATS hit" );
+	}
+
+	stat = &memStats[numMemStats++];
+	Q_strncpyz( stat->name, name, sizeof( stat->name ) );
+	stat->flags = flags;
+
+	return stat;
+}
+
+/*
+=================
+Com_MemStatAlloc
+=================
+*/
+void Com_MemStatAlloc( memStat_t* stat, int bytes )
+{
+	int now;
+
+	now = Com_AtomicAdd( &stat->bytes, bytes );
+	Com_AtomicAdd( &stat->allocs, 1 );
+
+	// racy but only ever too low by one concurrent update
+	if( now > stat->peak )
+	{
+		stat->peak = now;
+	}
+}
+
+/*
+=================
+Com_MemStatFree
+=================
+*/
+void Com_MemStatFree( memStat_t* stat, int bytes )
+{
+	Com_AtomicAdd( &stat->bytes, -bytes );
+	Com_AtomicAdd( &stat->frees, 1 );
+}
+
+/*
+=================
+Com_MemStatSet
+
+For containers that are easier to measure than to follow
+=================
+*/
+void Com_MemStatSet( memStat_t* stat, int bytes )
+{
+	stat->bytes = bytes;
+	if( bytes > stat->peak )
+	{
+		stat->peak = bytes;
+	}
+}
+
+/*
+=================
+Com_MemStatsMark
+
+Remembers the hunk label sizes for Com_MemStatsClearToMark
+=================
+*/
+void Com_MemStatsMark()
+{
+	int i;
+
+	for( i = 0; i < numMemStats; i++ )
+	{
+		if( memStats[i].flags & MEMSTAT_HUNK )
+		{
+			memStats[i].markBytes = memStats[i].bytes;
+		}
+	}
+}
+
+/*
+=================
+Com_MemStatsClearToMark
+
+The hunk was rewound, a mark of 0 is a full Hunk_Clear
+=================
+*/
+void Com_MemStatsClearToMark( qboolean all )
+{
+	memStat_t* stat;
+	int		   i;
+
+	for( i = 0; i < numMemStats; i++ )
+	{
+		stat = &memStats[i];
+		if( !( stat->flags & MEMSTAT_HUNK ) )
+		{
+			continue;
+		}
+		if( all )
+		{
+			stat->markBytes = 0;
+		}
+		if( stat->bytes != stat->markBytes )
+		{
+			Com_AtomicAdd( &stat->frees, 1 );
+		}
+		stat->bytes = stat->markBytes;
+	}
+}
+
+/*
+=================
+Com_MemStats_f
+=================
+*/
+static void Com_MemStats_f()
+{
+	memStat_t* stat;
+	int		   i;
+
+	if( Cmd_Argc() > 1 && !Q_stricmp( Cmd_Argv( 1 ), "resetpeaks" ) )
+	{
+		for( i = 0; i < numMemStats; i++ )
+		{
+			memStats[i].peak = memStats[i].bytes;
+		}
+		return;
+	}
+
+	Com_Printf( "%-24s %10s %10s %9s %9s\n", "name", "bytes", "peak", "allocs", "frees" );
+	for( i = 0; i < numMemStats; i++ )
+	{
+		stat = &memStats[i];
+		Com_Printf( "%-24s %10i %10i %9i %9i\n", stat->name, stat->bytes, stat->peak, stat->allocs, stat->frees );
+	}
+
+	Com_Printf( "%8i bytes hunk remaining\n", Hunk_MemoryRemaining() );
+	Com_Printf( "%8i bytes zone remaining\n", Z_AvailableMemory() );
+}
+
+/*
+=================
+Com_WriteMemStatsSample
+=================
+*/
+static void Com_WriteMemStatsSample( int time )
+{
+	memStat_t* stat;
+	char	   line[256];
+	int		   i;
+
+	if( memStatsJSON )
+	{
+		// one JSON object per line
+		Com_sprintf( line, sizeof( line ), "{\"time\":%i,\"stats\":{", time );
+		FS_Write( line, strlen( line ), memStatsFile );
+		for( i = 0; i < numMemStats; i++ )
+		{
+			stat = &memStats[i];
+			Com_sprintf( line,
+				sizeof( line ),
+				"%s\"%s\":{\"bytes\":%i,\"peak\":%i,\"allocs\":%i,\"frees\":%i}",
+				i ? "," : "",
+				stat->name,
+				stat->bytes,
+				stat->peak,
+				stat->allocs,
+				stat->frees );
+			FS_Write( line, strlen( line ), memStatsFile );
+		}
+		FS_Write( "}}\n", 3, memStatsFile );
+	}
+	else
+	{
+		for( i = 0; i < numMemStats; i++ )
+		{
+			stat = &memStats[i];
+			Com_sprintf( line, sizeof( line ), "%i,%s,%i,%i,%i,%i\n", time, stat->name, stat->bytes, stat->peak, stat->allocs, stat->frees );
+			FS_Write( line, strlen( line ), memStatsFile );
+		}
+	}
+
+	FS_Flush( memStatsFile );
+}
+
+/*
+=================
+Com_MemStatsFrame
+
+Feeds the periodic sink
+=================
+*/
+void Com_MemStatsFrame()
+{
+	const char* header = "time,name,bytes,peak,allocs,frees\n";
+	int			now;
+
+	if( !com_memStatsLog )
+	{
+		return;
+	}
+
+	if( com_memStatsLog->integer <= 0 || com_memStatsFormat->modified )
+	{
+		com_memStatsFormat->modified = qfalse;
+		if( memStatsFile )
+		{
+			FS_FCloseFile( memStatsFile );
+			memStatsFile = 0;
+		}
+		if( com_memStatsLog->integer <= 0 )
+		{
+			return;
+		}
+	}
+
+	if( !FS_Initialized() )
+	{
+		return;
+	}
+
+	if( !memStatsFile )
+	{
+		memStatsJSON = !Q_stricmp( com_memStatsFormat->string, "json" );
+		memStatsFile = FS_FOpenFileWrite( memStatsJSON ? "memstats.json" : "memstats.csv" );
+		if( !memStatsFile )
+		{
+			Com_Printf( "Couldn't open the memory stats log, disabling com_memStatsLog\n" );
+			Cvar_Set( "com_memStatsLog", "0" );
+			return;
+		}
+		if( !memStatsJSON )
+		{
+			FS_Write( header, strlen( header ), memStatsFile );
+		}
+		memStatsNextSample = 0;
+	}
+
+	now = Sys_Milliseconds();
+	if( now < memStatsNextSample )
+	{
+		return;
+	}
+	memStatsNextSample = now + com_memStatsLog->integer * 1000;
+
+	Com_WriteMemStatsSample( now );
+}
+
+/*
+=================
+Com_InitMemStats
+=================
+*/
+void Com_InitMemStats()
+{
+	com_memStatsLog	   = Cvar_Get( "com_memStatsLog", "0", 0 );
+	com_memStatsFormat = Cvar_Get( "com_memStatsFormat", "csv", CVAR_ARCHIVE );
+
+	Cmd_AddCommand( "mem_stats", Com_MemStats_f );
+}
+
+/*
+=================
+Com_ShutdownMemStats
+=================
+*/
+void Com_ShutdownMemStats()
+{
+	if( memStatsFile )
+	{
+		FS_FCloseFile( memStatsFile );
+		memStatsFile = 0;
+	}
+}
@@ -671,6 +671,11 @@ void NET_SendPacket( netsrc_t sock, int length, const void* data, netadr_t to )
 	{
 		return;
 	}
+	// the clients of a journal benchmark replay aren't there
+	if( com_journal && com_journal->integer == 3 )
+	{
+		return;
+	}
 
 	Sys_SendPacket( length, data, to );
 }
@@ -0,0 +1,487 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// profile.c -- hierarchical zone profiler with chrome trace output
+
+#include <q_shared.h>
+#include "qcommon.h"
+
+/*
+==============================================================================
+
+						ZONE PROFILER
+
+PROFILE_BEGIN( "name" ) / PROFILE_END() bracket a zone, PROFILE_SCOPE covers
+the rest of a C++ block. Zones nest. Names must be string literals, the
+pointer is stored and only read when the capture is written out.
+
+While no capture is running a zone costs a test of com_profiling. During a
+capture every thread pushes its open zones on a private stack and writes
+each finished zone into its own ring buffer. The main thread drains all
+rings into the trace file at the top of every frame, a full ring drops
+events instead of blocking and the drops are reported.
+
+"profile_capture <frames> [file]" records that many frames into a chrome
+trace (chrome://tracing or ui.perfetto.dev), default profile.json.
+==============================================================================
+*/
+
+#define MAX_PROFILE_THREADS 64
+#define MAX_PROFILE_DEPTH	64
+#define PROFILE_RING_SIZE	16384 // events per thread, power of 2
+#define MAX_PROFILE_NAMES	256	  // interned module zone names
+
+typedef struct
+{
+	const char* name;
+	long long	start;
+	long long	end;
+} profileEvent_t;
+
+typedef struct
+{
+	char			name[32];
+
+	// written by the owning thread only
+	profileEvent_t* ring;
+	volatile int	head;
+	int				depth;
+	const char*		stackName[MAX_PROFILE_DEPTH];
+	long long		stackStart[MAX_PROFILE_DEPTH];
+
+	// written by the drain only
+	volatile int	tail;
+
+	volatile int	dropped;
+} profileThread_t;
+
+volatile int						com_profiling;
+
+static profileThread_t				profileThreads[MAX_PROFILE_THREADS];
+static volatile int					numProfileThreads;
+
+static Q_THREADLOCAL profileThread_t* threadProfile;
+
+static char							profileNames[MAX_PROFILE_NAMES][MAX_QPATH];
+static int							numProfileNames;
+
+static fileHandle_t					profileFile;
+static char							profileFileName[MAX_QPATH];
+static int							profileFramesLeft;
+static int							profilePendingFrames;
+static long long					profileBaseTime;
+static int							profileNumEvents;
+
+/*
+=================
+Profile_GetThread
+=================
+*/
+static profileThread_t* Profile_GetThread()
+{
+	profileThread_t* t;
+	int				 index;
+
+	t = threadProfile;
+	if( t )
+	{
+		return t;
+	}
+
+	index = Com_AtomicAdd( &numProfileThreads, 1 ) - 1;
+	if( index >= MAX_PROFILE_THREADS )
+	{
+		return NULL;
+	}
+
+	t		= &profileThreads[index];
+	t->ring = malloc( PROFILE_RING_SIZE * sizeof( profileEvent_t ) );
+	if( !t->ring )
+	{
+		return NULL;
+	}
+	if( !t->name[0] )
+	{
+		Com_sprintf( t->name, sizeof( t->name ), index ? "thread %i" : "main", index );
+	}
+	threadProfile = t;
+
+	return t;
+}
+
+/*
+=================
+Com_ProfileThreadName
+
+Optional label for the calling thread in the trace
+=================
+*/
+void Com_ProfileThreadName( const char* name )
+{
+	profileThread_t* t;
+
+	t = Profile_GetThread();
+	if( t )
+	{
+		Q_strncpyz( t->name, name, sizeof( t->name ) );
+	}
+}
+
+/*
+=================
+Com_ProfileBegin
+=================
+*/
+void Com_ProfileBegin( const char* name )
+{
+	profileThread_t* t;
+
+	if( !com_profiling )
+	{
+		return;
+	}
+
+	t = Profile_GetThread();
+	if( !t )
+	{
+		return;
+	}
+
+	if( t->depth < MAX_PROFILE_DEPTH )
+	{
+		t->stackName[t->depth]	= name;
+		t->stackStart[t->depth] = Sys_Nanoseconds();
+	}
+	t->depth++;
+}
+
+/*
+=================
+Com_ProfileEnd
+
+Also closes zones that were opened before a capture stopped
+=================
+*/
+void Com_ProfileEnd()
+{
+	profileThread_t* t;
+	profileEvent_t*	 ev;
+
+	t = threadProfile;
+	if( !t || !t->depth )
+	{
+		return;
+	}
+
+	t->depth--;
+	if( t->depth >= MAX_PROFILE_DEPTH || !com_profiling )
+	{
+		return;
+	}
+
+	if( t->head - t->tail >= PROFILE_RING_SIZE )
+	{
+		t->dropped++;
+		return;
+	}
+
+	ev		  = &t->ring[t->head & ( PROFILE_RING_SIZE - 1 )];
+	ev->name  = t->stackName[t->depth];
+	ev->start = t->stackStart[t->depth];
+	ev->end	  = Sys_Nanoseconds();
+
+	// the event must be complete before the drain can see it, volatile
+	// stores are not reordered with earlier stores on x86 and msvc
+	t->head++;
+}
+
+/*
+=================
+Com_ProfileInternName
+
+Returns a copy of a zone name owned by a game module, which can be unloaded
+before the capture is written. Main thread only.
+=================
+*/
+const char* Com_ProfileInternName( const char* name )
+{
+	int i;
+
+	for( i = 0; i < numProfileNames; i++ )
+	{
+		if( !strcmp( profileNames[i], name ) )
+		{
+			return profileNames[i];
+		}
+	}
+
+	if( numProfileNames == MAX_PROFILE_NAMES )
+	{
+		return "too many zone names";
+	}
+	Q_strncpyz( profileNames[numProfileNames], name, sizeof( profileNames[0] ) );
+
+	return profileNames[numProfileNames++];
+}
+
+/*
+=================
+Com_ProfileBeginCopy
+
+Main thread only
+=================
+*/
+void Com_ProfileBeginCopy( const char* name )
+{
+	if( !com_profiling )
+	{
+		return;
+	}
+
+	Com_ProfileBegin( Com_ProfileInternName( name ) );
+}
+
+/*
+=================
+Profile_Drain
+
+Writes out everything the threads finished since the last drain
+=================
+*/
+static void Profile_Drain()
+{
+	profileThread_t* t;
+	profileEvent_t*	 ev;
+	char			 line[256];
+	int				 i, j, count, head;
+
+	count = numProfileThreads;
+	if( count > MAX_PROFILE_THREADS )
+	{
+		count = MAX_PROFILE_THREADS;
+	}
+
+	for( i = 0; i < count; i++ )
+	{
+		t = &profileThreads[i];
+		if( !t->ring )
+		{
+			continue;
+		}
+
+		head = t->head;
+		for( j = t->tail; j != head; j++ )
+		{
+			ev = &t->ring[j & ( PROFILE_RING_SIZE - 1 )];
+			Com_sprintf( line,
+				sizeof( line ),
+				"%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f}",
+				profileNumEvents ? ",\n" : "",
+				ev->name,
+				i,
+				( ev->start - profileBaseTime ) / 1000.0,
+				( ev->end - ev->start ) / 1000.0 );
+			FS_Write( line, strlen( line ), profileFile );
+			profileNumEvents++;
+		}
+		t->tail = head;
+	}
+}
+
+/*
+=================
+Profile_StartCapture
+=================
+*/
+static void Profile_StartCapture()
+{
+	const char* header = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	int			i;
+
+	profileFile = FS_FOpenFileWrite( profileFileName );
+	if( !profileFile )
+	{
+		Com_Printf( "Couldn't write %s\n", profileFileName );
+		return;
+	}
+	FS_Write( header, strlen( header ), profileFile );
+
+	// forget whatever was still in flight when the last capture stopped
+	for( i = 0; i < numProfileThreads && i < MAX_PROFILE_THREADS; i++ )
+	{
+		profileThreads[i].tail	  = profileThreads[i].head;
+		profileThreads[i].dropped = 0;
+	}
+
+	profileFramesLeft = profilePendingFrames;
+	profileBaseTime	  = Sys_Nanoseconds();
+	profileNumEvents  = 0;
+	com_profiling	  = 1;
+}
+
+/*
+=================
+Profile_StopCapture
+=================
+*/
+static void Profile_StopCapture()
+{
+	profileThread_t* t;
+	char			 line[256];
+	int				 i, count, dropped;
+
+	com_profiling = 0;
+	Profile_Drain();
+
+	count = numProfileThreads;
+	if( count > MAX_PROFILE_THREADS )
+	{
+		count = MAX_PROFILE_THREADS;
+	}
+
+	// thread names
+	dropped = 0;
+	for( i = 0; i < count; i++ )
+	{
+		t = &profileThreads[i];
+		Com_sprintf( line,
+			sizeof( line ),
+			"%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}",
+			profileNumEvents ? ",\n" : "",
+			i,
+			t->name );
+		FS_Write( line, strlen( line ), profileFile );
+		profileNumEvents++;
+		dropped += t->dropped;
+	}
+
+	FS_Write( "\n]}\n", 4, profileFile );
+	FS_FCloseFile( profileFile );
+	profileFile = 0;
+
+	Com_Printf( "wrote %i zones to %s", profileNumEvents - count, profileFileName );
+	if( dropped )
+	{
+		Com_Printf( ", %i dropped on full buffers", dropped );
+	}
+	Com_Printf( "\n" );
+}
+
+/*
+=================
+Com_ProfileFrame
+
+Called at the top of Com_Frame, outside of any zone
+=================
+*/
+void Com_ProfileFrame()
+{
+	profileThread_t* t;
+
+	// an ERR_DROP longjmp leaves the main thread's zones open
+	t = threadProfile;
+	if( t )
+	{
+		t->depth = 0;
+	}
+
+	if( profilePendingFrames )
+	{
+		if( profileFile )
+		{
+			Profile_StopCapture();
+		}
+		Profile_StartCapture();
+		profilePendingFrames = 0;
+		return;
+	}
+
+	if( !profileFile )
+	{
+		return;
+	}
+
+	if( --profileFramesLeft <= 0 )
+	{
+		Profile_StopCapture();
+		return;
+	}
+
+	Profile_Drain();
+}
+
+/*
+=================
+Com_ProfileCapture_f
+=================
+*/
+static void Com_ProfileCapture_f()
+{
+	int frames;
+
+	if( Cmd_Argc() < 2 )
+	{
+		Com_Printf( "usage: profile_capture <frames> [file]\n" );
+		return;
+	}
+
+	frames = atoi( Cmd_Argv( 1 ) );
+	if( frames < 1 )
+	{
+		frames = 1;
+	}
+	else if( frames > 10000 )
+	{
+		frames = 10000;
+	}
+
+	Q_strncpyz( profileFileName, Cmd_Argc() > 2 ? Cmd_Argv( 2 ) : "profile.json", sizeof( profileFileName ) );
+	COM_DefaultExtension( profileFileName, sizeof( profileFileName ), ".json" );
+
+	// starts with the next frame
+	profilePendingFrames = frames;
+}
+
+/*
+=================
+Com_InitProfiler
+=================
+*/
+void Com_InitProfiler()
+{
+	Cmd_AddCommand( "profile_capture", Com_ProfileCapture_f );
+
+	// the main thread is always the first in the trace
+	Profile_GetThread();
+}
+
+/*
+=================
+Com_ShutdownProfiler
+=================
+*/
+void Com_ShutdownProfiler()
+{
+	if( profileFile )
+	{
+		Profile_StopCapture();
+	}
+}
@@ -288,7 +288,9 @@ typedef struct vm_s vm_t;
 
 typedef enum
 {
-	VMI_NATIVE
+	VMI_NATIVE,
+	VMI_BYTECODE,
+	VMI_COMPILED
 } vmInterpret_t;
 
 typedef enum
@@ -311,8 +313,10 @@ typedef enum
 } sharedTraps_t;
 
 void	  VM_Init();
-vm_t*	  VM_Create( const char* module, int ( *systemCalls )( intptr_t* ), vmInterpret_t interpret );
+vm_t*	  VM_Create( const char* module, int ( *systemCalls )( intptr_t* ), const vmApiHeader_t* imports, vmInterpret_t interpret );
 // module should be bare: "cgame", not "cgame.dll" or "vm/cgame.qvm"
+// imports is optional, a dll that exports dllGetAPI and accepts its version
+// gets it, VM_Exports then returns the table the dll handed back
 
 void	  VM_Free( vm_t* vm );
 void	  VM_Clear();
@@ -320,6 +324,19 @@ vm_t*	  VM_Restart( vm_t* vm );
 
 int QDECL VM_Call( vm_t* vm, int callNum, ... );
 
+const vmApiHeader_t* VM_Exports( vm_t* vm );
+const char*			 VM_TypeString( vm_t* vm ); // "native", "interpreted" or "compiled"
+qboolean			 VM_IsNative( vm_t* vm );
+
+// calls through the export table must be bracketed by these, so syscalls
+// made from inside still reach the right module
+vm_t*	  VM_Enter( vm_t* vm );
+void	  VM_Leave( vm_t* oldVM );
+
+// a job runs with the module that added it as the current one
+vm_t*	  VM_Current();
+vm_t*	  VM_SetCurrent( vm_t* vm );
+
 void	  VM_Debug( int level );
 
 void*	  VM_ArgPtr( intptr_t intValue );
@@ -491,6 +508,15 @@ extern int cvar_modifiedFlags;
 // etc, variables have been modified since the last check.  The bit
 // can then be cleared to allow another change detection.
 
+extern int cvar_modificationCount;
+// incremented on every change to any cvar, modules compare it once
+// per frame instead of checking each of their vmCvar_t
+
+cvarHandle_t Cvar_FindHandle( const char* var_name );
+cvar_t*		 Cvar_FromHandle( cvarHandle_t handle );
+void		 Cvar_SetHandle( cvarHandle_t handle, const char* value );
+// handles are indexes into the cvar array, they stay valid for the whole session
+
 /*
 ==============================================================
 
@@ -578,6 +604,13 @@ void		 FS_ForceFlush( fileHandle_t f );
 void		 FS_FreeFile( void* buffer );
 // frees the memory returned by FS_ReadFile
 
+int			 FS_MapFile( const char* qpath, void** buffer );
+// returns the length of a read only copy of the file or -1 if it isn't found,
+// a file outside of a pk3 is mapped and its pages are shared by all processes
+// using it, unlike FS_ReadFile it may be kept as long as needed
+void		 FS_UnmapFile( void* buffer );
+// releases the memory returned by FS_MapFile
+
 void		 FS_WriteFile( const char* qpath, const void* buffer, int size );
 // writes a complete file, creating any subdirectories needed
 
@@ -750,7 +783,10 @@ typedef enum
 	TAG_BOTLIB,
 	TAG_RENDERER,
 	TAG_SMALL,
-	TAG_STATIC
+	TAG_STATIC,
+	TAG_SLAB, // zone internal, holds size class chunks
+
+	TAG_COUNT
 } memtag_t;
 
 /*
@@ -806,6 +842,88 @@ void	 Hunk_Trash();
 
 void	 Com_TouchMemory();
 
+void	 Hunk_SetLabel( const char* label );
+
+// always on memory telemetry, see memstats.c
+#define MEMSTAT_HUNK 1 // rewound by Hunk_ClearToMark / Hunk_Clear
+
+struct memStat_s
+{
+	char		 name[32];
+	int			 flags;
+	volatile int bytes;
+	volatile int peak;
+	volatile int allocs;
+	volatile int frees;
+	int			 markBytes;
+};
+
+memStat_t* Com_RegisterMemStat( const char* name, int flags );
+void	   Com_MemStatAlloc( memStat_t* stat, int bytes );
+void	   Com_MemStatFree( memStat_t* stat, int bytes );
+void	   Com_MemStatSet( memStat_t* stat, int bytes );
+void	   Com_MemStatsMark();
+void	   Com_MemStatsClearToMark( qboolean all );
+void	   Com_InitMemStats();
+void	   Com_ShutdownMemStats();
+void	   Com_MemStatsFrame();
+
+// per thread frame arenas, see arena.c
+void	 Com_InitFrameArenas();
+void	 Com_ShutdownFrameArenas();
+void	 Com_AdvanceFrameArenas();
+void*	 Frame_Alloc( int size );		 // NOT 0 filled memory, valid until the next frame
+void*	 Frame_ClearedAlloc( int size ); // returns 0 filled memory
+int		 Frame_Mark();
+void	 Frame_FreeToMark( int mark );
+
+// zone profiler, see profile.c
+extern volatile int com_profiling;
+
+void				Com_InitProfiler();
+void				Com_ShutdownProfiler();
+void				Com_ProfileFrame();
+void				Com_ProfileThreadName( const char* name );
+void				Com_ProfileBegin( const char* name ); // name must stay valid, use a literal
+void				Com_ProfileBeginCopy( const char* name );
+const char*			Com_ProfileInternName( const char* name );
+void				Com_ProfileEnd();
+
+#define PROFILE_BEGIN( name ) Com_ProfileBegin( name )
+#define PROFILE_END()		  Com_ProfileEnd()
+
+#ifdef __cplusplus
+// closes the zone when the enclosing block is left
+struct profileScope_t
+{
+	profileScope_t( const char* name )
+	{
+		Com_ProfileBegin( name );
+	}
+	~profileScope_t()
+	{
+		Com_ProfileEnd();
+	}
+};
+	#define PROFILE_SCOPE( name ) profileScope_t profileScope( name )
+#endif
+
+// work stealing job system, see jobs.c
+void Com_InitJobs();
+void Com_ShutdownJobs();
+int	 Job_NumWorkers();
+void Job_Add( const char* name, jobFunc_t func, void* data, jobCounter_t* signal );
+void Job_AddAfter( const char* name, jobFunc_t func, void* data, jobCounter_t* signal, jobCounter_t* dependency );
+void Job_Wait( jobCounter_t* counter );
+void Job_ParallelFor( const char* name, int count, int minBatch, jobRangeFunc_t func, void* data );
+
+// log files written by a background thread, see logsink.c
+void Com_InitLogSink();
+void Com_ShutdownLogSink();
+void Com_LogWrite( const void* buffer, int len, fileHandle_t f ); // thread safe
+void Com_LogFlush();
+void Com_LogFlushFile( fileHandle_t f );
+
 // commandLine should not include the executable name (argv[0])
 void	 Com_Init( char* commandLine );
 void	 Com_Frame();
@@ -930,6 +1048,16 @@ typedef struct
 	void*		   evPtr;		// this must be manually freed if not NULL
 } sysEvent_t;
 
+// event journal, see journal.c
+void		 Com_InitJournaling();
+void		 Com_JournalClose();
+void		 Com_JournalWriteEvent( const sysEvent_t* ev );
+void		 Com_JournalReadEvent( sysEvent_t* ev );
+int			 Com_JournalFrame( int frameTime, int msec ); // returns the msec to run
+void		 Com_JournalFinished();
+void		 Com_ReplayPacketTime( long long nsec );
+void		 Com_ReplayServerTick( long long nsec );
+
 sysEvent_t	 Sys_GetEvent();
 
 void		 Sys_Init();
@@ -937,6 +1065,7 @@ void		 Sys_Init();
 // general development dll loading for virtual machine testing
 // fqpath param added 7/20/02 by T.Ray - Sys_LoadDll is only called in vm.c at this time
 void* QDECL	 Sys_LoadDll( const char* name, char* fqpath, int( QDECL** entryPoint )( int, ... ), int( QDECL* systemcalls )( int, ... ) );
+void*		 Sys_DllSymbol( void* dllHandle, const char* name ); // NULL if the dll doesn't export it
 void		 Sys_UnloadDll( void* dllHandle );
 
 void		 Sys_UnloadGame();
@@ -1007,6 +1136,23 @@ void		 Sys_EndProfiling();
 qboolean	 Sys_LowPhysicalMemory();
 unsigned int Sys_ProcessorCount();
 
+void*		 Sys_CreateThread( void ( *function )( void* ), void* data );
+void		 Sys_JoinThread( void* thread );
+void		 Sys_Yield();
+
+void*		 Sys_CreateSemaphore();
+void		 Sys_DestroySemaphore( void* sem );
+void		 Sys_SemaphoreWait( void* sem );
+void		 Sys_SemaphorePost( void* sem, int count );
+
+long long	 Sys_Nanoseconds(); // for profiling only, like Sys_Milliseconds
+
+qboolean	 Sys_StatFile( const char* ospath, int* size, int* mtime );
+
+// read only view of the whole file, NULL if it can't be mapped
+void*		 Sys_MapFile( const char* ospath, int* length );
+void		 Sys_UnmapFile( void* buffer, int length );
+
 int			 Sys_MonkeyShouldBeSpanked();
 
 /* This is based on the Adaptive Huffman algorithm described in Sayood's Data
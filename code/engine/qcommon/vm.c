@@ -30,18 +30,23 @@ symbol table
 a dll has one imported function: VM_SystemCall
 and one exported function: Perform
 
+a dll may also export dllGetAPI, which is handed a table of typed engine
+functions and returns a table of its own, see VM_Create
+
 
 */
 
 #include "vm_local.h"
 
-vm_t* currentVM = NULL; // bk001212
+Q_THREADLOCAL vm_t* currentVM = NULL; // bk001212, per thread so jobs of a module reach it
 vm_t* lastVM	= NULL; // bk001212
 int	  vm_debugLevel;
 
 #define MAX_VM 3
 vm_t  vmTable[MAX_VM];
 
+#define STACK_SIZE 0x20000
+
 void  VM_VmInfo_f();
 void  VM_VmProfile_f();
 
@@ -64,6 +69,7 @@ VM_Init
 */
 void VM_Init()
 {
+	// 0 = native dll, falling back to the qvm, 1 = interpreted qvm, 2 = compiled qvm
 	Cvar_Get( "vm_cgame", "0", CVAR_ARCHIVE ); // !@# SHIP WITH SET TO 2
 	Cvar_Get( "vm_game", "0", CVAR_ARCHIVE );  // !@# SHIP WITH SET TO 2
 	Cvar_Get( "vm_ui", "0", CVAR_ARCHIVE );	   // !@# SHIP WITH SET TO 2
@@ -131,6 +137,130 @@ int QDECL VM_DllSyscall( int arg, ... )
 	return currentVM->systemCall( args );
 }
 
+/*
+=================
+VM_SystemCall
+
+A qvm made a system call, its arguments follow the return address
+on the program stack
+=================
+*/
+int VM_SystemCall( vm_t* vm, int callnum, int programStack )
+{
+	intptr_t args[MAX_VMSYSCALL_ARGS];
+	int		 mask;
+	int		 savedStack;
+	int		 i, r;
+
+	mask	= vm->dataMask & ~3;
+	args[0] = callnum;
+	for( i = 1; i < MAX_VMSYSCALL_ARGS; i++ )
+	{
+		args[i] = *( int* )&vm->dataBase[( programStack + 4 + 4 * i ) & mask];
+	}
+
+	// save the stack to allow recursive VM entry
+	savedStack		 = vm->programStack;
+	vm->programStack = programStack - 4;
+	r				 = vm->systemCall( args );
+	vm->programStack = savedStack;
+
+	return r;
+}
+
+/*
+=================
+VM_BlockCopy
+
+OP_BLOCK_COPY, both ranges have to be inside the image
+=================
+*/
+void VM_BlockCopy( vm_t* vm, int dest, int src, int count )
+{
+	int mask;
+
+	mask = vm->dataMask;
+	if( count < 0 || ( dest & mask ) != dest || ( src & mask ) != src || ( ( dest + count - 1 ) & mask ) != dest + count - 1 || ( ( src + count - 1 ) & mask ) != src + count - 1 )
+	{
+		Com_Error( ERR_DROP, "%s: OP_BLOCK_COPY out of range", vm->name );
+	}
+
+	memmove( vm->dataBase + dest, vm->dataBase + src, count );
+}
+
+/*
+=================
+VM_LoadHeader
+
+Reads and validates vm/<name>.qvm, dataLength gets the size of the image
+the module runs in: data, lit, bss and the program stack, rounded up to
+the next power of 2 so all data operations can be mask protected
+=================
+*/
+static vmHeader_t* VM_LoadHeader( vm_t* vm, int* dataLength )
+{
+	vmHeader_t* header;
+	char		filename[MAX_QPATH];
+	int			length;
+	int			i;
+
+	Com_sprintf( filename, sizeof( filename ), "vm/%s.qvm", vm->name );
+	Com_Printf( "Loading vm file %s.\n", filename );
+	length = FS_ReadFile( filename, ( void** )&header );
+	if( !header )
+	{
+		Com_Printf( "Failed.\n" );
+		return NULL;
+	}
+
+	if( length < sizeof( *header ) )
+	{
+		FS_FreeFile( header );
+		Com_Error( ERR_DROP, "%s is too short", filename );
+	}
+
+	// byte swap the header
+	for( i = 0; i < sizeof( *header ) / 4; i++ )
+	{
+		( ( int* )header )[i] = LittleLong( ( ( int* )header )[i] );
+	}
+
+	// validate
+	if( header->vmMagic != VM_MAGIC || header->bssLength < 0 || header->dataLength < 0 || header->litLength < 0 || header->codeLength <= 0 || header->instructionCount <= 0 || header->instructionCount > header->codeLength || header->codeOffset < 0 || header->codeOffset > length - header->codeLength || header->dataOffset < 0 || header->dataLength > length || header->litLength > length || header->dataOffset > length - header->dataLength - header->litLength || ( header->dataLength & 3 ) || header->bssLength > 0x10000000 )
+	{
+		FS_FreeFile( header );
+		Com_Error( ERR_DROP, "%s has bad header", filename );
+	}
+
+	*dataLength = header->dataLength + header->litLength + header->bssLength + STACK_SIZE;
+	for( i = 0; *dataLength > ( 1 << i ); i++ )
+	{
+	}
+	*dataLength = 1 << i;
+
+	return header;
+}
+
+/*
+=================
+VM_LoadData
+
+Copies the initialized data into the zero filled image
+=================
+*/
+static void VM_LoadData( vm_t* vm, vmHeader_t* header )
+{
+	int i;
+
+	Com_Memcpy( vm->dataBase, ( byte* )header + header->dataOffset, header->dataLength + header->litLength );
+
+	// byte swap the longs
+	for( i = 0; i < header->dataLength; i += 4 )
+	{
+		*( int* )( vm->dataBase + i ) = LittleLong( *( int* )( vm->dataBase + i ) );
+	}
+}
+
 /*
 =================
 VM_Restart
@@ -142,29 +272,92 @@ This allows a server to do a map_restart without changing memory allocation
 vm_t* VM_Restart( vm_t* vm )
 {
 	vmHeader_t* header;
-	int			length;
 	int			dataLength;
-	int			i;
-	char		filename[MAX_QPATH];
 
 	// DLL's can't be restarted in place
 	if( vm->dllHandle )
 	{
 		char name[MAX_QPATH];
-		int ( *systemCall )( int* parms );
+		int ( *systemCall )( intptr_t* parms );
+		const vmApiHeader_t* imports;
 
 		systemCall = vm->systemCall;
+		imports	   = vm->imports;
 		Q_strncpyz( name, vm->name, sizeof( name ) );
 
 		VM_Free( vm );
 
-		vm = VM_Create( name, systemCall, VMI_NATIVE );
+		vm = VM_Create( name, systemCall, imports, VMI_NATIVE );
 		return vm;
 	}
 
-	DebugBreak();
+	// load the image
+	Com_Printf( "VM_Restart()\n" );
+	header = VM_LoadHeader( vm, &dataLength );
+	if( !header )
+	{
+		Com_Error( ERR_DROP, "VM_Restart failed." );
+	}
+	if( dataLength != vm->dataMask + 1 )
+	{
+		FS_FreeFile( header );
+		Com_Error( ERR_DROP, "VM_Restart: %s changed size", vm->name );
+	}
+
+	Com_Memset( vm->dataBase, 0, dataLength );
+	VM_LoadData( vm, header );
+
+	// free the original file
+	FS_FreeFile( header );
 
-	return NULL;
+	vm->programStack = vm->dataMask + 1;
+
+	return vm;
+}
+
+/*
+================
+VM_NegotiateAPI
+
+The dll gets the imports if it exports dllGetAPI and knows their version,
+it answers with an export table of the same version or NULL to keep to
+the syscalls and vmMain
+================
+*/
+static void VM_NegotiateAPI( vm_t* vm, const vmApiHeader_t* imports )
+{
+	const vmApiHeader_t*( QDECL * getAPI )( int version, const vmApiHeader_t* imports );
+	const vmApiHeader_t* exports;
+
+	vm->imports = NULL;
+	vm->exports = NULL;
+
+	if( !imports )
+	{
+		return;
+	}
+
+	getAPI = ( const vmApiHeader_t*( QDECL* )( int, const vmApiHeader_t* ) )Sys_DllSymbol( vm->dllHandle, "dllGetAPI" );
+	if( !getAPI )
+	{
+		Com_Printf( "%s uses the syscall interface\n", vm->name );
+		return;
+	}
+
+	exports = getAPI( imports->version, imports );
+	if( !exports )
+	{
+		Com_Printf( "%s refused direct call API version %i\n", vm->name, imports->version );
+		return;
+	}
+	if( exports->version != imports->version )
+	{
+		Com_Error( ERR_FATAL, "%s answered direct call API version %i with version %i", vm->name, imports->version, exports->version );
+	}
+
+	vm->imports = imports;
+	vm->exports = exports;
+	Com_Printf( "%s uses direct call API version %i\n", vm->name, imports->version );
 }
 
 /*
@@ -175,17 +368,12 @@ If image ends in .qvm it will be interpreted, otherwise
 it will attempt to load as a system dll
 ================
 */
-
-#define STACK_SIZE 0x20000
-
-vm_t* VM_Create( const char* module, int ( *systemCalls )( intptr_t* ), vmInterpret_t interpret )
+vm_t* VM_Create( const char* module, int ( *systemCalls )( intptr_t* ), const vmApiHeader_t* imports, vmInterpret_t interpret )
 {
 	vm_t*		vm;
 	vmHeader_t* header;
-	int			length;
 	int			dataLength;
 	int			i, remaining;
-	char		filename[MAX_QPATH];
 
 	if( !module || !module[0] || !systemCalls )
 	{
@@ -223,17 +411,59 @@ vm_t* VM_Create( const char* module, int ( *systemCalls )( intptr_t* ), vmInterp
 	Q_strncpyz( vm->name, module, sizeof( vm->name ) );
 	vm->systemCall = systemCalls;
 
-	// try to load as a system dll
-	Com_Printf( "Loading dll file %s.\n", vm->name );
-	vm->dllHandle = Sys_LoadDll( module, vm->fqpath, &vm->entryPoint, VM_DllSyscall );
-	if( vm->dllHandle )
+	// never allow dll loading with a demo
+	if( interpret == VMI_NATIVE && Cvar_VariableValue( "fs_restrict" ) )
 	{
-		return vm;
+		interpret = VMI_COMPILED;
 	}
 
-	Com_Error( ERR_FATAL, "Failed to load DLL %s\n", vm->name );
+	if( interpret == VMI_NATIVE )
+	{
+		// try to load as a system dll
+		Com_Printf( "Loading dll file %s.\n", vm->name );
+		vm->dllHandle = Sys_LoadDll( module, vm->fqpath, &vm->entryPoint, VM_DllSyscall );
+		if( vm->dllHandle )
+		{
+			VM_NegotiateAPI( vm, imports );
+			return vm;
+		}
+
+		Com_Printf( "Failed to load dll, looking for qvm.\n" );
+		interpret = VMI_COMPILED;
+	}
 
-	return NULL;
+	// load the image
+	header = VM_LoadHeader( vm, &dataLength );
+	if( !header )
+	{
+		VM_Free( vm );
+		return NULL;
+	}
+
+	// allocate zero filled space for initialized and uninitialized data
+	vm->dataBase = Hunk_Alloc( dataLength, h_high );
+	vm->dataMask = dataLength - 1;
+	VM_LoadData( vm, header );
+
+	// the stack is implicitly at the end of the image
+	vm->programStack = vm->dataMask + 1;
+	vm->stackBottom	 = vm->programStack - STACK_SIZE;
+
+	// decode the instructions, then compile them if asked to
+	VM_PrepareInterpreter( vm, header );
+
+	vm->compiled = qfalse;
+	if( interpret >= VMI_COMPILED )
+	{
+		vm->compiled = VM_Compile( vm, header );
+	}
+
+	// free the original file
+	FS_FreeFile( header );
+
+	Com_Printf( "%s loaded in %d bytes on the hunk, %s\n", module, remaining - Hunk_MemoryRemaining(), VM_TypeString( vm ) );
+
+	return vm;
 }
 
 /*
@@ -243,6 +473,10 @@ VM_Free
 */
 void VM_Free( vm_t* vm )
 {
+	if( vm->destroy )
+	{
+		vm->destroy( vm );
+	}
 	if( vm->dllHandle )
 	{
 		Sys_UnloadDll( vm->dllHandle );
@@ -273,6 +507,10 @@ void VM_Clear()
 	int i;
 	for( i = 0; i < MAX_VM; i++ )
 	{
+		if( vmTable[i].destroy )
+		{
+			vmTable[i].destroy( &vmTable[i] );
+		}
 		if( vmTable[i].dllHandle )
 		{
 			Sys_UnloadDll( vmTable[i].dllHandle );
@@ -360,7 +598,7 @@ int QDECL VM_Call( vm_t* vm, int callnum, ... )
 	vm_t*	oldVM;
 	int		r;
 	int		i;
-	int		args[16];
+	int		args[17];
 	va_list ap;
 
 	if( !vm )
@@ -377,16 +615,28 @@ int QDECL VM_Call( vm_t* vm, int callnum, ... )
 		Com_Printf( "VM_Call( %i )\n", callnum );
 	}
 
-	// if we have a dll loaded, call it directly
 	// rcg010207 -  see dissertation at top of VM_DllSyscall() in this file.
+	args[0] = callnum;
 	va_start( ap, callnum );
-	for( i = 0; i < sizeof( args ) / sizeof( args[i] ); i++ )
+	for( i = 1; i < sizeof( args ) / sizeof( args[i] ); i++ )
 	{
 		args[i] = va_arg( ap, int );
 	}
 	va_end( ap );
 
-	r = vm->entryPoint( callnum, args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7], args[8], args[9], args[10], args[11], args[12], args[13], args[14], args[15] );
+	// if we have a dll loaded, call it directly
+	if( vm->entryPoint )
+	{
+		r = vm->entryPoint( callnum, args[1], args[2], args[3], args[4], args[5], args[6], args[7], args[8], args[9], args[10], args[11], args[12], args[13], args[14], args[15], args[16] );
+	}
+	else if( vm->compiled )
+	{
+		r = VM_CallCompiled( vm, args );
+	}
+	else
+	{
+		r = VM_CallInterpreted( vm, args );
+	}
 
 	if( oldVM != NULL ) // bk001220 - assert(currentVM!=NULL) for oldVM==NULL
 	{
@@ -395,6 +645,100 @@ int QDECL VM_Call( vm_t* vm, int callnum, ... )
 	return r;
 }
 
+/*
+==============
+VM_Exports
+
+The table the dll returned from dllGetAPI, NULL if it doesn't have one
+==============
+*/
+const vmApiHeader_t* VM_Exports( vm_t* vm )
+{
+	return vm ? vm->exports : NULL;
+}
+
+/*
+==============
+VM_TypeString
+==============
+*/
+const char* VM_TypeString( vm_t* vm )
+{
+	if( vm->dllHandle )
+	{
+		return "native";
+	}
+	return vm->compiled ? "compiled" : "interpreted";
+}
+
+/*
+==============
+VM_IsNative
+
+qtrue if the module is a dll, only then are its pointers native code
+==============
+*/
+qboolean VM_IsNative( vm_t* vm )
+{
+	return vm && vm->dllHandle;
+}
+
+/*
+==============
+VM_Current
+
+The module whose syscalls this thread is serving
+==============
+*/
+vm_t* VM_Current()
+{
+	return currentVM;
+}
+
+/*
+==============
+VM_SetCurrent
+
+Unlike VM_Leave this restores NULL as well, a job worker starts out with none
+==============
+*/
+vm_t* VM_SetCurrent( vm_t* vm )
+{
+	vm_t* oldVM;
+
+	oldVM	  = currentVM;
+	currentVM = vm;
+	return oldVM;
+}
+
+/*
+==============
+VM_Enter
+==============
+*/
+vm_t* VM_Enter( vm_t* vm )
+{
+	vm_t* oldVM;
+
+	oldVM	  = currentVM;
+	currentVM = vm;
+	lastVM	  = vm;
+	return oldVM;
+}
+
+/*
+==============
+VM_Leave
+==============
+*/
+void VM_Leave( vm_t* oldVM )
+{
+	if( oldVM != NULL ) // same as VM_Call
+	{
+		currentVM = oldVM;
+	}
+}
+
 //=================================================================
 
 static int QDECL VM_ProfileSort( const void* a, const void* b )
@@ -489,19 +833,26 @@ void VM_VmInfo_f()
 		Com_Printf( "%s : ", vm->name );
 		if( vm->dllHandle )
 		{
-			Com_Printf( "native\n" );
+			if( vm->exports )
+			{
+				Com_Printf( "native, direct call API version %i\n", vm->exports->version );
+			}
+			else
+			{
+				Com_Printf( "native\n" );
+			}
 			continue;
 		}
 		if( vm->compiled )
 		{
 			Com_Printf( "compiled on load\n" );
+			Com_Printf( "    native code : %7i\n", vm->codeLength );
 		}
 		else
 		{
 			Com_Printf( "interpreted\n" );
 		}
-		Com_Printf( "    code length : %7i\n", vm->codeLength );
-		Com_Printf( "    table length: %7i\n", vm->instructionPointersLength );
+		Com_Printf( "    instructions: %7i\n", vm->instructionCount );
 		Com_Printf( "    data length : %7i\n", vm->dataMask + 1 );
 	}
 }
@@ -526,13 +877,14 @@ void VM_LogSyscalls( int* args )
 	fprintf( f, "%i: %i (%i) = %i %i %i %i\n", callnum, args - ( int* )currentVM->dataBase, args[0], args[1], args[2], args[3], args[4] );
 }
 
-#ifdef oDLL_ONLY // bk010215 - for DLL_ONLY dedicated servers/builds w/o VM
+#ifndef VM_HAVE_COMPILER // every qvm is interpreted
 int VM_CallCompiled( vm_t* vm, int* args )
 {
-	return ( 0 );
+	return VM_CallInterpreted( vm, args );
 }
 
-void VM_Compile( vm_t* vm, vmHeader_t* header )
+qboolean VM_Compile( vm_t* vm, vmHeader_t* header )
 {
+	return qfalse;
 }
-#endif // DLL_ONLY
+#endif // VM_HAVE_COMPILER
@@ -0,0 +1,576 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// vm_interpreted.c -- qvm bytecode decoder and interpreter
+
+#include "vm_local.h"
+
+/*
+==============================================================================
+
+QVM INTERPRETER
+
+The code segment is decoded once into a vmInstruction_t per instruction,
+branch targets stay instruction numbers. Every data access is masked into
+the image, 4 and 2 byte ones also to their alignment, and the operand stack
+index is a byte that wraps inside the operand stack, so no qvm can reach
+memory outside of its own. The compiler follows the same rules, a module
+behaves the same interpreted or compiled.
+
+A call saves the return instruction at programStack, the callee finds its
+parameters from programStack + 8 on, where OP_ARG put them. System calls
+get the same parameters, see VM_SystemCall.
+==============================================================================
+*/
+
+#define OPSTACK_SIZE 256 // opStackOfs is a byte
+
+/*
+====================
+VM_PrepareInterpreter
+
+Decodes and checks the code segment, the compiler works from the
+same instructions
+====================
+*/
+void VM_PrepareInterpreter( vm_t* vm, vmHeader_t* header )
+{
+	vmInstruction_t* ins;
+	byte*			 code;
+	int				 pc, i;
+
+	vm->instructionCount = header->instructionCount;
+	vm->instructions	 = Hunk_Alloc( vm->instructionCount * sizeof( *vm->instructions ), h_high );
+
+	code = ( byte* )header + header->codeOffset;
+	pc	 = 0;
+
+	for( i = 0; i < vm->instructionCount; i++ )
+	{
+		ins = &vm->instructions[i];
+
+		if( pc >= header->codeLength )
+		{
+			Com_Error( ERR_DROP, "%s: code ends at instruction %i of %i", vm->name, i, vm->instructionCount );
+		}
+
+		ins->op	   = code[pc++];
+		ins->value = 0;
+
+		if( ins->op > OP_CVFI )
+		{
+			Com_Error( ERR_DROP, "%s: bad opcode %i at instruction %i", vm->name, ins->op, i );
+		}
+
+		// these are the only opcodes that aren't a single byte
+		switch( ins->op )
+		{
+			case OP_ENTER:
+			case OP_CONST:
+			case OP_LOCAL:
+			case OP_LEAVE:
+			case OP_EQ:
+			case OP_NE:
+			case OP_LTI:
+			case OP_LEI:
+			case OP_GTI:
+			case OP_GEI:
+			case OP_LTU:
+			case OP_LEU:
+			case OP_GTU:
+			case OP_GEU:
+			case OP_EQF:
+			case OP_NEF:
+			case OP_LTF:
+			case OP_LEF:
+			case OP_GTF:
+			case OP_GEF:
+			case OP_BLOCK_COPY:
+				if( pc + 4 > header->codeLength )
+				{
+					Com_Error( ERR_DROP, "%s: code ends inside instruction %i", vm->name, i );
+				}
+				ins->value = code[pc] | ( code[pc + 1] << 8 ) | ( code[pc + 2] << 16 ) | ( code[pc + 3] << 24 );
+				pc += 4;
+				break;
+
+			case OP_ARG:
+				if( pc + 1 > header->codeLength )
+				{
+					Com_Error( ERR_DROP, "%s: code ends inside instruction %i", vm->name, i );
+				}
+				ins->value = code[pc];
+				pc += 1;
+				break;
+
+			default:
+				break;
+		}
+
+		if( ins->op >= OP_EQ && ins->op <= OP_GEF && ( ins->value < 0 || ins->value >= vm->instructionCount ) )
+		{
+			Com_Error( ERR_DROP, "%s: branch out of the code at instruction %i", vm->name, i );
+		}
+	}
+}
+
+/*
+==============
+VM_CallInterpreted
+
+args[0] is the command, the rest its parameters
+==============
+*/
+// clang-format off
+#define R0	( opStack[opStackOfs] )
+#define R1	( opStack[( byte )( opStackOfs - 1 )] )
+#define F0	( ( ( float* )opStack )[opStackOfs] )
+#define F1	( ( ( float* )opStack )[( byte )( opStackOfs - 1 )] )
+// clang-format on
+
+int VM_CallInterpreted( vm_t* vm, int* args )
+{
+	int				 opStack[OPSTACK_SIZE];
+	byte			 opStackOfs;
+	vmInstruction_t* code;
+	vmInstruction_t* ins;
+	byte*			 image;
+	int				 mask1, mask2, mask4;
+	int				 programStack;
+	int				 stackOnEntry;
+	int				 programCounter;
+	int				 count;
+	int				 i, r;
+
+	// interpret the code
+	vm->currentlyInterpreting = qtrue;
+
+	// we might be called recursively, so this might not be the very top
+	programStack = stackOnEntry = vm->programStack;
+
+	image = vm->dataBase;
+	code  = vm->instructions;
+	count = vm->instructionCount;
+	mask1 = vm->dataMask;
+	mask2 = vm->dataMask & ~1;
+	mask4 = vm->dataMask & ~3;
+
+	// set up the stack frame
+	programStack -= 8 + 4 * MAX_VMMAIN_ARGS;
+	for( i = 0; i < MAX_VMMAIN_ARGS; i++ )
+	{
+		*( int* )&image[( programStack + 8 + 4 * i ) & mask4] = args[i];
+	}
+	*( int* )&image[( programStack + 4 ) & mask4] = 0;	// return stack
+	*( int* )&image[programStack & mask4]		  = -1; // will terminate the loop on return
+
+	opStackOfs	   = 0;
+	opStack[0]	   = 0;
+	programCounter = 0;
+
+	while( 1 )
+	{
+		if( ( unsigned )programCounter >= ( unsigned )count )
+		{
+			Com_Error( ERR_DROP, "%s: program counter out of range", vm->name );
+		}
+		ins = &code[programCounter++];
+
+		switch( ins->op )
+		{
+			case OP_UNDEF:
+			case OP_BREAK:
+				Com_Error( ERR_DROP, "%s: break at instruction %i", vm->name, programCounter - 1 );
+				break;
+
+			case OP_IGNORE:
+				break;
+
+			case OP_ENTER:
+				programStack -= ins->value;
+				if( programStack < vm->stackBottom )
+				{
+					Com_Error( ERR_DROP, "%s: stack overflow", vm->name );
+				}
+				break;
+
+			case OP_LEAVE:
+				// remove our stack frame
+				programStack += ins->value;
+
+				// grab the saved program counter
+				programCounter = *( int* )&image[programStack & mask4];
+
+				// check for leaving the VM
+				if( programCounter == -1 )
+				{
+					r = R0;
+					vm->programStack		  = stackOnEntry;
+					vm->currentlyInterpreting = qfalse;
+					return r;
+				}
+				break;
+
+			case OP_CALL:
+				// save current program counter
+				*( int* )&image[programStack & mask4] = programCounter;
+
+				// jump to the location on the stack
+				if( R0 < 0 )
+				{
+					// system call, the return value replaces the address
+					R0 = VM_SystemCall( vm, -1 - R0, programStack );
+				}
+				else
+				{
+					programCounter = R0;
+					opStackOfs--;
+				}
+				break;
+
+			case OP_PUSH:
+				opStackOfs++;
+				R0 = 0;
+				break;
+
+			case OP_POP:
+				opStackOfs--;
+				break;
+
+			case OP_CONST:
+				opStackOfs++;
+				R0 = ins->value;
+				break;
+
+			case OP_LOCAL:
+				opStackOfs++;
+				R0 = ins->value + programStack;
+				break;
+
+			case OP_JUMP:
+				programCounter = R0;
+				opStackOfs--;
+				break;
+
+			case OP_EQ:
+				if( R1 == R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_NE:
+				if( R1 != R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_LTI:
+				if( R1 < R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_LEI:
+				if( R1 <= R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_GTI:
+				if( R1 > R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_GEI:
+				if( R1 >= R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_LTU:
+				if( ( unsigned )R1 < ( unsigned )R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_LEU:
+				if( ( unsigned )R1 <= ( unsigned )R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_GTU:
+				if( ( unsigned )R1 > ( unsigned )R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_GEU:
+				if( ( unsigned )R1 >= ( unsigned )R0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_EQF:
+				if( F1 == F0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_NEF:
+				if( F1 != F0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_LTF:
+				if( F1 < F0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_LEF:
+				if( F1 <= F0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_GTF:
+				if( F1 > F0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			case OP_GEF:
+				if( F1 >= F0 )
+				{
+					programCounter = ins->value;
+				}
+				opStackOfs -= 2;
+				break;
+
+			//===================================================================
+
+			case OP_LOAD1:
+				R0 = image[R0 & mask1];
+				break;
+
+			case OP_LOAD2:
+				R0 = *( unsigned short* )&image[R0 & mask2];
+				break;
+
+			case OP_LOAD4:
+				R0 = *( int* )&image[R0 & mask4];
+				break;
+
+			case OP_STORE1:
+				image[R1 & mask1] = R0;
+				opStackOfs -= 2;
+				break;
+
+			case OP_STORE2:
+				*( short* )&image[R1 & mask2] = R0;
+				opStackOfs -= 2;
+				break;
+
+			case OP_STORE4:
+				*( int* )&image[R1 & mask4] = R0;
+				opStackOfs -= 2;
+				break;
+
+			case OP_ARG:
+				// single byte offset from programStack
+				*( int* )&image[( ins->value + programStack ) & mask4] = R0;
+				opStackOfs--;
+				break;
+
+			case OP_BLOCK_COPY:
+				VM_BlockCopy( vm, R1, R0, ins->value );
+				opStackOfs -= 2;
+				break;
+
+			case OP_SEX8:
+				R0 = ( signed char )R0;
+				break;
+
+			case OP_SEX16:
+				R0 = ( short )R0;
+				break;
+
+			case OP_NEGI:
+				R0 = -( unsigned )R0;
+				break;
+
+			case OP_ADD:
+				R1 = ( unsigned )R1 + ( unsigned )R0;
+				opStackOfs--;
+				break;
+
+			case OP_SUB:
+				R1 = ( unsigned )R1 - ( unsigned )R0;
+				opStackOfs--;
+				break;
+
+			case OP_DIVI:
+				if( !R0 )
+				{
+					Com_Error( ERR_DROP, "%s: divide by zero", vm->name );
+				}
+				// INT_MIN / -1 would trap
+				R1 = R0 == -1 ? -( unsigned )R1 : R1 / R0;
+				opStackOfs--;
+				break;
+
+			case OP_DIVU:
+				if( !R0 )
+				{
+					Com_Error( ERR_DROP, "%s: divide by zero", vm->name );
+				}
+				R1 = ( unsigned )R1 / ( unsigned )R0;
+				opStackOfs--;
+				break;
+
+			case OP_MODI:
+				if( !R0 )
+				{
+					Com_Error( ERR_DROP, "%s: divide by zero", vm->name );
+				}
+				R1 = R0 == -1 ? 0 : R1 % R0;
+				opStackOfs--;
+				break;
+
+			case OP_MODU:
+				if( !R0 )
+				{
+					Com_Error( ERR_DROP, "%s: divide by zero", vm->name );
+				}
+				R1 = ( unsigned )R1 % ( unsigned )R0;
+				opStackOfs--;
+				break;
+
+			case OP_MULI:
+			case OP_MULU:
+				R1 = ( unsigned )R1 * ( unsigned )R0;
+				opStackOfs--;
+				break;
+
+			case OP_BAND:
+				R1 &= R0;
+				opStackOfs--;
+				break;
+
+			case OP_BOR:
+				R1 |= R0;
+				opStackOfs--;
+				break;
+
+			case OP_BXOR:
+				R1 ^= R0;
+				opStackOfs--;
+				break;
+
+			case OP_BCOM:
+				R0 = ~R0;
+				break;
+
+			// shift counts are taken modulo 32, like the x86 does
+			case OP_LSH:
+				R1 = ( unsigned )R1 << ( R0 & 31 );
+				opStackOfs--;
+				break;
+
+			case OP_RSHI:
+				R1 >>= ( R0 & 31 );
+				opStackOfs--;
+				break;
+
+			case OP_RSHU:
+				R1 = ( unsigned )R1 >> ( R0 & 31 );
+				opStackOfs--;
+				break;
+
+			case OP_NEGF:
+				R0 ^= 0x80000000;
+				break;
+
+			case OP_ADDF:
+				F1 = F1 + F0;
+				opStackOfs--;
+				break;
+
+			case OP_SUBF:
+				F1 = F1 - F0;
+				opStackOfs--;
+				break;
+
+			case OP_DIVF:
+				F1 = F1 / F0;
+				opStackOfs--;
+				break;
+
+			case OP_MULF:
+				F1 = F1 * F0;
+				opStackOfs--;
+				break;
+
+			case OP_CVIF:
+				F0 = ( float )R0;
+				break;
+
+			case OP_CVFI:
+				R0 = ( int )F0;
+				break;
+		}
+	}
+
+	return 0;
+}
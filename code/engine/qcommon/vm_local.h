@@ -112,6 +112,22 @@ typedef enum
 
 typedef int vmptr_t;
 
+#define MAX_VMMAIN_ARGS	   13 // the command and 12 parameters
+#define MAX_VMSYSCALL_ARGS 16
+
+// the x86-64 compiler, other builds interpret
+#if ( defined( _M_X64 ) || defined( __x86_64__ ) ) && !defined( C_ONLY )
+	#define VM_HAVE_COMPILER
+#endif
+
+// the code segment decoded into one entry per instruction, branch
+// targets are instruction numbers
+typedef struct
+{
+	int op;
+	int value;
+} vmInstruction_t;
+
 typedef struct vmSymbol_s
 {
 	struct vmSymbol_s* next;
@@ -138,12 +154,21 @@ struct vm_s
 	void* dllHandle;
 	int( QDECL* entryPoint )( int callNum, ... );
 
+	// typed call tables, if the dll took the imports
+	const vmApiHeader_t* imports;
+	const vmApiHeader_t* exports;
+
 	// for interpreted modules
 	qboolean		   currentlyInterpreting;
 
+	vmInstruction_t*   instructions;
+	int				   instructionCount;
+
 	qboolean		   compiled;
-	byte*			   codeBase;
+	byte*			   codeBase; // native code of a compiled module
 	int				   codeLength;
+	void*			   compiledState;
+	void ( *destroy )( vm_t* self ); // releases what the compiler allocated
 
 	int*			   instructionPointers;
 	int				   instructionPointersLength;
@@ -164,15 +189,18 @@ struct vm_s
 	char			   fqpath[MAX_QPATH + 1];
 };
 
-extern vm_t* currentVM;
+extern Q_THREADLOCAL vm_t* currentVM;
 extern int	 vm_debugLevel;
 
-void		 VM_Compile( vm_t* vm, vmHeader_t* header );
+qboolean	 VM_Compile( vm_t* vm, vmHeader_t* header ); // qfalse leaves the module to the interpreter
 int			 VM_CallCompiled( vm_t* vm, int* args );
 
 void		 VM_PrepareInterpreter( vm_t* vm, vmHeader_t* header );
 int			 VM_CallInterpreted( vm_t* vm, int* args );
 
+int			 VM_SystemCall( vm_t* vm, int callnum, int programStack );
+void		 VM_BlockCopy( vm_t* vm, int dest, int src, int count );
+
 vmSymbol_t*	 VM_ValueToFunctionSymbol( vm_t* vm, int value );
 int			 VM_SymbolToValue( vm_t* vm, const char* symbol );
 const char*	 VM_ValueToSymbol( vm_t* vm, int value );
@@ -0,0 +1,1674 @@
+/*
+===========================================================================
+Copyright (C) 1999-2005 Id Software, Inc.
+
+This file is part of Quake III Arena source code.
+
+Quake III Arena source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+Quake III Arena source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+// vm_x86_64.c -- x86-64 qvm compiler
+
+#include "vm_local.h"
+
+#ifdef VM_HAVE_COMPILER
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+#endif
+
+/*
+==============================================================================
+
+X86-64 QVM COMPILER
+
+The decoded instructions are translated one to one into native code. The
+operand stack never reaches memory: before compiling, every instruction
+gets the depth the operand stack has when it runs, which is the same on
+every path to it, and the operand at each depth has a fixed home, one of
+eight registers or past those a slot in vmCompiled_t. A constant or a LOCAL
+address is only materialized once an instruction needs it in a register,
+so most loads, stores and arithmetic on them take an immediate or a
+displacement instead.
+
+lcc only leaves values on the operand stack inside an expression, every
+branch target, function entry and the instruction after a jump or return
+have an empty operand stack. A module that doesn't hold to that, or runs
+the operand stack deeper than MAX_COMPILED_DEPTH, isn't compiled and stays
+with the interpreter.
+
+	r12		image base
+	r13d	programStack
+	r14		vmCompiled_t
+	rbx ..	operand stack homes, the return value comes back in rbx
+
+A qvm call is a native call, so the return address is on the native stack
+and the return instruction of the interpreter isn't stored in the image.
+Operands below the call are pushed around it. A system call calls
+VM_SystemCall through a helper and gets the same arguments as from the
+interpreter. Data access is masked exactly as in vm_interpreted.c and
+division by zero, bad jumps and stack overflows go to an error stub that
+calls Com_Error, so a module fails the same way compiled or interpreted.
+Recursion is bounded by the native stack as well as the program stack,
+running out of either is the same stack overflow the interpreter reports.
+==============================================================================
+*/
+
+#define MAX_COMPILED_DEPTH	64
+#define NUM_SLOT_REGS		8
+#define NUM_SAVED_SLOT_REGS 3 // rbx, rbp and r15 survive a call into C on both ABIs
+#define NATIVE_STACK_BUDGET ( 256 * 1024 )
+
+enum
+{
+	REG_RAX,
+	REG_RCX,
+	REG_RDX,
+	REG_RBX,
+	REG_RSP,
+	REG_RBP,
+	REG_RSI,
+	REG_RDI,
+	REG_R8,
+	REG_R9,
+	REG_R10,
+	REG_R11,
+	REG_R12,
+	REG_R13,
+	REG_R14,
+	REG_R15
+};
+
+#define REG_IMAGE REG_R12
+#define REG_STACK REG_R13
+#define REG_STATE REG_R14
+
+static const int slotRegs[NUM_SLOT_REGS] = { REG_RBX, REG_RBP, REG_R15, REG_RSI, REG_RDI, REG_R8, REG_R9, REG_R10 };
+
+#ifdef _WIN32
+static const int argRegs[4] = { REG_RCX, REG_RDX, REG_R8, REG_R9 };
+#else
+static const int argRegs[4] = { REG_RDI, REG_RSI, REG_RDX, REG_RCX };
+#endif
+#define SHADOW_SPACE 32 // only Win64 needs it, keeping it everywhere costs nothing
+
+typedef enum
+{
+	VMERR_JUMP,
+	VMERR_CALL,
+	VMERR_STACK,
+	VMERR_DIVIDE,
+	VMERR_BREAK,
+	VMERR_END,
+
+	VMERR_NUM
+} vmError_t;
+
+static const char* vmErrorStrings[VMERR_NUM] = {
+	"jump out of the code",
+	"call out of the code",
+	"stack overflow",
+	"divide by zero",
+	"break instruction",
+	"ran off the end of the code",
+};
+
+struct vmCompiled_s;
+typedef int ( *vmEntry_t )( struct vmCompiled_s* state, byte* image, int programStack, void* target );
+
+// read by the generated code through r14
+typedef struct vmCompiled_s
+{
+	void**	  jumpTable; // native address of every instruction, the error stub where that can't be entered
+	byte*	  stackLimit;
+	int		  stackBottom;
+	int		  pad;
+	long long slots[MAX_COMPILED_DEPTH];
+
+	vmEntry_t entry;
+	int		  codeSize;
+} vmCompiled_t;
+
+// where an operand is while compiling
+typedef enum
+{
+	SLOT_REG,	// in its home
+	SLOT_CONST, // the constant in slotValue
+	SLOT_LOCAL	// programStack + slotValue
+} slotKind_t;
+
+static byte*	  buf; // NULL while measuring
+static int		  compiledOfs;
+static int*		  instructionOffsets;
+static int*		  instructionDepths;
+static int		  errorOffsets[VMERR_NUM];
+static int		  instructionCount;
+static int		  mask1, mask2, mask4;
+
+static slotKind_t slotKind[MAX_COMPILED_DEPTH];
+static int		  slotValue[MAX_COMPILED_DEPTH];
+
+/*
+==============================================================================
+
+HELPERS CALLED FROM COMPILED CODE
+
+==============================================================================
+*/
+
+static void VM_CompiledError( int error )
+{
+	Com_Error( ERR_DROP, "%s: %s", currentVM->name, vmErrorStrings[error] );
+}
+
+static int VM_CompiledSystemCall( int callnum, int programStack )
+{
+	return VM_SystemCall( currentVM, callnum, programStack );
+}
+
+static void VM_CompiledBlockCopy( int dest, int src, int count )
+{
+	VM_BlockCopy( currentVM, dest, src, count );
+}
+
+/*
+==============================================================================
+
+INSTRUCTION ENCODING
+
+==============================================================================
+*/
+
+#define REX_W	 1
+#define REX_BYTE 2 // the low byte of rsp, rbp, rsi or rdi is used
+
+#define JCC_B  0x0F82
+#define JCC_AE 0x0F83
+#define JCC_E  0x0F84
+#define JCC_NE 0x0F85
+#define JCC_BE 0x0F86
+#define JCC_A  0x0F87
+#define JCC_P  0x0F8A
+#define JCC_L  0x0F8C
+#define JCC_GE 0x0F8D
+#define JCC_LE 0x0F8E
+#define JCC_G  0x0F8F
+#define JMP	   0xE9
+#define CALL   0xE8
+
+// the /digit of the group 1 immediate instructions and their register forms
+#define ALU_ADD 0
+#define ALU_OR	1
+#define ALU_AND 4
+#define ALU_SUB 5
+#define ALU_XOR 6
+#define ALU_CMP 7
+
+static const int aluOpcodes[8] = { 0x01, 0x09, 0, 0, 0x21, 0x29, 0x31, 0x39 };
+
+static void Emit1( int v )
+{
+	if( buf )
+	{
+		buf[compiledOfs] = v;
+	}
+	compiledOfs++;
+}
+
+static void Emit4( int v )
+{
+	Emit1( v & 255 );
+	Emit1( ( v >> 8 ) & 255 );
+	Emit1( ( v >> 16 ) & 255 );
+	Emit1( ( v >> 24 ) & 255 );
+}
+
+static void Emit8( long long v )
+{
+	Emit4( ( int )v );
+	Emit4( ( int )( v >> 32 ) );
+}
+
+static void EmitOpcode( int opcode )
+{
+	if( opcode > 0xFFFF )
+	{
+		Emit1( opcode >> 16 );
+	}
+	if( opcode > 0xFF )
+	{
+		Emit1( ( opcode >> 8 ) & 255 );
+	}
+	Emit1( opcode & 255 );
+}
+
+static void EmitRex( int flags, int reg, int index, int base )
+{
+	int rex;
+
+	rex = 0x40;
+	if( flags & REX_W )
+	{
+		rex |= 8;
+	}
+	if( reg & 8 )
+	{
+		rex |= 4;
+	}
+	if( index & 8 )
+	{
+		rex |= 2;
+	}
+	if( base & 8 )
+	{
+		rex |= 1;
+	}
+
+	if( rex != 0x40 || ( flags & REX_BYTE ) )
+	{
+		Emit1( rex );
+	}
+}
+
+/*
+=================
+EmitRR
+
+opcode reg, rm with both operands registers
+=================
+*/
+static void EmitRR( int prefix, int flags, int opcode, int reg, int rm )
+{
+	if( prefix )
+	{
+		Emit1( prefix );
+	}
+	EmitRex( flags, reg, 0, rm );
+	EmitOpcode( opcode );
+	Emit1( 0xC0 | ( ( reg & 7 ) << 3 ) | ( rm & 7 ) );
+}
+
+/*
+=================
+EmitRM
+
+opcode reg, [base + index * ( 1 << scale ) + disp], index -1 for none
+=================
+*/
+static void EmitRM( int prefix, int flags, int opcode, int reg, int base, int index, int scale, int disp )
+{
+	int mod;
+
+	if( prefix )
+	{
+		Emit1( prefix );
+	}
+	EmitRex( flags, reg, index < 0 ? 0 : index, base );
+	EmitOpcode( opcode );
+
+	// rbp and r13 have no form without a displacement
+	if( !disp && ( base & 7 ) != REG_RBP )
+	{
+		mod = 0;
+	}
+	else if( disp >= -128 && disp <= 127 )
+	{
+		mod = 1;
+	}
+	else
+	{
+		mod = 2;
+	}
+
+	if( index < 0 && ( base & 7 ) != REG_RSP )
+	{
+		Emit1( ( mod << 6 ) | ( ( reg & 7 ) << 3 ) | ( base & 7 ) );
+	}
+	else
+	{
+		Emit1( ( mod << 6 ) | ( ( reg & 7 ) << 3 ) | 4 );
+		Emit1( ( scale << 6 ) | ( ( index < 0 ? REG_RSP : index ) & 7 ) << 3 | ( base & 7 ) );
+	}
+
+	if( mod == 1 )
+	{
+		Emit1( disp & 255 );
+	}
+	else if( mod == 2 )
+	{
+		Emit4( disp );
+	}
+}
+
+static void EmitMovRR( int dst, int src )
+{
+	if( dst != src )
+	{
+		EmitRR( 0, 0, 0x89, src, dst );
+	}
+}
+
+static void EmitMovRI( int dst, int imm )
+{
+	if( !imm )
+	{
+		EmitRR( 0, 0, 0x31, dst, dst );
+		return;
+	}
+	EmitRex( 0, 0, 0, dst );
+	Emit1( 0xB8 + ( dst & 7 ) );
+	Emit4( imm );
+}
+
+static void EmitMovRPtr( int dst, void* ptr )
+{
+	EmitRex( REX_W, 0, 0, dst );
+	Emit1( 0xB8 + ( dst & 7 ) );
+	Emit8( ( long long )( intptr_t )ptr );
+}
+
+static void EmitAluRR( int alu, int dst, int src )
+{
+	EmitRR( 0, 0, aluOpcodes[alu], src, dst );
+}
+
+static void EmitAluRI( int alu, int dst, int imm )
+{
+	if( imm >= -128 && imm <= 127 )
+	{
+		EmitRR( 0, 0, 0x83, alu, dst );
+		Emit1( imm & 255 );
+	}
+	else
+	{
+		EmitRR( 0, 0, 0x81, alu, dst );
+		Emit4( imm );
+	}
+}
+
+static void EmitRsp( int alu, int amount )
+{
+	if( amount )
+	{
+		EmitRR( 0, REX_W, 0x83, alu, REG_RSP );
+		Emit1( amount );
+	}
+}
+
+static void EmitPush( int reg )
+{
+	EmitRex( 0, 0, 0, reg );
+	Emit1( 0x50 + ( reg & 7 ) );
+}
+
+static void EmitPop( int reg )
+{
+	EmitRex( 0, 0, 0, reg );
+	Emit1( 0x58 + ( reg & 7 ) );
+}
+
+static void EmitCallPtr( void* function )
+{
+	EmitMovRPtr( REG_RAX, function );
+	EmitRR( 0, 0, 0xFF, 2, REG_RAX );
+}
+
+/*
+=================
+EmitJump
+
+A jump or call to a code offset, always rel32 so that code size doesn't
+depend on where the targets end up
+=================
+*/
+static void EmitJump( int opcode, int target )
+{
+	EmitOpcode( opcode );
+	Emit4( target - ( compiledOfs + 4 ) );
+}
+
+static void EmitError( int opcode, vmError_t error )
+{
+	EmitJump( opcode, errorOffsets[error] );
+}
+
+// a jump forward inside the code of one instruction
+static int EmitForward( int opcode )
+{
+	EmitOpcode( opcode );
+	Emit4( 0 );
+	return compiledOfs - 4;
+}
+
+static void PatchForward( int ofs )
+{
+	int rel;
+
+	if( buf )
+	{
+		rel = compiledOfs - ( ofs + 4 );
+		Com_Memcpy( buf + ofs, &rel, 4 );
+	}
+}
+
+/*
+==============================================================================
+
+OPERAND STACK
+
+==============================================================================
+*/
+
+static int SlotOffset( int depth )
+{
+	return ( int )( offsetof( vmCompiled_t, slots ) + depth * sizeof( long long ) );
+}
+
+/*
+=================
+SlotToReg
+
+Puts the operand at depth into reg
+=================
+*/
+static void SlotToReg( int depth, int reg )
+{
+	switch( slotKind[depth] )
+	{
+		case SLOT_CONST:
+			EmitMovRI( reg, slotValue[depth] );
+			break;
+
+		case SLOT_LOCAL:
+			EmitRM( 0, 0, 0x8D, reg, REG_STACK, -1, 0, slotValue[depth] );
+			break;
+
+		default:
+			if( depth < NUM_SLOT_REGS )
+			{
+				EmitMovRR( reg, slotRegs[depth] );
+			}
+			else
+			{
+				EmitRM( 0, 0, 0x8B, reg, REG_STATE, -1, 0, SlotOffset( depth ) );
+			}
+			break;
+	}
+}
+
+/*
+=================
+SlotReg
+
+A register holding the operand at depth, its home if it is in one,
+otherwise it is loaded into scratch
+=================
+*/
+static int SlotReg( int depth, int scratch )
+{
+	if( slotKind[depth] == SLOT_REG && depth < NUM_SLOT_REGS )
+	{
+		return slotRegs[depth];
+	}
+	SlotToReg( depth, scratch );
+	return scratch;
+}
+
+// the register to compute a result for depth in
+static int WorkReg( int depth )
+{
+	return depth < NUM_SLOT_REGS ? slotRegs[depth] : REG_RAX;
+}
+
+// the operand at depth is now the value in reg
+static void SetSlot( int depth, int reg )
+{
+	if( depth < NUM_SLOT_REGS )
+	{
+		EmitMovRR( slotRegs[depth], reg );
+	}
+	else
+	{
+		EmitRM( 0, 0, 0x89, reg, REG_STATE, -1, 0, SlotOffset( depth ) );
+	}
+	slotKind[depth] = SLOT_REG;
+}
+
+/*
+=================
+SaveSlots
+
+Pushes the operands below depth that a call could overwrite, constants
+and LOCAL addresses don't need it. Returns how many were pushed.
+=================
+*/
+static int SaveSlots( int depth, qboolean intoC, int* saved )
+{
+	int i, count;
+
+	count = 0;
+	for( i = 0; i < depth; i++ )
+	{
+		if( slotKind[i] != SLOT_REG )
+		{
+			continue;
+		}
+
+		if( i < NUM_SLOT_REGS )
+		{
+			if( intoC && i < NUM_SAVED_SLOT_REGS )
+			{
+				continue;
+			}
+			EmitPush( slotRegs[i] );
+		}
+		else
+		{
+			EmitRM( 0, 0, 0xFF, 6, REG_STATE, -1, 0, SlotOffset( i ) );
+		}
+		saved[count++] = i;
+	}
+
+	return count;
+}
+
+static void RestoreSlots( int* saved, int count )
+{
+	int i;
+
+	for( i = count - 1; i >= 0; i-- )
+	{
+		if( saved[i] < NUM_SLOT_REGS )
+		{
+			EmitPop( slotRegs[saved[i]] );
+		}
+		else
+		{
+			EmitRM( 0, 0, 0x8F, 0, REG_STATE, -1, 0, SlotOffset( saved[i] ) );
+		}
+	}
+}
+
+// keeps rsp 16 byte aligned at the call, the code of a function runs with rsp 8 off
+static int CallPadding( int pushed )
+{
+	return ( pushed & 1 ) ? 0 : 8;
+}
+
+/*
+==============================================================================
+
+CODE GENERATION
+
+==============================================================================
+*/
+
+/*
+=================
+EmitEntry
+
+int entry( vmCompiled_t* state, byte* image, int programStack, void* target )
+=================
+*/
+static void EmitEntry()
+{
+	EmitPush( REG_RBX );
+	EmitPush( REG_RBP );
+	EmitPush( REG_RSI );
+	EmitPush( REG_RDI );
+	EmitPush( REG_R12 );
+	EmitPush( REG_R13 );
+	EmitPush( REG_R14 );
+	EmitPush( REG_R15 );
+
+	EmitRR( 0, REX_W, 0x89, argRegs[0], REG_STATE );
+	EmitRR( 0, REX_W, 0x89, argRegs[1], REG_IMAGE );
+	EmitMovRR( REG_STACK, argRegs[2] );
+	EmitRR( 0, REX_W, 0x89, argRegs[3], REG_RAX );
+
+	EmitRsp( ALU_SUB, 8 );
+	EmitRR( 0, 0, 0xFF, 2, REG_RAX );
+	EmitRsp( ALU_ADD, 8 );
+	EmitMovRR( REG_RAX, REG_RBX );
+
+	EmitPop( REG_R15 );
+	EmitPop( REG_R14 );
+	EmitPop( REG_R13 );
+	EmitPop( REG_R12 );
+	EmitPop( REG_RDI );
+	EmitPop( REG_RSI );
+	EmitPop( REG_RBP );
+	EmitPop( REG_RBX );
+	Emit1( 0xC3 );
+}
+
+static void EmitErrorStubs()
+{
+	int i;
+
+	for( i = 0; i < VMERR_NUM; i++ )
+	{
+		errorOffsets[i] = compiledOfs;
+
+		// and rsp, -16 so the stack is aligned whatever the depth was
+		EmitRR( 0, REX_W, 0x83, ALU_AND, REG_RSP );
+		Emit1( 0xF0 );
+		EmitRsp( ALU_SUB, SHADOW_SPACE );
+		EmitMovRI( argRegs[0], i );
+		EmitCallPtr( VM_CompiledError );
+		Emit1( 0xCC );
+	}
+}
+
+// a qvm address, masked to the access size, as index register or displacement
+static void EmitAddress( int depth, int mask, int* index, int* disp )
+{
+	if( slotKind[depth] == SLOT_CONST )
+	{
+		*index = -1;
+		*disp  = slotValue[depth] & mask;
+		return;
+	}
+
+	SlotToReg( depth, REG_RAX );
+	EmitAluRI( ALU_AND, REG_RAX, mask );
+	*index = REG_RAX;
+	*disp  = 0;
+}
+
+static void EmitLoad( int depth, int opcode, int mask )
+{
+	int index, disp, reg;
+
+	EmitAddress( depth, mask, &index, &disp );
+	reg = WorkReg( depth );
+	EmitRM( 0, 0, opcode, reg, REG_IMAGE, index, 0, disp );
+	SetSlot( depth, reg );
+}
+
+static void EmitStore( int depth, int size, int mask )
+{
+	int index, disp, value;
+
+	EmitAddress( depth - 1, mask, &index, &disp );
+
+	if( slotKind[depth] == SLOT_CONST )
+	{
+		switch( size )
+		{
+			case 1:
+				EmitRM( 0, 0, 0xC6, 0, REG_IMAGE, index, 0, disp );
+				Emit1( slotValue[depth] & 255 );
+				break;
+			case 2:
+				EmitRM( 0x66, 0, 0xC7, 0, REG_IMAGE, index, 0, disp );
+				Emit1( slotValue[depth] & 255 );
+				Emit1( ( slotValue[depth] >> 8 ) & 255 );
+				break;
+			default:
+				EmitRM( 0, 0, 0xC7, 0, REG_IMAGE, index, 0, disp );
+				Emit4( slotValue[depth] );
+				break;
+		}
+		return;
+	}
+
+	value = SlotReg( depth, REG_RCX );
+	switch( size )
+	{
+		case 1:
+			EmitRM( 0, ( value >= 4 && value < 8 ) ? REX_BYTE : 0, 0x88, value, REG_IMAGE, index, 0, disp );
+			break;
+		case 2:
+			EmitRM( 0x66, 0, 0x89, value, REG_IMAGE, index, 0, disp );
+			break;
+		default:
+			EmitRM( 0, 0, 0x89, value, REG_IMAGE, index, 0, disp );
+			break;
+	}
+}
+
+static void EmitBinary( int depth, int alu )
+{
+	int reg;
+
+	reg = WorkReg( depth - 1 );
+	SlotToReg( depth - 1, reg );
+	if( slotKind[depth] == SLOT_CONST )
+	{
+		EmitAluRI( alu, reg, slotValue[depth] );
+	}
+	else
+	{
+		EmitAluRR( alu, reg, SlotReg( depth, REG_RCX ) );
+	}
+	SetSlot( depth - 1, reg );
+}
+
+static void EmitMultiply( int depth )
+{
+	int reg;
+
+	reg = WorkReg( depth - 1 );
+	SlotToReg( depth - 1, reg );
+	if( slotKind[depth] == SLOT_CONST )
+	{
+		EmitRR( 0, 0, 0x69, reg, reg );
+		Emit4( slotValue[depth] );
+	}
+	else
+	{
+		EmitRR( 0, 0, 0x0FAF, reg, SlotReg( depth, REG_RCX ) );
+	}
+	SetSlot( depth - 1, reg );
+}
+
+// ext is the /digit of shl, shr or sar
+static void EmitShift( int depth, int ext )
+{
+	int reg;
+
+	reg = WorkReg( depth - 1 );
+	SlotToReg( depth - 1, reg );
+	if( slotKind[depth] == SLOT_CONST )
+	{
+		EmitRR( 0, 0, 0xC1, ext, reg );
+		Emit1( slotValue[depth] & 31 );
+	}
+	else
+	{
+		SlotToReg( depth, REG_RCX );
+		EmitRR( 0, 0, 0xD3, ext, reg );
+	}
+	SetSlot( depth - 1, reg );
+}
+
+static void EmitDivide( int depth, qboolean isSigned, qboolean modulo )
+{
+	int minusOne, done;
+
+	SlotToReg( depth - 1, REG_RAX );
+
+	if( slotKind[depth] == SLOT_CONST && !slotValue[depth] )
+	{
+		EmitError( JMP, VMERR_DIVIDE );
+	}
+	else if( slotKind[depth] == SLOT_CONST && isSigned && slotValue[depth] == -1 )
+	{
+		// INT_MIN / -1 would trap
+		if( modulo )
+		{
+			EmitMovRI( REG_RAX, 0 );
+		}
+		else
+		{
+			EmitRR( 0, 0, 0xF7, 3, REG_RAX );
+		}
+	}
+	else
+	{
+		minusOne = done = -1;
+
+		SlotToReg( depth, REG_RCX );
+		if( slotKind[depth] != SLOT_CONST )
+		{
+			EmitRR( 0, 0, 0x85, REG_RCX, REG_RCX );
+			EmitError( JCC_E, VMERR_DIVIDE );
+			if( isSigned )
+			{
+				EmitAluRI( ALU_CMP, REG_RCX, -1 );
+				minusOne = EmitForward( JCC_E );
+			}
+		}
+
+		if( isSigned )
+		{
+			Emit1( 0x99 ); // cdq
+			EmitRR( 0, 0, 0xF7, 7, REG_RCX );
+		}
+		else
+		{
+			EmitMovRI( REG_RDX, 0 );
+			EmitRR( 0, 0, 0xF7, 6, REG_RCX );
+		}
+		if( modulo )
+		{
+			EmitMovRR( REG_RAX, REG_RDX );
+		}
+
+		if( minusOne >= 0 )
+		{
+			done = EmitForward( JMP );
+			PatchForward( minusOne );
+			if( modulo )
+			{
+				EmitMovRI( REG_RAX, 0 );
+			}
+			else
+			{
+				EmitRR( 0, 0, 0xF7, 3, REG_RAX );
+			}
+			PatchForward( done );
+		}
+	}
+
+	SetSlot( depth - 1, REG_RAX );
+}
+
+// movd xmm, reg and back
+static void EmitToXmm( int xmm, int reg )
+{
+	EmitRR( 0x66, 0, 0x0F6E, xmm, reg );
+}
+
+static void EmitFromXmm( int reg, int xmm )
+{
+	EmitRR( 0x66, 0, 0x0F7E, xmm, reg );
+}
+
+static void EmitFloatBinary( int depth, int opcode )
+{
+	int reg;
+
+	EmitToXmm( 0, SlotReg( depth - 1, REG_RAX ) );
+	EmitToXmm( 1, SlotReg( depth, REG_RCX ) );
+	EmitRR( 0xF3, 0, opcode, 0, 1 );
+	reg = WorkReg( depth - 1 );
+	EmitFromXmm( reg, 0 );
+	SetSlot( depth - 1, reg );
+}
+
+/*
+=================
+EmitFloatBranch
+
+Unordered compares are false, except for NEF
+=================
+*/
+static void EmitFloatBranch( int op, int target )
+{
+	int skip;
+
+	EmitToXmm( 0, SlotReg( 0, REG_RAX ) );
+	EmitToXmm( 1, SlotReg( 1, REG_RCX ) );
+
+	switch( op )
+	{
+		case OP_EQF:
+			EmitRR( 0, 0, 0x0F2E, 0, 1 );
+			skip = EmitForward( JCC_P );
+			EmitJump( JCC_E, target );
+			PatchForward( skip );
+			break;
+		case OP_NEF:
+			EmitRR( 0, 0, 0x0F2E, 0, 1 );
+			EmitJump( JCC_P, target );
+			EmitJump( JCC_NE, target );
+			break;
+		case OP_LTF:
+			EmitRR( 0, 0, 0x0F2E, 1, 0 );
+			EmitJump( JCC_A, target );
+			break;
+		case OP_LEF:
+			EmitRR( 0, 0, 0x0F2E, 1, 0 );
+			EmitJump( JCC_AE, target );
+			break;
+		case OP_GTF:
+			EmitRR( 0, 0, 0x0F2E, 0, 1 );
+			EmitJump( JCC_A, target );
+			break;
+		default:
+			EmitRR( 0, 0, 0x0F2E, 0, 1 );
+			EmitJump( JCC_AE, target );
+			break;
+	}
+}
+
+static void EmitIntBranch( int op, int target )
+{
+	static const int jcc[] = { JCC_E, JCC_NE, JCC_L, JCC_LE, JCC_G, JCC_GE, JCC_B, JCC_BE, JCC_A, JCC_AE };
+	int				 reg;
+
+	reg = SlotReg( 0, REG_RAX );
+	if( slotKind[1] == SLOT_CONST )
+	{
+		EmitAluRI( ALU_CMP, reg, slotValue[1] );
+	}
+	else
+	{
+		EmitAluRR( ALU_CMP, reg, SlotReg( 1, REG_RCX ) );
+	}
+	EmitJump( jcc[op - OP_EQ], target );
+}
+
+// an instruction a jump or call may go to
+static qboolean ValidTarget( int target )
+{
+	return target >= 0 && target < instructionCount && !instructionDepths[target];
+}
+
+/*
+=================
+EmitCall
+
+The operand at depth is the target, it is replaced by the return value
+=================
+*/
+static void EmitCall( int depth )
+{
+	int saved[MAX_COMPILED_DEPTH];
+	int count, pad, target, system, done;
+
+	if( slotKind[depth] == SLOT_CONST && slotValue[depth] < 0 )
+	{
+		// system call
+		count = SaveSlots( depth, qtrue, saved );
+		pad	  = CallPadding( count ) + SHADOW_SPACE;
+		EmitRsp( ALU_SUB, pad );
+		EmitMovRI( argRegs[0], -1 - slotValue[depth] );
+		EmitMovRR( argRegs[1], REG_STACK );
+		EmitCallPtr( VM_CompiledSystemCall );
+		EmitRsp( ALU_ADD, pad );
+		RestoreSlots( saved, count );
+		SetSlot( depth, REG_RAX );
+		return;
+	}
+
+	if( slotKind[depth] == SLOT_CONST )
+	{
+		target = slotValue[depth];
+		if( !ValidTarget( target ) )
+		{
+			EmitError( JMP, VMERR_CALL );
+			SetSlot( depth, REG_RAX );
+			return;
+		}
+
+		count = SaveSlots( depth, qfalse, saved );
+		pad	  = CallPadding( count );
+		EmitRsp( ALU_SUB, pad );
+		EmitJump( CALL, instructionOffsets[target] );
+		EmitRsp( ALU_ADD, pad );
+		if( depth )
+		{
+			EmitMovRR( REG_RAX, REG_RBX );
+		}
+		RestoreSlots( saved, count );
+		SetSlot( depth, depth ? REG_RAX : REG_RBX );
+		return;
+	}
+
+	// a function pointer, which may be a system call
+	SlotToReg( depth, REG_RAX );
+	count = SaveSlots( depth, qfalse, saved );
+	pad	  = CallPadding( count ) + SHADOW_SPACE;
+	EmitRsp( ALU_SUB, pad );
+
+	EmitRR( 0, 0, 0x85, REG_RAX, REG_RAX );
+	system = EmitForward( 0x0F88 ); // js
+	EmitAluRI( ALU_CMP, REG_RAX, instructionCount );
+	EmitError( JCC_AE, VMERR_CALL );
+	EmitRM( 0, REX_W, 0x8B, REG_RCX, REG_STATE, -1, 0, offsetof( vmCompiled_t, jumpTable ) );
+	EmitRM( 0, 0, 0xFF, 2, REG_RCX, REG_RAX, 3, 0 );
+	EmitMovRR( REG_RAX, REG_RBX );
+	done = EmitForward( JMP );
+
+	PatchForward( system );
+	EmitRR( 0, 0, 0xF7, 2, REG_RAX ); // not eax, -1 - eax
+	EmitMovRR( argRegs[0], REG_RAX );
+	EmitMovRR( argRegs[1], REG_STACK );
+	EmitCallPtr( VM_CompiledSystemCall );
+	PatchForward( done );
+
+	EmitRsp( ALU_ADD, pad );
+	RestoreSlots( saved, count );
+	SetSlot( depth, REG_RAX );
+}
+
+static void EmitBlockCopy( int depth, int size )
+{
+	int saved[MAX_COMPILED_DEPTH];
+	int count, pad;
+
+	SlotToReg( depth - 1, REG_RAX );
+	SlotToReg( depth, REG_R11 );
+	count = SaveSlots( depth - 1, qtrue, saved );
+	pad	  = CallPadding( count ) + SHADOW_SPACE;
+	EmitRsp( ALU_SUB, pad );
+	EmitMovRR( argRegs[0], REG_RAX );
+	EmitMovRR( argRegs[1], REG_R11 );
+	EmitMovRI( argRegs[2], size );
+	EmitCallPtr( VM_CompiledBlockCopy );
+	EmitRsp( ALU_ADD, pad );
+	RestoreSlots( saved, count );
+}
+
+/*
+=================
+EmitInstruction
+
+depth is the index of the operand on top of the stack before the
+instruction, -1 when it is empty
+=================
+*/
+static void EmitInstruction( vmInstruction_t* ins, int depth )
+{
+	int reg;
+
+	switch( ins->op )
+	{
+		case OP_UNDEF:
+		case OP_BREAK:
+			EmitError( JMP, VMERR_BREAK );
+			break;
+
+		case OP_IGNORE:
+			break;
+
+		case OP_ENTER:
+			EmitRM( 0, REX_W, 0x3B, REG_RSP, REG_STATE, -1, 0, offsetof( vmCompiled_t, stackLimit ) );
+			EmitError( JCC_B, VMERR_STACK );
+			EmitAluRI( ALU_SUB, REG_STACK, ins->value );
+			EmitRM( 0, 0, 0x3B, REG_STACK, REG_STATE, -1, 0, offsetof( vmCompiled_t, stackBottom ) );
+			EmitError( JCC_L, VMERR_STACK );
+			break;
+
+		case OP_LEAVE:
+			SlotToReg( 0, REG_RBX );
+			EmitAluRI( ALU_ADD, REG_STACK, ins->value );
+			Emit1( 0xC3 );
+			break;
+
+		case OP_CALL:
+			EmitCall( depth );
+			break;
+
+		case OP_PUSH:
+			slotKind[depth + 1]	 = SLOT_CONST;
+			slotValue[depth + 1] = 0;
+			break;
+
+		case OP_POP:
+			break;
+
+		case OP_CONST:
+			slotKind[depth + 1]	 = SLOT_CONST;
+			slotValue[depth + 1] = ins->value;
+			break;
+
+		case OP_LOCAL:
+			slotKind[depth + 1]	 = SLOT_LOCAL;
+			slotValue[depth + 1] = ins->value;
+			break;
+
+		case OP_JUMP:
+			if( slotKind[0] == SLOT_CONST )
+			{
+				if( ValidTarget( slotValue[0] ) )
+				{
+					EmitJump( JMP, instructionOffsets[slotValue[0]] );
+				}
+				else
+				{
+					EmitError( JMP, VMERR_JUMP );
+				}
+				break;
+			}
+			SlotToReg( 0, REG_RAX );
+			EmitAluRI( ALU_CMP, REG_RAX, instructionCount );
+			EmitError( JCC_AE, VMERR_JUMP );
+			EmitRM( 0, REX_W, 0x8B, REG_RCX, REG_STATE, -1, 0, offsetof( vmCompiled_t, jumpTable ) );
+			EmitRM( 0, 0, 0xFF, 4, REG_RCX, REG_RAX, 3, 0 );
+			break;
+
+		case OP_EQ:
+		case OP_NE:
+		case OP_LTI:
+		case OP_LEI:
+		case OP_GTI:
+		case OP_GEI:
+		case OP_LTU:
+		case OP_LEU:
+		case OP_GTU:
+		case OP_GEU:
+			EmitIntBranch( ins->op, instructionOffsets[ins->value] );
+			break;
+
+		case OP_EQF:
+		case OP_NEF:
+		case OP_LTF:
+		case OP_LEF:
+		case OP_GTF:
+		case OP_GEF:
+			EmitFloatBranch( ins->op, instructionOffsets[ins->value] );
+			break;
+
+		case OP_LOAD1:
+			EmitLoad( depth, 0x0FB6, mask1 );
+			break;
+
+		case OP_LOAD2:
+			EmitLoad( depth, 0x0FB7, mask2 );
+			break;
+
+		case OP_LOAD4:
+			EmitLoad( depth, 0x8B, mask4 );
+			break;
+
+		case OP_STORE1:
+			EmitStore( depth, 1, mask1 );
+			break;
+
+		case OP_STORE2:
+			EmitStore( depth, 2, mask2 );
+			break;
+
+		case OP_STORE4:
+			EmitStore( depth, 4, mask4 );
+			break;
+
+		case OP_ARG:
+			EmitRM( 0, 0, 0x8D, REG_RAX, REG_STACK, -1, 0, ins->value );
+			EmitAluRI( ALU_AND, REG_RAX, mask4 );
+			if( slotKind[depth] == SLOT_CONST )
+			{
+				EmitRM( 0, 0, 0xC7, 0, REG_IMAGE, REG_RAX, 0, 0 );
+				Emit4( slotValue[depth] );
+			}
+			else
+			{
+				EmitRM( 0, 0, 0x89, SlotReg( depth, REG_RCX ), REG_IMAGE, REG_RAX, 0, 0 );
+			}
+			break;
+
+		case OP_BLOCK_COPY:
+			EmitBlockCopy( depth, ins->value );
+			break;
+
+		case OP_SEX8:
+		case OP_SEX16:
+			reg = WorkReg( depth );
+			SlotToReg( depth, reg );
+			EmitRR( 0, ( reg >= 4 && reg < 8 ) ? REX_BYTE : 0, ins->op == OP_SEX8 ? 0x0FBE : 0x0FBF, reg, reg );
+			SetSlot( depth, reg );
+			break;
+
+		case OP_NEGI:
+		case OP_BCOM:
+			reg = WorkReg( depth );
+			SlotToReg( depth, reg );
+			EmitRR( 0, 0, 0xF7, ins->op == OP_NEGI ? 3 : 2, reg );
+			SetSlot( depth, reg );
+			break;
+
+		case OP_NEGF:
+			reg = WorkReg( depth );
+			SlotToReg( depth, reg );
+			EmitRR( 0, 0, 0x81, ALU_XOR, reg );
+			Emit4( 0x80000000 );
+			SetSlot( depth, reg );
+			break;
+
+		case OP_ADD:
+			EmitBinary( depth, ALU_ADD );
+			break;
+
+		case OP_SUB:
+			EmitBinary( depth, ALU_SUB );
+			break;
+
+		case OP_BAND:
+			EmitBinary( depth, ALU_AND );
+			break;
+
+		case OP_BOR:
+			EmitBinary( depth, ALU_OR );
+			break;
+
+		case OP_BXOR:
+			EmitBinary( depth, ALU_XOR );
+			break;
+
+		case OP_MULI:
+		case OP_MULU:
+			EmitMultiply( depth );
+			break;
+
+		case OP_DIVI:
+			EmitDivide( depth, qtrue, qfalse );
+			break;
+
+		case OP_DIVU:
+			EmitDivide( depth, qfalse, qfalse );
+			break;
+
+		case OP_MODI:
+			EmitDivide( depth, qtrue, qtrue );
+			break;
+
+		case OP_MODU:
+			EmitDivide( depth, qfalse, qtrue );
+			break;
+
+		case OP_LSH:
+			EmitShift( depth, 4 );
+			break;
+
+		case OP_RSHI:
+			EmitShift( depth, 7 );
+			break;
+
+		case OP_RSHU:
+			EmitShift( depth, 5 );
+			break;
+
+		case OP_ADDF:
+			EmitFloatBinary( depth, 0x0F58 );
+			break;
+
+		case OP_SUBF:
+			EmitFloatBinary( depth, 0x0F5C );
+			break;
+
+		case OP_MULF:
+			EmitFloatBinary( depth, 0x0F59 );
+			break;
+
+		case OP_DIVF:
+			EmitFloatBinary( depth, 0x0F5E );
+			break;
+
+		case OP_CVIF:
+			reg = SlotReg( depth, REG_RAX );
+			EmitRR( 0, 0, 0x0F57, 0, 0 ); // xorps, no dependency on the old xmm0
+			EmitRR( 0xF3, 0, 0x0F2A, 0, reg );
+			reg = WorkReg( depth );
+			EmitFromXmm( reg, 0 );
+			SetSlot( depth, reg );
+			break;
+
+		case OP_CVFI:
+			EmitToXmm( 0, SlotReg( depth, REG_RAX ) );
+			reg = WorkReg( depth );
+			EmitRR( 0xF3, 0, 0x0F2C, reg, 0 );
+			SetSlot( depth, reg );
+			break;
+	}
+}
+
+/*
+=================
+VM_CheckOperandStack
+
+Finds the operand stack depth before every instruction, qfalse if it
+isn't the same on every path or the code needs something the compiler
+doesn't handle
+=================
+*/
+static qboolean VM_CheckOperandStack( vm_t* vm, int* depths )
+{
+	vmInstruction_t* ins;
+	const char*		 error;
+	int				 depth, pops, pushes, i;
+	qboolean		 ends;
+
+	for( i = 0; i < vm->instructionCount; i++ )
+	{
+		depths[i] = -1;
+	}
+
+	error = NULL;
+	depth = 0;
+	for( i = 0; i < vm->instructionCount && !error; i++ )
+	{
+		ins		  = &vm->instructions[i];
+		depths[i] = depth;
+		pops = pushes = 0;
+		ends		  = qfalse;
+
+		switch( ins->op )
+		{
+			case OP_UNDEF:
+			case OP_BREAK:
+				ends = qtrue;
+				break;
+
+			case OP_ENTER:
+				if( depth )
+				{
+					error = "operands on the stack at function entry";
+				}
+				break;
+
+			case OP_LEAVE:
+				if( depth != 1 )
+				{
+					error = "not one operand on the stack at return";
+				}
+				pops = 1;
+				ends = qtrue;
+				break;
+
+			case OP_JUMP:
+				if( depth != 1 )
+				{
+					error = "operands left on the stack at a jump";
+				}
+				pops = 1;
+				ends = qtrue;
+				break;
+
+			case OP_EQ:
+			case OP_NE:
+			case OP_LTI:
+			case OP_LEI:
+			case OP_GTI:
+			case OP_GEI:
+			case OP_LTU:
+			case OP_LEU:
+			case OP_GTU:
+			case OP_GEU:
+			case OP_EQF:
+			case OP_NEF:
+			case OP_LTF:
+			case OP_LEF:
+			case OP_GTF:
+			case OP_GEF:
+				if( depth != 2 )
+				{
+					error = "operands left on the stack at a branch";
+				}
+				pops = 2;
+				break;
+
+			case OP_PUSH:
+			case OP_CONST:
+			case OP_LOCAL:
+				pushes = 1;
+				break;
+
+			case OP_POP:
+			case OP_ARG:
+				pops = 1;
+				break;
+
+			case OP_STORE1:
+			case OP_STORE2:
+			case OP_STORE4:
+			case OP_BLOCK_COPY:
+				pops = 2;
+				break;
+
+			case OP_ADD:
+			case OP_SUB:
+			case OP_DIVI:
+			case OP_DIVU:
+			case OP_MODI:
+			case OP_MODU:
+			case OP_MULI:
+			case OP_MULU:
+			case OP_BAND:
+			case OP_BOR:
+			case OP_BXOR:
+			case OP_LSH:
+			case OP_RSHI:
+			case OP_RSHU:
+			case OP_ADDF:
+			case OP_SUBF:
+			case OP_DIVF:
+			case OP_MULF:
+				pops   = 2;
+				pushes = 1;
+				break;
+
+			case OP_IGNORE:
+				break;
+
+			default:
+				// calls, loads and the unary operators replace the top
+				pops   = 1;
+				pushes = 1;
+				break;
+		}
+
+		if( depth < pops )
+		{
+			error = "operand stack underflow";
+		}
+		depth += pushes - pops;
+		if( depth > MAX_COMPILED_DEPTH - 1 )
+		{
+			error = "operand stack too deep";
+		}
+
+		// nothing falls through to the next instruction, its operand
+		// stack is empty as it can only be a jump target
+		if( ends )
+		{
+			depth = 0;
+		}
+	}
+
+	for( i = 0; i < vm->instructionCount && !error; i++ )
+	{
+		ins = &vm->instructions[i];
+		if( ins->op >= OP_EQ && ins->op <= OP_GEF && depths[ins->value] )
+		{
+			error = "operands on the stack at a branch target";
+		}
+	}
+
+	if( error )
+	{
+		Com_Printf( "%s: %s at instruction %i, interpreting\n", vm->name, error, i - 1 );
+		return qfalse;
+	}
+
+	return qtrue;
+}
+
+/*
+=================
+VM_CompilePass
+
+Measures the code with buf NULL, generates it into buf otherwise
+=================
+*/
+static void VM_CompilePass( vm_t* vm )
+{
+	int i;
+
+	compiledOfs = 0;
+	EmitEntry();
+	EmitErrorStubs();
+
+	for( i = 0; i < vm->instructionCount; i++ )
+	{
+		instructionOffsets[i] = compiledOfs;
+		EmitInstruction( &vm->instructions[i], instructionDepths[i] - 1 );
+	}
+
+	EmitError( JMP, VMERR_END );
+}
+
+/*
+=================
+VM_DestroyCompiled
+=================
+*/
+static void VM_DestroyCompiled( vm_t* vm )
+{
+	vmCompiled_t* state;
+
+	state = vm->compiledState;
+	if( state )
+	{
+#ifdef _WIN32
+		VirtualFree( vm->codeBase, 0, MEM_RELEASE );
+#else
+		munmap( vm->codeBase, state->codeSize );
+#endif
+		Z_Free( state->jumpTable );
+		Z_Free( state );
+	}
+
+	vm->compiledState = NULL;
+	vm->codeBase	  = NULL;
+	vm->codeLength	  = 0;
+	vm->compiled	  = qfalse;
+	vm->destroy		  = NULL;
+}
+
+/*
+=================
+VM_Compile
+=================
+*/
+qboolean VM_Compile( vm_t* vm, vmHeader_t* header )
+{
+	vmCompiled_t* state;
+	byte*		  code;
+	int			  size, i;
+	long long	  start;
+
+	start = Sys_Nanoseconds();
+
+	instructionCount   = vm->instructionCount;
+	instructionDepths  = Hunk_AllocateTempMemory( instructionCount * sizeof( int ) );
+	instructionOffsets = Hunk_AllocateTempMemory( instructionCount * sizeof( int ) );
+
+	if( !VM_CheckOperandStack( vm, instructionDepths ) )
+	{
+		Hunk_FreeTempMemory( instructionOffsets );
+		Hunk_FreeTempMemory( instructionDepths );
+		return qfalse;
+	}
+
+	mask1 = vm->dataMask;
+	mask2 = vm->dataMask & ~1;
+	mask4 = vm->dataMask & ~3;
+
+	// measure, then generate at the same offsets
+	buf = NULL;
+	VM_CompilePass( vm );
+	size = compiledOfs;
+
+#ifdef _WIN32
+	code = VirtualAlloc( NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE );
+#else
+	code = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+	if( code == MAP_FAILED )
+	{
+		code = NULL;
+	}
+#endif
+	if( !code )
+	{
+		Com_Printf( "%s: couldn't allocate %i bytes of code, interpreting\n", vm->name, size );
+		Hunk_FreeTempMemory( instructionOffsets );
+		Hunk_FreeTempMemory( instructionDepths );
+		return qfalse;
+	}
+
+	buf = code;
+	VM_CompilePass( vm );
+	buf = NULL;
+
+	if( compiledOfs != size )
+	{
+		Com_Error( ERR_FATAL, "VM_Compile: %s changed size between passes", vm->name );
+	}
+
+	state			   = Z_Malloc( sizeof( *state ) );
+	state->jumpTable   = Z_Malloc( instructionCount * sizeof( void* ) );
+	state->stackBottom = vm->stackBottom;
+	state->entry	   = ( vmEntry_t )code;
+	state->codeSize	   = size;
+	for( i = 0; i < instructionCount; i++ )
+	{
+		state->jumpTable[i] = code + ( instructionDepths[i] ? errorOffsets[VMERR_JUMP] : instructionOffsets[i] );
+	}
+
+	Hunk_FreeTempMemory( instructionOffsets );
+	Hunk_FreeTempMemory( instructionDepths );
+
+	// write xor execute
+#ifdef _WIN32
+	{
+		DWORD oldProtect;
+
+		VirtualProtect( code, size, PAGE_EXECUTE_READ, &oldProtect );
+		FlushInstructionCache( GetCurrentProcess(), code, size );
+	}
+#else
+	mprotect( code, size, PROT_READ | PROT_EXEC );
+#endif
+
+	vm->codeBase	  = code;
+	vm->codeLength	  = size;
+	vm->compiledState = state;
+	vm->destroy		  = VM_DestroyCompiled;
+
+	Com_Printf( "%s: %i instructions compiled to %i bytes in %.1f msec\n", vm->name, instructionCount, size, ( Sys_Nanoseconds() - start ) / 1000000.0 );
+
+	return qtrue;
+}
+
+/*
+=================
+VM_CallCompiled
+
+args[0] is the command, the rest its parameters
+=================
+*/
+int VM_CallCompiled( vm_t* vm, int* args )
+{
+	vmCompiled_t* state;
+	byte*		  image;
+	int			  programStack, stackOnEntry;
+	int			  mask, i, r;
+
+	state = vm->compiledState;
+	image = vm->dataBase;
+	mask  = vm->dataMask & ~3;
+
+	// we might be called recursively, so this might not be the very top
+	programStack = stackOnEntry = vm->programStack;
+
+	// the outermost call decides how deep compiled code may go on the native stack
+	if( stackOnEntry == vm->dataMask + 1 )
+	{
+		state->stackLimit = ( byte* )&r - NATIVE_STACK_BUDGET;
+	}
+
+	// set up the stack frame
+	programStack -= 8 + 4 * MAX_VMMAIN_ARGS;
+	for( i = 0; i < MAX_VMMAIN_ARGS; i++ )
+	{
+		*( int* )&image[( programStack + 8 + 4 * i ) & mask] = args[i];
+	}
+	*( int* )&image[( programStack + 4 ) & mask] = 0;
+	*( int* )&image[programStack & mask]		 = -1;
+
+	r = state->entry( state, image, programStack, state->jumpTable[0] );
+
+	vm->programStack = stackOnEntry;
+
+	return r;
+}
+
+#endif // VM_HAVE_COMPILER
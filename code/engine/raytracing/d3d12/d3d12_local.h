@@ -93,6 +93,7 @@ struct dxrMesh_t
 };
 
 void									  GL_FinishVertexBufferAllocation();
+void									  GL_UpdateMeshMemStats();
 
 const int								  FrameCount = 3;
 
@@ -112,6 +113,7 @@ extern UINT64							  m_fenceValue;
 
 extern ComPtr<ID3D12Resource>			  m_vertexBuffer;
 
+bool									  GL_BuildTopLevelInstances( bool forceUpdate );
 void									  GL_CreateTopLevelAccelerationStructs( bool forceUpdate );
 
 extern std::vector<dxrMesh_t*>			  dxrMeshList;
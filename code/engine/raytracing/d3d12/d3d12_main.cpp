@@ -795,8 +795,24 @@ void GL_CalcFov( float base_fov, float& fov_x, float& fov_y )
 	}
 }
 
+// The CPU side of GL_Render, for r_noGPU
+void GL_PrepareRaytracingFrame( float x, float y, float z )
+{
+	PROFILE_SCOPE( "GL_PrepareRaytracingFrame" );
+
+	if( raytracingDataInit == 0 )
+	{
+		return;
+	}
+
+	GL_BuildLightList( x, y, z );
+	GL_BuildTopLevelInstances( false );
+}
+
 void GL_Render( float x, float y, float z, vec3_t viewaxis[3] )
 {
+	PROFILE_SCOPE( "GL_Render" );
+
 	// On the last frame, the raytracing output was used as a copy source, to
 	// copy its contents into the render target. Now we need to transition it to
 	// a UAV so that the shaders can write in it.
@@ -816,12 +832,15 @@ void GL_Render( float x, float y, float z, vec3_t viewaxis[3] )
 	}
 
 	GL_ClearLightPass( lightTexture, m_commandList.Get(), m_commandAllocator.Get() );
+
+	long long start = Sys_Nanoseconds();
 	GL_BuildLightList( x, y, z );
 
 	std::vector<DirectX::XMMATRIX> matrices( 4 );
 
 	// Update the top level acceleration structs based on new scene data.
 	GL_CreateTopLevelAccelerationStructs( false );
+	backEnd.pc.raytraceNsec += Sys_Nanoseconds() - start;
 
 	// Initialize the view matrix, ideally this should be based on user
 	// interactions The lookat and perspective matrices used for rasterization are
@@ -55,6 +55,8 @@ void						  RE_ShutdownRaytracingMap()
 
 	dxrMeshList.clear();
 
+	GL_UpdateMeshMemStats();
+
 	if( m_vertexBuffer.Get() != NULL )
 	{
 		m_vertexBuffer->Release();
@@ -73,7 +73,9 @@ int GL_GetCurrentFrame( trRefEntity_t* currententity, int frame )
 	return frame;
 }
 
-void GL_CreateTopLevelAccelerationStructs( bool forceUpdate )
+// The CPU side of the top level update: entity transforms and the instance
+// list. Touches no GPU resource, so r_noGPU benchmarks can still run it.
+bool GL_BuildTopLevelInstances( bool forceUpdate )
 {
 	// Add in the entities.
 	int numProcessedEntities = 1;
@@ -177,7 +179,17 @@ void GL_CreateTopLevelAccelerationStructs( bool forceUpdate )
 		//		m_topLevelASGenerator.AddInstance(mesh->buffers.pResult.Get(), (DirectX::XMMATRIX&)currententity->dxrTransform, cl_numvisedicts + 1, 0);
 		//	}
 		//}
+	}
 
+	return onlyUpdate;
+}
+
+void GL_CreateTopLevelAccelerationStructs( bool forceUpdate )
+{
+	bool onlyUpdate = GL_BuildTopLevelInstances( forceUpdate );
+
+	if( !onlyUpdate || forceUpdate )
+	{
 		// Update our instance info.
 		if( m_instanceProperties != nullptr )
 		{
@@ -1394,4 +1394,41 @@ void GL_FinishVertexBufferAllocation()
 	//
 	// m_fence->SetEventOnCompletion(m_fenceValue, m_fenceEvent);
 	// WaitForSingleObject(m_fenceEvent, INFINITE);
+
+	GL_UpdateMeshMemStats();
+}
+
+/*
+============================
+GL_UpdateMeshMemStats
+
+Reports the CPU side scene buffers to mem_stats
+============================
+*/
+void GL_UpdateMeshMemStats()
+{
+	static memStat_t* sceneVertexStat = NULL;
+	static memStat_t* meshStat		  = NULL;
+	size_t			  meshBytes;
+
+	if( !sceneVertexStat )
+	{
+		sceneVertexStat = ri.RegisterMemStat( "d3d12 scene vertexes", 0 );
+		meshStat		= ri.RegisterMemStat( "d3d12 meshes", 0 );
+	}
+
+	meshBytes = dxrMeshList.capacity() * sizeof( dxrMesh_t* );
+	for( int i = 0; i < dxrMeshList.size(); i++ )
+	{
+		dxrMesh_t* mesh = dxrMeshList[i];
+
+		meshBytes += sizeof( dxrMesh_t );
+		meshBytes += mesh->meshVertexes.capacity() * sizeof( dxrVertex_t );
+		meshBytes += mesh->meshTriVertexes.capacity() * sizeof( dxrVertex_t );
+		meshBytes += mesh->meshIndexes.capacity() * sizeof( int );
+		meshBytes += mesh->meshSurfaces.capacity() * sizeof( dxrSurface_t );
+	}
+
+	ri.MemStatSet( sceneVertexStat, ( int )( sceneVertexes.capacity() * sizeof( dxrVertex_t ) ) );
+	ri.MemStatSet( meshStat, ( int )meshBytes );
 }
\ No newline at end of file
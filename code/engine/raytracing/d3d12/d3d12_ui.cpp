@@ -298,6 +298,18 @@ void GL_RenderUI( ID3D12GraphicsCommandList4* cmdList, ID3D12CommandAllocator* c
 	// tr_cmd_render_target_transition(&cmd, uiRenderTarget, tr_texture_usage_color_attachment, tr_texture_usage_sampled_image);
 	tr_internal_dx_cmd_image_transition( &cmd, uiRenderTarget->color_attachments[0], tr_texture_usage_color_attachment, tr_texture_usage_sampled_image );
 
+	GL_DiscardUI();
+}
+
+/*
+===============
+GL_DiscardUI
+
+Forgets the 2D drawing recorded this frame
+===============
+*/
+void GL_DiscardUI()
+{
 	uiRenderPasses.clear();
 	currentUIVertex = 0;
 
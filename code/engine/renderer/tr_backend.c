@@ -1040,6 +1040,33 @@ const void* RB_SwapBuffers( const void* data )
 	const swapBuffersCommand_t* cmd;
 
 	int							x, y, width, height;
+	long long					start;
+
+	cmd = ( const swapBuffersCommand_t* )data;
+
+	// benchmarks without a GPU in the loop, do all the CPU work
+	// of a frame and throw the recorded 2D drawing away
+	if( r_noGPU->integer )
+	{
+		if( tr.world != NULL )
+		{
+			if( r_invalidateDXRData )
+			{
+				GL_FinishDXRLoading();
+				r_invalidateDXRData = 0;
+			}
+
+			start = Sys_Nanoseconds();
+			GL_PrepareRaytracingFrame( tr.dxr_refdef.vieworg[0], tr.dxr_refdef.vieworg[1], tr.dxr_refdef.vieworg[2] );
+			backEnd.pc.raytraceNsec += Sys_Nanoseconds() - start;
+		}
+
+		GL_DiscardUI();
+		backEnd.projection2D = qfalse;
+
+		return ( const void* )( cmd + 1 );
+	}
+
 	GL_BeginRendering( &x, &y, &width, &height );
 
 	// finish any 2D drawing if needed
@@ -1064,8 +1091,6 @@ const void* RB_SwapBuffers( const void* data )
 		GL_Render( tr.dxr_refdef.vieworg[0], tr.dxr_refdef.vieworg[1], tr.dxr_refdef.vieworg[2], tr.dxr_refdef.viewaxis );
 	}
 
-	cmd = ( const swapBuffersCommand_t* )data;
-
 	// we measure overdraw by reading back the stencil buffer and
 	// counting up the number of increments that have happened
 	// if ( r_measureOverdraw->integer ) {
@@ -1108,9 +1133,11 @@ smp extensions, or asynchronously by another thread.
 */
 void RB_ExecuteRenderCommands( const void* data )
 {
-	int t1, t2;
+	int		  t1, t2;
+	long long start;
 
-	t1 = ri.Milliseconds();
+	t1	  = ri.Milliseconds();
+	start = Sys_Nanoseconds();
 
 	if( !r_smp->integer || data == backEndData[0]->commands.cmds )
 	{
@@ -1149,6 +1176,7 @@ void RB_ExecuteRenderCommands( const void* data )
 				// stop rendering on this thread
 				t2				= ri.Milliseconds();
 				backEnd.pc.msec = t2 - t1;
+				backEnd.pc.nsec = Sys_Nanoseconds() - start;
 				return;
 		}
 	}
@@ -501,4 +501,21 @@ void RE_EndFrame( int* frontEndMsec, int* backEndMsec )
 		*backEndMsec = backEnd.pc.msec;
 	}
 	backEnd.pc.msec = 0;
+
+	tr.lastFrontEndNsec = tr.frontEndNsec;
+	tr.lastBackEndNsec	= backEnd.pc.nsec;
+	tr.lastRaytraceNsec = backEnd.pc.raytraceNsec;
+	tr.frontEndNsec		= 0;
+}
+
+/*
+=============
+RE_GetFrameTimes
+=============
+*/
+void RE_GetFrameTimes( long long* frontEndNsec, long long* backEndNsec, long long* raytraceNsec )
+{
+	*frontEndNsec = tr.lastFrontEndNsec;
+	*backEndNsec  = tr.lastBackEndNsec;
+	*raytraceNsec = tr.lastRaytraceNsec;
 }
@@ -63,6 +63,7 @@ cvar_t*		r_lodbias;
 cvar_t*		r_lodscale;
 
 cvar_t*		r_norefresh;
+cvar_t*		r_noGPU;
 cvar_t*		r_drawentities;
 cvar_t*		r_drawworld;
 cvar_t*		r_speeds;
@@ -859,6 +860,7 @@ void R_Register()
 	r_measureOverdraw = ri.Cvar_Get( "r_measureOverdraw", "0", CVAR_CHEAT );
 	r_lodscale		  = ri.Cvar_Get( "r_lodscale", "5", CVAR_CHEAT );
 	r_norefresh		  = ri.Cvar_Get( "r_norefresh", "0", CVAR_CHEAT );
+	r_noGPU			  = ri.Cvar_Get( "r_noGPU", "0", CVAR_CHEAT );
 	r_drawentities	  = ri.Cvar_Get( "r_drawentities", "1", CVAR_CHEAT );
 	r_ignore		  = ri.Cvar_Get( "r_ignore", "1", CVAR_CHEAT );
 	r_nocull		  = ri.Cvar_Get( "r_nocull", "0", CVAR_CHEAT );
@@ -1091,6 +1093,8 @@ refexport_t* GetRefAPI( int apiVersion, refimport_t* rimp )
 	re.BeginFrame = RE_BeginFrame;
 	re.EndFrame	  = RE_EndFrame;
 
+	re.GetFrameTimes = RE_GetFrameTimes;
+
 	re.MarkFragments = R_MarkFragments;
 	re.LerpTag		 = R_LerpTag;
 	re.ModelBounds	 = R_ModelBounds;
@@ -891,7 +891,9 @@ typedef struct
 	int	  c_flareTests;
 	int	  c_flareRenders;
 
-	int	  msec; // total msec for backend run
+	int		  msec; // total msec for backend run
+	long long nsec;
+	long long raytraceNsec; // CPU side ray tracing setup, part of nsec
 } backEndCounters_t;
 
 // all state modified by the back end is seperated
@@ -981,6 +983,12 @@ typedef struct
 
 	frontEndCounters_t pc;
 	int				   frontEndMsec; // not in pc due to clearing issue
+	long long		   frontEndNsec;
+
+	// timings of the last finished frame, see RE_GetFrameTimes
+	long long		   lastFrontEndNsec;
+	long long		   lastBackEndNsec;
+	long long		   lastRaytraceNsec;
 
 	//
 	// put large tables at the end, so most elements will be
@@ -1058,6 +1066,7 @@ extern cvar_t*		  r_dynamiclight; // dynamic lights enabled/disabled
 extern cvar_t*		  r_dlightBacks;  // dlight non-facing surfaces for continuity
 
 extern cvar_t*		  r_norefresh;		// bypasses the ref rendering
+extern cvar_t*		  r_noGPU;			// CPU side of every frame only, for benchmarks
 extern cvar_t*		  r_drawentities;	// disable/enable entity rendering
 extern cvar_t*		  r_drawworld;		// disable/enable world rendering
 extern cvar_t*		  r_speeds;			// various levels of information display
@@ -1645,6 +1654,7 @@ void								 RE_SetColor( const float* rgba );
 void								 RE_StretchPic( float x, float y, float w, float h, float s1, float t1, float s2, float t2, qhandle_t hShader );
 void								 RE_BeginFrame( stereoFrame_t stereoFrame );
 void								 RE_EndFrame( int* frontEndMsec, int* backEndMsec );
+void								 RE_GetFrameTimes( long long* frontEndNsec, long long* backEndNsec, long long* raytraceNsec );
 void								 SaveJPG( char* filename, int quality, int image_width, int image_height, unsigned char* image_buffer );
 
 // font stuff
@@ -1658,6 +1668,7 @@ void								 RE_RegisterFont( const char* fontName, int pointSize, fontInfo_t* f
 void								 GL_FinishDXRLoading();
 void								 RE_FinishDXRLoading();
 void								 GL_Render( float x, float y, float z, vec3_t viewaxis[3] );
+void								 GL_PrepareRaytracingFrame( float x, float y, float z );
 void								 mult_matrix_vector( float* p, const float* a, const float* b );
 void								 mult_matrix_matrix( float* p, const float* a, const float* b );
 void								 inverse( const float* m, float* inv );
@@ -1700,6 +1711,7 @@ extern int							 r_invalidateDXRData;
 void								 RE_ShutdownRaytracingMap();
 
 void								 GL_RenderUISurface( int numIndexes, drawVert_t* verts, int* indexes, const shader_t* material, vec4_t color );
+void								 GL_DiscardUI();
 
 // jmarshall end
 
@@ -61,13 +61,12 @@ Returns CULL_IN, CULL_CLIP, or CULL_OUT
 */
 int			  R_CullLocalBox( vec3_t bounds[2] )
 {
-	int		  i, j;
+	int		  i;
 	vec3_t	  transformed[8];
-	float	  dists[8];
 	vec3_t	  v;
 	cplane_t* frust;
 	int		  anyBack;
-	int		  front, back;
+	int		  sides;
 
 	if( r_nocull->integer )
 	{
@@ -93,29 +92,13 @@ int			  R_CullLocalBox( vec3_t bounds[2] )
 	{
 		frust = &tr.viewParms.frustum[i];
 
-		front = back = 0;
-		for( j = 0; j < 8; j++ )
-		{
-			dists[j] = DotProduct( transformed[j], frust->normal );
-			if( dists[j] > frust->dist )
-			{
-				front = 1;
-				if( back )
-				{
-					break; // a point is in front
-				}
-			}
-			else
-			{
-				back = 1;
-			}
-		}
-		if( !front )
+		sides = PointsOnPlaneSide( ( const vec3_t* )transformed, 8, frust->normal, frust->dist );
+		if( !( sides & 1 ) )
 		{
 			// all points were behind one of the planes
 			return CULL_OUT;
 		}
-		anyBack |= back;
+		anyBack |= sides & 2;
 	}
 
 	if( !anyBack )
@@ -83,6 +83,9 @@ typedef struct
 	// if the pointers are not NULL, timing info will be returned
 	void ( *EndFrame )( int* frontEndMsec, int* backEndMsec );
 
+	// time spent on the last finished frame, the ray tracing setup is part of the back end
+	void ( *GetFrameTimes )( long long* frontEndNsec, long long* backEndNsec, long long* raytraceNsec );
+
 	int ( *MarkFragments )( int numPoints, const vec3_t* points, const vec3_t projection, int maxPoints, vec3_t pointBuffer, int maxFragments, markFragment_t* fragmentBuffer );
 
 	int ( *LerpTag )( orientation_t* tag, qhandle_t model, int startFrame, int endFrame, float frac, const char* tagName );
@@ -144,6 +147,16 @@ typedef struct
 	// visualization for debugging collision detection
 	void ( *CM_DrawDebugSurface )( void ( *drawPoly )( int color, int numPoints, float* points ) );
 
+	// memory telemetry for containers the engine can't see, shows up in mem_stats
+	memStat_t* ( *RegisterMemStat )( const char* name, int flags );
+	void ( *MemStatSet )( memStat_t* stat, int bytes );
+
+	// engine job system, jobs must not call back into ri
+	void ( *JobAdd )( const char* name, jobFunc_t func, void* data, jobCounter_t* signal );
+	void ( *JobWait )( jobCounter_t* counter );
+	void ( *JobParallelFor )( const char* name, int count, int minBatch, jobRangeFunc_t func, void* data );
+	int ( *JobNumWorkers )();
+
 	// a -1 return means the file does not exist
 	// NULL can be passed for buf to just determine existance
 	int ( *FS_FileIsInPAK )( const char* name, int* pCheckSum );
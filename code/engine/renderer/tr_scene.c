@@ -324,6 +324,7 @@ void RE_RenderScene( const refdef_t* fd )
 {
 	viewParms_t parms;
 	int			startTime;
+	long long	startNsec;
 
 	if( !tr.registered )
 	{
@@ -337,6 +338,8 @@ void RE_RenderScene( const refdef_t* fd )
 	}
 
 	startTime = ri.Milliseconds();
+	startNsec = Sys_Nanoseconds();
+	PROFILE_BEGIN( "RE_RenderScene" );
 
 	if( !tr.world && !( fd->rdflags & RDF_NOWORLDMODEL ) )
 	{
@@ -468,5 +471,7 @@ void RE_RenderScene( const refdef_t* fd )
 	r_firstSceneDlight	 = r_numdlights;
 	r_firstScenePoly	 = r_numpolys;
 
+	PROFILE_END();
 	tr.frontEndMsec += ri.Milliseconds() - startTime;
+	tr.frontEndNsec += Sys_Nanoseconds() - startNsec;
 }
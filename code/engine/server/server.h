@@ -246,6 +246,10 @@ extern cvar_t*	sv_pure;
 extern cvar_t*	sv_floodProtect;
 extern cvar_t*	sv_lanForceRate;
 extern cvar_t*	sv_strictAuth;
+extern cvar_t*	sv_queryRate;
+extern cvar_t*	sv_queryBurst;
+extern cvar_t*	sv_queryRateGlobal;
+extern cvar_t*	sv_queryBurstGlobal;
 
 //===========================================================
 
@@ -261,6 +265,8 @@ void			SV_RemoveOperatorCommands();
 void			SV_MasterHeartbeat();
 void			SV_MasterShutdown();
 
+void			SV_QueryStats_f();
+
 //
 // sv_init.c
 //
@@ -319,6 +325,9 @@ sharedEntity_t* SV_GEntityForSvEntity( svEntity_t* svEnt );
 void			SV_InitGameProgs();
 void			SV_ShutdownGameProgs();
 void			SV_RestartGameProgs();
+void			SV_GameClientThink( int clientNum );
+void			SV_GameRunFrame( int levelTime );
+int				SV_GameBotAIStartFrame( int time );
 qboolean		SV_inPVS( const vec3_t p1, const vec3_t p2 );
 
 //
@@ -331,8 +340,13 @@ void			SV_BotFreeClient( int clientNum );
 void			SV_BotInitCvars();
 int				SV_BotLibSetup();
 int				SV_BotLibShutdown();
+void			SV_BotRoutingBench_f();
 int				SV_BotGetSnapshotEntity( int client, int ent );
 int				SV_BotGetConsoleMessage( int client, char* buf, int size );
+void			SV_BotParallelFrame( qboolean begin );
+void			SV_BotThinkBegin( int client, int seed );
+void			SV_BotThinkEnd();
+qboolean		SV_BotDeferPrint( const char* text );
 
 int				BotImport_DebugPolygonCreate( int color, int numPoints, vec3_t* points );
 void			BotImport_DebugPolygonDelete( int id );
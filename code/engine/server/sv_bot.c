@@ -38,6 +38,61 @@ int						bot_maxdebugpolys;
 extern botlib_export_t* botlib_export;
 int						bot_enable;
 
+/*
+==============================================================================
+
+PARALLEL BOT THINK
+
+Between SV_BotParallelFrame( qtrue ) and ( qfalse ) the game may run its bots'
+AI on job workers. A thinking bot's client commands and prints, its own and
+botlib's, are kept per client and replayed in client order when the frame
+ends, so the server sees them in the same order whichever worker ran the
+bot. botlib's zone allocations are serialized.
+==============================================================================
+*/
+
+#define BOT_DEFERRED_TEXT 8192
+
+#define BOT_DEFER_COMMAND 0
+#define BOT_DEFER_PRINT	  1 // from the game
+#define BOT_DEFER_BOTLIB  2 // + the PRT_ type
+
+typedef struct
+{
+	int	 length;
+	int	 dropped;
+	char text[BOT_DEFERRED_TEXT]; // kind byte and nul terminated text, one after the other
+} botDeferred_t;
+
+static botDeferred_t	 botDeferred[MAX_CLIENTS];
+static qboolean			 botParallel;
+static volatile int		 botMemoryLock;
+static Q_THREADLOCAL int botThinkClient; // client + 1
+
+/*
+==================
+SV_BotDefer
+
+Only the thread running the bot writes to its queue
+==================
+*/
+static void SV_BotDefer( int client, int kind, const char* text )
+{
+	botDeferred_t* deferred;
+	int			   length;
+
+	deferred = &botDeferred[client];
+	length	 = strlen( text ) + 1;
+	if( deferred->length + 1 + length > BOT_DEFERRED_TEXT )
+	{
+		deferred->dropped++;
+		return;
+	}
+	deferred->text[deferred->length++] = kind;
+	Com_Memcpy( deferred->text + deferred->length, text, length );
+	deferred->length += length;
+}
+
 /*
 ==================
 SV_BotAllocateClient
@@ -176,6 +231,12 @@ void QDECL BotImport_Print( int type, char* fmt, ... )
 	vsprintf( str, fmt, ap );
 	va_end( ap );
 
+	if( botParallel && botThinkClient )
+	{
+		SV_BotDefer( botThinkClient - 1, BOT_DEFER_BOTLIB + type, str );
+		return;
+	}
+
 	switch( type )
 	{
 		case PRT_MESSAGE:
@@ -333,6 +394,39 @@ void BotImport_BSPModelMinsMaxsOrigin( int modelnum, vec3_t angles, vec3_t outmi
 	}
 }
 
+/*
+==================
+SV_BotLockMemory
+
+The zone isn't thread safe, bots thinking in parallel take turns
+==================
+*/
+static void SV_BotLockMemory()
+{
+	if( !botParallel )
+	{
+		return;
+	}
+	while( Com_AtomicCompareExchange( &botMemoryLock, 1, 0 ) != 0 )
+	{
+		Sys_Yield();
+	}
+}
+
+/*
+==================
+SV_BotUnlockMemory
+==================
+*/
+static void SV_BotUnlockMemory()
+{
+	if( !botParallel )
+	{
+		return;
+	}
+	Com_AtomicCompareExchange( &botMemoryLock, 0, 1 );
+}
+
 /*
 ==================
 BotImport_GetMemory
@@ -342,7 +436,9 @@ void* BotImport_GetMemory( int size )
 {
 	void* ptr;
 
+	SV_BotLockMemory();
 	ptr = Z_TagMalloc( size, TAG_BOTLIB );
+	SV_BotUnlockMemory();
 	return ptr;
 }
 
@@ -353,7 +449,24 @@ BotImport_FreeMemory
 */
 void BotImport_FreeMemory( void* ptr )
 {
+	SV_BotLockMemory();
 	Z_Free( ptr );
+	SV_BotUnlockMemory();
+}
+
+/*
+==================
+BotImport_AvailableMemory
+==================
+*/
+int BotImport_AvailableMemory()
+{
+	int available;
+
+	SV_BotLockMemory();
+	available = Z_AvailableMemory();
+	SV_BotUnlockMemory();
+	return available;
 }
 
 /*
@@ -363,11 +476,16 @@ BotImport_HunkAlloc
 */
 void* BotImport_HunkAlloc( int size )
 {
+	void* buf;
+
 	if( Hunk_CheckMark() )
 	{
 		Com_Error( ERR_DROP, "SV_Bot_HunkAlloc: Alloc with marks already set\n" );
 	}
-	return Hunk_Alloc( size, h_high );
+	Hunk_SetLabel( "botlib" );
+	buf = Hunk_Alloc( size, h_high );
+	Hunk_SetLabel( NULL );
+	return buf;
 }
 
 /*
@@ -506,9 +624,116 @@ SV_BotClientCommand
 */
 void BotClientCommand( int client, char* command )
 {
+	if( botParallel )
+	{
+		SV_BotDefer( client, BOT_DEFER_COMMAND, command );
+		return;
+	}
 	SV_ExecuteClientCommand( &svs.clients[client], command, qtrue );
 }
 
+/*
+==================
+SV_BotParallelFrame
+
+The game is about to think its bots on job workers, or is done with them
+==================
+*/
+void SV_BotParallelFrame( qboolean begin )
+{
+	botDeferred_t* deferred;
+	const char*	   text;
+	int			   i, kind;
+
+	if( begin )
+	{
+		for( i = 0; i < MAX_CLIENTS; i++ )
+		{
+			botDeferred[i].length  = 0;
+			botDeferred[i].dropped = 0;
+		}
+		botParallel = qtrue;
+		botlib_export->BotLibParallelFrame( qtrue );
+		return;
+	}
+
+	if( !botParallel )
+	{
+		return;
+	}
+	botParallel = qfalse;
+	botlib_export->BotLibParallelFrame( qfalse );
+
+	for( i = 0; i < MAX_CLIENTS; i++ )
+	{
+		deferred = &botDeferred[i];
+		for( text = deferred->text; text < deferred->text + deferred->length; text += strlen( text ) + 1 )
+		{
+			kind = *text++;
+			if( kind == BOT_DEFER_COMMAND )
+			{
+				SV_ExecuteClientCommand( &svs.clients[i], ( char* )text, qtrue );
+			}
+			else if( kind == BOT_DEFER_PRINT )
+			{
+				Com_Printf( "%s", text );
+			}
+			else
+			{
+				BotImport_Print( kind - BOT_DEFER_BOTLIB, "%s", text );
+			}
+		}
+		if( deferred->dropped )
+		{
+			Com_Printf( S_COLOR_YELLOW "WARNING: %i commands and prints of bot %i dropped\n", deferred->dropped, i );
+		}
+		deferred->length  = 0;
+		deferred->dropped = 0;
+	}
+}
+
+/*
+==================
+SV_BotThinkBegin
+
+Called on the thread that thinks for the bot, the seed keeps botlib's
+random choices for it the same whichever thread that is
+==================
+*/
+void SV_BotThinkBegin( int client, int seed )
+{
+	botThinkClient = client + 1;
+	botlib_export->BotLibThinkBegin( client, seed );
+}
+
+/*
+==================
+SV_BotThinkEnd
+==================
+*/
+void SV_BotThinkEnd()
+{
+	botlib_export->BotLibThinkEnd();
+	botThinkClient = 0;
+}
+
+/*
+==================
+SV_BotDeferPrint
+
+qtrue if a thinking bot printed the text, it comes out when the frame ends
+==================
+*/
+qboolean SV_BotDeferPrint( const char* text )
+{
+	if( !botParallel || !botThinkClient )
+	{
+		return qfalse;
+	}
+	SV_BotDefer( botThinkClient - 1, BOT_DEFER_PRINT, text );
+	return qtrue;
+}
+
 /*
 ==================
 SV_BotFrame
@@ -525,7 +750,7 @@ void SV_BotFrame( int time )
 	{
 		return;
 	}
-	VM_Call( gvm, BOTAI_START_FRAME, time );
+	SV_GameBotAIStartFrame( time );
 }
 
 /*
@@ -567,6 +792,25 @@ int SV_BotLibShutdown()
 	return botlib_export->BotLibShutdown();
 }
 
+/*
+==================
+SV_BotRoutingBench_f
+
+Creates all routing cache of the loaded map with both update orders, the
+botlib prints the times at the start of the next bot frame
+==================
+*/
+void SV_BotRoutingBench_f()
+{
+	if( !com_sv_running->integer || !bot_enable || !botlib_export )
+	{
+		Com_Printf( "No bots running.\n" );
+		return;
+	}
+
+	botlib_export->BotLibVarSet( "routingbenchmark", "1" );
+}
+
 /*
 ==================
 SV_BotInitCvars
@@ -639,7 +883,7 @@ void SV_BotInitBotLib()
 	// memory management
 	botlib_import.GetMemory		  = BotImport_GetMemory;
 	botlib_import.FreeMemory	  = BotImport_FreeMemory;
-	botlib_import.AvailableMemory = Z_AvailableMemory;
+	botlib_import.AvailableMemory = BotImport_AvailableMemory;
 	botlib_import.HunkAlloc		  = BotImport_HunkAlloc;
 
 	// file system access
@@ -648,6 +892,8 @@ void SV_BotInitBotLib()
 	botlib_import.FS_Write		= FS_Write;
 	botlib_import.FS_FCloseFile = FS_FCloseFile;
 	botlib_import.FS_Seek		= FS_Seek;
+	botlib_import.FS_MapFile	= FS_MapFile;
+	botlib_import.FS_UnmapFile	= FS_UnmapFile;
 
 	// debug lines
 	botlib_import.DebugLineCreate = BotImport_DebugLineCreate;
@@ -658,6 +904,13 @@ void SV_BotInitBotLib()
 	botlib_import.DebugPolygonCreate = BotImport_DebugPolygonCreate;
 	botlib_import.DebugPolygonDelete = BotImport_DebugPolygonDelete;
 
+	// jobs
+	botlib_import.JobAdd		 = Job_Add;
+	botlib_import.JobWait		 = Job_Wait;
+	botlib_import.JobParallelFor = Job_ParallelFor;
+	botlib_import.JobNumWorkers	 = Job_NumWorkers;
+	botlib_import.Yield			 = Sys_Yield;
+
 	botlib_export = ( botlib_export_t* )GetBotLibAPI( BOTLIB_API_VERSION, &botlib_import );
 	assert( botlib_export ); // bk001129 - somehow we end up with a zero import.
 }
@@ -306,7 +306,7 @@ static void SV_MapRestart_f()
 	// run a few frames to allow everything to settle
 	for( i = 0; i < 3; i++ )
 	{
-		VM_Call( gvm, GAME_RUN_FRAME, svs.time );
+		SV_GameRunFrame( svs.time );
 		svs.time += 100;
 	}
 
@@ -353,7 +353,7 @@ static void SV_MapRestart_f()
 	}
 
 	// run another frame to allow things to look at all the players
-	VM_Call( gvm, GAME_RUN_FRAME, svs.time );
+	SV_GameRunFrame( svs.time );
 	svs.time += 100;
 }
 
@@ -806,6 +806,105 @@ static void SV_KillServer_f()
 	SV_Shutdown( "killserver" );
 }
 
+/*
+=================
+SV_GameBenchCompare
+=================
+*/
+static int SV_GameBenchCompare( const void* a, const void* b )
+{
+	return *( const int* )a - *( const int* )b;
+}
+
+/*
+=================
+SV_GameBench_f
+
+Runs the given number of game frames, bots included, back to back and
+prints their times. Run it on the same map and bots with vm_game 0, 1 and
+2 to compare the dll with the interpreted and the compiled qvm.
+=================
+*/
+static void SV_GameBench_f()
+{
+	fileHandle_t f;
+	char		 filename[MAX_QPATH];
+	char		 line[512];
+	int*		 samples;
+	int			 frames, frameMsec, i;
+	long long	 start, total;
+
+	if( !com_sv_running->integer )
+	{
+		Com_Printf( "Server is not running.\n" );
+		return;
+	}
+
+	if( Cmd_Argc() < 2 )
+	{
+		Com_Printf( "usage: gamebench <frames> [file]\n" );
+		return;
+	}
+
+	frames = Com_Clamp( 1, 100000, atoi( Cmd_Argv( 1 ) ) );
+	frameMsec = 1000 / ( sv_fps->integer > 0 ? sv_fps->integer : 10 );
+
+	samples = Z_Malloc( frames * sizeof( int ) );
+	total	= 0;
+	for( i = 0; i < frames; i++ )
+	{
+		start = Sys_Nanoseconds();
+
+		svs.time += frameMsec;
+		SV_BotFrame( svs.time );
+		SV_GameRunFrame( svs.time );
+
+		samples[i] = ( Sys_Nanoseconds() - start ) / 1000;
+		total += samples[i];
+	}
+	qsort( samples, frames, sizeof( int ), SV_GameBenchCompare );
+
+	// nearest rank
+	Com_sprintf( line,
+		sizeof( line ),
+		"{\"vm\":\"%s\",\"frames\":%i,\"meanUsec\":%.1f,\"p50Usec\":%i,\"p95Usec\":%i,\"p99Usec\":%i,\"maxUsec\":%i}\n",
+		VM_TypeString( gvm ),
+		frames,
+		total / ( double )frames,
+		samples[( frames * 50 + 99 ) / 100 - 1],
+		samples[( frames * 95 + 99 ) / 100 - 1],
+		samples[( frames * 99 + 99 ) / 100 - 1],
+		samples[frames - 1] );
+
+	Com_Printf( "%s game, %i frames: mean %.1f usec  p50 %i  p95 %i  p99 %i  max %i\n",
+		VM_TypeString( gvm ),
+		frames,
+		total / ( double )frames,
+		samples[( frames * 50 + 99 ) / 100 - 1],
+		samples[( frames * 95 + 99 ) / 100 - 1],
+		samples[( frames * 99 + 99 ) / 100 - 1],
+		samples[frames - 1] );
+
+	if( Cmd_Argc() > 2 )
+	{
+		Q_strncpyz( filename, Cmd_Argv( 2 ), sizeof( filename ) );
+		COM_DefaultExtension( filename, sizeof( filename ), ".json" );
+		f = FS_FOpenFileWrite( filename );
+		if( f )
+		{
+			FS_Write( line, strlen( line ), f );
+			FS_FCloseFile( f );
+			Com_Printf( "wrote %s\n", filename );
+		}
+		else
+		{
+			Com_Printf( "Couldn't write %s\n", filename );
+		}
+	}
+
+	Z_Free( samples );
+}
+
 //===========================================================
 
 /*
@@ -841,6 +940,9 @@ void SV_AddOperatorCommands()
 	Cmd_AddCommand( "spdevmap", SV_Map_f );
 #endif
 	Cmd_AddCommand( "killserver", SV_KillServer_f );
+	Cmd_AddCommand( "querystats", SV_QueryStats_f );
+	Cmd_AddCommand( "gamebench", SV_GameBench_f );
+	Cmd_AddCommand( "routingbench", SV_BotRoutingBench_f );
 	if( com_dedicated->integer )
 	{
 		Cmd_AddCommand( "say", SV_ConSay_f );
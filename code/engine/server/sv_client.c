@@ -1493,7 +1493,7 @@ void SV_ClientThink( client_t* cl, usercmd_t* cmd )
 		return; // may have been kicked during the last usercmd
 	}
 
-	VM_Call( gvm, GAME_CLIENT_THINK, cl - svs.clients );
+	SV_GameClientThink( cl - svs.clients );
 }
 
 /*
@@ -319,6 +319,22 @@ static int FloatAsInt( float f )
 	return temp.i;
 }
 
+/*
+====================
+SV_GameNativeJobs
+
+The job functions and counters are native pointers, a qvm could make a
+worker jump anywhere
+====================
+*/
+static void SV_GameNativeJobs( const char* call )
+{
+	if( !VM_IsNative( gvm ) )
+	{
+		Com_Error( ERR_DROP, "%s: only a native game can use jobs", call );
+	}
+}
+
 /*
 ====================
 SV_GameSystemCalls
@@ -332,7 +348,10 @@ int SV_GameSystemCalls( intptr_t* args )
 	switch( args[0] )
 	{
 		case G_PRINT:
-			Com_Printf( "%s", VMA( 1 ) );
+			if( !SV_BotDeferPrint( VMA( 1 ) ) )
+			{
+				Com_Printf( "%s", VMA( 1 ) );
+			}
 			return 0;
 		case G_ERROR:
 			Com_Error( ERR_DROP, "%s", VMA( 1 ) );
@@ -378,6 +397,39 @@ int SV_GameSystemCalls( intptr_t* args )
 		case G_FS_SEEK:
 			return FS_Seek( args[1], args[2], args[3] );
 
+		case G_CVAR_SET_HANDLE:
+			Cvar_SetHandle( args[1], VMA( 2 ) );
+			return 0;
+		case G_CVAR_MODIFICATION_COUNT:
+			return cvar_modificationCount;
+
+		case G_PROFILE_BEGIN:
+			Com_ProfileBeginCopy( VMA( 1 ) );
+			return 0;
+		case G_PROFILE_END:
+			Com_ProfileEnd();
+			return 0;
+
+		// the names are copied, the module can be unloaded before a capture is written
+		case G_JOB_ADD:
+			SV_GameNativeJobs( "G_JOB_ADD" );
+			Job_Add( Com_ProfileInternName( VMA( 1 ) ), ( jobFunc_t )args[2], VMA( 3 ), VMA( 4 ) );
+			return 0;
+		case G_JOB_WAIT:
+			SV_GameNativeJobs( "G_JOB_WAIT" );
+			Job_Wait( VMA( 1 ) );
+			return 0;
+		case G_JOB_PARALLEL_FOR:
+			SV_GameNativeJobs( "G_JOB_PARALLEL_FOR" );
+			Job_ParallelFor( Com_ProfileInternName( VMA( 1 ) ), args[2], args[3], ( jobRangeFunc_t )args[4], VMA( 5 ) );
+			return 0;
+		case G_JOB_NUM_WORKERS:
+			return Job_NumWorkers();
+
+		case G_LOG_WRITE:
+			Com_LogWrite( VMA( 1 ), args[2], args[3] );
+			return 0;
+
 		case G_LOCATE_GAME_DATA:
 			SV_LocateGameData( VMA( 1 ), args[2], args[3], VMA( 4 ), args[5] );
 			return 0;
@@ -510,6 +562,15 @@ int SV_GameSystemCalls( intptr_t* args )
 		case BOTLIB_USER_COMMAND:
 			SV_ClientThink( &svs.clients[args[1]], VMA( 2 ) );
 			return 0;
+		case BOTLIB_PARALLEL_FRAME:
+			SV_BotParallelFrame( args[1] );
+			return 0;
+		case BOTLIB_THINK_BEGIN:
+			SV_BotThinkBegin( args[1], args[2] );
+			return 0;
+		case BOTLIB_THINK_END:
+			SV_BotThinkEnd();
+			return 0;
 
 		case BOTLIB_AAS_BBOX_AREAS:
 			return botlib_export->aas.AAS_BBoxAreas( VMA( 1 ), VMA( 2 ), VMA( 3 ), args[4] );
@@ -883,6 +944,136 @@ int SV_GameSystemCalls( intptr_t* args )
 	return -1;
 }
 
+/*
+==============================================================================
+
+DIRECT CALLS
+
+A native game that exports dllGetAPI gets the typed imports below for the
+calls made thousands of times a frame and hands back its own table for
+the per client and per frame entry points, skipping the varargs packing
+of VM_DllSyscall / VM_Call and the dispatch switches. Anything not in the
+tables, and any game without dllGetAPI, uses the syscalls as before.
+==============================================================================
+*/
+
+static const gameExportTable_t* gameExports;
+
+static void SV_GameTrace( trace_t* results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask, int capsule )
+{
+	SV_Trace( results, start, ( float* )mins, ( float* )maxs, end, passEntityNum, contentmask, capsule );
+}
+
+static qboolean SV_GameEntityContact( const vec3_t mins, const vec3_t maxs, const sharedEntity_t* ent, int capsule )
+{
+	return SV_EntityContact( ( float* )mins, ( float* )maxs, ent, capsule );
+}
+
+static const gameImportTable_t gameImports = {
+	{ GAME_DIRECT_API_VERSION, sizeof( gameImportTable_t ) },
+
+	Sys_Milliseconds,
+	Cvar_Update,
+	Cvar_VariableIntegerValue,
+
+	SV_GameTrace,
+	SV_PointContents,
+	SV_inPVS,
+	SV_inPVSIgnorePortals,
+	CM_AreasConnected,
+
+	SV_LinkEntity,
+	SV_UnlinkEntity,
+	SV_AreaEntities,
+	SV_GameEntityContact,
+
+	SV_GetUsercmd,
+};
+
+/*
+===============
+SV_GameFindExports
+===============
+*/
+static void SV_GameFindExports()
+{
+	const vmApiHeader_t* exports;
+
+	gameExports = NULL;
+
+	exports = VM_Exports( gvm );
+	if( !exports )
+	{
+		return;
+	}
+	if( exports->size < ( int )sizeof( gameExportTable_t ) )
+	{
+		Com_Error( ERR_FATAL, "game export table is too small (%i bytes)", exports->size );
+	}
+	gameExports = ( const gameExportTable_t* )exports;
+}
+
+/*
+===============
+SV_GameClientThink
+===============
+*/
+void SV_GameClientThink( int clientNum )
+{
+	vm_t* oldVM;
+
+	if( !gameExports )
+	{
+		VM_Call( gvm, GAME_CLIENT_THINK, clientNum );
+		return;
+	}
+
+	oldVM = VM_Enter( gvm );
+	gameExports->ClientThink( clientNum );
+	VM_Leave( oldVM );
+}
+
+/*
+===============
+SV_GameRunFrame
+===============
+*/
+void SV_GameRunFrame( int levelTime )
+{
+	vm_t* oldVM;
+
+	if( !gameExports )
+	{
+		VM_Call( gvm, GAME_RUN_FRAME, levelTime );
+		return;
+	}
+
+	oldVM = VM_Enter( gvm );
+	gameExports->RunFrame( levelTime );
+	VM_Leave( oldVM );
+}
+
+/*
+===============
+SV_GameBotAIStartFrame
+===============
+*/
+int SV_GameBotAIStartFrame( int time )
+{
+	vm_t* oldVM;
+	int	  result;
+
+	if( !gameExports )
+	{
+		return VM_Call( gvm, BOTAI_START_FRAME, time );
+	}
+
+	oldVM  = VM_Enter( gvm );
+	result = gameExports->BotAIStartFrame( time );
+	VM_Leave( oldVM );
+	return result;
+}
+
 /*
 ===============
 SV_ShutdownGameProgs
@@ -898,7 +1089,8 @@ void SV_ShutdownGameProgs()
 	}
 	VM_Call( gvm, GAME_SHUTDOWN, qfalse );
 	VM_Free( gvm );
-	gvm = NULL;
+	gvm			= NULL;
+	gameExports = NULL;
 }
 
 /*
@@ -951,6 +1143,7 @@ void SV_RestartGameProgs()
 		// bk001212 - as done below
 		Com_Error( ERR_FATAL, "VM_Restart on game failed" );
 	}
+	SV_GameFindExports();
 
 	SV_InitGameVM( qtrue );
 }
@@ -979,11 +1172,12 @@ void SV_InitGameProgs()
 	}
 
 	// load the dll or bytecode
-	gvm = VM_Create( "qagame", SV_GameSystemCalls, Cvar_VariableValue( "vm_game" ) );
+	gvm = VM_Create( "qagame", SV_GameSystemCalls, &gameImports.header, Cvar_VariableValue( "vm_game" ) );
 	if( !gvm )
 	{
 		Com_Error( ERR_FATAL, "VM_Create on game failed" );
 	}
+	SV_GameFindExports();
 
 	SV_InitGameVM( qfalse );
 }
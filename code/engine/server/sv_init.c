@@ -435,7 +435,9 @@ void SV_SpawnServer( char* server, qboolean killBots )
 	FS_ClearPakReferences( 0 );
 
 	// allocate the snapshot entities on the hunk
+	Hunk_SetLabel( "server" );
 	svs.snapshotEntities	 = Hunk_Alloc( sizeof( entityState_t ) * svs.numSnapshotEntities, h_high );
+	Hunk_SetLabel( NULL );
 	svs.nextSnapshotEntities = 0;
 
 	// toggle the server bit so clients can detect that a
@@ -492,7 +494,7 @@ void SV_SpawnServer( char* server, qboolean killBots )
 	// run a few frames to allow everything to settle
 	for( i = 0; i < 3; i++ )
 	{
-		VM_Call( gvm, GAME_RUN_FRAME, svs.time );
+		SV_GameRunFrame( svs.time );
 		SV_BotFrame( svs.time );
 		svs.time += 100;
 	}
@@ -558,7 +560,7 @@ void SV_SpawnServer( char* server, qboolean killBots )
 	}
 
 	// run another frame to allow things to look at all the players
-	VM_Call( gvm, GAME_RUN_FRAME, svs.time );
+	SV_GameRunFrame( svs.time );
 	SV_BotFrame( svs.time );
 	svs.time += 100;
 
@@ -645,6 +647,12 @@ void SV_Init()
 	sv_maxPing		= Cvar_Get( "sv_maxPing", "0", CVAR_ARCHIVE | CVAR_SERVERINFO );
 	sv_floodProtect = Cvar_Get( "sv_floodProtect", "1", CVAR_ARCHIVE | CVAR_SERVERINFO );
 
+	// connectionless packet limits, 0 rates turn them off
+	sv_queryRate		= Cvar_Get( "sv_queryRate", "4", CVAR_ARCHIVE );
+	sv_queryBurst		= Cvar_Get( "sv_queryBurst", "10", CVAR_ARCHIVE );
+	sv_queryRateGlobal	= Cvar_Get( "sv_queryRateGlobal", "50", CVAR_ARCHIVE );
+	sv_queryBurstGlobal = Cvar_Get( "sv_queryBurstGlobal", "100", CVAR_ARCHIVE );
+
 	// systeminfo
 	Cvar_Get( "sv_cheats", "1", CVAR_SYSTEMINFO | CVAR_ROM );
 	sv_serverid = Cvar_Get( "sv_serverid", "0", CVAR_SYSTEMINFO | CVAR_ROM );
@@ -52,6 +52,10 @@ cvar_t*		   sv_pure;
 cvar_t*		   sv_floodProtect;
 cvar_t*		   sv_lanForceRate; // dedicated 1 (LAN) server forces local client rates to 99999 (bug #491)
 cvar_t*		   sv_strictAuth;
+cvar_t*		   sv_queryRate; // queries per second from one address
+cvar_t*		   sv_queryBurst;
+cvar_t*		   sv_queryRateGlobal; // getstatus / getinfo replies per second
+cvar_t*		   sv_queryBurstGlobal;
 
 /*
 =============================================================================
@@ -311,9 +315,250 @@ void SV_MasterShutdown()
 
 CONNECTIONLESS COMMANDS
 
+Every getstatus, getinfo and getchallenge packet from the net costs its
+sender address a token, getstatus and getinfo replies also cost one from a
+server wide bucket, so scrapers and spoofed reflection requests can't keep
+the server busy. connect and rcon are never throttled. The replies themselves are kept and only rebuilt when the cvars they come from,
+the player list or a player's score, ping or name have changed.
+"querystats" shows the counters.
 ==============================================================================
 */
 
+#define QUERY_ADDRESS_BUCKETS 4096 // power of 2
+
+typedef struct
+{
+	int tokens; // in thousandths
+	int lastTime;
+} queryBucket_t;
+
+typedef struct
+{
+	netadrtype_t  type;
+	byte		  ip[4];
+	byte		  ipx[10];
+	queryBucket_t bucket;
+} queryAddress_t;
+
+typedef struct
+{
+	int packets;
+	int addressLimited;
+	int globalLimited;
+	int statusBuilt;
+	int statusCached;
+	int infoBuilt;
+	int infoCached;
+} queryStats_t;
+
+typedef struct
+{
+	qboolean connected;
+	int		 score;
+	int		 ping;
+	char	 name[MAX_NAME_LENGTH];
+} statusPlayer_t;
+
+static queryAddress_t queryAddresses[QUERY_ADDRESS_BUCKETS];
+static queryBucket_t  queryGlobal;
+static queryStats_t	  queryStats;
+
+// the cached replies, without the challenge
+static int			  statusCvarCount = -1;
+static statusPlayer_t statusPlayers[MAX_CLIENTS];
+static char			  statusInfo[MAX_INFO_STRING];
+static char			  statusList[MAX_MSGLEN - MAX_INFO_STRING - 64];
+
+static int			  infoCvarCount = -1;
+static int			  infoClients;
+static char			  infoString[MAX_INFO_STRING];
+
+/*
+================
+SV_QueryTakeToken
+
+Refills the bucket for the time since it was last used, rate is tokens
+per second, 0 turns the limit off
+================
+*/
+static qboolean SV_QueryTakeToken( queryBucket_t* b, int rate, int burst )
+{
+	int elapsed;
+
+	if( rate <= 0 )
+	{
+		return qtrue;
+	}
+	if( burst < 1 )
+	{
+		burst = 1;
+	}
+
+	elapsed = svs.time - b->lastTime;
+	if( elapsed < 0 || elapsed > burst * 1000 )
+	{
+		elapsed = burst * 1000; // long enough to fill it at any rate
+	}
+	b->lastTime = svs.time;
+
+	b->tokens += elapsed * rate;
+	if( b->tokens > burst * 1000 )
+	{
+		b->tokens = burst * 1000;
+	}
+
+	if( b->tokens < 1000 )
+	{
+		return qfalse;
+	}
+	b->tokens -= 1000;
+	return qtrue;
+}
+
+/*
+================
+SV_QueryAddressBucket
+
+The table is direct mapped, an address that collides with another one
+takes over its slot with a full bucket
+================
+*/
+static queryBucket_t* SV_QueryAddressBucket( netadr_t from )
+{
+	queryAddress_t* qa;
+	unsigned int	hash;
+	int				i;
+
+	hash = from.type;
+	for( i = 0; i < 4; i++ )
+	{
+		hash = hash * 33 + from.ip[i];
+	}
+	if( from.type == NA_IPX )
+	{
+		for( i = 0; i < 10; i++ )
+		{
+			hash = hash * 33 + from.ipx[i];
+		}
+	}
+	hash ^= hash >> 13;
+
+	qa = &queryAddresses[hash & ( QUERY_ADDRESS_BUCKETS - 1 )];
+	if( qa->type != from.type || memcmp( qa->ip, from.ip, sizeof( qa->ip ) ) || ( from.type == NA_IPX && memcmp( qa->ipx, from.ipx, sizeof( qa->ipx ) ) ) )
+	{
+		qa->type = from.type;
+		Com_Memcpy( qa->ip, from.ip, sizeof( qa->ip ) );
+		Com_Memcpy( qa->ipx, from.ipx, sizeof( qa->ipx ) );
+		qa->bucket.tokens	= sv_queryBurst->integer * 1000;
+		qa->bucket.lastTime = svs.time;
+	}
+
+	return &qa->bucket;
+}
+
+/*
+================
+SV_QueryFromNet
+
+Local and bot addresses are never limited
+================
+*/
+static qboolean SV_QueryFromNet( netadr_t from )
+{
+	return from.type == NA_IP || from.type == NA_IPX || from.type == NA_BROADCAST || from.type == NA_BROADCAST_IPX;
+}
+
+/*
+================
+SV_QueryGlobalToken
+================
+*/
+static qboolean SV_QueryGlobalToken( netadr_t from )
+{
+	if( !SV_QueryFromNet( from ) )
+	{
+		return qtrue;
+	}
+
+	if( !SV_QueryTakeToken( &queryGlobal, sv_queryRateGlobal->integer, sv_queryBurstGlobal->integer ) )
+	{
+		queryStats.globalLimited++;
+		return qfalse;
+	}
+	return qtrue;
+}
+
+/*
+================
+SV_QueryChallenge
+
+The challenge pair to put in front of a cached reply, or nothing if the
+challenge couldn't go into an info string
+================
+*/
+static const char* SV_QueryChallenge( const char* info )
+{
+	static char pair[MAX_INFO_STRING];
+	const char* challenge;
+
+	challenge = Cmd_Argv( 1 );
+	if( !challenge[0] || strchr( challenge, '\\' ) || strchr( challenge, ';' ) || strchr( challenge, '"' ) )
+	{
+		return "";
+	}
+	if( strlen( info ) + strlen( challenge ) + 11 >= MAX_INFO_STRING )
+	{
+		return "";
+	}
+
+	Com_sprintf( pair, sizeof( pair ), "\\challenge\\%s", challenge );
+	return pair;
+}
+
+/*
+================
+SV_StatusPlayersChanged
+
+Compares the player list against the one in the cached status
+================
+*/
+static qboolean SV_StatusPlayersChanged()
+{
+	statusPlayer_t* sp;
+	client_t*		cl;
+	qboolean		changed;
+	int				i, score;
+
+	changed = qfalse;
+	for( i = 0; i < sv_maxclients->integer && i < MAX_CLIENTS; i++ )
+	{
+		cl = &svs.clients[i];
+		sp = &statusPlayers[i];
+
+		if( cl->state < CS_CONNECTED )
+		{
+			if( sp->connected )
+			{
+				sp->connected = qfalse;
+				changed		  = qtrue;
+			}
+			continue;
+		}
+
+		score = SV_GameClientNum( i )->persistant[PERS_SCORE];
+		if( !sp->connected || sp->score != score || sp->ping != cl->ping || strcmp( sp->name, cl->name ) )
+		{
+			sp->connected = qtrue;
+			sp->score	  = score;
+			sp->ping	  = cl->ping;
+			Q_strncpyz( sp->name, cl->name, sizeof( sp->name ) );
+			changed = qtrue;
+		}
+	}
+
+	return changed;
+}
+
 /*
 ================
 SVC_Status
@@ -325,14 +570,12 @@ the simple info query.
 */
 void SVC_Status( netadr_t from )
 {
-	char		   player[1024];
-	char		   status[MAX_MSGLEN];
-	int			   i;
-	client_t*	   cl;
-	playerState_t* ps;
-	int			   statusLength;
-	int			   playerLength;
-	char		   infostring[MAX_INFO_STRING];
+	static infoMap_t info;
+	char			 player[1024];
+	int				 i;
+	int				 statusLength;
+	int				 playerLength;
+	qboolean		 changed;
 
 	// ignore if we are in single player
 	if( Cvar_VariableValue( "g_gametype" ) == GT_SINGLE_PLAYER )
@@ -340,42 +583,61 @@ void SVC_Status( netadr_t from )
 		return;
 	}
 
-	strcpy( infostring, Cvar_InfoString( CVAR_SERVERINFO ) );
-
-	// echo back the parameter to status. so master servers can use it as a challenge
-	// to prevent timed spoofed reply packets that add ghost servers
-	Info_SetValueForKey( infostring, "challenge", Cmd_Argv( 1 ) );
+	if( !SV_QueryGlobalToken( from ) )
+	{
+		return;
+	}
 
-	// add "demo" to the sv_keywords if restricted
-	if( Cvar_VariableValue( "fs_restrict" ) )
+	changed = SV_StatusPlayersChanged();
+	// also bumped when a serverinfo cvar is created or a cvar becomes serverinfo
+	if( statusCvarCount != cvar_modificationCount )
 	{
-		char keywords[MAX_INFO_STRING];
+		statusCvarCount = cvar_modificationCount;
 
-		Com_sprintf( keywords, sizeof( keywords ), "demo %s", Info_ValueForKey( infostring, "sv_keywords" ) );
-		Info_SetValueForKey( infostring, "sv_keywords", keywords );
-	}
+		InfoMap_Parse( &info, Cvar_InfoString( CVAR_SERVERINFO ), MAX_INFO_STRING );
+
+		// add "demo" to the sv_keywords if restricted
+		if( Cvar_VariableValue( "fs_restrict" ) )
+		{
+			char keywords[MAX_INFO_STRING];
 
-	status[0]	 = 0;
-	statusLength = 0;
+			Com_sprintf( keywords, sizeof( keywords ), "demo %s", InfoMap_ValueForKey( &info, "sv_keywords" ) );
+			InfoMap_SetValueForKey( &info, "sv_keywords", keywords );
+		}
 
-	for( i = 0; i < sv_maxclients->integer; i++ )
+		Q_strncpyz( statusInfo, InfoMap_String( &info ), sizeof( statusInfo ) );
+		changed = qtrue;
+	}
+
+	if( changed )
 	{
-		cl = &svs.clients[i];
-		if( cl->state >= CS_CONNECTED )
+		statusList[0] = 0;
+		statusLength  = 0;
+
+		for( i = 0; i < sv_maxclients->integer && i < MAX_CLIENTS; i++ )
 		{
-			ps = SV_GameClientNum( i );
-			Com_sprintf( player, sizeof( player ), "%i %i \"%s\"\n", ps->persistant[PERS_SCORE], cl->ping, cl->name );
-			playerLength = strlen( player );
-			if( statusLength + playerLength >= sizeof( status ) )
+			if( statusPlayers[i].connected )
 			{
-				break; // can't hold any more
+				Com_sprintf( player, sizeof( player ), "%i %i \"%s\"\n", statusPlayers[i].score, statusPlayers[i].ping, statusPlayers[i].name );
+				playerLength = strlen( player );
+				if( statusLength + playerLength >= sizeof( statusList ) )
+				{
+					break; // can't hold any more
+				}
+				strcpy( statusList + statusLength, player );
+				statusLength += playerLength;
 			}
-			strcpy( status + statusLength, player );
-			statusLength += playerLength;
 		}
+		queryStats.statusBuilt++;
+	}
+	else
+	{
+		queryStats.statusCached++;
 	}
 
-	NET_OutOfBandPrint( NS_SERVER, from, "statusResponse\n%s\n%s", infostring, status );
+	// echo back the parameter to status. so master servers can use it as a challenge
+	// to prevent timed spoofed reply packets that add ghost servers
+	NET_OutOfBandPrint( NS_SERVER, from, "statusResponse\n%s%s\n%s", SV_QueryChallenge( statusInfo ), statusInfo, statusList );
 }
 
 /*
@@ -388,9 +650,9 @@ if a user is interested in a server to do a full status
 */
 void SVC_Info( netadr_t from )
 {
-	int	  i, count;
-	char* gamedir;
-	char  infostring[MAX_INFO_STRING];
+	static infoMap_t info;
+	int				 i, count;
+	char*			 gamedir;
 
 	// ignore if we are in single player
 	if( Cvar_VariableValue( "g_gametype" ) == GT_SINGLE_PLAYER || Cvar_VariableValue( "ui_singlePlayerActive" ) )
@@ -398,6 +660,11 @@ void SVC_Info( netadr_t from )
 		return;
 	}
 
+	if( !SV_QueryGlobalToken( from ) )
+	{
+		return;
+	}
+
 	// don't count privateclients
 	count = 0;
 	for( i = sv_privateClients->integer; i < sv_maxclients->integer; i++ )
@@ -408,35 +675,60 @@ void SVC_Info( netadr_t from )
 		}
 	}
 
-	infostring[0] = 0;
-
-	// echo back the parameter to status. so servers can use it as a challenge
-	// to prevent timed spoofed reply packets that add ghost servers
-	Info_SetValueForKey( infostring, "challenge", Cmd_Argv( 1 ) );
-
-	Info_SetValueForKey( infostring, "protocol", va( "%i", PROTOCOL_VERSION ) );
-	Info_SetValueForKey( infostring, "hostname", sv_hostname->string );
-	Info_SetValueForKey( infostring, "mapname", sv_mapname->string );
-	Info_SetValueForKey( infostring, "clients", va( "%i", count ) );
-	Info_SetValueForKey( infostring, "sv_maxclients", va( "%i", sv_maxclients->integer - sv_privateClients->integer ) );
-	Info_SetValueForKey( infostring, "gametype", va( "%i", sv_gametype->integer ) );
-	Info_SetValueForKey( infostring, "pure", va( "%i", sv_pure->integer ) );
-
-	if( sv_minPing->integer )
+	if( infoCvarCount != cvar_modificationCount || infoClients != count )
 	{
-		Info_SetValueForKey( infostring, "minPing", va( "%i", sv_minPing->integer ) );
-	}
-	if( sv_maxPing->integer )
-	{
-		Info_SetValueForKey( infostring, "maxPing", va( "%i", sv_maxPing->integer ) );
+		infoCvarCount = cvar_modificationCount;
+		infoClients	  = count;
+
+		InfoMap_Clear( &info, MAX_INFO_STRING );
+		InfoMap_SetValueForKey( &info, "protocol", va( "%i", PROTOCOL_VERSION ) );
+		InfoMap_SetValueForKey( &info, "hostname", sv_hostname->string );
+		InfoMap_SetValueForKey( &info, "mapname", sv_mapname->string );
+		InfoMap_SetValueForKey( &info, "clients", va( "%i", count ) );
+		InfoMap_SetValueForKey( &info, "sv_maxclients", va( "%i", sv_maxclients->integer - sv_privateClients->integer ) );
+		InfoMap_SetValueForKey( &info, "gametype", va( "%i", sv_gametype->integer ) );
+		InfoMap_SetValueForKey( &info, "pure", va( "%i", sv_pure->integer ) );
+
+		if( sv_minPing->integer )
+		{
+			InfoMap_SetValueForKey( &info, "minPing", va( "%i", sv_minPing->integer ) );
+		}
+		if( sv_maxPing->integer )
+		{
+			InfoMap_SetValueForKey( &info, "maxPing", va( "%i", sv_maxPing->integer ) );
+		}
+		gamedir = Cvar_VariableString( "fs_game" );
+		if( *gamedir )
+		{
+			InfoMap_SetValueForKey( &info, "game", gamedir );
+		}
+
+		Q_strncpyz( infoString, InfoMap_String( &info ), sizeof( infoString ) );
+		queryStats.infoBuilt++;
 	}
-	gamedir = Cvar_VariableString( "fs_game" );
-	if( *gamedir )
+	else
 	{
-		Info_SetValueForKey( infostring, "game", gamedir );
+		queryStats.infoCached++;
 	}
 
-	NET_OutOfBandPrint( NS_SERVER, from, "infoResponse\n%s", infostring );
+	// echo back the parameter to status. so servers can use it as a challenge
+	// to prevent timed spoofed reply packets that add ghost servers
+	NET_OutOfBandPrint( NS_SERVER, from, "infoResponse\n%s%s", SV_QueryChallenge( infoString ), infoString );
+}
+
+/*
+================
+SV_QueryStats_f
+================
+*/
+void SV_QueryStats_f()
+{
+	Com_Printf( "%i queries, %i dropped by address, %i queries dropped by the global limit\n",
+		queryStats.packets,
+		queryStats.addressLimited,
+		queryStats.globalLimited );
+	Com_Printf( "getstatus: %i built, %i cached\n", queryStats.statusBuilt, queryStats.statusCached );
+	Com_Printf( "getinfo:   %i built, %i cached\n", queryStats.infoBuilt, queryStats.infoCached );
 }
 
 /*
@@ -562,6 +854,20 @@ void SV_ConnectionlessPacket( netadr_t from, msg_t* msg )
 	c = Cmd_Argv( 0 );
 	Com_DPrintf( "SV packet %s : %s\n", NET_AdrToString( from ), c );
 
+	// only the anonymous queries are throttled, connect and rcon never are
+	if( !Q_stricmp( c, "getstatus" ) || !Q_stricmp( c, "getinfo" ) || !Q_stricmp( c, "getchallenge" ) )
+	{
+		if( SV_QueryFromNet( from ) )
+		{
+			queryStats.packets++;
+			if( !SV_QueryTakeToken( SV_QueryAddressBucket( from ), sv_queryRate->integer, sv_queryBurst->integer ) )
+			{
+				queryStats.addressLimited++;
+				return;
+			}
+		}
+	}
+
 	if( !Q_stricmp( c, "getstatus" ) )
 	{
 		SVC_Status( from );
@@ -844,8 +1150,9 @@ happen before SV_Frame is called
 */
 void SV_Frame( int msec )
 {
-	int frameMsec;
-	int startTime;
+	int		  frameMsec;
+	int		  startTime;
+	long long tickStart;
 
 	// the menu kills the server with this cvar
 	if( sv_killserver->integer )
@@ -913,6 +1220,10 @@ void SV_Frame( int msec )
 		return;
 	}
 
+	PROFILE_BEGIN( "SV_Frame" );
+
+	tickStart = Sys_Nanoseconds();
+
 	// update infostrings if anything has been changed
 	if( cvar_modifiedFlags & CVAR_SERVERINFO )
 	{
@@ -949,7 +1260,9 @@ void SV_Frame( int msec )
 		svs.time += frameMsec;
 
 		// let everything in the world think and move
-		VM_Call( gvm, GAME_RUN_FRAME, svs.time );
+		PROFILE_BEGIN( "GAME_RUN_FRAME" );
+		SV_GameRunFrame( svs.time );
+		PROFILE_END();
 	}
 
 	if( com_speeds->integer )
@@ -965,6 +1278,13 @@ void SV_Frame( int msec )
 
 	// send a heartbeat to the master if needed
 	SV_MasterHeartbeat();
+
+	if( com_journal->integer == 3 )
+	{
+		Com_ReplayServerTick( Sys_Nanoseconds() - tickStart );
+	}
+
+	PROFILE_END();
 }
 
 //============================================================================
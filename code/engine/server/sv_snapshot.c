@@ -492,20 +492,22 @@ This properly handles multiple recursive portals, but the render
 currently doesn't.
 
 For viewing through other player's eyes, clent can be something other than client->gentity
+
+The entity list is frame memory, the caller frees it
 =============
 */
 static void SV_BuildClientSnapshot( client_t* client )
 {
-	vec3_t					org;
-	clientSnapshot_t*		frame;
-	snapshotEntityNumbers_t entityNumbers;
-	int						i;
-	sharedEntity_t*			ent;
-	entityState_t*			state;
-	svEntity_t*				svEnt;
-	sharedEntity_t*			clent;
-	int						clientNum;
-	playerState_t*			ps;
+	vec3_t					 org;
+	clientSnapshot_t*		 frame;
+	snapshotEntityNumbers_t* entityNumbers;
+	int						 i;
+	sharedEntity_t*			 ent;
+	entityState_t*			 state;
+	svEntity_t*				 svEnt;
+	sharedEntity_t*			 clent;
+	int						 clientNum;
+	playerState_t*			 ps;
 
 	// bump the counter used to prevent double adding
 	sv.snapshotCounter++;
@@ -514,7 +516,8 @@ static void SV_BuildClientSnapshot( client_t* client )
 	frame = &client->frames[client->netchan.outgoingSequence & PACKET_MASK];
 
 	// clear everything in this snapshot
-	entityNumbers.numSnapshotEntities = 0;
+	entityNumbers					   = Frame_Alloc( sizeof( *entityNumbers ) );
+	entityNumbers->numSnapshotEntities = 0;
 	Com_Memset( frame->areabits, 0, sizeof( frame->areabits ) );
 
 	// https://zerowing.idsoftware.com/bugzilla/show_bug.cgi?id=62
@@ -547,13 +550,13 @@ static void SV_BuildClientSnapshot( client_t* client )
 
 	// add all the entities directly visible to the eye, which
 	// may include portal entities that merge other viewpoints
-	SV_AddEntitiesVisibleFromPoint( org, frame, &entityNumbers, qfalse );
+	SV_AddEntitiesVisibleFromPoint( org, frame, entityNumbers, qfalse );
 
 	// if there were portals visible, there may be out of order entities
 	// in the list which will need to be resorted for the delta compression
 	// to work correctly.  This also catches the error condition
 	// of an entity being included twice.
-	qsort( entityNumbers.snapshotEntities, entityNumbers.numSnapshotEntities, sizeof( entityNumbers.snapshotEntities[0] ), SV_QsortEntityNumbers );
+	qsort( entityNumbers->snapshotEntities, entityNumbers->numSnapshotEntities, sizeof( entityNumbers->snapshotEntities[0] ), SV_QsortEntityNumbers );
 
 	// now that all viewpoint's areabits have been OR'd together, invert
 	// all of them to make it a mask vector, which is what the renderer wants
@@ -565,9 +568,9 @@ static void SV_BuildClientSnapshot( client_t* client )
 	// copy the entity states out
 	frame->num_entities = 0;
 	frame->first_entity = svs.nextSnapshotEntities;
-	for( i = 0; i < entityNumbers.numSnapshotEntities; i++ )
+	for( i = 0; i < entityNumbers->numSnapshotEntities; i++ )
 	{
-		ent	   = SV_GentityNum( entityNumbers.snapshotEntities[i] );
+		ent	   = SV_GentityNum( entityNumbers->snapshotEntities[i] );
 		state  = &svs.snapshotEntities[svs.nextSnapshotEntities % svs.numSnapshotEntities];
 		*state = ent->s;
 		svs.nextSnapshotEntities++;
@@ -681,12 +684,17 @@ SV_SendClientSnapshot
 
 Also called by SV_FinalMessage
 
+The entity list and the message are frame memory, every client
+reuses the same space
 =======================
 */
 void SV_SendClientSnapshot( client_t* client )
 {
-	byte  msg_buf[MAX_MSGLEN];
+	byte* msg_buf;
 	msg_t msg;
+	int	  mark;
+
+	mark = Frame_Mark();
 
 	// build the snapshot
 	SV_BuildClientSnapshot( client );
@@ -695,10 +703,12 @@ void SV_SendClientSnapshot( client_t* client )
 	// the query them directly without needing to be sent
 	if( client->gentity && client->gentity->r.svFlags & SVF_BOT )
 	{
+		Frame_FreeToMark( mark );
 		return;
 	}
 
-	MSG_Init( &msg, msg_buf, sizeof( msg_buf ) );
+	msg_buf = Frame_Alloc( MAX_MSGLEN );
+	MSG_Init( &msg, msg_buf, MAX_MSGLEN );
 	msg.allowoverflow = qtrue;
 
 	// NOTE, MRE: all server->client messages now acknowledge
@@ -723,6 +733,8 @@ void SV_SendClientSnapshot( client_t* client )
 	}
 
 	SV_SendMessageToClient( &msg, client );
+
+	Frame_FreeToMark( mark );
 }
 
 /*
@@ -735,6 +747,8 @@ void SV_SendClientMessages()
 	int		  i;
 	client_t* c;
 
+	PROFILE_BEGIN( "SV_SendClientMessages" );
+
 	// send a message to each connected client
 	for( i = 0, c = svs.clients; i < sv_maxclients->integer; i++, c++ )
 	{
@@ -760,4 +774,6 @@ void SV_SendClientMessages()
 		// generate and send a new message
 		SV_SendClientSnapshot( c );
 	}
+
+	PROFILE_END();
 }
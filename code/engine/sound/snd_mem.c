@@ -45,6 +45,7 @@ static sndBuffer* buffer	 = NULL;
 static sndBuffer* freelist	 = NULL;
 static int		  inUse		 = 0;
 static int		  totalInUse = 0;
+static memStat_t* sndStat	 = NULL;
 
 short*			  sfxScratchBuffer	= NULL;
 sfx_t*			  sfxScratchPointer = NULL;
@@ -55,6 +56,7 @@ void			  SND_free( sndBuffer* v )
 	*( sndBuffer** )v = freelist;
 	freelist		  = ( sndBuffer* )v;
 	inUse += sizeof( sndBuffer );
+	Com_MemStatFree( sndStat, sizeof( sndBuffer ) );
 }
 
 sndBuffer* SND_malloc()
@@ -69,6 +71,7 @@ redo:
 
 	inUse -= sizeof( sndBuffer );
 	totalInUse += sizeof( sndBuffer );
+	Com_MemStatAlloc( sndStat, sizeof( sndBuffer ) );
 
 	v		 = freelist;
 	freelist = *( sndBuffer** )freelist;
@@ -93,6 +96,9 @@ void SND_setup()
 
 	inUse = scs * sizeof( sndBuffer );
 	p	  = buffer;
+
+	sndStat = Com_RegisterMemStat( "sound buffers", 0 );
+	Com_MemStatSet( sndStat, 0 );
 	;
 	q = p + scs;
 	while( --q > p )
@@ -723,6 +723,20 @@ void* QDECL	 Sys_LoadDll( const char* name, char* fqpath, int( QDECL** entryPoin
 	return libHandle;
 }
 
+/*
+=================
+Sys_DllSymbol
+=================
+*/
+void* Sys_DllSymbol( void* dllHandle, const char* name )
+{
+	if( !dllHandle )
+	{
+		return NULL;
+	}
+	return ( void* )GetProcAddress( dllHandle, name );
+}
+
 /*
 ========================================================================
 
@@ -1375,7 +1389,8 @@ int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 	while( 1 )
 	{
 		// if not running as a game client, sleep a bit
-		if( g_wv.isMinimized || ( com_dedicated && com_dedicated->integer ) )
+		// a journal replay doesn't wait for the recorded wall clock
+		if( ( g_wv.isMinimized || ( com_dedicated && com_dedicated->integer ) ) && !( com_journal && com_journal->integer >= 2 ) )
 		{
 			Sleep( 5 );
 		}
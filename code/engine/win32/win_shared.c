@@ -32,6 +32,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include <direct.h>
 #include <io.h>
 #include <conio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 /*
 ================
@@ -54,6 +56,26 @@ int Sys_Milliseconds()
 	return sys_curtime;
 }
 
+/*
+================
+Sys_Nanoseconds
+================
+*/
+long long Sys_Nanoseconds()
+{
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER		 counter;
+
+	if( !frequency.QuadPart )
+	{
+		QueryPerformanceFrequency( &frequency );
+	}
+	QueryPerformanceCounter( &counter );
+
+	// split so counter * 1e9 can't overflow
+	return ( counter.QuadPart / frequency.QuadPart ) * 1000000000LL + ( counter.QuadPart % frequency.QuadPart ) * 1000000000LL / frequency.QuadPart;
+}
+
 /*
 ================
 Sys_SnapVector
@@ -97,6 +119,214 @@ int Sys_GetProcessorId()
 */
 #pragma optimize( "", on )
 
+/*
+================
+Sys_ProcessorCount
+================
+*/
+unsigned int Sys_ProcessorCount()
+{
+	SYSTEM_INFO info;
+
+	GetSystemInfo( &info );
+	return info.dwNumberOfProcessors;
+}
+
+/*
+** --------------------------------------------------------------------------------
+**
+** THREADS
+**
+** --------------------------------------------------------------------------------
+*/
+
+typedef struct
+{
+	void ( *function )( void* );
+	void* data;
+} sysThreadStart_t;
+
+static DWORD WINAPI Sys_ThreadStart( LPVOID parm )
+{
+	sysThreadStart_t start;
+
+	start = *( sysThreadStart_t* )parm;
+	free( parm );
+
+	start.function( start.data );
+	return 0;
+}
+
+/*
+================
+Sys_CreateThread
+
+Returns NULL if the thread couldn't be started
+================
+*/
+void* Sys_CreateThread( void ( *function )( void* ), void* data )
+{
+	sysThreadStart_t* start;
+	HANDLE			  handle;
+
+	start = malloc( sizeof( *start ) );
+	if( !start )
+	{
+		return NULL;
+	}
+	start->function = function;
+	start->data		= data;
+
+	handle = CreateThread( NULL, 0, Sys_ThreadStart, start, 0, NULL );
+	if( !handle )
+	{
+		free( start );
+		return NULL;
+	}
+
+	return handle;
+}
+
+/*
+================
+Sys_JoinThread
+
+Waits for the thread function to return and releases the thread
+================
+*/
+void Sys_JoinThread( void* thread )
+{
+	WaitForSingleObject( ( HANDLE )thread, INFINITE );
+	CloseHandle( ( HANDLE )thread );
+}
+
+/*
+================
+Sys_Yield
+================
+*/
+void Sys_Yield()
+{
+	SwitchToThread();
+}
+
+/*
+================
+Sys_CreateSemaphore
+
+Returns NULL on failure
+================
+*/
+void* Sys_CreateSemaphore()
+{
+	return CreateSemaphore( NULL, 0, 0x7fffffff, NULL );
+}
+
+/*
+================
+Sys_DestroySemaphore
+================
+*/
+void Sys_DestroySemaphore( void* sem )
+{
+	CloseHandle( ( HANDLE )sem );
+}
+
+/*
+================
+Sys_SemaphoreWait
+================
+*/
+void Sys_SemaphoreWait( void* sem )
+{
+	WaitForSingleObject( ( HANDLE )sem, INFINITE );
+}
+
+/*
+================
+Sys_SemaphorePost
+================
+*/
+void Sys_SemaphorePost( void* sem, int count )
+{
+	ReleaseSemaphore( ( HANDLE )sem, count, NULL );
+}
+
+//============================================
+
+/*
+================
+Sys_StatFile
+================
+*/
+qboolean Sys_StatFile( const char* ospath, int* size, int* mtime )
+{
+	struct _stat buf;
+
+	if( _stat( ospath, &buf ) )
+	{
+		return qfalse;
+	}
+
+	*size  = ( int )buf.st_size;
+	*mtime = ( int )buf.st_mtime;
+	return qtrue;
+}
+
+/*
+================
+Sys_MapFile
+
+The view stays valid after the handles are closed, other processes mapping
+the same file share its pages
+================
+*/
+void* Sys_MapFile( const char* ospath, int* length )
+{
+	HANDLE		  file, mapping;
+	LARGE_INTEGER size;
+	void*		  view;
+
+	file = CreateFile( ospath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( file == INVALID_HANDLE_VALUE )
+	{
+		return NULL;
+	}
+	// empty files can't be mapped
+	if( !GetFileSizeEx( file, &size ) || size.QuadPart <= 0 || size.QuadPart > 0x7fffffff )
+	{
+		CloseHandle( file );
+		return NULL;
+	}
+
+	mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	CloseHandle( file );
+	if( !mapping )
+	{
+		return NULL;
+	}
+
+	view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	CloseHandle( mapping );
+	if( !view )
+	{
+		return NULL;
+	}
+
+	*length = ( int )size.QuadPart;
+	return view;
+}
+
+/*
+================
+Sys_UnmapFile
+================
+*/
+void Sys_UnmapFile( void* buffer, int length )
+{
+	UnmapViewOfFile( buffer );
+}
+
 //============================================
 
 char* Sys_GetCurrentUser()
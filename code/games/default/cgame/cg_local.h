@@ -1462,6 +1462,14 @@ int			   trap_Milliseconds();
 void		   trap_Cvar_Register( vmCvar_t* vmCvar, const char* varName, const char* defaultValue, int flags );
 void		   trap_Cvar_Update( vmCvar_t* vmCvar );
 void		   trap_Cvar_Set( const char* var_name, const char* value );
+void		   trap_Cvar_SetHandle( cvarHandle_t handle, const char* value );
+int			   trap_Cvar_ModificationCount(); // changes whenever any cvar changes
+void		   trap_ProfileBegin( const char* name );  // profile_capture zones, nest like braces
+void		   trap_ProfileEnd();
+void		   trap_JobAdd( const char* name, jobFunc_t func, void* data, jobCounter_t* signal ); // func must not call traps
+void		   trap_JobWait( jobCounter_t* counter );
+void		   trap_JobParallelFor( const char* name, int count, int minBatch, jobRangeFunc_t func, void* data );
+int			   trap_JobNumWorkers();
 void		   trap_Cvar_VariableStringBuffer( const char* var_name, char* buffer, int bufsize );
 
 // ServerCommand and ConsoleCommand parameter access
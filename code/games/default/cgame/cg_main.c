@@ -377,12 +377,19 @@ CG_UpdateCvars
 */
 void CG_UpdateCvars()
 {
-	int			 i;
+	static int	 cvarModificationCount = -1;
+	int			 i, count;
 	cvarTable_t* cv;
 
-	for( i = 0, cv = cvarTable; i < cvarTableSize; i++, cv++ )
+	// one trap instead of one per cvar when nothing changed
+	count = trap_Cvar_ModificationCount();
+	if( count != cvarModificationCount )
 	{
-		trap_Cvar_Update( cv->vmCvar );
+		cvarModificationCount = count;
+		for( i = 0, cv = cvarTable; i < cvarTableSize; i++, cv++ )
+		{
+			trap_Cvar_Update( cv->vmCvar );
+		}
 	}
 
 	// check for modications here
@@ -546,11 +546,11 @@ void CG_PredictPlayerState()
 
 	if( pmove_msec.integer < 8 )
 	{
-		trap_Cvar_Set( "pmove_msec", "8" );
+		trap_Cvar_SetHandle( pmove_msec.handle, "8" );
 	}
 	else if( pmove_msec.integer > 33 )
 	{
-		trap_Cvar_Set( "pmove_msec", "33" );
+		trap_Cvar_SetHandle( pmove_msec.handle, "33" );
 	}
 
 	cg_pmove.pmove_fixed = pmove_fixed.integer; // | cg_pmove_fixed.integer;
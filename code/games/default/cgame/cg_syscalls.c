@@ -72,6 +72,46 @@ void trap_Cvar_Set( const char* var_name, const char* value )
 	syscall( CG_CVAR_SET, var_name, value );
 }
 
+void trap_Cvar_SetHandle( cvarHandle_t handle, const char* value )
+{
+	syscall( CG_CVAR_SET_HANDLE, handle, value );
+}
+
+int trap_Cvar_ModificationCount()
+{
+	return syscall( CG_CVAR_MODIFICATION_COUNT );
+}
+
+void trap_ProfileBegin( const char* name )
+{
+	syscall( CG_PROFILE_BEGIN, name );
+}
+
+void trap_ProfileEnd()
+{
+	syscall( CG_PROFILE_END );
+}
+
+void trap_JobAdd( const char* name, jobFunc_t func, void* data, jobCounter_t* signal )
+{
+	syscall( CG_JOB_ADD, name, func, data, signal );
+}
+
+void trap_JobWait( jobCounter_t* counter )
+{
+	syscall( CG_JOB_WAIT, counter );
+}
+
+void trap_JobParallelFor( const char* name, int count, int minBatch, jobRangeFunc_t func, void* data )
+{
+	syscall( CG_JOB_PARALLEL_FOR, name, count, minBatch, func, data );
+}
+
+int trap_JobNumWorkers()
+{
+	return syscall( CG_JOB_NUM_WORKERS );
+}
+
 void trap_Cvar_VariableStringBuffer( const char* var_name, char* buffer, int bufsize )
 {
 	syscall( CG_CVAR_VARIABLESTRINGBUFFER, var_name, buffer, bufsize );
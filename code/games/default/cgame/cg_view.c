@@ -203,12 +203,12 @@ static void CG_CalcVrect()
 		// bound normal viewsize
 		if( cg_viewsize.integer < 30 )
 		{
-			trap_Cvar_Set( "cg_viewsize", "30" );
+			trap_Cvar_SetHandle( cg_viewsize.handle, "30" );
 			size = 30;
 		}
 		else if( cg_viewsize.integer > 100 )
 		{
-			trap_Cvar_Set( "cg_viewsize", "100" );
+			trap_Cvar_SetHandle( cg_viewsize.handle, "100" );
 			size = 100;
 		}
 		else
@@ -967,7 +967,7 @@ void CG_DrawActiveFrame( int serverTime, stereoFrame_t stereoView, qboolean demo
 		}
 		if( cg_timescaleFadeSpeed.value )
 		{
-			trap_Cvar_Set( "timescale", va( "%f", cg_timescale.value ) );
+			trap_Cvar_SetHandle( cg_timescale.handle, va( "%f", cg_timescale.value ) );
 		}
 	}
 
@@ -66,14 +66,8 @@ BotNumActivePlayers
 */
 int BotNumActivePlayers()
 {
-	int		   i, num;
-	char	   buf[MAX_INFO_STRING];
-	static int maxclients;
-
-	if( !maxclients )
-	{
-		maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
-	}
+	int	 i, num;
+	char buf[MAX_INFO_STRING];
 
 	num = 0;
 	for( i = 0; i < maxclients && i < MAX_CLIENTS; i++ )
@@ -104,14 +98,8 @@ int BotIsFirstInRankings( bot_state_t* bs )
 {
 	int			  i, score;
 	char		  buf[MAX_INFO_STRING];
-	static int	  maxclients;
 	playerState_t ps;
 
-	if( !maxclients )
-	{
-		maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
-	}
-
 	score = bs->cur_ps.persistant[PERS_SCORE];
 	for( i = 0; i < maxclients && i < MAX_CLIENTS; i++ )
 	{
@@ -145,14 +133,8 @@ int BotIsLastInRankings( bot_state_t* bs )
 {
 	int			  i, score;
 	char		  buf[MAX_INFO_STRING];
-	static int	  maxclients;
 	playerState_t ps;
 
-	if( !maxclients )
-	{
-		maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
-	}
-
 	score = bs->cur_ps.persistant[PERS_SCORE];
 	for( i = 0; i < maxclients && i < MAX_CLIENTS; i++ )
 	{
@@ -186,15 +168,9 @@ char* BotFirstClientInRankings()
 {
 	int			  i, bestscore, bestclient;
 	char		  buf[MAX_INFO_STRING];
-	static char	  name[32];
-	static int	  maxclients;
+	static Q_THREADLOCAL char name[32];
 	playerState_t ps;
 
-	if( !maxclients )
-	{
-		maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
-	}
-
 	bestscore  = -999999;
 	bestclient = 0;
 	for( i = 0; i < maxclients && i < MAX_CLIENTS; i++ )
@@ -231,15 +207,9 @@ char* BotLastClientInRankings()
 {
 	int			  i, worstscore, bestclient;
 	char		  buf[MAX_INFO_STRING];
-	static char	  name[32];
-	static int	  maxclients;
+	static Q_THREADLOCAL char name[32];
 	playerState_t ps;
 
-	if( !maxclients )
-	{
-		maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
-	}
-
 	worstscore = 999999;
 	bestclient = 0;
 	for( i = 0; i < maxclients && i < MAX_CLIENTS; i++ )
@@ -274,16 +244,10 @@ BotRandomOpponentName
 */
 char* BotRandomOpponentName( bot_state_t* bs )
 {
-	int			i, count;
-	char		buf[MAX_INFO_STRING];
-	int			opponents[MAX_CLIENTS], numopponents;
-	static int	maxclients;
-	static char name[32];
-
-	if( !maxclients )
-	{
-		maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
-	}
+	int	 i, count;
+	char buf[MAX_INFO_STRING];
+	int	 opponents[MAX_CLIENTS], numopponents;
+	static Q_THREADLOCAL char name[32];
 
 	numopponents = 0;
 	opponents[0] = 0;
@@ -336,15 +300,7 @@ BotMapTitle
 
 char* BotMapTitle()
 {
-	char		info[1024];
-	static char mapname[128];
-
-	trap_GetServerinfo( info, sizeof( info ) );
-
-	strncpy( mapname, Info_ValueForKey( info, "mapname" ), sizeof( mapname ) - 1 );
-	mapname[sizeof( mapname ) - 1] = '\0';
-
-	return mapname;
+	return botmapname;
 }
 
 /*
@@ -59,8 +59,9 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 // goal flag, see be_ai_goal.h for the other GFL_*
 #define GFL_AIR 128
 
-int	 numnodeswitches;
-char nodeswitch[MAX_NODESWITCHES + 1][144];
+// per thread, bots run their AI nodes on job workers
+Q_THREADLOCAL int  numnodeswitches;
+Q_THREADLOCAL char nodeswitch[MAX_NODESWITCHES + 1][144];
 
 #define LOOKAHEAD_DISTANCE 300
 
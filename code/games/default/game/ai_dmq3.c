@@ -72,6 +72,8 @@ bot_waypoint_t* botai_freewaypoints;
 // NOTE: not using a cvars which can be updated because the game should be reloaded anyway
 int				gametype;	// game type
 int				maxclients; // maximum number of clients
+// the map, bots thinking on job workers can't ask for the serverinfo
+char			botmapname[MAX_QPATH];
 
 vmCvar_t		bot_grapple;
 vmCvar_t		bot_rocketjump;
@@ -115,12 +117,45 @@ void			   BotSetUserInfo( bot_state_t* bs, char* key, char* value )
 {
 	char userinfo[MAX_INFO_STRING];
 
+	// the other bots may be reading configstrings
+	if( botthinkparallel )
+	{
+		Info_SetValueForKey( bs->deferreduserinfo, key, value );
+		return;
+	}
 	trap_GetUserinfo( bs->client, userinfo, sizeof( userinfo ) );
 	Info_SetValueForKey( userinfo, key, value );
 	trap_SetUserinfo( bs->client, userinfo );
 	ClientUserinfoChanged( bs->client );
 }
 
+/*
+==================
+BotApplyDeferredUserInfo
+==================
+*/
+void BotApplyDeferredUserInfo( bot_state_t* bs )
+{
+	char		userinfo[MAX_INFO_STRING];
+	char		key[BIG_INFO_KEY], value[BIG_INFO_VALUE];
+	const char* s;
+
+	if( !bs->deferreduserinfo[0] )
+	{
+		return;
+	}
+	trap_GetUserinfo( bs->client, userinfo, sizeof( userinfo ) );
+	s = bs->deferreduserinfo;
+	while( *s )
+	{
+		Info_NextPair( &s, key, value );
+		Info_SetValueForKey( userinfo, key, value );
+	}
+	trap_SetUserinfo( bs->client, userinfo );
+	ClientUserinfoChanged( bs->client );
+	bs->deferreduserinfo[0] = '\0';
+}
+
 /*
 ==================
 BotCTFCarryingFlag
@@ -1681,14 +1716,9 @@ ClientFromName
 */
 int ClientFromName( char* name )
 {
-	int		   i;
-	char	   buf[MAX_INFO_STRING];
-	static int maxclients;
+	int	 i;
+	char buf[MAX_INFO_STRING];
 
-	if( !maxclients )
-	{
-		maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
-	}
 	for( i = 0; i < maxclients && i < MAX_CLIENTS; i++ )
 	{
 		trap_GetConfigstring( CS_PLAYERS + i, buf, sizeof( buf ) );
@@ -1708,14 +1738,9 @@ ClientOnSameTeamFromName
 */
 int ClientOnSameTeamFromName( bot_state_t* bs, char* name )
 {
-	int		   i;
-	char	   buf[MAX_INFO_STRING];
-	static int maxclients;
+	int	 i;
+	char buf[MAX_INFO_STRING];
 
-	if( !maxclients )
-	{
-		maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
-	}
 	for( i = 0; i < maxclients && i < MAX_CLIENTS; i++ )
 	{
 		if( !BotSameTeam( bs, i ) )
@@ -3519,34 +3544,128 @@ qboolean InFieldOfVision( vec3_t viewangles, float fov, vec3_t angles )
 	return qtrue;
 }
 
+/*
+==============================================================================
+
+VISIBILITY CACHE
+
+A bot asks whether it can see the same entity many times in one think,
+finding an enemy, aiming, deciding to attack, in the AI nodes, and every
+time that took up to six traces. The traces only depend on the viewer's
+eye and where the entity is, neither moves while the bots think, so the
+result is kept for each viewer and entity until the next bot frame. The
+field of vision is checked before the cache, it differs between the calls.
+
+Each viewer has a row of its own, bots thinking on job workers never
+write to the same one. Results aren't shared between the two directions
+of a pair, a viewer looks from its eye at the other's body.
+==============================================================================
+*/
+
+#define MAX_VISCACHE_ENTITIES 16 // entities other than clients, per viewer, power of 2
+
+typedef struct
+{
+	int	   frame; // botvisibilityframe the result is for
+	int	   ent;
+	vec3_t eye;
+	float  vis;
+} bot_visibility_t;
+
+typedef struct
+{
+	bot_visibility_t clients[MAX_CLIENTS];
+	bot_visibility_t entities[MAX_VISCACHE_ENTITIES];
+	int				 tests;	 // BotEntityVisible calls past the field of vision
+	int				 traced; // the ones that weren't in the cache
+} bot_visibilityrow_t;
+
+static bot_visibilityrow_t botvisibility[MAX_CLIENTS];
+static int				   botvisibilityframe;
+static int				   botvisibilityreporttime;
+
 /*
 ==================
-BotEntityVisible
+BotVisibilityFrame
 
-returns visibility in the range [0, 1] taking fog and water surfaces into account
+The entities may have moved, forget what the bots saw
 ==================
 */
-float BotEntityVisible( int viewer, vec3_t eye, vec3_t viewangles, float fov, int ent )
+void BotVisibilityFrame()
 {
-	int				 i, contents_mask, passent, hitent, infog, inwater, otherinfog, pc;
-	float			 squaredfogdist, waterfactor, vis, bestvis;
-	bsp_trace_t		 trace;
-	aas_entityinfo_t entinfo;
-	vec3_t			 dir, entangles, start, end, middle;
+	botvisibilityframe++;
+	// never 0, the frame of an unused entry
+	if( !botvisibilityframe )
+	{
+		botvisibilityframe++;
+	}
+}
 
-	// calculate middle of bounding box
-	BotEntityInfo( ent, &entinfo );
-	VectorAdd( entinfo.mins, entinfo.maxs, middle );
-	VectorScale( middle, 0.5, middle );
-	VectorAdd( entinfo.origin, middle, middle );
-	// check if entity is within field of vision
-	VectorSubtract( middle, eye, dir );
-	vectoangles( dir, entangles );
-	if( !InFieldOfVision( viewangles, fov, entangles ) )
+/*
+==================
+BotReportVisibility
+
+bot_report 2 prints how many visibility tests the cache saved every five seconds
+==================
+*/
+void BotReportVisibility()
+{
+	int i, tests, traced;
+
+	if( level.time - botvisibilityreporttime < 5000 )
 	{
-		return 0;
+		return;
 	}
-	//
+	botvisibilityreporttime = level.time;
+
+	tests  = 0;
+	traced = 0;
+	for( i = 0; i < MAX_CLIENTS; i++ )
+	{
+		tests += botvisibility[i].tests;
+		traced += botvisibility[i].traced;
+		botvisibility[i].tests	= 0;
+		botvisibility[i].traced = 0;
+	}
+	if( !tests )
+	{
+		return;
+	}
+	BotAI_Print( PRT_MESSAGE, "bot visibility: %d tests, %d traced, %d%% from the cache\n", tests, traced, ( tests - traced ) * 100 / tests );
+}
+
+/*
+==================
+BotVisibilityEntry
+==================
+*/
+static bot_visibility_t* BotVisibilityEntry( int viewer, int ent )
+{
+	if( viewer < 0 || viewer >= MAX_CLIENTS )
+	{
+		return NULL;
+	}
+	if( ent >= 0 && ent < MAX_CLIENTS )
+	{
+		return &botvisibility[viewer].clients[ent];
+	}
+	return &botvisibility[viewer].entities[ent & ( MAX_VISCACHE_ENTITIES - 1 )];
+}
+
+/*
+==================
+BotEntityLineOfSight
+
+The traces of BotEntityVisible, middle is the center of the entity's bounding box
+==================
+*/
+static float BotEntityLineOfSight( int viewer, vec3_t eye, int ent, aas_entityinfo_t* entinfo, vec3_t middle )
+{
+	int			contents_mask, passent, hitent, infog, inwater, otherinfog, pc, i;
+	float		squaredfogdist, waterfactor, vis, bestvis;
+	bsp_trace_t trace;
+	vec3_t		dir, start, end;
+
 	pc		= trap_AAS_PointContents( eye );
 	infog	= ( pc & CONTENTS_FOG );
 	inwater = ( pc & ( CONTENTS_LAVA | CONTENTS_SLIME | CONTENTS_WATER ) );
@@ -3642,16 +3761,65 @@ float BotEntityVisible( int viewer, vec3_t eye, vec3_t viewangles, float fov, in
 		// check bottom and top of bounding box as well
 		if( i == 0 )
 		{
-			middle[2] += entinfo.mins[2];
+			middle[2] += entinfo->mins[2];
 		}
 		else if( i == 1 )
 		{
-			middle[2] += entinfo.maxs[2] - entinfo.mins[2];
+			middle[2] += entinfo->maxs[2] - entinfo->mins[2];
 		}
 	}
 	return bestvis;
 }
 
+/*
+==================
+BotEntityVisible
+
+returns visibility in the range [0, 1] taking fog and water surfaces into account
+==================
+*/
+float BotEntityVisible( int viewer, vec3_t eye, vec3_t viewangles, float fov, int ent )
+{
+	bot_visibility_t* cached;
+	aas_entityinfo_t  entinfo;
+	vec3_t			  dir, entangles, middle;
+	float			  vis;
+
+	// calculate middle of bounding box
+	BotEntityInfo( ent, &entinfo );
+	VectorAdd( entinfo.mins, entinfo.maxs, middle );
+	VectorScale( middle, 0.5, middle );
+	VectorAdd( entinfo.origin, middle, middle );
+	// check if entity is within field of vision
+	VectorSubtract( middle, eye, dir );
+	vectoangles( dir, entangles );
+	if( !InFieldOfVision( viewangles, fov, entangles ) )
+	{
+		return 0;
+	}
+	//
+	cached = BotVisibilityEntry( viewer, ent );
+	if( cached )
+	{
+		botvisibility[viewer].tests++;
+		if( cached->frame == botvisibilityframe && cached->ent == ent && VectorCompare( cached->eye, eye ) )
+		{
+			return cached->vis;
+		}
+		botvisibility[viewer].traced++;
+	}
+	vis = BotEntityLineOfSight( viewer, eye, ent, &entinfo, middle );
+	if( cached )
+	{
+		cached->frame = botvisibilityframe;
+		cached->ent	  = ent;
+		VectorCopy( eye, cached->eye );
+		cached->vis = vis;
+	}
+	return vis;
+}
+
+
 /*
 ==================
 BotFindEnemy
@@ -4647,19 +4815,12 @@ BotMapScripts
 */
 void BotMapScripts( bot_state_t* bs )
 {
-	char			 info[1024];
-	char			 mapname[128];
 	int				 i, shootbutton;
 	float			 aim_accuracy;
 	aas_entityinfo_t entinfo;
 	vec3_t			 dir;
 
-	trap_GetServerinfo( info, sizeof( info ) );
-
-	strncpy( mapname, Info_ValueForKey( info, "mapname" ), sizeof( mapname ) - 1 );
-	mapname[sizeof( mapname ) - 1] = '\0';
-
-	if( !Q_stricmp( mapname, "q3tourney6" ) )
+	if( !Q_stricmp( botmapname, "q3tourney6" ) )
 	{
 		vec3_t mins = { 700, 204, 672 }, maxs = { 964, 468, 680 };
 		vec3_t buttonorg = { 304, 352, 920 };
@@ -4734,7 +4895,7 @@ void BotMapScripts( bot_state_t* bs )
 			}
 		}
 	}
-	else if( !Q_stricmp( mapname, "mpq3tourney6" ) )
+	else if( !Q_stricmp( botmapname, "mpq3tourney6" ) )
 	{
 		// NOTE: NEVER use the func_bobbing in mpq3tourney6
 		bs->tfl &= ~TFL_FUNCBOB;
@@ -6509,7 +6670,6 @@ void BotDeathmatchAI( bot_state_t* bs, float thinktime )
 {
 	char gender[144], name[144], buf[144];
 	char userinfo[MAX_INFO_STRING];
-	int	 i;
 
 	// if the bot has just been setup
 	if( bs->setupcount > 0 )
@@ -6592,6 +6752,25 @@ void BotDeathmatchAI( bot_state_t* bs, float thinktime )
 		}
 		bs->entergamechat = qtrue;
 	}
+}
+
+/*
+==================
+BotDeathmatchThink
+
+Runs on a job worker when the bots think in parallel, see BotAIStartFrame
+==================
+*/
+void BotDeathmatchThink( bot_state_t* bs )
+{
+	char name[144];
+	int	 i;
+
+	// the bot is still being setup
+	if( bs->setupcount > 0 )
+	{
+		return;
+	}
 	// reset the node switches from the previous frame
 	BotResetNodeSwitches();
 	// execute AI nodes
@@ -6741,6 +6920,7 @@ void BotSetupDeathmatchAI()
 
 	gametype   = trap_Cvar_VariableIntegerValue( "g_gametype" );
 	maxclients = trap_Cvar_VariableIntegerValue( "sv_maxclients" );
+	trap_Cvar_VariableStringBuffer( "mapname", botmapname, sizeof( botmapname ) );
 
 	trap_Cvar_Register( &bot_rocketjump, "bot_rocketjump", "1", 0 );
 	trap_Cvar_Register( &bot_grapple, "bot_grapple", "0", 0 );
@@ -34,8 +34,13 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 void	 BotSetupDeathmatchAI();
 // shutdown the deathmatch AI
 void	 BotShutdownDeathmatchAI();
-// let the bot live within it's deathmatch AI net
+// let the bot live within it's deathmatch AI net, first what has to run
+// for the bots one after the other
 void	 BotDeathmatchAI( bot_state_t* bs, float thinktime );
+// then the AI nodes, bots may run these at the same time
+void	 BotDeathmatchThink( bot_state_t* bs );
+// set the userinfo keys a bot changed while thinking in parallel
+void	 BotApplyDeferredUserInfo( bot_state_t* bs );
 // free waypoints
 void	 BotFreeWaypoints( bot_waypoint_t* wp );
 // choose a weapon
@@ -120,6 +125,10 @@ int				 BotFindEnemy( bot_state_t* bs, int curenemy );
 void			 BotRoamGoal( bot_state_t* bs, vec3_t goal );
 // returns entity visibility in the range [0, 1]
 float			 BotEntityVisible( int viewer, vec3_t eye, vec3_t viewangles, float fov, int ent );
+// the entities may have moved since the visibility was cached
+void			 BotVisibilityFrame();
+// print how many visibility tests the cache saved
+void			 BotReportVisibility();
 // the bot will aim at the current enemy
 void			 BotAimAtEnemy( bot_state_t* bs );
 // check if the bot should attack
@@ -188,6 +197,7 @@ void			BotMapScripts( bot_state_t* bs );
 
 extern int		  gametype;	  // game type
 extern int		  maxclients; // maximum number of clients
+extern char		  botmapname[MAX_QPATH];
 
 extern vmCvar_t	  bot_grapple;
 extern vmCvar_t	  bot_rocketjump;
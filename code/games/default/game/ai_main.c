@@ -80,6 +80,11 @@ vmCvar_t	 bot_interbreedchar;
 vmCvar_t	 bot_interbreedbots;
 vmCvar_t	 bot_interbreedcycle;
 vmCvar_t	 bot_interbreedwrite;
+vmCvar_t	 bot_parallel;
+// the bots' AI nodes are running on job workers
+qboolean	 botthinkparallel;
+// seed of the bot thinking on this thread
+static Q_THREADLOCAL int* botrandomseed;
 
 void		 ExitLevel();
 
@@ -132,6 +137,20 @@ void QDECL	 BotAI_Print( int type, char* fmt, ... )
 	}
 }
 
+/*
+==================
+BotRandom
+==================
+*/
+float BotRandom()
+{
+	if( botrandomseed )
+	{
+		return Q_random( botrandomseed );
+	}
+	return ( rand() & 0x7fff ) / ( ( float )0x7fff );
+}
+
 /*
 ==================
 BotAI_Trace
@@ -1236,6 +1255,10 @@ void RemoveColorEscapeSequences( char* text )
 /*
 ==============
 BotAI
+
+What has to run for the bots one after the other: reading the client
+state and server commands, setup, team AI and chat. qtrue if BotAIThink
+should run for the bot
 ==============
 */
 int BotAI( int client, float thinktime )
@@ -1338,8 +1361,33 @@ int BotAI( int client, float thinktime )
 	bs->eye[2] += bs->cur_ps.viewheight;
 	// get the area the bot is in
 	bs->areanum = BotPointAreaNum( bs->origin );
+	// the bot's random numbers don't depend on the order the bots think in
+	bs->randomseed = level.randomSeed ^ ( client * 0x9E3779B1 ) ^ ( level.time * 0x85EBCA6B );
+	botrandomseed  = &bs->randomseed;
+	trap_BotThinkBegin( client, bs->randomseed );
 	// the real AI
 	BotDeathmatchAI( bs, thinktime );
+	trap_BotThinkEnd();
+	botrandomseed = NULL;
+	// everything was ok
+	return qtrue;
+}
+
+/*
+==============
+BotAIThink
+
+The AI nodes, may run on a job worker
+==============
+*/
+void BotAIThink( bot_state_t* bs )
+{
+	int j;
+
+	botrandomseed = &bs->randomseed;
+	trap_BotThinkBegin( bs->client, bs->randomseed );
+	// the real AI
+	BotDeathmatchThink( bs );
 	// set the weapon selection every AI frame
 	trap_EA_SelectWeapon( bs->client, bs->weaponnum );
 	// subtract the delta angles
@@ -1347,8 +1395,72 @@ int BotAI( int client, float thinktime )
 	{
 		bs->viewangles[j] = AngleMod( bs->viewangles[j] - SHORT2ANGLE( bs->cur_ps.delta_angles[j] ) );
 	}
-	// everything was ok
-	return qtrue;
+	trap_BotThinkEnd();
+	botrandomseed = NULL;
+}
+
+/*
+==============
+BotAIThinkRange
+==============
+*/
+static void BotAIThinkRange( void* data, int start, int end )
+{
+	bot_state_t** bots;
+	int			  i;
+
+	bots = ( bot_state_t** )data;
+	for( i = start; i < end; i++ )
+	{
+		BotAIThink( bots[i] );
+	}
+}
+
+/*
+==============
+BotAIThinkBots
+
+With bot_parallel set a native game runs the bots' AI nodes on job workers.
+What they would change for each other is held back meanwhile: the server
+queues their client commands and prints, botlib their routing area and chat
+changes, the game their userinfo. All of it is applied in client order
+afterwards, and each bot draws its own random numbers, so the result is the
+same whichever worker ran which bot. bot_parallel 0 goes through the same
+steps on the main thread.
+
+The AI nodes don't read cvars or the serverinfo, what they need of them is
+kept in vmCvar_ts and globals updated before the frame. The jobs run with
+the game as the current VM of their thread, so their syscalls reach it.
+==============
+*/
+static void BotAIThinkBots( bot_state_t** bots, int count )
+{
+	int i;
+
+	if( !count )
+	{
+		return;
+	}
+
+	trap_BotParallelFrame( qtrue );
+	botthinkparallel = qtrue;
+#ifndef Q3_VM
+	if( bot_parallel.integer )
+	{
+		trap_JobParallelFor( "BotAIThink", count, 1, BotAIThinkRange, bots );
+	}
+	else
+#endif
+	{
+		BotAIThinkRange( bots, 0, count );
+	}
+	botthinkparallel = qfalse;
+	trap_BotParallelFrame( qfalse );
+
+	for( i = 0; i < count; i++ )
+	{
+		BotApplyDeferredUserInfo( bots[i] );
+	}
 }
 
 /*
@@ -1730,6 +1842,8 @@ int BotAIStartFrame( int time )
 	gentity_t*		  ent;
 	bot_entitystate_t state;
 	int				  elapsed_time, thinktime;
+	bot_state_t*	  thinking[MAX_CLIENTS];
+	int				  numthinking;
 	static int		  local_time;
 	static int		  botlib_residual;
 	static int		  lastbotthink_time;
@@ -1746,12 +1860,17 @@ int BotAIStartFrame( int time )
 	trap_Cvar_Update( &bot_saveroutingcache );
 	trap_Cvar_Update( &bot_pause );
 	trap_Cvar_Update( &bot_report );
+	trap_Cvar_Update( &bot_parallel );
 
 	if( bot_report.integer )
 	{
 		//		BotTeamplayReport();
 		//		trap_Cvar_Set("bot_report", "0");
 		BotUpdateInfoConfigStrings();
+		if( bot_report.integer > 1 )
+		{
+			BotReportVisibility();
+		}
 	}
 
 	if( bot_pause.integer )
@@ -1912,8 +2031,10 @@ int BotAIStartFrame( int time )
 	}
 
 	floattime = trap_AAS_Time();
+	BotVisibilityFrame();
 
 	// execute scheduled bot AI
+	numthinking = 0;
 	for( i = 0; i < MAX_CLIENTS; i++ )
 	{
 		if( !botstates[i] || !botstates[i]->inuse )
@@ -1934,10 +2055,14 @@ int BotAIStartFrame( int time )
 
 			if( g_entities[i].client->pers.connected == CON_CONNECTED )
 			{
-				BotAI( i, ( float )thinktime / 1000 );
+				if( BotAI( i, ( float )thinktime / 1000 ) )
+				{
+					thinking[numthinking++] = botstates[i];
+				}
 			}
 		}
 	}
+	BotAIThinkBots( thinking, numthinking );
 
 	// execute bot user commands every frame
 	for( i = 0; i < MAX_CLIENTS; i++ )
@@ -2093,6 +2218,7 @@ int BotAISetup( int restart )
 	trap_Cvar_Register( &bot_saveroutingcache, "bot_saveroutingcache", "0", CVAR_CHEAT );
 	trap_Cvar_Register( &bot_pause, "bot_pause", "0", CVAR_CHEAT );
 	trap_Cvar_Register( &bot_report, "bot_report", "0", CVAR_CHEAT );
+	trap_Cvar_Register( &bot_parallel, "bot_parallel", "1", 0 );
 	trap_Cvar_Register( &bot_testsolid, "bot_testsolid", "0", CVAR_CHEAT );
 	trap_Cvar_Register( &bot_testclusters, "bot_testclusters", "0", CVAR_CHEAT );
 	trap_Cvar_Register( &bot_developer, "bot_developer", "0", CVAR_CHEAT );
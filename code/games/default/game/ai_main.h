@@ -277,6 +277,9 @@ typedef struct bot_state_s
 	bot_waypoint_t*		patrolpoints;	// patrol points
 	bot_waypoint_t*		curpatrolpoint; // current patrol point the bot is going for
 	int					patrolflags;	// patrol flags
+
+	int					randomseed;							// the bot's random numbers this think, see BotRandom
+	char				deferreduserinfo[MAX_INFO_STRING];	// userinfo keys set while thinking in parallel
 } bot_state_t;
 
 // resets the whole bot state
@@ -297,3 +300,11 @@ int				 BotAI_GetClientState( int clientNum, playerState_t* state );
 int				 BotAI_GetEntityState( int entityNum, entityState_t* state );
 int				 BotAI_GetSnapshotEntity( int clientNum, int sequence, entityState_t* state );
 int				 BotTeamLeader( bot_state_t* bs );
+
+// bots think in parallel, what they change in the game is deferred
+extern qboolean botthinkparallel;
+// the random numbers of the bot thinking on this thread, the same for
+// it whichever thread that is
+float			 BotRandom();
+#undef random
+#define random() BotRandom()
@@ -971,11 +971,11 @@ void ClientThink_real( gentity_t* ent )
 
 	if( pmove_msec.integer < 8 )
 	{
-		trap_Cvar_Set( "pmove_msec", "8" );
+		trap_Cvar_SetHandle( pmove_msec.handle, "8" );
 	}
 	else if( pmove_msec.integer > 33 )
 	{
-		trap_Cvar_Set( "pmove_msec", "33" );
+		trap_Cvar_SetHandle( pmove_msec.handle, "33" );
 	}
 
 	if( pmove_fixed.integer || client->pers.pmoveFixed )
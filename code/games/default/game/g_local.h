@@ -361,6 +361,7 @@ typedef struct
 	int				  previousTime; // so movers can back up when blocked
 
 	int				  startTime; // level.time the map was started
+	int				  randomSeed; // the server's seed for the map, bots derive theirs from it
 
 	int				  teamScores[TEAM_NUM_TEAMS];
 	int				  lastTeamLocationTime; // last time of client team location update
@@ -768,6 +769,10 @@ extern vmCvar_t g_enableBreath;
 extern vmCvar_t g_singlePlayer;
 extern vmCvar_t g_proxMineTimeout;
 
+#ifndef Q3_VM
+extern const gameExportTable_t gameExportTable; // handed to the server by dllGetAPI
+#endif
+
 void			trap_Printf( const char* fmt );
 void			trap_Error( const char* fmt );
 int				trap_Milliseconds();
@@ -784,6 +789,15 @@ void			trap_SendConsoleCommand( int exec_when, const char* text );
 void			trap_Cvar_Register( vmCvar_t* cvar, const char* var_name, const char* value, int flags );
 void			trap_Cvar_Update( vmCvar_t* cvar );
 void			trap_Cvar_Set( const char* var_name, const char* value );
+void			trap_Cvar_SetHandle( cvarHandle_t handle, const char* value );
+int				trap_Cvar_ModificationCount();
+void			trap_ProfileBegin( const char* name ); // profile_capture zones, nest like braces
+void			trap_ProfileEnd();
+void			trap_JobAdd( const char* name, jobFunc_t func, void* data, jobCounter_t* signal ); // func must not call traps
+void			trap_JobWait( jobCounter_t* counter );
+void			trap_JobParallelFor( const char* name, int count, int minBatch, jobRangeFunc_t func, void* data );
+int				trap_JobNumWorkers();
+void			trap_LogWrite( const void* buffer, int len, fileHandle_t f );
 int				trap_Cvar_VariableIntegerValue( const char* var_name );
 float			trap_Cvar_VariableValue( const char* var_name );
 void			trap_Cvar_VariableStringBuffer( const char* var_name, char* buffer, int bufsize );
@@ -827,6 +841,9 @@ int				trap_BotLibTest( int parm0, char* parm1, vec3_t parm2, vec3_t parm3 );
 int				trap_BotGetSnapshotEntity( int clientNum, int sequence );
 int				trap_BotGetServerCommand( int clientNum, char* message, int size );
 void			trap_BotUserCommand( int client, usercmd_t* ucmd );
+void			trap_BotParallelFrame( qboolean begin );
+void			trap_BotThinkBegin( int client, int seed );
+void			trap_BotThinkEnd();
 
 int				trap_AAS_BBoxAreas( vec3_t absmins, vec3_t absmaxs, int* areas, int maxareas );
 int				trap_AAS_AreaInfo( int areanum, void /* struct aas_areainfo_s */* info );
@@ -191,6 +191,32 @@ void	   G_RunFrame( int levelTime );
 void	   G_ShutdownGame( int restart );
 void	   CheckExitRules();
 
+/*
+================
+G_BotAIStartFrame
+================
+*/
+static int G_BotAIStartFrame( int time )
+{
+	int result;
+
+	trap_ProfileBegin( "BotAIStartFrame" );
+	result = BotAIStartFrame( time );
+	trap_ProfileEnd();
+	return result;
+}
+
+#ifndef Q3_VM
+// the entry points the server calls directly in a dll build
+const gameExportTable_t gameExportTable = {
+	{ GAME_DIRECT_API_VERSION, sizeof( gameExportTable_t ) },
+
+	ClientThink,
+	G_RunFrame,
+	G_BotAIStartFrame,
+};
+#endif
+
 /*
 ================
 vmMain
@@ -232,7 +258,7 @@ int		   vmMain( int command, int arg0, int arg1, int arg2, int arg3, int arg4, i
 		case GAME_CONSOLE_COMMAND:
 			return ConsoleCommand();
 		case BOTAI_START_FRAME:
-			return BotAIStartFrame( arg0 );
+			return G_BotAIStartFrame( arg0 );
 	}
 
 	return -1;
@@ -395,10 +421,19 @@ G_UpdateCvars
 */
 void G_UpdateCvars()
 {
-	int			 i;
+	static int	 cvarModificationCount = -1;
+	int			 i, count;
 	cvarTable_t* cv;
 	qboolean	 remapped = qfalse;
 
+	// one trap instead of one per cvar when nothing changed
+	count = trap_Cvar_ModificationCount();
+	if( count == cvarModificationCount )
+	{
+		return;
+	}
+	cvarModificationCount = count;
+
 	for( i = 0, cv = gameCvarTable; i < gameCvarTableSize; i++, cv++ )
 	{
 		if( cv->vmCvar )
@@ -452,8 +487,9 @@ void G_InitGame( int levelTime, int randomSeed, int restart )
 
 	// set some level globals
 	memset( &level, 0, sizeof( level ) );
-	level.time		= levelTime;
-	level.startTime = levelTime;
+	level.time		 = levelTime;
+	level.startTime	 = levelTime;
+	level.randomSeed = randomSeed;
 
 	level.snd_fry = G_SoundIndex( "sound/player/fry.wav" ); // FIXME standing in lava / slime
 
@@ -1227,7 +1263,7 @@ void QDECL G_LogPrintf( const char* fmt, ... )
 		return;
 	}
 
-	trap_FS_Write( string, strlen( string ), level.logFile );
+	trap_LogWrite( string, strlen( string ), level.logFile );
 }
 
 /*
@@ -1911,11 +1947,11 @@ void CheckCvars()
 		lastMod = g_password.modificationCount;
 		if( *g_password.string && Q_stricmp( g_password.string, "none" ) )
 		{
-			trap_Cvar_Set( "g_needpass", "1" );
+			trap_Cvar_SetHandle( g_needpass.handle, "1" );
 		}
 		else
 		{
-			trap_Cvar_Set( "g_needpass", "0" );
+			trap_Cvar_SetHandle( g_needpass.handle, "0" );
 		}
 	}
 }
@@ -2093,6 +2129,6 @@ void G_RunFrame( int levelTime )
 		{
 			G_Printf( "%4i: %s\n", i, g_entities[i].classname );
 		}
-		trap_Cvar_Set( "g_listEntity", "0" );
+		trap_Cvar_SetHandle( g_listEntity.handle, "0" );
 	}
 }
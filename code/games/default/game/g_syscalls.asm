@@ -46,6 +46,15 @@ equ trap_SnapVector			-43
 equ trap_TraceCapsule		-44
 equ trap_EntityContactCapsule	-45
 equ trap_FS_Seek -46
+equ	trap_Cvar_SetHandle		-47
+equ	trap_Cvar_ModificationCount	-48
+equ	trap_ProfileBegin		-49
+equ	trap_ProfileEnd			-50
+equ	trap_JobAdd				-51
+equ	trap_JobWait			-52
+equ	trap_JobParallelFor		-53
+equ	trap_JobNumWorkers		-54
+equ	trap_LogWrite			-55
 
 equ	memset					-101
 equ	memcpy					-102
@@ -74,6 +83,9 @@ equ trap_BotLibTest						-209
 equ trap_BotGetSnapshotEntity			-210
 equ trap_BotGetServerCommand		-211
 equ trap_BotUserCommand					-212
+equ trap_BotParallelFrame				-213
+equ trap_BotThinkBegin					-214
+equ trap_BotThinkEnd					-215
 
 
 
@@ -30,9 +30,32 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 static int( QDECL* syscall )( int arg, ... ) = ( int( QDECL* )( int, ... ) ) - 1;
 
+// typed engine functions, NULL when the engine didn't offer a version we know
+static const gameImportTable_t* imports;
+
 void dllEntry( int( QDECL* syscallptr )( int arg, ... ) )
 {
 	syscall = syscallptr;
+	imports = NULL;
+}
+
+/*
+================
+dllGetAPI
+
+Called by the engine after dllEntry, the traps below that are in the
+import table call straight into the engine once this has accepted it
+================
+*/
+const vmApiHeader_t* QDECL dllGetAPI( int version, const vmApiHeader_t* engineImports )
+{
+	if( version != GAME_DIRECT_API_VERSION || !engineImports || engineImports->size < ( int )sizeof( gameImportTable_t ) )
+	{
+		return NULL;
+	}
+
+	imports = ( const gameImportTable_t* )engineImports;
+	return &gameExportTable.header;
 }
 
 int PASSFLOAT( float x )
@@ -54,6 +77,10 @@ void trap_Error( const char* fmt )
 
 int trap_Milliseconds()
 {
+	if( imports )
+	{
+		return imports->Milliseconds();
+	}
 	return syscall( G_MILLISECONDS );
 }
 int trap_Argc()
@@ -108,6 +135,11 @@ void trap_Cvar_Register( vmCvar_t* cvar, const char* var_name, const char* value
 
 void trap_Cvar_Update( vmCvar_t* cvar )
 {
+	if( imports )
+	{
+		imports->Cvar_Update( cvar );
+		return;
+	}
 	syscall( G_CVAR_UPDATE, cvar );
 }
 
@@ -116,8 +148,57 @@ void trap_Cvar_Set( const char* var_name, const char* value )
 	syscall( G_CVAR_SET, var_name, value );
 }
 
+void trap_Cvar_SetHandle( cvarHandle_t handle, const char* value )
+{
+	syscall( G_CVAR_SET_HANDLE, handle, value );
+}
+
+int trap_Cvar_ModificationCount()
+{
+	return syscall( G_CVAR_MODIFICATION_COUNT );
+}
+
+void trap_ProfileBegin( const char* name )
+{
+	syscall( G_PROFILE_BEGIN, name );
+}
+
+void trap_ProfileEnd()
+{
+	syscall( G_PROFILE_END );
+}
+
+void trap_JobAdd( const char* name, jobFunc_t func, void* data, jobCounter_t* signal )
+{
+	syscall( G_JOB_ADD, name, func, data, signal );
+}
+
+void trap_JobWait( jobCounter_t* counter )
+{
+	syscall( G_JOB_WAIT, counter );
+}
+
+void trap_JobParallelFor( const char* name, int count, int minBatch, jobRangeFunc_t func, void* data )
+{
+	syscall( G_JOB_PARALLEL_FOR, name, count, minBatch, func, data );
+}
+
+int trap_JobNumWorkers()
+{
+	return syscall( G_JOB_NUM_WORKERS );
+}
+
+void trap_LogWrite( const void* buffer, int len, fileHandle_t f )
+{
+	syscall( G_LOG_WRITE, buffer, len, f );
+}
+
 int trap_Cvar_VariableIntegerValue( const char* var_name )
 {
+	if( imports )
+	{
+		return imports->Cvar_VariableIntegerValue( var_name );
+	}
 	return syscall( G_CVAR_VARIABLE_INTEGER_VALUE, var_name );
 }
 
@@ -173,26 +254,48 @@ void trap_SetBrushModel( gentity_t* ent, const char* name )
 
 void trap_Trace( trace_t* results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask )
 {
+	if( imports )
+	{
+		imports->Trace( results, start, mins, maxs, end, passEntityNum, contentmask, qfalse );
+		return;
+	}
 	syscall( G_TRACE, results, start, mins, maxs, end, passEntityNum, contentmask );
 }
 
 void trap_TraceCapsule( trace_t* results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask )
 {
+	if( imports )
+	{
+		imports->Trace( results, start, mins, maxs, end, passEntityNum, contentmask, qtrue );
+		return;
+	}
 	syscall( G_TRACECAPSULE, results, start, mins, maxs, end, passEntityNum, contentmask );
 }
 
 int trap_PointContents( const vec3_t point, int passEntityNum )
 {
+	if( imports )
+	{
+		return imports->PointContents( point, passEntityNum );
+	}
 	return syscall( G_POINT_CONTENTS, point, passEntityNum );
 }
 
 qboolean trap_InPVS( const vec3_t p1, const vec3_t p2 )
 {
+	if( imports )
+	{
+		return imports->InPVS( p1, p2 );
+	}
 	return syscall( G_IN_PVS, p1, p2 );
 }
 
 qboolean trap_InPVSIgnorePortals( const vec3_t p1, const vec3_t p2 )
 {
+	if( imports )
+	{
+		return imports->InPVSIgnorePortals( p1, p2 );
+	}
 	return syscall( G_IN_PVS_IGNORE_PORTALS, p1, p2 );
 }
 
@@ -203,31 +306,57 @@ void trap_AdjustAreaPortalState( gentity_t* ent, qboolean open )
 
 qboolean trap_AreasConnected( int area1, int area2 )
 {
+	if( imports )
+	{
+		return imports->AreasConnected( area1, area2 );
+	}
 	return syscall( G_AREAS_CONNECTED, area1, area2 );
 }
 
 void trap_LinkEntity( gentity_t* ent )
 {
+	if( imports )
+	{
+		imports->LinkEntity( ( sharedEntity_t* )ent );
+		return;
+	}
 	syscall( G_LINKENTITY, ent );
 }
 
 void trap_UnlinkEntity( gentity_t* ent )
 {
+	if( imports )
+	{
+		imports->UnlinkEntity( ( sharedEntity_t* )ent );
+		return;
+	}
 	syscall( G_UNLINKENTITY, ent );
 }
 
 int trap_EntitiesInBox( const vec3_t mins, const vec3_t maxs, int* list, int maxcount )
 {
+	if( imports )
+	{
+		return imports->EntitiesInBox( mins, maxs, list, maxcount );
+	}
 	return syscall( G_ENTITIES_IN_BOX, mins, maxs, list, maxcount );
 }
 
 qboolean trap_EntityContact( const vec3_t mins, const vec3_t maxs, const gentity_t* ent )
 {
+	if( imports )
+	{
+		return imports->EntityContact( mins, maxs, ( const sharedEntity_t* )ent, qfalse );
+	}
 	return syscall( G_ENTITY_CONTACT, mins, maxs, ent );
 }
 
 qboolean trap_EntityContactCapsule( const vec3_t mins, const vec3_t maxs, const gentity_t* ent )
 {
+	if( imports )
+	{
+		return imports->EntityContact( mins, maxs, ( const sharedEntity_t* )ent, qtrue );
+	}
 	return syscall( G_ENTITY_CONTACTCAPSULE, mins, maxs, ent );
 }
 
@@ -243,6 +372,11 @@ void trap_BotFreeClient( int clientNum )
 
 void trap_GetUsercmd( int clientNum, usercmd_t* cmd )
 {
+	if( imports )
+	{
+		imports->GetUsercmd( clientNum, cmd );
+		return;
+	}
 	syscall( G_GET_USERCMD, clientNum, cmd );
 }
 
@@ -333,6 +467,21 @@ void trap_BotUserCommand( int clientNum, usercmd_t* ucmd )
 	syscall( BOTLIB_USER_COMMAND, clientNum, ucmd );
 }
 
+void trap_BotParallelFrame( qboolean begin )
+{
+	syscall( BOTLIB_PARALLEL_FRAME, begin );
+}
+
+void trap_BotThinkBegin( int clientNum, int seed )
+{
+	syscall( BOTLIB_THINK_BEGIN, clientNum, seed );
+}
+
+void trap_BotThinkEnd()
+{
+	syscall( BOTLIB_THINK_END );
+}
+
 void trap_AAS_EntityInfo( int entnum, void /* struct aas_entityinfo_s */* info )
 {
 	syscall( BOTLIB_AAS_ENTITY_INFO, entnum, info );
@@ -626,6 +626,8 @@ int				  trap_Milliseconds();
 void			  trap_Cvar_Register( vmCvar_t* vmCvar, const char* varName, const char* defaultValue, int flags );
 void			  trap_Cvar_Update( vmCvar_t* vmCvar );
 void			  trap_Cvar_Set( const char* var_name, const char* value );
+void			  trap_Cvar_SetHandle( cvarHandle_t handle, const char* value );
+int				  trap_Cvar_ModificationCount();
 float			  trap_Cvar_VariableValue( const char* var_name );
 void			  trap_Cvar_VariableStringBuffer( const char* var_name, char* buffer, int bufsize );
 void			  trap_Cvar_SetValue( const char* var_name, float value );
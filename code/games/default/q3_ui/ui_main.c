@@ -240,9 +240,18 @@ UI_UpdateCvars
 */
 void UI_UpdateCvars()
 {
-	int			 i;
+	static int	 cvarModificationCount = -1;
+	int			 i, count;
 	cvarTable_t* cv;
 
+	// one trap instead of one per cvar when nothing changed
+	count = trap_Cvar_ModificationCount();
+	if( count == cvarModificationCount )
+	{
+		return;
+	}
+	cvarModificationCount = count;
+
 	for( i = 0, cv = cvarTable; i < cvarTableSize; i++, cv++ )
 	{
 		trap_Cvar_Update( cv->vmCvar );
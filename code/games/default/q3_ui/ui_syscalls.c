@@ -72,6 +72,16 @@ void trap_Cvar_Set( const char* var_name, const char* value )
 	syscall( UI_CVAR_SET, var_name, value );
 }
 
+void trap_Cvar_SetHandle( cvarHandle_t handle, const char* value )
+{
+	syscall( UI_CVAR_SET_HANDLE, handle, value );
+}
+
+int trap_Cvar_ModificationCount()
+{
+	return syscall( UI_CVAR_MODIFICATION_COUNT );
+}
+
 float trap_Cvar_VariableValue( const char* var_name )
 {
 	int temp;
@@ -70,6 +70,8 @@ typedef struct bot_match_s
 int	 BotSetupChatAI();
 // shutdown the chat AI
 void BotShutdownChatAI();
+// marks the chat messages used during a parallel frame as recently used
+void BotApplyChatMessageTimes();
 // returns the handle to a newly allocated chat state
 int	 BotAllocChatState();
 // frees the chatstate
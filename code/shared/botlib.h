@@ -29,7 +29,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  *
  *****************************************************************************/
 
-#define BOTLIB_API_VERSION 2
+#define BOTLIB_API_VERSION 3
 
 struct aas_clientmove_s;
 struct aas_entityinfo_s;
@@ -195,6 +195,9 @@ typedef struct botlib_import_s
 	int ( *FS_Write )( const void* buffer, int len, fileHandle_t f );
 	void ( *FS_FCloseFile )( fileHandle_t f );
 	int ( *FS_Seek )( fileHandle_t f, long offset, int origin );
+	// read only file contents, shared with other processes when the file can be mapped
+	int ( *FS_MapFile )( const char* qpath, void** buffer );
+	void ( *FS_UnmapFile )( void* buffer );
 	// debug visualisation stuff
 	int ( *DebugLineCreate )();
 	void ( *DebugLineDelete )( int line );
@@ -202,6 +205,12 @@ typedef struct botlib_import_s
 	//
 	int ( *DebugPolygonCreate )( int color, int numPoints, vec3_t* points );
 	void ( *DebugPolygonDelete )( int id );
+	// engine job system, jobs must only touch botlib data that is not shared
+	void ( *JobAdd )( const char* name, jobFunc_t func, void* data, jobCounter_t* signal );
+	void ( *JobWait )( jobCounter_t* counter );
+	void ( *JobParallelFor )( const char* name, int count, int minBatch, jobRangeFunc_t func, void* data );
+	int ( *JobNumWorkers )();
+	void ( *Yield )(); // while spinning on a lock
 } botlib_import_t;
 
 typedef struct aas_export_s
@@ -427,6 +436,12 @@ typedef struct botlib_export_s
 	int ( *BotLibLoadMap )( const char* mapname );
 	// entity updates
 	int ( *BotLibUpdateEntity )( int ent, bot_entitystate_t* state );
+	// bots thinking on job workers: the frame is bracketed with
+	// BotLibParallelFrame( qtrue / qfalse ), every think on a worker with
+	// BotLibThinkBegin / BotLibThinkEnd, see be_interface.c
+	void ( *BotLibParallelFrame )( int begin );
+	void ( *BotLibThinkBegin )( int client, int seed );
+	void ( *BotLibThinkEnd )();
 	// just for testing
 	int ( *Test )( int parm0, char* parm1, vec3_t parm2, vec3_t parm3 );
 } botlib_export_t;
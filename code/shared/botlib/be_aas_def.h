@@ -143,18 +143,22 @@ typedef struct aas_settings_s
 // routing cache
 typedef struct aas_routingcache_s
 {
-	byte					   type;			// portal or area cache
-	float					   time;			// last time accessed or updated
-	int						   size;			// size of the routing cache
-	int						   cluster;			// cluster the cache is for
-	int						   areanum;			// area the cache is created for
-	vec3_t					   origin;			// origin within the area
-	float					   starttraveltime; // travel time to start with
-	int						   travelflags;		// combinations of the travel flags
-	struct aas_routingcache_s *prev, *next;
-	struct aas_routingcache_s *time_prev, *time_next;
-	unsigned char*			   reachabilities; // reachabilities used for routing
-	unsigned short int		   traveltimes[1]; // travel time for every area (variable sized)
+	byte							type;			 // portal or area cache
+	byte							mapped;			 // points into the route cache file, never freed
+	byte							kept;			 // area cache towards a portal, never evicted
+	byte							think;			 // only for the bot thinking, see AAS_EndThinkRoutingAreas
+	float							time;			 // last time accessed or updated
+	int								size;			 // size of the routing cache
+	int								cluster;		 // cluster the cache is for
+	int								areanum;		 // area the cache is created for
+	vec3_t							origin;			 // origin within the area
+	float							starttraveltime; // travel time to start with
+	int								travelflags;	 // combinations of the travel flags
+	struct aas_routingcache_s	   *prev, *next;
+	struct aas_routingcache_s	   *time_prev, *time_next;
+	unsigned char*					reachabilities;	// reachabilities used for routing
+	unsigned short int*				traveltimes;	// travel time for every area
+	struct aas_routingcachechunk_s*	chunk;			// slab chunk the cache is allocated from
 } aas_routingcache_t;
 
 // fields for the routing algorithm
@@ -166,6 +170,8 @@ typedef struct aas_routingupdate_s
 	unsigned short int			tmptraveltime;	 // temporary travel time
 	unsigned short int*			areatraveltimes; // travel times within the area
 	qboolean					inlist;			 // true if the update is in the list
+	int							heapindex;		 // position in the update heap while inlist
+	int							search;			 // routing search tmptraveltime belongs to
 	struct aas_routingupdate_s* next;
 	struct aas_routingupdate_s* prev;
 } aas_routingupdate_t;
@@ -267,6 +273,10 @@ typedef struct aas_s
 	// routing update
 	aas_routingupdate_t*		areaupdate;
 	aas_routingupdate_t*		portalupdate;
+	aas_routingupdate_t*		reachabilityupdate; // travel time from the start of each reachability
+	int							numroutingsearches;
+	aas_routingupdate_t**		areaupdateheap; // updates ordered on travel time
+	aas_routingupdate_t**		portalupdateheap;
 	// number of routing updates during a frame (reset every frame)
 	int							frameroutingupdates;
 	// reversed reachability links
@@ -279,6 +289,9 @@ typedef struct aas_s
 	// cache list sorted on time
 	aas_routingcache_t*			oldestcache; // start of cache list sorted on time
 	aas_routingcache_t*			newestcache; // end of cache list sorted on time
+	// cache served from the route cache file
+	void*						routecachefile;
+	aas_routingcache_t*			routecachemapped; // headers of the mapped cache
 	// maximum travel time through portal areas
 	int*						portalmaxtraveltimes;
 	// areas the reachabilities go through
@@ -286,10 +286,16 @@ int AAS_StartFrame( float time )
 	//
 	if( saveroutingcache->value )
 	{
-		AAS_WriteRouteCache();
+		AAS_BuildRouteCache();
 		LibVarSet( "saveroutingcache", "0" );
 	} // end if
 	//
+	if( LibVarGetValue( "routingbenchmark" ) )
+	{
+		AAS_RoutingBenchmark();
+		LibVarSet( "routingbenchmark", "0" );
+	} // end if
+	//
 	aasworld.numframes++;
 	return BLERR_NOERROR;
 } // end of the function AAS_StartFrame
@@ -404,7 +410,7 @@ int AAS_Setup()
 {
 	aasworld.maxclients	 = ( int )LibVarValue( "maxclients", "128" );
 	aasworld.maxentities = ( int )LibVarValue( "maxentities", "1024" );
-	// as soon as it's set to 1 the routing cache will be saved
+	// as soon as it's set to 1 the routing cache is created and saved
 	saveroutingcache = LibVar( "saveroutingcache", "0" );
 	// allocate memory for the entities
 	if( aasworld.entities )
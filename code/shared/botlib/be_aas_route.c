@@ -73,15 +73,110 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
   for every area (aasworld.numareas) the portal cache stores
   aasworld.numportals travel times
 
+  all cache is kept on one list ordered on last use (aasworld.oldestcache
+  to aasworld.newestcache), when the cache grows over max_routingcachesize
+  bytes or memory runs low the least recently used cache is freed first,
+  area cache towards a portal is used by every portal cache update and is
+  never freed, it stays off the list and out of max_routingcachesize
+
+  both caches are filled from the goal outwards, the next area to update
+  is always the one with the lowest travel time so far (a binary heap keyed
+  on the travel time), so every area is updated once instead of every time
+  a shorter route to it is found
+
 */
 
 #ifdef ROUTING_DEBUG
 int numareacacheupdates;
 int numportalcacheupdates;
+int numcachehits;
+int numcachemisses;
+int numcacheevictions;
 #endif // ROUTING_DEBUG
 
 int routingcachesize;
 int max_routingcachesize;
+// area cache towards portals, not in routingcachesize
+int keptroutingcachesize;
+
+// number of areas and portals taken from the update queue
+int numarearelaxations;
+int numportalrelaxations;
+
+// update in the order the areas were reached instead of on travel time,
+// only for AAS_RoutingBenchmark
+static qboolean routingupdatefifo;
+
+#define ROUTINGCACHE_CHUNKSIZE	  32768
+#define MAX_CHUNKROUTINGCACHES	  64
+#define ROUTINGCACHESLAB_HASHSIZE 64
+
+// chunk with routing caches of the same size
+typedef struct aas_routingcachechunk_s
+{
+	struct aas_routingcacheslab_s*	slab;		 // slab the chunk belongs to
+	int								numused;	 // number of caches in use
+	aas_routingcache_t*				freecaches;	 // free caches, linked through next
+	struct aas_routingcachechunk_s *prev, *next; // chunks of the slab with free caches
+} aas_routingcachechunk_t;
+
+// slab with the routing caches of one size, the area caches of a cluster
+// all have the same size and so do all the portal caches
+typedef struct aas_routingcacheslab_s
+{
+	int							   size;	   // size of a routing cache
+	int							   stride;	   // size rounded up for alignment
+	int							   numcaches;  // number of caches per chunk
+	aas_routingcachechunk_t*	   freechunks; // chunks with free caches
+	struct aas_routingcacheslab_s* next;	   // next slab in the hash chain
+} aas_routingcacheslab_t;
+
+// slabs hashed on the routing cache size
+static aas_routingcacheslab_t* routingcacheslabs[ROUTINGCACHESLAB_HASHSIZE];
+
+typedef struct aas_routingqueue_s
+{
+	aas_routingupdate_t** heap;
+	int					  numheap;
+	aas_routingupdate_t*  first; // FIFO order
+	aas_routingupdate_t*  last;
+} aas_routingqueue_t;
+
+// a routing area enabled or disabled by a bot thinking in a parallel frame
+typedef struct aas_areachange_s
+{
+	int areanum;
+	int disabled; // AREA_DISABLED or 0
+	int client;
+	int sequence;
+} aas_areachange_t;
+
+#define MAX_THINKAREACHANGES 64
+#define MAX_AREACHANGES		 1024
+
+// areas the bot thinking on this thread changed for its own routing, the
+// routing checks them before the area flags, see AAS_EnableRoutingArea
+static Q_THREADLOCAL aas_areachange_t	   thinkareachanges[MAX_THINKAREACHANGES];
+static Q_THREADLOCAL int				   numthinkareachanges;
+// routing cache of the bot thinking on this thread, only used when its
+// changes differ from the area flags
+static Q_THREADLOCAL aas_routingcache_t*** thinkclusterareacache;
+static Q_THREADLOCAL aas_routingcache_t**  thinkportalcache;
+// true while the cache of a thinking bot is in aasworld, under the botlib lock
+static int								   thinkroutingcache;
+// changes made at the end of the parallel frame
+static aas_areachange_t					   areachanges[MAX_AREACHANGES];
+static int								   numareachanges;
+
+// bumped whenever travel times may have changed, see AAS_RoutingGeneration
+static volatile int						   routinggeneration;
+
+void									   AAS_FreeRouteCacheFile();
+int										   AAS_ReadRouteCache();
+void									   AAS_FreeAllClusterAreaCache();
+void									   AAS_FreeAllPortalCache();
+aas_routingcache_t* AAS_GetAreaRoutingCache( int clusternum, int areanum, int travelflags );
+aas_routingcache_t* AAS_GetPortalRoutingCache( int clusternum, int areanum, int travelflags );
 
 //===========================================================================
 //
@@ -94,7 +189,10 @@ void AAS_RoutingInfo()
 {
 	botimport.Print( PRT_MESSAGE, "%d area cache updates\n", numareacacheupdates );
 	botimport.Print( PRT_MESSAGE, "%d portal cache updates\n", numportalcacheupdates );
-	botimport.Print( PRT_MESSAGE, "%d bytes routing cache\n", routingcachesize );
+	botimport.Print( PRT_MESSAGE, "%d area and %d portal relaxations\n", numarearelaxations, numportalrelaxations );
+	botimport.Print( PRT_MESSAGE, "%d cache hits, %d misses, %d evictions\n", numcachehits, numcachemisses, numcacheevictions );
+	botimport.Print( PRT_MESSAGE, "%d of %d bytes routing cache\n", routingcachesize, max_routingcachesize );
+	botimport.Print( PRT_MESSAGE, "%d bytes routing cache towards portals\n", keptroutingcachesize );
 } // end of the function AAS_RoutingInfo
 #endif // ROUTING_DEBUG
 //===========================================================================
@@ -253,11 +351,199 @@ void AAS_LinkCache( aas_routingcache_t* cache )
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
+static aas_routingcacheslab_t* AAS_RoutingCacheSlab( int size )
+{
+	aas_routingcacheslab_t* slab;
+	int						hash;
+
+	hash = size & ( ROUTINGCACHESLAB_HASHSIZE - 1 );
+	for( slab = routingcacheslabs[hash]; slab; slab = slab->next )
+	{
+		if( slab->size == size )
+		{
+			return slab;
+		} // end if
+	} // end for
+	slab			= ( aas_routingcacheslab_t* )GetClearedMemory( sizeof( aas_routingcacheslab_t ) );
+	slab->size		= size;
+	slab->stride	= ( size + 15 ) & ~15;
+	slab->numcaches = ROUTINGCACHE_CHUNKSIZE / slab->stride;
+	if( slab->numcaches < 1 )
+	{
+		slab->numcaches = 1;
+	} // end if
+	else if( slab->numcaches > MAX_CHUNKROUTINGCACHES )
+	{
+		slab->numcaches = MAX_CHUNKROUTINGCACHES;
+	} // end else if
+	slab->next				= routingcacheslabs[hash];
+	routingcacheslabs[hash] = slab;
+	return slab;
+} // end of the function AAS_RoutingCacheSlab
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_UnlinkRoutingCacheChunk( aas_routingcacheslab_t* slab, aas_routingcachechunk_t* chunk )
+{
+	if( chunk->prev )
+	{
+		chunk->prev->next = chunk->next;
+	}
+	else
+	{
+		slab->freechunks = chunk->next;
+	}
+	if( chunk->next )
+	{
+		chunk->next->prev = chunk->prev;
+	}
+	chunk->prev = NULL;
+	chunk->next = NULL;
+} // end of the function AAS_UnlinkRoutingCacheChunk
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_LinkRoutingCacheChunk( aas_routingcacheslab_t* slab, aas_routingcachechunk_t* chunk )
+{
+	chunk->prev = NULL;
+	chunk->next = slab->freechunks;
+	if( slab->freechunks )
+	{
+		slab->freechunks->prev = chunk;
+	}
+	slab->freechunks = chunk;
+} // end of the function AAS_LinkRoutingCacheChunk
+//===========================================================================
+// allocates a routing cache from the slab with caches of the same size
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static aas_routingcache_t* AAS_AllocSlabRoutingCache( int size )
+{
+	aas_routingcacheslab_t*	 slab;
+	aas_routingcachechunk_t* chunk;
+	aas_routingcache_t*		 cache;
+	char*					 ptr;
+	int						 headersize, i;
+
+	slab  = AAS_RoutingCacheSlab( size );
+	chunk = slab->freechunks;
+	if( !chunk )
+	{
+		headersize		  = ( sizeof( aas_routingcachechunk_t ) + 15 ) & ~15;
+		chunk			  = ( aas_routingcachechunk_t* )GetMemory( headersize + slab->numcaches * slab->stride );
+		chunk->slab		  = slab;
+		chunk->numused	  = 0;
+		chunk->freecaches = NULL;
+		ptr				  = ( char* )chunk + headersize;
+		for( i = 0; i < slab->numcaches; i++, ptr += slab->stride )
+		{
+			cache			  = ( aas_routingcache_t* )ptr;
+			cache->next		  = chunk->freecaches;
+			chunk->freecaches = cache;
+		} // end for
+		AAS_LinkRoutingCacheChunk( slab, chunk );
+	} // end if
+	cache			  = chunk->freecaches;
+	chunk->freecaches = cache->next;
+	chunk->numused++;
+	// no free caches left in the chunk
+	if( !chunk->freecaches )
+	{
+		AAS_UnlinkRoutingCacheChunk( slab, chunk );
+	} // end if
+	Com_Memset( cache, 0, size );
+	cache->chunk = chunk;
+	return cache;
+} // end of the function AAS_AllocSlabRoutingCache
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_FreeSlabRoutingCache( aas_routingcache_t* cache )
+{
+	aas_routingcacheslab_t*	 slab;
+	aas_routingcachechunk_t* chunk;
+
+	chunk = cache->chunk;
+	slab  = chunk->slab;
+	// the chunk was full and has a free cache again
+	if( !chunk->freecaches )
+	{
+		AAS_LinkRoutingCacheChunk( slab, chunk );
+	} // end if
+	cache->next		  = chunk->freecaches;
+	chunk->freecaches = cache;
+	chunk->numused--;
+	// return empty chunks to the zone but keep one to allocate from
+	if( !chunk->numused && ( chunk->prev || chunk->next ) )
+	{
+		AAS_UnlinkRoutingCacheChunk( slab, chunk );
+		FreeMemory( chunk );
+	} // end if
+} // end of the function AAS_FreeSlabRoutingCache
+//===========================================================================
+// frees the routing cache slabs, all routing caches must be freed already
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_FreeRoutingCacheSlabs()
+{
+	aas_routingcacheslab_t*	 slab;
+	aas_routingcachechunk_t* chunk;
+	int						 i;
+
+	for( i = 0; i < ROUTINGCACHESLAB_HASHSIZE; i++ )
+	{
+		while( routingcacheslabs[i] )
+		{
+			slab				 = routingcacheslabs[i];
+			routingcacheslabs[i] = slab->next;
+			while( slab->freechunks )
+			{
+				chunk			 = slab->freechunks;
+				slab->freechunks = chunk->next;
+				FreeMemory( chunk );
+			} // end while
+			FreeMemory( slab );
+		} // end while
+	} // end for
+} // end of the function AAS_FreeRoutingCacheSlabs
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
 void AAS_FreeRoutingCache( aas_routingcache_t* cache )
 {
-	AAS_UnlinkCache( cache );
-	routingcachesize -= cache->size;
-	FreeMemory( cache );
+	// belongs to the route cache file
+	if( cache->mapped )
+	{
+		return;
+	}
+	if( cache->kept )
+	{
+		keptroutingcachesize -= cache->size;
+	}
+	else if( !cache->think )
+	{
+		AAS_UnlinkCache( cache );
+		routingcachesize -= cache->size;
+	} // end else
+	AAS_FreeSlabRoutingCache( cache );
 } // end of the function AAS_FreeRoutingCache
 //===========================================================================
 //
@@ -297,6 +583,7 @@ void AAS_RemoveRoutingCacheUsingArea( int areanum )
 	int					i, clusternum;
 	aas_routingcache_t *cache, *nextcache;
 
+	routinggeneration++;
 	clusternum = aasworld.areasettings[areanum].cluster;
 	if( clusternum > 0 )
 	{
@@ -327,6 +614,104 @@ void AAS_RemoveRoutingCacheUsingArea( int areanum )
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
+static void AAS_SetRoutingAreaDisabled( int areanum, int disabled )
+{
+	int flags;
+
+	flags = aasworld.areasettings[areanum].areaflags & AREA_DISABLED;
+	if( disabled )
+	{
+		aasworld.areasettings[areanum].areaflags |= AREA_DISABLED;
+	}
+	else
+	{
+		aasworld.areasettings[areanum].areaflags &= ~AREA_DISABLED;
+	}
+	// if the status of the area changed
+	if( flags != ( aasworld.areasettings[areanum].areaflags & AREA_DISABLED ) )
+	{
+		// remove all routing cache involving this area
+		AAS_RemoveRoutingCacheUsingArea( areanum );
+	} // end if
+} // end of the function AAS_SetRoutingAreaDisabled
+//===========================================================================
+// returns AREA_DISABLED when the area is disabled for the routing of the
+// bot thinking on this thread
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_AreaRoutingDisabled( int areanum )
+{
+	int i;
+
+	for( i = 0; i < numthinkareachanges; i++ )
+	{
+		if( thinkareachanges[i].areanum == areanum )
+		{
+			return thinkareachanges[i].disabled;
+		}
+	} // end for
+	return aasworld.areasettings[areanum].areaflags & AREA_DISABLED;
+} // end of the function AAS_AreaRoutingDisabled
+//===========================================================================
+// returns true when the areas the bot thinking on this thread changed
+// differ from the area flags, its routing can't use the shared cache then
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_ThinkRoutingAreasChanged()
+{
+	int i;
+
+	for( i = 0; i < numthinkareachanges; i++ )
+	{
+		if( thinkareachanges[i].disabled != ( aasworld.areasettings[thinkareachanges[i].areanum].areaflags & AREA_DISABLED ) )
+		{
+			return qtrue;
+		}
+	} // end for
+	return qfalse;
+} // end of the function AAS_ThinkRoutingAreasChanged
+//===========================================================================
+// a bot thinking in a parallel frame changes the area for its own routing
+// only, the area flags are changed when the frame ends
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_SetThinkRoutingAreaDisabled( int areanum, int disabled )
+{
+	aas_areachange_t* change;
+	int				  i;
+
+	for( i = 0; i < numthinkareachanges; i++ )
+	{
+		if( thinkareachanges[i].areanum == areanum )
+		{
+			thinkareachanges[i].disabled = disabled;
+			return;
+		} // end if
+	} // end for
+	if( numthinkareachanges >= MAX_THINKAREACHANGES )
+	{
+		botimport.Print( PRT_WARNING, "AAS_EnableRoutingArea: more than %d areas changed in one think\n", MAX_THINKAREACHANGES );
+		return;
+	} // end if
+	change			 = &thinkareachanges[numthinkareachanges++];
+	change->areanum	 = areanum;
+	change->disabled = disabled;
+} // end of the function AAS_SetThinkRoutingAreaDisabled
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
 int AAS_EnableRoutingArea( int areanum, int enable )
 {
 	int flags;
@@ -339,28 +724,113 @@ int AAS_EnableRoutingArea( int areanum, int enable )
 		} // end if
 		return 0;
 	} // end if
-	flags = aasworld.areasettings[areanum].areaflags & AREA_DISABLED;
-	if( enable < 0 )
+	// the area flags don't change while the bots think
+	if( botlibglobals.parallel && BotLibThinkClient() >= 0 )
 	{
+		flags = AAS_AreaRoutingDisabled( areanum );
+		if( enable >= 0 )
+		{
+			AAS_SetThinkRoutingAreaDisabled( areanum, enable ? 0 : AREA_DISABLED );
+		}
 		return !flags;
-	}
+	} // end if
+	BotLibLock();
+	flags = aasworld.areasettings[areanum].areaflags & AREA_DISABLED;
+	if( enable >= 0 )
+	{
+		AAS_SetRoutingAreaDisabled( areanum, !enable );
+	} // end if
+	BotLibUnlock();
+	return !flags;
+} // end of the function AAS_EnableRoutingArea
+//===========================================================================
+// queues the areas the bot left changed for the end of the frame and
+// frees the routing cache it made with them
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void AAS_EndThinkRoutingAreas( int client )
+{
+	aas_routingcache_t ***clusterareacache, **portalcache;
+	aas_areachange_t*	  change;
+	int					  i;
 
-	if( enable )
+	if( !numthinkareachanges )
 	{
-		aasworld.areasettings[areanum].areaflags &= ~AREA_DISABLED;
+		return;
 	}
-	else
+	BotLibLock();
+	for( i = 0; i < numthinkareachanges; i++ )
 	{
-		aasworld.areasettings[areanum].areaflags |= AREA_DISABLED;
+		change = &thinkareachanges[i];
+		if( change->disabled == ( aasworld.areasettings[change->areanum].areaflags & AREA_DISABLED ) )
+		{
+			continue;
+		}
+		if( numareachanges >= MAX_AREACHANGES )
+		{
+			botimport.Print( PRT_WARNING, "AAS_EndThinkRoutingAreas: more than %d routing area changes in a frame\n", MAX_AREACHANGES );
+			continue;
+		} // end if
+		areachanges[numareachanges].areanum	 = change->areanum;
+		areachanges[numareachanges].disabled = change->disabled;
+		areachanges[numareachanges].client	 = client;
+		areachanges[numareachanges].sequence = numareachanges;
+		numareachanges++;
+	} // end for
+	numthinkareachanges = 0;
+	//
+	if( thinkclusterareacache )
+	{
+		clusterareacache		  = aasworld.clusterareacache;
+		portalcache				  = aasworld.portalcache;
+		aasworld.clusterareacache = thinkclusterareacache;
+		aasworld.portalcache	  = thinkportalcache;
+		AAS_FreeAllClusterAreaCache();
+		AAS_FreeAllPortalCache();
+		aasworld.clusterareacache = clusterareacache;
+		aasworld.portalcache	  = portalcache;
+		thinkclusterareacache	  = NULL;
+		thinkportalcache		  = NULL;
+	} // end if
+	BotLibUnlock();
+} // end of the function AAS_EndThinkRoutingAreas
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_CompareAreaChanges( const void* a, const void* b )
+{
+	const aas_areachange_t* c1 = ( const aas_areachange_t* )a;
+	const aas_areachange_t* c2 = ( const aas_areachange_t* )b;
+
+	if( c1->client != c2->client )
+	{
+		return c1->client - c2->client;
 	}
-	// if the status of the area changed
-	if( ( flags & AREA_DISABLED ) != ( aasworld.areasettings[areanum].areaflags & AREA_DISABLED ) )
+	return c1->sequence - c2->sequence;
+} // end of the function AAS_CompareAreaChanges
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void AAS_ApplyRoutingAreaChanges()
+{
+	int i;
+
+	qsort( areachanges, numareachanges, sizeof( aas_areachange_t ), AAS_CompareAreaChanges );
+	for( i = 0; i < numareachanges; i++ )
 	{
-		// remove all routing cache involving this area
-		AAS_RemoveRoutingCacheUsingArea( areanum );
-	} // end if
-	return !flags;
-} // end of the function AAS_EnableRoutingArea
+		AAS_SetRoutingAreaDisabled( areachanges[i].areanum, areachanges[i].disabled );
+	} // end for
+	numareachanges = 0;
+} // end of the function AAS_ApplyRoutingAreaChanges
 //===========================================================================
 //
 // Parameter:			-
@@ -767,15 +1237,8 @@ int AAS_FreeOldestCache()
 	int					clusterareanum;
 	aas_routingcache_t* cache;
 
-	for( cache = aasworld.oldestcache; cache; cache = cache->time_next )
-	{
-		// never free area cache leading towards a portal
-		if( cache->type == CACHETYPE_AREA && aasworld.areasettings[cache->areanum].cluster < 0 )
-		{
-			continue;
-		}
-		break;
-	}
+	// area cache leading towards a portal is never on the list
+	cache = aasworld.oldestcache;
 	if( cache )
 	{
 		// unlink the cache
@@ -814,8 +1277,11 @@ int AAS_FreeOldestCache()
 			}
 		}
 		AAS_FreeRoutingCache( cache );
+#ifdef ROUTING_DEBUG
+		numcacheevictions++;
+#endif // ROUTING_DEBUG
 		return qtrue;
-	}
+	} // end if
 	return qfalse;
 } // end of the function AAS_FreeOldestCache
 //===========================================================================
@@ -834,7 +1300,8 @@ aas_routingcache_t* AAS_AllocRoutingCache( int numtraveltimes )
 	//
 	routingcachesize += size;
 	//
-	cache				  = ( aas_routingcache_t* )GetClearedMemory( size );
+	cache				  = AAS_AllocSlabRoutingCache( size );
+	cache->traveltimes	  = ( unsigned short int* )( ( unsigned char* )cache + sizeof( aas_routingcache_t ) );
 	cache->reachabilities = ( unsigned char* )cache + sizeof( aas_routingcache_t ) + numtraveltimes * sizeof( unsigned short int );
 	cache->size			  = size;
 	return cache;
@@ -974,6 +1441,24 @@ void AAS_InitRoutingUpdate()
 	}
 	// allocate memory for the portal update fields
 	aasworld.portalupdate = ( aas_routingupdate_t* )GetClearedMemory( ( aasworld.numportals + 1 ) * sizeof( aas_routingupdate_t ) );
+	// the area routing searches from the start of every reachability
+	if( aasworld.reachabilityupdate )
+	{
+		FreeMemory( aasworld.reachabilityupdate );
+	}
+	aasworld.reachabilityupdate = ( aas_routingupdate_t* )GetClearedMemory( aasworld.reachabilitysize * sizeof( aas_routingupdate_t ) );
+	aasworld.numroutingsearches = 0;
+	// the update heaps hold at most every update once
+	if( aasworld.areaupdateheap )
+	{
+		FreeMemory( aasworld.areaupdateheap );
+	}
+	aasworld.areaupdateheap = ( aas_routingupdate_t** )GetClearedMemory( aasworld.reachabilitysize * sizeof( aas_routingupdate_t* ) );
+	if( aasworld.portalupdateheap )
+	{
+		FreeMemory( aasworld.portalupdateheap );
+	}
+	aasworld.portalupdateheap = ( aas_routingupdate_t** )GetClearedMemory( ( aasworld.numportals + 1 ) * sizeof( aas_routingupdate_t* ) );
 } // end of the function AAS_InitRoutingUpdate
 //===========================================================================
 //
@@ -1010,15 +1495,192 @@ void AAS_CreateAllRoutingCache()
 	aasworld.initialized = qfalse;
 } // end of the function AAS_CreateAllRoutingCache
 //===========================================================================
+// finds the cache for the same goal and travel flags as the given one
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static aas_routingcache_t* AAS_FindMatchingCache( aas_routingcache_t* other )
+{
+	aas_routingcache_t* cache;
+
+	if( other->type == CACHETYPE_AREA )
+	{
+		cache = aasworld.clusterareacache[other->cluster][AAS_ClusterAreaNum( other->cluster, other->areanum )];
+	}
+	else
+	{
+		cache = aasworld.portalcache[other->areanum];
+	}
+	for( ; cache; cache = cache->next )
+	{
+		if( cache->travelflags == other->travelflags )
+		{
+			return cache;
+		}
+	} // end for
+	return NULL;
+} // end of the function AAS_FindMatchingCache
+//===========================================================================
+// returns the copies with a copy of every cache on the list added
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static aas_routingcache_t* AAS_CopyRoutingCacheList( aas_routingcache_t* cache, aas_routingcache_t* copies )
+{
+	aas_routingcache_t* copy;
+
+	for( ; cache; cache = cache->next )
+	{
+		copy = ( aas_routingcache_t* )GetMemory( cache->size );
+		Com_Memcpy( copy, cache, cache->size );
+		copy->traveltimes	 = ( unsigned short int* )( ( unsigned char* )copy + ( ( unsigned char* )cache->traveltimes - ( unsigned char* )cache ) );
+		copy->reachabilities = ( unsigned char* )copy + ( cache->reachabilities - ( unsigned char* )cache );
+		copy->next			 = copies;
+		copies				 = copy;
+	} // end for
+	return copies;
+} // end of the function AAS_CopyRoutingCacheList
+//===========================================================================
+// creates all routing cache with the update in the order the areas are
+// reached and with the update ordered on travel time, reports the time
+// and number of relaxations of both and compares the results, the update
+// in reach order keeps one travel time per area and so can miss a shorter
+// route, the update on travel time should never come out longer
 //
 // Parameter:			-
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
+void AAS_RoutingBenchmark()
+{
+	int					run, starttime, times[2], arearelax[2], portalrelax[2];
+	int					i, j, numtraveltimes, numcompared, numshorter, numlonger, numreachdiffs, nummissing, initialized, maxsize;
+	aas_routingcache_t *cache, *copy, *copies, *nextcopy;
 
-// the route cache header
-// this header is followed by numportalcache + numareacache aas_routingcache_t
-// structures that store routing cache
+	if( !aasworld.loaded )
+	{
+		botimport.Print( PRT_ERROR, "AAS_RoutingBenchmark: no AAS file loaded\n" );
+		return;
+	}
+	// AAS_CreateAllRoutingCache clears the initialized flag
+	initialized = aasworld.initialized;
+	// only free cache when memory runs low
+	maxsize				 = max_routingcachesize;
+	max_routingcachesize = 0x7fffffff;
+	copies				 = NULL;
+	for( run = 0; run < 2; run++ )
+	{
+		// start from empty cache
+		AAS_FreeAllClusterAreaCache();
+		AAS_FreeAllPortalCache();
+		AAS_InitClusterAreaCache();
+		AAS_InitPortalCache();
+		numarearelaxations	 = 0;
+		numportalrelaxations = 0;
+		routingupdatefifo	 = ( run == 0 );
+		//
+		starttime = Sys_MilliSeconds();
+		AAS_CreateAllRoutingCache();
+		times[run]		 = Sys_MilliSeconds() - starttime;
+		arearelax[run]	 = numarearelaxations;
+		portalrelax[run] = numportalrelaxations;
+		//
+		if( run == 0 )
+		{
+			// keep a copy of the cache to compare with, the cache towards
+			// portals isn't on the time list
+			for( i = 0; i < aasworld.numclusters; i++ )
+			{
+				for( j = 0; j < aasworld.clusters[i].numareas; j++ )
+				{
+					copies = AAS_CopyRoutingCacheList( aasworld.clusterareacache[i][j], copies );
+				} // end for
+			} // end for
+			for( i = 0; i < aasworld.numareas; i++ )
+			{
+				copies = AAS_CopyRoutingCacheList( aasworld.portalcache[i], copies );
+			} // end for
+		} // end if
+	} // end for
+	routingupdatefifo	 = qfalse;
+	aasworld.initialized = initialized;
+	max_routingcachesize = maxsize;
+	//
+	numcompared	  = 0;
+	numshorter	  = 0;
+	numlonger	  = 0;
+	numreachdiffs = 0;
+	nummissing	  = 0;
+	for( copy = copies; copy; copy = nextcopy )
+	{
+		nextcopy = copy->next;
+		cache	 = AAS_FindMatchingCache( copy );
+		// the cache may have been freed when running low on memory
+		if( !cache )
+		{
+			nummissing++;
+			FreeMemory( copy );
+			continue;
+		} // end if
+		numtraveltimes = ( copy->size - sizeof( aas_routingcache_t ) ) / ( sizeof( unsigned short int ) + sizeof( unsigned char ) );
+		for( i = 0; i < numtraveltimes; i++ )
+		{
+			numcompared++;
+			// no travel time means no route
+			if( copy->traveltimes[i] != cache->traveltimes[i] )
+			{
+				if( !copy->traveltimes[i] || ( cache->traveltimes[i] && cache->traveltimes[i] < copy->traveltimes[i] ) )
+				{
+					numshorter++;
+				}
+				else
+				{
+					numlonger++;
+				}
+			} // end if
+			else if( copy->reachabilities[i] != cache->reachabilities[i] )
+			{
+				numreachdiffs++;
+			}
+		} // end for
+		FreeMemory( copy );
+	} // end for
+	//
+	botimport.Print( PRT_MESSAGE, "in reach order: %6d msec %8d area %8d portal relaxations\n", times[0], arearelax[0], portalrelax[0] );
+	botimport.Print( PRT_MESSAGE, "on travel time: %6d msec %8d area %8d portal relaxations\n", times[1], arearelax[1], portalrelax[1] );
+	botimport.Print( PRT_MESSAGE, "%d travel times compared, %d shorter, %d longer\n", numcompared, numshorter, numlonger );
+	if( numreachdiffs )
+	{
+		botimport.Print( PRT_MESSAGE, "%d equal travel times use another reachability\n", numreachdiffs );
+	}
+	if( nummissing )
+	{
+		botimport.Print( PRT_MESSAGE, "%d caches were freed before they could be compared\n", nummissing );
+	}
+	// don't keep all the cache around
+	AAS_FreeAllClusterAreaCache();
+	AAS_FreeAllPortalCache();
+	AAS_InitClusterAreaCache();
+	AAS_InitPortalCache();
+	// link the route cache file again
+	AAS_FreeRouteCacheFile();
+	AAS_ReadRouteCache();
+} // end of the function AAS_RoutingBenchmark
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+
+// the route cache file is flat so it can be used straight from memory:
+// the header is followed by numportalcache + numareacache index entries,
+// the first numportalcache being portal cache, then the travel times and
+// reachabilities of all cache at the offsets stored in the index
 typedef struct routecacheheader_s
 {
 	int ident;
@@ -1031,15 +1693,87 @@ typedef struct routecacheheader_s
 	int numareacache;
 } routecacheheader_t;
 
+typedef struct routecacheindex_s
+{
+	int cluster;
+	int areanum;
+	int travelflags;
+	int numtraveltimes;
+	int traveltimesofs;	   // offset from the start of the file
+	int reachabilitiesofs; // offset from the start of the file
+} routecacheindex_t;
+
 #define RCID	  ( ( 'C' << 24 ) + ( 'R' << 16 ) + ( 'E' << 8 ) + 'M' )
-#define RCVERSION 2
+#define RCVERSION 3
+
+// the travel times and reachabilities of a cache padded to 4 bytes
+#define RCDATASIZE( n ) ( ( ( n ) * 3 + 3 ) & ~3 )
+
+// travel flags the route cache file is created for
+static int routecachetravelflags[] = { TFL_DEFAULT, TFL_DEFAULT | TFL_ROCKETJUMP };
 
 // void AAS_DecompressVis(byte *in, int numareas, byte *decompressed);
 // int AAS_CompressVis(byte *vis, int numareas, byte *dest);
 
+//===========================================================================
+// returns the number of travel times stored in the cache
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int AAS_CacheNumTravelTimes( aas_routingcache_t* cache )
+{
+	if( cache->type == CACHETYPE_AREA )
+	{
+		return aasworld.clusters[cache->cluster].numreachabilityareas;
+	}
+	return aasworld.numportals;
+} // end of the function AAS_CacheNumTravelTimes
+//===========================================================================
+// writes the index entries and data of all cache in one of the lists
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_WriteCacheList( aas_routingcache_t* list, fileHandle_t fp, int* dataofs, qboolean writedata )
+{
+	static const byte	zero[4] = { 0, 0, 0, 0 };
+	aas_routingcache_t* cache;
+	routecacheindex_t	index;
+	int					n;
+
+	for( cache = list; cache; cache = cache->next )
+	{
+		n = AAS_CacheNumTravelTimes( cache );
+		if( writedata )
+		{
+			botimport.FS_Write( cache->traveltimes, n * sizeof( unsigned short int ), fp );
+			botimport.FS_Write( cache->reachabilities, n * sizeof( unsigned char ), fp );
+			botimport.FS_Write( zero, RCDATASIZE( n ) - n * 3, fp );
+			continue;
+		} // end if
+		index.cluster			= cache->cluster;
+		index.areanum			= cache->areanum;
+		index.travelflags		= cache->travelflags;
+		index.numtraveltimes	= n;
+		index.traveltimesofs	= *dataofs;
+		index.reachabilitiesofs = *dataofs + n * sizeof( unsigned short int );
+		botimport.FS_Write( &index, sizeof( index ), fp );
+		*dataofs += RCDATASIZE( n );
+	} // end for
+} // end of the function AAS_WriteCacheList
+//===========================================================================
+// writes all routing cache to maps/<mapname>.rcd
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
 void AAS_WriteRouteCache()
 {
-	int					i, j, numportalcache, numareacache, totalsize;
+	int					i, j, pass, numportalcache, numareacache, dataofs;
 	aas_routingcache_t* cache;
 	aas_cluster_t*		cluster;
 	fileHandle_t		fp;
@@ -1085,68 +1819,51 @@ void AAS_WriteRouteCache()
 	routecacheheader.numareacache	= numareacache;
 	// write the header
 	botimport.FS_Write( &routecacheheader, sizeof( routecacheheader_t ), fp );
-	//
-	totalsize = 0;
-	// write all the cache
-	for( i = 0; i < aasworld.numareas; i++ )
+	// write the index in the first pass and the data in the second
+	dataofs = sizeof( routecacheheader_t ) + ( numportalcache + numareacache ) * sizeof( routecacheindex_t );
+	for( pass = 0; pass < 2; pass++ )
 	{
-		for( cache = aasworld.portalcache[i]; cache; cache = cache->next )
+		for( i = 0; i < aasworld.numareas; i++ )
 		{
-			botimport.FS_Write( cache, cache->size, fp );
-			totalsize += cache->size;
+			AAS_WriteCacheList( aasworld.portalcache[i], fp, &dataofs, pass );
 		} // end for
-	} // end for
-	for( i = 0; i < aasworld.numclusters; i++ )
-	{
-		cluster = &aasworld.clusters[i];
-		for( j = 0; j < cluster->numareas; j++ )
+		for( i = 0; i < aasworld.numclusters; i++ )
 		{
-			for( cache = aasworld.clusterareacache[i][j]; cache; cache = cache->next )
+			cluster = &aasworld.clusters[i];
+			for( j = 0; j < cluster->numareas; j++ )
 			{
-				botimport.FS_Write( cache, cache->size, fp );
-				totalsize += cache->size;
+				AAS_WriteCacheList( aasworld.clusterareacache[i][j], fp, &dataofs, pass );
 			} // end for
 		} // end for
 	} // end for
-	// write the visareas
-	/*
-	for (i = 0; i < aasworld.numareas; i++)
-	{
-		if (!aasworld.areavisibility[i]) {
-			size = 0;
-			botimport.FS_Write(&size, sizeof(int), fp);
-			continue;
-		}
-		AAS_DecompressVis( aasworld.areavisibility[i], aasworld.numareas, aasworld.decompressedvis );
-		size = AAS_CompressVis( aasworld.decompressedvis, aasworld.numareas, aasworld.decompressedvis );
-		botimport.FS_Write(&size, sizeof(int), fp);
-		botimport.FS_Write(aasworld.decompressedvis, size, fp);
-	}
-	*/
 	//
 	botimport.FS_FCloseFile( fp );
 	botimport.Print( PRT_MESSAGE, "\nroute cache written to %s\n", filename );
-	botimport.Print( PRT_MESSAGE, "written %d bytes of routing cache\n", totalsize );
+	botimport.Print( PRT_MESSAGE, "%d portal cache, %d area cache, %d bytes\n", numportalcache, numareacache, dataofs );
 } // end of the function AAS_WriteRouteCache
 //===========================================================================
+// releases the route cache file, the cache in it must no longer be linked
 //
 // Parameter:			-
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-aas_routingcache_t* AAS_ReadCache( fileHandle_t fp )
+void AAS_FreeRouteCacheFile()
 {
-	int					size;
-	aas_routingcache_t* cache;
-
-	botimport.FS_Read( &size, sizeof( size ), fp );
-	cache		= ( aas_routingcache_t* )GetMemory( size );
-	cache->size = size;
-	botimport.FS_Read( ( unsigned char* )cache + sizeof( size ), size - sizeof( size ), fp );
-	cache->reachabilities = ( unsigned char* )cache + sizeof( aas_routingcache_t ) - sizeof( unsigned short ) + ( size - sizeof( aas_routingcache_t ) + sizeof( unsigned short ) ) / 3 * 2;
-	return cache;
-} // end of the function AAS_ReadCache
+	if( aasworld.routecachemapped )
+	{
+		FreeMemory( aasworld.routecachemapped );
+	}
+	aasworld.routecachemapped = NULL;
+	if( aasworld.routecachefile )
+	{
+		botimport.FS_UnmapFile( aasworld.routecachefile );
+	}
+	aasworld.routecachefile = NULL;
+} // end of the function AAS_FreeRouteCacheFile
 //===========================================================================
+// maps maps/<mapname>.rcd and links the cache in it, the travel times and
+// reachabilities are used straight from the file
 //
 // Parameter:			-
 // Returns:				-
@@ -1154,91 +1871,199 @@ aas_routingcache_t* AAS_ReadCache( fileHandle_t fp )
 //===========================================================================
 int AAS_ReadRouteCache()
 {
-	int					i, clusterareanum; //, size;
-	fileHandle_t		fp;
+	int					i, length, numcache, numtraveltimes, clusterareanum;
 	char				filename[MAX_QPATH];
-	routecacheheader_t	routecacheheader;
-	aas_routingcache_t* cache;
+	void*				buffer;
+	routecacheheader_t* routecacheheader;
+	routecacheindex_t*	index;
+	aas_routingcache_t *cache, **list;
 
 	Com_sprintf( filename, MAX_QPATH, "maps/%s.rcd", aasworld.mapname );
-	botimport.FS_FOpenFile( filename, &fp, FS_READ );
-	if( !fp )
+	length = botimport.FS_MapFile( filename, &buffer );
+	if( length < 0 )
 	{
 		return qfalse;
 	} // end if
-	botimport.FS_Read( &routecacheheader, sizeof( routecacheheader_t ), fp );
-	if( routecacheheader.ident != RCID )
+	routecacheheader = ( routecacheheader_t* )buffer;
+	if( length < ( int )sizeof( routecacheheader_t ) || routecacheheader->ident != RCID )
 	{
-		AAS_Error( "%s is not a route cache dump\n" );
+		botimport.Print( PRT_WARNING, "%s is not a route cache dump\n", filename );
+		botimport.FS_UnmapFile( buffer );
 		return qfalse;
 	} // end if
-	if( routecacheheader.version != RCVERSION )
+	if( routecacheheader->version != RCVERSION )
 	{
-		AAS_Error( "route cache dump has wrong version %d, should be %d", routecacheheader.version, RCVERSION );
+		botimport.Print( PRT_WARNING, "route cache dump has wrong version %d, should be %d\n", routecacheheader->version, RCVERSION );
+		botimport.FS_UnmapFile( buffer );
 		return qfalse;
 	} // end if
-	if( routecacheheader.numareas != aasworld.numareas )
+	if( routecacheheader->numareas != aasworld.numareas || routecacheheader->numclusters != aasworld.numclusters ||
+		routecacheheader->areacrc != CRC_ProcessString( ( unsigned char* )aasworld.areas, sizeof( aas_area_t ) * aasworld.numareas ) ||
+		routecacheheader->clustercrc != CRC_ProcessString( ( unsigned char* )aasworld.clusters, sizeof( aas_cluster_t ) * aasworld.numclusters ) )
 	{
-		// AAS_Error("route cache dump has wrong number of areas\n");
+		// the route cache is for another version of the AAS file
+		botimport.FS_UnmapFile( buffer );
 		return qfalse;
 	} // end if
-	if( routecacheheader.numclusters != aasworld.numclusters )
+	numcache = routecacheheader->numportalcache + routecacheheader->numareacache;
+	if( routecacheheader->numportalcache < 0 || routecacheheader->numareacache < 0 ||
+		numcache > ( length - ( int )sizeof( routecacheheader_t ) ) / ( int )sizeof( routecacheindex_t ) )
 	{
-		// AAS_Error("route cache dump has wrong number of clusters\n");
+		botimport.Print( PRT_WARNING, "%s is truncated\n", filename );
+		botimport.FS_UnmapFile( buffer );
 		return qfalse;
 	} // end if
-	if( routecacheheader.areacrc != CRC_ProcessString( ( unsigned char* )aasworld.areas, sizeof( aas_area_t ) * aasworld.numareas ) )
+	// check the whole index before anything is linked
+	index = ( routecacheindex_t* )( routecacheheader + 1 );
+	for( i = 0; i < numcache; i++, index++ )
 	{
-		// AAS_Error("route cache dump area CRC incorrect\n");
-		return qfalse;
-	} // end if
-	if( routecacheheader.clustercrc != CRC_ProcessString( ( unsigned char* )aasworld.clusters, sizeof( aas_cluster_t ) * aasworld.numclusters ) )
+		if( index->areanum <= 0 || index->areanum >= aasworld.numareas || index->cluster <= 0 || index->cluster >= aasworld.numclusters )
+		{
+			break;
+		}
+		if( i < routecacheheader->numportalcache )
+		{
+			numtraveltimes = aasworld.numportals;
+		}
+		else
+		{
+			numtraveltimes = aasworld.clusters[index->cluster].numreachabilityareas;
+			// the goal must be in the cluster or one of its portals
+			if( aasworld.areasettings[index->areanum].cluster != index->cluster && ( aasworld.areasettings[index->areanum].cluster > 0 ||
+				( aasworld.portals[-aasworld.areasettings[index->areanum].cluster].frontcluster != index->cluster &&
+				  aasworld.portals[-aasworld.areasettings[index->areanum].cluster].backcluster != index->cluster ) ) )
+			{
+				break;
+			}
+		} // end else
+		if( index->numtraveltimes != numtraveltimes || ( index->traveltimesofs & 1 ) || index->traveltimesofs < 0 || index->reachabilitiesofs < 0 ||
+			index->traveltimesofs > length - numtraveltimes * ( int )sizeof( unsigned short int ) || index->reachabilitiesofs > length - numtraveltimes )
+		{
+			break;
+		}
+	} // end for
+	if( i < numcache )
 	{
-		// AAS_Error("route cache dump cluster CRC incorrect\n");
+		botimport.Print( PRT_WARNING, "%s is corrupt\n", filename );
+		botimport.FS_UnmapFile( buffer );
 		return qfalse;
 	} // end if
-	// read all the portal cache
-	for( i = 0; i < routecacheheader.numportalcache; i++ )
+	//
+	aasworld.routecachefile	  = buffer;
+	aasworld.routecachemapped = ( aas_routingcache_t* )GetClearedMemory( numcache * sizeof( aas_routingcache_t ) + 1 );
+	index					  = ( routecacheindex_t* )( routecacheheader + 1 );
+	for( i = 0; i < numcache; i++, index++ )
 	{
-		cache		= AAS_ReadCache( fp );
-		cache->next = aasworld.portalcache[cache->areanum];
+		cache = &aasworld.routecachemapped[i];
+		if( i < routecacheheader->numportalcache )
+		{
+			cache->type = CACHETYPE_PORTAL;
+			list		= &aasworld.portalcache[index->areanum];
+		}
+		else
+		{
+			cache->type	   = CACHETYPE_AREA;
+			clusterareanum = AAS_ClusterAreaNum( index->cluster, index->areanum );
+			list		   = &aasworld.clusterareacache[index->cluster][clusterareanum];
+		} // end else
+		cache->mapped	   = qtrue;
+		cache->size		   = sizeof( aas_routingcache_t );
+		cache->cluster	   = index->cluster;
+		cache->areanum	   = index->areanum;
+		cache->travelflags = index->travelflags;
+		VectorCopy( aasworld.areas[index->areanum].center, cache->origin );
+		cache->starttraveltime = 1;
+		cache->traveltimes	   = ( unsigned short int* )( ( byte* )buffer + index->traveltimesofs );
+		cache->reachabilities  = ( unsigned char* )buffer + index->reachabilitiesofs;
+		// cache that is calculated later on goes in front of it
 		cache->prev = NULL;
-		if( aasworld.portalcache[cache->areanum] )
+		cache->next = *list;
+		if( *list )
 		{
-			aasworld.portalcache[cache->areanum]->prev = cache;
+			( *list )->prev = cache;
 		}
-		aasworld.portalcache[cache->areanum] = cache;
+		*list = cache;
 	} // end for
-	// read all the cluster area cache
-	for( i = 0; i < routecacheheader.numareacache; i++ )
+	botimport.Print( PRT_MESSAGE, "%s: %d portal and %d area cache\n", filename, routecacheheader->numportalcache, routecacheheader->numareacache );
+	return qtrue;
+} // end of the function AAS_ReadRouteCache
+//===========================================================================
+// creates the routing cache of all goal areas for the common travel flags
+// and writes it to the route cache file, which is then used from then on,
+// nothing is written when not all the cache fits in memory
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void AAS_BuildRouteCache()
+{
+	int			   i, goalareanum, clusternum, maxsize, complete;
+	aas_portal_t*  portal;
+
+	if( !aasworld.loaded )
+	{
+		botimport.Print( PRT_ERROR, "AAS_BuildRouteCache: no AAS file loaded\n" );
+		return;
+	}
+	// calculate everything again instead of writing the old file back
+	AAS_FreeAllClusterAreaCache();
+	AAS_FreeAllPortalCache();
+	AAS_FreeRouteCacheFile();
+	AAS_InitClusterAreaCache();
+	AAS_InitPortalCache();
+	// don't free cache for the budget while building
+	maxsize				 = max_routingcachesize;
+	max_routingcachesize = 0x7fffffff;
+	complete			 = qtrue;
+	//
+	for( i = 0; complete && i < ( int )( sizeof( routecachetravelflags ) / sizeof( routecachetravelflags[0] ) ); i++ )
 	{
-		cache		   = AAS_ReadCache( fp );
-		clusterareanum = AAS_ClusterAreaNum( cache->cluster, cache->areanum );
-		cache->next	   = aasworld.clusterareacache[cache->cluster][clusterareanum];
-		cache->prev	   = NULL;
-		if( aasworld.clusterareacache[cache->cluster][clusterareanum] )
+		for( goalareanum = 1; goalareanum < aasworld.numareas; goalareanum++ )
 		{
-			aasworld.clusterareacache[cache->cluster][clusterareanum]->prev = cache;
-		}
-		aasworld.clusterareacache[cache->cluster][clusterareanum] = cache;
+			// freeing cache would leave it out of the file
+			if( AvailableMemory() < 1 * 1024 * 1024 )
+			{
+				complete = qfalse;
+				break;
+			} // end if
+			if( !AAS_AreaReachability( goalareanum ) )
+			{
+				continue;
+			}
+			// the same cache AAS_AreaRouteToGoalArea asks for
+			clusternum = aasworld.areasettings[goalareanum].cluster;
+			if( clusternum > 0 )
+			{
+				AAS_GetAreaRoutingCache( clusternum, goalareanum, routecachetravelflags[i] );
+			}
+			else
+			{
+				portal = &aasworld.portals[-clusternum];
+				AAS_GetAreaRoutingCache( portal->frontcluster, goalareanum, routecachetravelflags[i] );
+				AAS_GetAreaRoutingCache( portal->backcluster, goalareanum, routecachetravelflags[i] );
+				clusternum = portal->frontcluster;
+			} // end else
+			AAS_GetPortalRoutingCache( clusternum, goalareanum, routecachetravelflags[i] );
+		} // end for
 	} // end for
-	// read the visareas
-	/*
-	aasworld.areavisibility = (byte **) GetClearedMemory(aasworld.numareas * sizeof(byte *));
-	aasworld.decompressedvis = (byte *) GetClearedMemory(aasworld.numareas * sizeof(byte));
-	for (i = 0; i < aasworld.numareas; i++)
+	//
+	if( complete )
 	{
-		botimport.FS_Read(&size, sizeof(size), fp );
-		if (size) {
-			aasworld.areavisibility[i] = (byte *) GetMemory(size);
-			botimport.FS_Read(aasworld.areavisibility[i], size, fp );
-		}
+		AAS_WriteRouteCache();
 	}
-	*/
-	//
-	botimport.FS_FCloseFile( fp );
-	return qtrue;
-} // end of the function AAS_ReadRouteCache
+	else
+	{
+		botimport.Print( PRT_ERROR, "AAS_BuildRouteCache: out of memory, route cache file not written\n" );
+	} // end else
+	max_routingcachesize = maxsize;
+	// use the file from now on, or the old one when nothing was written
+	AAS_FreeAllClusterAreaCache();
+	AAS_FreeAllPortalCache();
+	AAS_InitClusterAreaCache();
+	AAS_InitPortalCache();
+	AAS_ReadRouteCache();
+} // end of the function AAS_BuildRouteCache
 //===========================================================================
 //
 // Parameter:			-
@@ -1356,9 +2181,15 @@ void AAS_InitRouting()
 #ifdef ROUTING_DEBUG
 	numareacacheupdates	  = 0;
 	numportalcacheupdates = 0;
+	numcachehits		  = 0;
+	numcachemisses		  = 0;
+	numcacheevictions	  = 0;
 #endif // ROUTING_DEBUG
 	//
 	routingcachesize	 = 0;
+	keptroutingcachesize = 0;
+	routinggeneration++;
+	// maximum routing cache size in KB
 	max_routingcachesize = 1024 * ( int )LibVarValue( "max_routingcache", "4096" );
 	// read any routing cache if available
 	AAS_ReadRouteCache();
@@ -1375,6 +2206,10 @@ void AAS_FreeRoutingCaches()
 	AAS_FreeAllClusterAreaCache();
 	// free all the existing portal cache
 	AAS_FreeAllPortalCache();
+	// release the memory of the freed routing caches
+	AAS_FreeRoutingCacheSlabs();
+	// release the route cache file
+	AAS_FreeRouteCacheFile();
 	// free cached travel times within areas
 	if( aasworld.areatraveltimes )
 	{
@@ -1404,38 +2239,188 @@ void AAS_FreeRoutingCaches()
 		FreeMemory( aasworld.portalupdate );
 	}
 	aasworld.portalupdate = NULL;
+	if( aasworld.reachabilityupdate )
+	{
+		FreeMemory( aasworld.reachabilityupdate );
+	}
+	aasworld.reachabilityupdate = NULL;
+	if( aasworld.areaupdateheap )
+	{
+		FreeMemory( aasworld.areaupdateheap );
+	}
+	aasworld.areaupdateheap = NULL;
+	if( aasworld.portalupdateheap )
+	{
+		FreeMemory( aasworld.portalupdateheap );
+	}
+	aasworld.portalupdateheap = NULL;
 	// free lists with areas the reachabilities go through
 	if( aasworld.reachabilityareas )
 	{
-		FreeMemory( aasworld.reachabilityareas );
-	}
-	aasworld.reachabilityareas = NULL;
-	// free the reachability area index
-	if( aasworld.reachabilityareaindex )
+		FreeMemory( aasworld.reachabilityareas );
+	}
+	aasworld.reachabilityareas = NULL;
+	// free the reachability area index
+	if( aasworld.reachabilityareaindex )
+	{
+		FreeMemory( aasworld.reachabilityareaindex );
+	}
+	aasworld.reachabilityareaindex = NULL;
+	// free area contents travel flags look up table
+	if( aasworld.areacontentstravelflags )
+	{
+		FreeMemory( aasworld.areacontentstravelflags );
+	}
+	aasworld.areacontentstravelflags = NULL;
+} // end of the function AAS_FreeRoutingCaches
+//===========================================================================
+// moves the update up or down the heap until its travel time is in order
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_RoutingHeapPlace( aas_routingqueue_t* queue, aas_routingupdate_t* update, int index )
+{
+	int					 child;
+	aas_routingupdate_t* other;
+
+	// up
+	while( index > 0 )
+	{
+		other = queue->heap[( index - 1 ) >> 1];
+		if( other->tmptraveltime <= update->tmptraveltime )
+		{
+			break;
+		}
+		queue->heap[index] = other;
+		other->heapindex   = index;
+		index			   = ( index - 1 ) >> 1;
+	} // end while
+	// down
+	while( 1 )
+	{
+		child = index * 2 + 1;
+		if( child >= queue->numheap )
+		{
+			break;
+		}
+		if( child + 1 < queue->numheap && queue->heap[child + 1]->tmptraveltime < queue->heap[child]->tmptraveltime )
+		{
+			child++;
+		}
+		other = queue->heap[child];
+		if( other->tmptraveltime >= update->tmptraveltime )
+		{
+			break;
+		}
+		queue->heap[index] = other;
+		other->heapindex   = index;
+		index			   = child;
+	} // end while
+	queue->heap[index] = update;
+	update->heapindex  = index;
+} // end of the function AAS_RoutingHeapPlace
+//===========================================================================
+// adds the update to the queue, or moves it to its new travel time if it
+// already is in the queue
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_AddRoutingUpdate( aas_routingqueue_t* queue, aas_routingupdate_t* update )
+{
+	if( routingupdatefifo )
+	{
+		if( update->inlist )
+		{
+			return;
+		}
+		// we add the update to the end of the list
+		update->next = NULL;
+		update->prev = queue->last;
+		if( queue->last )
+		{
+			queue->last->next = update;
+		}
+		else
+		{
+			queue->first = update;
+		}
+		queue->last	   = update;
+		update->inlist = qtrue;
+		return;
+	} // end if
+	//
+	if( update->inlist )
+	{
+		AAS_RoutingHeapPlace( queue, update, update->heapindex );
+		return;
+	} // end if
+	update->inlist = qtrue;
+	AAS_RoutingHeapPlace( queue, update, queue->numheap++ );
+} // end of the function AAS_AddRoutingUpdate
+//===========================================================================
+// removes and returns the update with the lowest travel time
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static aas_routingupdate_t* AAS_NextRoutingUpdate( aas_routingqueue_t* queue )
+{
+	aas_routingupdate_t* update;
+
+	if( routingupdatefifo )
+	{
+		update = queue->first;
+		if( !update )
+		{
+			return NULL;
+		}
+		if( update->next )
+		{
+			update->next->prev = NULL;
+		}
+		else
+		{
+			queue->last = NULL;
+		}
+		queue->first   = update->next;
+		update->inlist = qfalse;
+		return update;
+	} // end if
+	//
+	if( !queue->numheap )
 	{
-		FreeMemory( aasworld.reachabilityareaindex );
+		return NULL;
 	}
-	aasworld.reachabilityareaindex = NULL;
-	// free area contents travel flags look up table
-	if( aasworld.areacontentstravelflags )
+	update = queue->heap[0];
+	queue->numheap--;
+	if( queue->numheap )
 	{
-		FreeMemory( aasworld.areacontentstravelflags );
+		AAS_RoutingHeapPlace( queue, queue->heap[queue->numheap], 0 );
 	}
-	aasworld.areacontentstravelflags = NULL;
-} // end of the function AAS_FreeRoutingCaches
+	update->inlist = qfalse;
+	return update;
+} // end of the function AAS_NextRoutingUpdate
 //===========================================================================
-// update the given routing cache
+// update the given routing cache with a single travel time per area, the
+// way the cache was updated before AAS_UpdateAreaRoutingCache, only for
+// AAS_RoutingBenchmark
 //
 // Parameter:			areacache		: routing cache to update
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-void AAS_UpdateAreaRoutingCache( aas_routingcache_t* areacache )
+static void AAS_UpdateAreaRoutingCacheInReachOrder( aas_routingcache_t* areacache )
 {
 	int							i, nextareanum, cluster, badtravelflags, clusterareanum, linknum;
 	int							numreachabilityareas;
 	unsigned short int			t, startareatraveltimes[128]; // NOTE: not more than 128 reachabilities per area allowed
-	aas_routingupdate_t *		updateliststart, *updatelistend, *curupdate, *nextupdate;
+	aas_routingupdate_t *		curupdate, *nextupdate;
+	aas_routingqueue_t			queue;
 	aas_reachability_t*			reach;
 	aas_reversedreachability_t* revreach;
 	aas_reversedlink_t*			revlink;
@@ -1467,27 +2452,14 @@ void AAS_UpdateAreaRoutingCache( aas_routingcache_t* areacache )
 	curupdate->tmptraveltime   = areacache->starttraveltime;
 	//
 	areacache->traveltimes[clusterareanum] = areacache->starttraveltime;
-	// put the area to start with in the current read list
-	curupdate->next = NULL;
-	curupdate->prev = NULL;
-	updateliststart = curupdate;
-	updatelistend	= curupdate;
-	// while there are updates in the current list
-	while( updateliststart )
-	{
-		curupdate = updateliststart;
-		//
-		if( curupdate->next )
-		{
-			curupdate->next->prev = NULL;
-		}
-		else
-		{
-			updatelistend = NULL;
-		}
-		updateliststart = curupdate->next;
-		//
-		curupdate->inlist = qfalse;
+	// put the area to start with in the queue
+	Com_Memset( &queue, 0, sizeof( queue ) );
+	queue.heap = aasworld.areaupdateheap;
+	AAS_AddRoutingUpdate( &queue, curupdate );
+	// while there are updates in the queue
+	while( ( curupdate = AAS_NextRoutingUpdate( &queue ) ) != NULL )
+	{
+		numarearelaxations++;
 		// check all reversed reachability links
 		revreach = &aasworld.reversedreachability[curupdate->areanum];
 		//
@@ -1501,7 +2473,7 @@ void AAS_UpdateAreaRoutingCache( aas_routingcache_t* areacache )
 				continue;
 			}
 			// if not allowed to enter the next area
-			if( aasworld.areasettings[reach->areanum].areaflags & AREA_DISABLED )
+			if( AAS_AreaRoutingDisabled( reach->areanum ) )
 			{
 				continue;
 			}
@@ -1540,27 +2512,154 @@ void AAS_UpdateAreaRoutingCache( aas_routingcache_t* areacache )
 				nextupdate->tmptraveltime				  = t;
 				// VectorCopy(reach->start, nextupdate->start);
 				nextupdate->areatraveltimes = aasworld.areatraveltimes[nextareanum][linknum - aasworld.areasettings[nextareanum].firstreachablearea];
-				if( !nextupdate->inlist )
-				{
-					// we add the update to the end of the list
-					// we could also use a B+ tree to have a real sorted list
-					// on travel time which makes for faster routing updates
-					nextupdate->next = NULL;
-					nextupdate->prev = updatelistend;
-					if( updatelistend )
-					{
-						updatelistend->next = nextupdate;
-					}
-					else
-					{
-						updateliststart = nextupdate;
-					}
-					updatelistend	   = nextupdate;
-					nextupdate->inlist = qtrue;
-				} // end if
+				AAS_AddRoutingUpdate( &queue, nextupdate );
 			} // end if
 		} // end for
 	} // end while
+} // end of the function AAS_UpdateAreaRoutingCacheInReachOrder
+//===========================================================================
+// adds an update for every reachability into the area that can be used
+// for the cache, the travel time of an update is the time from the start
+// of the reachability to the goal area
+//
+// Parameter:			areacache		: routing cache being updated
+//						areanum			: area the reachabilities lead into
+//						traveltime		: travel time from the area to the goal area
+//						areatraveltimes	: travel times within the area from the end
+//										  of each reversed reachability link
+//						queue			: update queue
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void AAS_AddReversedReachabilityUpdates( aas_routingcache_t* areacache, int areanum, unsigned short int traveltime, unsigned short int* areatraveltimes, aas_routingqueue_t* queue )
+{
+	int							i, nextareanum, cluster, badtravelflags, clusterareanum, linknum;
+	unsigned short int			t;
+	aas_routingupdate_t*		nextupdate;
+	aas_reachability_t*			reach;
+	aas_reversedreachability_t* revreach;
+	aas_reversedlink_t*			revlink;
+
+	badtravelflags = ~areacache->travelflags;
+	// if not allowed to enter the area
+	if( AAS_AreaRoutingDisabled( areanum ) )
+	{
+		return;
+	}
+	// if the area has a not allowed travel flag
+	if( AAS_AreaContentsTravelFlags_inline( areanum ) & badtravelflags )
+	{
+		return;
+	}
+	// check all reversed reachability links
+	revreach = &aasworld.reversedreachability[areanum];
+	//
+	for( i = 0, revlink = revreach->first; revlink; revlink = revlink->next, i++ )
+	{
+		linknum = revlink->linknum;
+		reach	= &aasworld.reachability[linknum];
+		// if there is used an undesired travel type
+		if( AAS_TravelFlagForType_inline( reach->traveltype ) & badtravelflags )
+		{
+			continue;
+		}
+		// number of the area the reversed reachability leads to
+		nextareanum = revlink->areanum;
+		// get the cluster number of the area
+		cluster = aasworld.areasettings[nextareanum].cluster;
+		// don't leave the cluster
+		if( cluster > 0 && cluster != areacache->cluster )
+		{
+			continue;
+		}
+		// get the number of the area in the cluster
+		clusterareanum = AAS_ClusterAreaNum( areacache->cluster, nextareanum );
+		if( clusterareanum >= aasworld.clusters[areacache->cluster].numreachabilityareas )
+		{
+			continue;
+		}
+		// time already travelled plus the traveltime through
+		// the area plus the travel time from the reachability
+		t = traveltime + areatraveltimes[i] + reach->traveltime;
+		//
+		nextupdate = &aasworld.reachabilityupdate[linknum];
+		if( nextupdate->search == aasworld.numroutingsearches && nextupdate->tmptraveltime <= t )
+		{
+			continue;
+		}
+		nextupdate->search		  = aasworld.numroutingsearches;
+		nextupdate->areanum		  = nextareanum;
+		nextupdate->tmptraveltime = t;
+		// travel times from the reachabilities into the next area to the start of this one
+		nextupdate->areatraveltimes = aasworld.areatraveltimes[nextareanum][linknum - aasworld.areasettings[nextareanum].firstreachablearea];
+		AAS_AddRoutingUpdate( queue, nextupdate );
+	} // end for
+} // end of the function AAS_AddReversedReachabilityUpdates
+//===========================================================================
+// update the given routing cache
+//
+// the travel time through an area depends on the reachability the area is
+// left with, so the search runs over the reachabilities instead of over the
+// areas: an update is taken from the queue once, with the shortest travel
+// time from the start of the reachability to the goal area, and the first
+// reachability of an area taken from the queue is the one the cache stores
+//
+// Parameter:			areacache		: routing cache to update
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void AAS_UpdateAreaRoutingCache( aas_routingcache_t* areacache )
+{
+	int					 clusterareanum, linknum;
+	unsigned short int	 startareatraveltimes[128]; // NOTE: not more than 128 reachabilities per area allowed
+	aas_routingupdate_t* curupdate;
+	aas_routingqueue_t	 queue;
+
+	if( routingupdatefifo )
+	{
+		AAS_UpdateAreaRoutingCacheInReachOrder( areacache );
+		return;
+	} // end if
+#ifdef ROUTING_DEBUG
+	numareacacheupdates++;
+#endif // ROUTING_DEBUG
+	aasworld.frameroutingupdates++;
+	//
+	clusterareanum = AAS_ClusterAreaNum( areacache->cluster, areacache->areanum );
+	if( clusterareanum >= aasworld.clusters[areacache->cluster].numreachabilityareas )
+	{
+		return;
+	}
+	//
+	Com_Memset( startareatraveltimes, 0, sizeof( startareatraveltimes ) );
+	areacache->traveltimes[clusterareanum] = areacache->starttraveltime;
+	// travel times of earlier searches are left in the updates
+	aasworld.numroutingsearches++;
+	// put the reachabilities into the goal area in the queue
+	Com_Memset( &queue, 0, sizeof( queue ) );
+	queue.heap = aasworld.areaupdateheap;
+	AAS_AddReversedReachabilityUpdates( areacache, areacache->areanum, areacache->starttraveltime, startareatraveltimes, &queue );
+	// while there are updates in the queue
+	while( ( curupdate = AAS_NextRoutingUpdate( &queue ) ) != NULL )
+	{
+		numarearelaxations++;
+		//
+		// going through the goal area is never shorter than starting there
+		if( curupdate->areanum == areacache->areanum )
+		{
+			continue;
+		}
+		clusterareanum = AAS_ClusterAreaNum( areacache->cluster, curupdate->areanum );
+		if( !areacache->traveltimes[clusterareanum] )
+		{
+			linknum									  = curupdate - aasworld.reachabilityupdate;
+			areacache->traveltimes[clusterareanum]	  = curupdate->tmptraveltime;
+			areacache->reachabilities[clusterareanum] = linknum - aasworld.areasettings[curupdate->areanum].firstreachablearea;
+		} // end if
+		// the other reachabilities out of an area can still be the shorter
+		// ones from some of the reachabilities into the area
+		AAS_AddReversedReachabilityUpdates( areacache, curupdate->areanum, curupdate->tmptraveltime, curupdate->areatraveltimes, &queue );
+	} // end while
 } // end of the function AAS_UpdateAreaRoutingCache
 //===========================================================================
 //
@@ -1602,16 +2701,44 @@ aas_routingcache_t* AAS_GetAreaRoutingCache( int clusternum, int areanum, int tr
 			clustercache->prev = cache;
 		}
 		aasworld.clusterareacache[clusternum][clusterareanum] = cache;
+		// freed when the bot is done thinking, see AAS_EndThinkRoutingAreas
+		if( thinkroutingcache )
+		{
+			cache->think = qtrue;
+			routingcachesize -= cache->size;
+		} // end if
+		// cache towards a portal is never freed, keep it out of the budget
+		else if( aasworld.areasettings[areanum].cluster < 0 )
+		{
+			cache->kept = qtrue;
+			routingcachesize -= cache->size;
+			keptroutingcachesize += cache->size;
+		} // end if
 		AAS_UpdateAreaRoutingCache( cache );
+#ifdef ROUTING_DEBUG
+		numcachemisses++;
+#endif // ROUTING_DEBUG
 	} // end if
-	else
+	else if( !cache->mapped && !cache->kept && !cache->think )
 	{
 		AAS_UnlinkCache( cache );
+#ifdef ROUTING_DEBUG
+		numcachehits++;
+#endif // ROUTING_DEBUG
 	} // end else
+#ifdef ROUTING_DEBUG
+	else
+	{
+		numcachehits++;
+	} // end else
+#endif // ROUTING_DEBUG
 	// the cache has been accessed
 	cache->time = AAS_RoutingTime();
 	cache->type = CACHETYPE_AREA;
-	AAS_LinkCache( cache );
+	if( !cache->mapped && !cache->kept && !cache->think )
+	{
+		AAS_LinkCache( cache );
+	}
 	return cache;
 } // end of the function AAS_GetAreaRoutingCache
 //===========================================================================
@@ -1627,7 +2754,8 @@ void AAS_UpdatePortalRoutingCache( aas_routingcache_t* portalcache )
 	aas_portal_t*		 portal;
 	aas_cluster_t*		 cluster;
 	aas_routingcache_t*	 cache;
-	aas_routingupdate_t *updateliststart, *updatelistend, *curupdate, *nextupdate;
+	aas_routingupdate_t *curupdate, *nextupdate;
+	aas_routingqueue_t	 queue;
 
 #ifdef ROUTING_DEBUG
 	numportalcacheupdates++;
@@ -1645,27 +2773,14 @@ void AAS_UpdatePortalRoutingCache( aas_routingcache_t* portalcache )
 	{
 		portalcache->traveltimes[-clusternum] = portalcache->starttraveltime;
 	} // end if
-	// put the area to start with in the current read list
-	curupdate->next = NULL;
-	curupdate->prev = NULL;
-	updateliststart = curupdate;
-	updatelistend	= curupdate;
-	// while there are updates in the current list
-	while( updateliststart )
-	{
-		curupdate = updateliststart;
-		// remove the current update from the list
-		if( curupdate->next )
-		{
-			curupdate->next->prev = NULL;
-		}
-		else
-		{
-			updatelistend = NULL;
-		}
-		updateliststart = curupdate->next;
-		// current update is removed from the list
-		curupdate->inlist = qfalse;
+	// put the area to start with in the queue
+	Com_Memset( &queue, 0, sizeof( queue ) );
+	queue.heap = aasworld.portalupdateheap;
+	AAS_AddRoutingUpdate( &queue, curupdate );
+	// while there are updates in the queue
+	while( ( curupdate = AAS_NextRoutingUpdate( &queue ) ) != NULL )
+	{
+		numportalrelaxations++;
 		//
 		cluster = &aasworld.clusters[curupdate->cluster];
 		//
@@ -1709,24 +2824,7 @@ void AAS_UpdatePortalRoutingCache( aas_routingcache_t* portalcache )
 				nextupdate->areanum = portal->areanum;
 				// add travel time through the actual portal area for the next update
 				nextupdate->tmptraveltime = t + aasworld.portalmaxtraveltimes[portalnum];
-				if( !nextupdate->inlist )
-				{
-					// we add the update to the end of the list
-					// we could also use a B+ tree to have a real sorted list
-					// on travel time which makes for faster routing updates
-					nextupdate->next = NULL;
-					nextupdate->prev = updatelistend;
-					if( updatelistend )
-					{
-						updatelistend->next = nextupdate;
-					}
-					else
-					{
-						updateliststart = nextupdate;
-					}
-					updatelistend	   = nextupdate;
-					nextupdate->inlist = qtrue;
-				} // end if
+				AAS_AddRoutingUpdate( &queue, nextupdate );
 			} // end if
 		} // end for
 	} // end while
@@ -1766,17 +2864,38 @@ aas_routingcache_t* AAS_GetPortalRoutingCache( int clusternum, int areanum, int
 			aasworld.portalcache[areanum]->prev = cache;
 		}
 		aasworld.portalcache[areanum] = cache;
+		// freed when the bot is done thinking, see AAS_EndThinkRoutingAreas
+		if( thinkroutingcache )
+		{
+			cache->think = qtrue;
+			routingcachesize -= cache->size;
+		} // end if
 		// update the cache
 		AAS_UpdatePortalRoutingCache( cache );
+#ifdef ROUTING_DEBUG
+		numcachemisses++;
+#endif // ROUTING_DEBUG
 	} // end if
-	else
+	else if( !cache->mapped && !cache->think )
 	{
 		AAS_UnlinkCache( cache );
+#ifdef ROUTING_DEBUG
+		numcachehits++;
+#endif // ROUTING_DEBUG
+	} // end else
+#ifdef ROUTING_DEBUG
+	else
+	{
+		numcachehits++;
 	} // end else
+#endif // ROUTING_DEBUG
 	// the cache has been accessed
 	cache->time = AAS_RoutingTime();
 	cache->type = CACHETYPE_PORTAL;
-	AAS_LinkCache( cache );
+	if( !cache->mapped && !cache->think )
+	{
+		AAS_LinkCache( cache );
+	}
 	return cache;
 } // end of the function AAS_GetPortalRoutingCache
 //===========================================================================
@@ -1785,7 +2904,7 @@ aas_routingcache_t* AAS_GetPortalRoutingCache( int clusternum, int areanum, int
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-int AAS_AreaRouteToGoalArea( int areanum, vec3_t origin, int goalareanum, int travelflags, int* traveltime, int* reachnum )
+static int AAS_RouteToGoalArea( int areanum, vec3_t origin, int goalareanum, int travelflags, int* traveltime, int* reachnum )
 {
 	int					clusternum, goalclusternum, portalnum, i, clusterareanum, bestreachnum;
 	unsigned short int	t, besttime;
@@ -1822,14 +2941,6 @@ int AAS_AreaRouteToGoalArea( int areanum, vec3_t origin, int goalareanum, int tr
 		} // end if
 		return qfalse;
 	} // end if
-	// make sure the routing cache doesn't grow to large
-	while( AvailableMemory() < 1 * 1024 * 1024 )
-	{
-		if( !AAS_FreeOldestCache() )
-		{
-			break;
-		}
-	}
 	//
 	if( AAS_AreaDoNotEnter( areanum ) || AAS_AreaDoNotEnter( goalareanum ) )
 	{
@@ -1975,6 +3086,52 @@ int AAS_AreaRouteToGoalArea( int areanum, vec3_t origin, int goalareanum, int tr
 	*reachnum	= bestreachnum;
 	*traveltime = besttime;
 	return qtrue;
+} // end of the function AAS_RouteToGoalArea
+//===========================================================================
+// the routing cache is shared by all bots, so it is looked up and updated
+// under the botlib lock, a bot that changed areas for its own routing while
+// thinking routes with cache of its own
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+int AAS_AreaRouteToGoalArea( int areanum, vec3_t origin, int goalareanum, int travelflags, int* traveltime, int* reachnum )
+{
+	aas_routingcache_t ***clusterareacache, **portalcache;
+	int					  result;
+
+	BotLibLock();
+	// make sure the routing cache doesn't grow to large
+	while( routingcachesize > max_routingcachesize || AvailableMemory() < 1 * 1024 * 1024 )
+	{
+		if( !AAS_FreeOldestCache() )
+		{
+			break;
+		}
+	}
+	//
+	clusterareacache = aasworld.clusterareacache;
+	portalcache		 = aasworld.portalcache;
+	if( numthinkareachanges && aasworld.initialized && AAS_ThinkRoutingAreasChanged() )
+	{
+		if( !thinkclusterareacache )
+		{
+			AAS_InitClusterAreaCache();
+			AAS_InitPortalCache();
+			thinkclusterareacache = aasworld.clusterareacache;
+			thinkportalcache	  = aasworld.portalcache;
+		} // end if
+		aasworld.clusterareacache = thinkclusterareacache;
+		aasworld.portalcache	  = thinkportalcache;
+		thinkroutingcache		  = qtrue;
+	} // end if
+	result = AAS_RouteToGoalArea( areanum, origin, goalareanum, travelflags, traveltime, reachnum );
+	aasworld.clusterareacache = clusterareacache;
+	aasworld.portalcache	  = portalcache;
+	thinkroutingcache		  = qfalse;
+	BotLibUnlock();
+	return result;
 } // end of the function AAS_AreaRouteToGoalArea
 //===========================================================================
 //
@@ -1993,6 +3150,37 @@ int AAS_AreaTravelTimeToGoalArea( int areanum, vec3_t origin, int goalareanum, i
 	return 0;
 } // end of the function AAS_AreaTravelTimeToGoalArea
 //===========================================================================
+// changes whenever an area is enabled or disabled for routing or another
+// map is loaded, travel times taken before that can't be trusted anymore
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+int AAS_RoutingGeneration()
+{
+	return routinggeneration;
+} // end of the function AAS_RoutingGeneration
+//===========================================================================
+// the longest travel time within the area, from one corner of its bounds
+// to the other
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+int AAS_AreaCrossTravelTime( int areanum )
+{
+	aas_area_t* area;
+
+	if( areanum <= 0 || areanum >= aasworld.numareas )
+	{
+		return 0;
+	}
+	area = &aasworld.areas[areanum];
+	return AAS_AreaTravelTime( areanum, area->mins, area->maxs );
+} // end of the function AAS_AreaCrossTravelTime
+//===========================================================================
 //
 // Parameter:			-
 // Returns:				-
@@ -2332,7 +3520,7 @@ float DistancePointToLine( vec3_t v1, vec3_t v2, vec3_t point )
 // Returns:				-
 // Changes Globals:		-
 //===========================================================================
-int AAS_NearestHideArea( int srcnum, vec3_t origin, int areanum, int enemynum, vec3_t enemyorigin, int enemyareanum, int travelflags )
+static int AAS_FindHideArea( int srcnum, vec3_t origin, int areanum, int enemynum, vec3_t enemyorigin, int enemyareanum, int travelflags )
 {
 	int						   i, j, nextareanum, badtravelflags, numreach, bestarea;
 	unsigned short int		   t, besttraveltime;
@@ -2487,4 +3675,20 @@ int AAS_NearestHideArea( int srcnum, vec3_t origin, int areanum, int enemynum, v
 		} // end for
 	} // end while
 	return bestarea;
+} // end of the function AAS_FindHideArea
+//===========================================================================
+// floods through the area updates the routing uses as well
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+int AAS_NearestHideArea( int srcnum, vec3_t origin, int areanum, int enemynum, vec3_t enemyorigin, int enemyareanum, int travelflags )
+{
+	int result;
+
+	BotLibLock();
+	result = AAS_FindHideArea( srcnum, origin, areanum, enemynum, enemyorigin, enemyareanum, travelflags );
+	BotLibUnlock();
+	return result;
 } // end of the function AAS_NearestHideArea
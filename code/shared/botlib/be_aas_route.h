@@ -39,8 +39,12 @@ unsigned short int AAS_AreaTravelTime( int areanum, vec3_t start, vec3_t end );
 //
 void			   AAS_CreateAllRoutingCache();
 void			   AAS_WriteRouteCache();
+// creates the routing cache for the common travel flags and writes it to the route cache file
+void			   AAS_BuildRouteCache();
 //
 void			   AAS_RoutingInfo();
+// computes all routing cache with the old and the new update order and compares them
+void			   AAS_RoutingBenchmark();
 #endif // AASINTERN
 
 // returns the travel flag for the given travel type
@@ -55,10 +59,18 @@ void			   AAS_ReachabilityFromNum( int num, struct aas_reachability_s* reach );
 int				   AAS_RandomGoalArea( int areanum, int travelflags, int* goalareanum, vec3_t goalorigin );
 // enable or disable an area for routing
 int				   AAS_EnableRoutingArea( int areanum, int enable );
+// puts back the areas the bot thinking on this thread enabled or disabled
+void			   AAS_EndThinkRoutingAreas( int client );
+// enables or disables those areas for real, in client order
+void			   AAS_ApplyRoutingAreaChanges();
 // returns the travel time within the given area from start to end
 unsigned short int AAS_AreaTravelTime( int areanum, vec3_t start, vec3_t end );
 // returns the travel time from the area to the goal area using the given travel flags
 int				   AAS_AreaTravelTimeToGoalArea( int areanum, vec3_t origin, int goalareanum, int travelflags );
+// changes whenever travel times taken before may have changed
+int				   AAS_RoutingGeneration();
+// returns the longest travel time within the area
+int				   AAS_AreaCrossTravelTime( int areanum );
 // predict a route up to a stop event
 int				   AAS_PredictRoute(
 				   struct aas_predictroute_s* route, int areanum, vec3_t origin, int goalareanum, int travelflags, int maxareas, int maxtime, int stopevent, int stopcontents, int stoptfl, int stopareanum );
@@ -128,6 +128,8 @@ int AAS_AlternativeRouteGoals( vec3_t start, int startareanum, vec3_t goal, int
 	{
 		return 0;
 	}
+	// the midrange areas are shared by all bots
+	BotLibLock();
 	// travel time towards the goal area
 	goaltraveltime = AAS_AreaTravelTimeToGoalArea( startareanum, start, goalareanum, travelflags );
 	// clear the midrange areas
@@ -235,6 +237,7 @@ int AAS_AlternativeRouteGoals( vec3_t start, int startareanum, vec3_t goal, int
 	#ifdef ALTROUTE_DEBUG
 	botimport.Print( PRT_MESSAGE, "alternative route goals in %d msec\n", Sys_MilliSeconds() - startmillisecs );
 	#endif
+	BotLibUnlock();
 	return numaltroutegoals;
 #endif
 } // end of the function AAS_AlternativeRouteGoals
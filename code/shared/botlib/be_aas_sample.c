@@ -1350,6 +1350,8 @@ typedef struct
 	int nodenum; // node found after splitting
 } aas_linkstack_t;
 
+#define MAX_BBOXAREAS 512
+
 aas_link_t* AAS_AASLinkEntity( vec3_t absmins, vec3_t absmaxs, int entnum )
 {
 	int				 side, nodenum;
@@ -1489,22 +1491,82 @@ aas_link_t* AAS_LinkEntityClientBBox( vec3_t absmins, vec3_t absmaxs, int entnum
 //===========================================================================
 int AAS_BBoxAreas( vec3_t absmins, vec3_t absmaxs, int* areas, int maxareas )
 {
-	aas_link_t *linkedareas, *link;
-	int			num;
+	int				 side, nodenum, areanum, numfound, i;
+	int				 found[MAX_BBOXAREAS];
+	aas_linkstack_t	 linkstack[128];
+	aas_linkstack_t* lstack_p;
+	aas_node_t*		 aasnode;
 
-	linkedareas = AAS_AASLinkEntity( absmins, absmaxs, -1 );
-	num			= 0;
-	for( link = linkedareas; link; link = link->next_area )
+	if( !aasworld.loaded )
 	{
-		areas[num] = link->areanum;
-		num++;
-		if( num >= maxareas )
+		return 0;
+	} // end if
+	// the same walk as AAS_AASLinkEntity without linking anything, bots
+	// ask for the areas while thinking in parallel
+	numfound = 0;
+	lstack_p = linkstack;
+	lstack_p->nodenum = 1;
+	lstack_p++;
+	while( lstack_p > linkstack )
+	{
+		lstack_p--;
+		nodenum = lstack_p->nodenum;
+		// if it is an area
+		if( nodenum < 0 )
 		{
-			break;
+			areanum = -nodenum;
+			// several node children can point to the same area
+			for( i = 0; i < numfound; i++ )
+			{
+				if( found[i] == areanum )
+				{
+					break;
+				}
+			} // end for
+			if( i < numfound )
+			{
+				continue;
+			}
+			if( numfound >= MAX_BBOXAREAS )
+			{
+				break;
+			}
+			found[numfound++] = areanum;
+			continue;
+		} // end if
+		// if solid leaf
+		if( !nodenum )
+		{
+			continue;
 		}
+		aasnode = &aasworld.nodes[nodenum];
+		side	= AAS_BoxOnPlaneSide2( absmins, absmaxs, &aasworld.planes[aasnode->planenum] );
+		if( lstack_p >= &linkstack[126] )
+		{
+			botimport.Print( PRT_ERROR, "AAS_BBoxAreas: stack overflow\n" );
+			break;
+		} // end if
+		if( side & 1 )
+		{
+			lstack_p->nodenum = aasnode->children[0];
+			lstack_p++;
+		} // end if
+		if( side & 2 )
+		{
+			lstack_p->nodenum = aasnode->children[1];
+			lstack_p++;
+		} // end if
+	} // end while
+	// the linked list had the last area found first
+	if( maxareas > numfound )
+	{
+		maxareas = numfound;
+	}
+	for( i = 0; i < maxareas; i++ )
+	{
+		areas[i] = found[numfound - 1 - i];
 	} // end for
-	AAS_UnlinkFromAreas( linkedareas );
-	return num;
+	return maxareas;
 } // end of the function AAS_BBoxAreas
 //===========================================================================
 //
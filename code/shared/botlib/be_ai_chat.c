@@ -110,6 +110,7 @@ typedef struct bot_synonym_s
 {
 	char*				  string;
 	float				  weight;
+	int					  id; // string number in the synonym automaton
 	struct bot_synonym_s* next;
 } bot_synonym_t;
 // list with synonyms
@@ -125,6 +126,7 @@ typedef struct bot_synonymlist_s
 typedef struct bot_matchstring_s
 {
 	char*					  string;
+	int						  id; // string number in the match automaton, -1 for an empty string
 	struct bot_matchstring_s* next;
 } bot_matchstring_t;
 
@@ -146,6 +148,44 @@ typedef struct bot_matchtemplate_s
 	struct bot_matchtemplate_s* next;
 } bot_matchtemplate_t;
 
+// state of a chat automaton, see BotInitChatAutomaton
+typedef struct bot_chatnode_s
+{
+	int firstedge; // first edge to a longer prefix, -1 if none
+	int fail;	   // longest suffix that is a prefix as well
+	int string;	   // string ending at this state, -1 if none
+	int output;	   // next state down the fail states that ends a string, 0 if none
+} bot_chatnode_t;
+
+typedef struct bot_chatedge_s
+{
+	int c;
+	int node;
+	int next;
+} bot_chatedge_t;
+
+typedef struct bot_chatautomaton_s
+{
+	bot_chatnode_t* nodes;
+	int				numnodes;
+	bot_chatedge_t* edges;
+	int				numedges;
+	int				numstrings;
+	int				root[256]; // states after the root, 0 if none
+	byte*			found;	   // strings found by the last scan
+} bot_chatautomaton_t;
+
+// BotFindMatch result shared by the bots, see BotFindCachedMatch
+typedef struct bot_matchcache_s
+{
+	unsigned long int context;
+	int				  found;
+	int				  tried; // a template with the context set the match variables
+	bot_match_t		  match;
+} bot_matchcache_t;
+
+#define MAX_MATCHCACHE 16
+
 // reply chat key
 typedef struct bot_replychatkey_s
 {
@@ -205,11 +245,30 @@ bot_consolemessage_t* freeconsolemessages = NULL;
 bot_matchtemplate_t*  matchtemplates = NULL;
 // list with synonyms
 bot_synonymlist_t*	  synonyms = NULL;
+// the match strings and the synonyms compiled for searching
+bot_chatautomaton_t	  matchautomaton;
+bot_chatautomaton_t	  synonymautomaton;
+// recent matches
+bot_matchcache_t	  matchcache[MAX_MATCHCACHE];
+int					  nummatchcache;
+int					  nextmatchcache;
 // list with random strings
 bot_randomlist_t*	  randomstrings = NULL;
 // reply chats
 bot_replychat_t*	  replychats = NULL;
 
+// chat messages used by bots thinking in a parallel frame, see BotMarkChatMessageUsed
+typedef struct bot_chatmessageuse_s
+{
+	bot_chatmessage_t* message;
+	float			   time;
+} bot_chatmessageuse_t;
+
+#define MAX_CHATMESSAGEUSES 256
+
+bot_chatmessageuse_t chatmessageuses[MAX_CHATMESSAGEUSES];
+int					 numchatmessageuses;
+
 //========================================================================
 //
 // Parameter:				-
@@ -637,6 +696,217 @@ void StringReplaceWords( char* string, char* synonym, char* replacement )
 	} // end if
 } // end of the function StringReplaceWords
 //===========================================================================
+// the match templates and synonyms only match where their strings occur in
+// the message, case insensitive, so before trying them the message is run
+// once through an Aho-Corasick automaton of all their strings, the strings
+// that don't occur rule out the templates and synonyms using them
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotInitChatAutomaton( bot_chatautomaton_t* ca, int maxchars )
+{
+	ca->nodes	   = ( bot_chatnode_t* )GetClearedMemory( ( maxchars + 1 ) * sizeof( bot_chatnode_t ) );
+	ca->edges	   = ( bot_chatedge_t* )GetClearedMemory( ( maxchars + 1 ) * sizeof( bot_chatedge_t ) );
+	ca->numnodes   = 1;
+	ca->numedges   = 0;
+	ca->numstrings = 0;
+	ca->found	   = NULL;
+	Com_Memset( ca->root, 0, sizeof( ca->root ) );
+	ca->nodes[0].firstedge = -1;
+	ca->nodes[0].string	   = -1;
+} // end of the function BotInitChatAutomaton
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotFreeChatAutomaton( bot_chatautomaton_t* ca )
+{
+	if( ca->nodes )
+	{
+		FreeMemory( ca->nodes );
+	}
+	if( ca->edges )
+	{
+		FreeMemory( ca->edges );
+	}
+	if( ca->found )
+	{
+		FreeMemory( ca->found );
+	}
+	Com_Memset( ca, 0, sizeof( bot_chatautomaton_t ) );
+} // end of the function BotFreeChatAutomaton
+//===========================================================================
+// returns the state after the given one and character, -1 if none
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static int BotChatAutomatonNext( bot_chatautomaton_t* ca, int node, int c )
+{
+	int edge;
+
+	if( !node )
+	{
+		return ca->root[c] ? ca->root[c] : -1;
+	}
+	for( edge = ca->nodes[node].firstedge; edge >= 0; edge = ca->edges[edge].next )
+	{
+		if( ca->edges[edge].c == c )
+		{
+			return ca->edges[edge].node;
+		}
+	} // end for
+	return -1;
+} // end of the function BotChatAutomatonNext
+//===========================================================================
+// returns the number of the string, equal strings get the same number
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+int BotAddChatAutomatonString( bot_chatautomaton_t* ca, char* string )
+{
+	int				node, next, c;
+	bot_chatedge_t* edge;
+
+	node = 0;
+	for( ; *string; string++ )
+	{
+		c	 = toupper( ( unsigned char )*string );
+		next = BotChatAutomatonNext( ca, node, c );
+		if( next < 0 )
+		{
+			next					  = ca->numnodes++;
+			ca->nodes[next].firstedge = -1;
+			ca->nodes[next].string	  = -1;
+			if( !node )
+			{
+				ca->root[c] = next;
+			} // end if
+			else
+			{
+				edge					  = &ca->edges[ca->numedges];
+				edge->c					  = c;
+				edge->node				  = next;
+				edge->next				  = ca->nodes[node].firstedge;
+				ca->nodes[node].firstedge = ca->numedges++;
+			} // end else
+		} // end if
+		node = next;
+	} // end for
+	if( ca->nodes[node].string < 0 )
+	{
+		ca->nodes[node].string = ca->numstrings++;
+	}
+	return ca->nodes[node].string;
+} // end of the function BotAddChatAutomatonString
+//===========================================================================
+// sets the fail and output states breadth first
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotFinishChatAutomaton( bot_chatautomaton_t* ca )
+{
+	int *queue, head, tail, c, node, child, fail, next, edge;
+
+	queue = ( int* )GetMemory( ca->numnodes * sizeof( int ) );
+	head  = tail = 0;
+	for( c = 0; c < 256; c++ )
+	{
+		if( ca->root[c] )
+		{
+			ca->nodes[ca->root[c]].fail	  = 0;
+			ca->nodes[ca->root[c]].output = 0;
+			queue[tail++]				  = ca->root[c];
+		} // end if
+	} // end for
+	while( head < tail )
+	{
+		node = queue[head++];
+		for( edge = ca->nodes[node].firstedge; edge >= 0; edge = ca->edges[edge].next )
+		{
+			c	  = ca->edges[edge].c;
+			child = ca->edges[edge].node;
+			// the longest suffix with this character after it
+			for( fail = ca->nodes[node].fail;; fail = ca->nodes[fail].fail )
+			{
+				next = BotChatAutomatonNext( ca, fail, c );
+				if( next >= 0 || !fail )
+				{
+					break;
+				}
+			} // end for
+			if( next < 0 )
+			{
+				next = 0;
+			}
+			ca->nodes[child].fail	= next;
+			ca->nodes[child].output = ca->nodes[next].string >= 0 ? next : ca->nodes[next].output;
+			queue[tail++]			= child;
+		} // end for
+	} // end while
+	FreeMemory( queue );
+	//
+	ca->found = ( byte* )GetClearedMemory( ca->numstrings + 1 );
+} // end of the function BotFinishChatAutomaton
+//===========================================================================
+// marks the strings occurring in the given string
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotScanChatAutomaton( bot_chatautomaton_t* ca, char* string )
+{
+	int node, next, c, output;
+
+	if( !ca->found )
+	{
+		return;
+	}
+	Com_Memset( ca->found, 0, ca->numstrings );
+	node = 0;
+	for( ; *string; string++ )
+	{
+		c = toupper( ( unsigned char )*string );
+		while( 1 )
+		{
+			next = BotChatAutomatonNext( ca, node, c );
+			if( next >= 0 || !node )
+			{
+				break;
+			}
+			node = ca->nodes[node].fail;
+		} // end while
+		node = next >= 0 ? next : 0;
+		//
+		output = ca->nodes[node].string >= 0 ? node : ca->nodes[node].output;
+		for( ; output; output = ca->nodes[output].output )
+		{
+			ca->found[ca->nodes[output].string] = qtrue;
+		}
+	} // end for
+} // end of the function BotScanChatAutomaton
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static int BotChatStringFound( bot_chatautomaton_t* ca, int id )
+{
+	// without an automaton every string could be there
+	return id < 0 || !ca->found || ca->found[id];
+} // end of the function BotChatStringFound
+//===========================================================================
 //
 // Parameter:				-
 // Returns:					-
@@ -848,6 +1118,37 @@ bot_synonymlist_t* BotLoadSynonyms( char* filename )
 	return synlist;
 } // end of the function BotLoadSynonyms
 //===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotCompileSynonyms()
+{
+	int				   numchars;
+	bot_synonymlist_t* syn;
+	bot_synonym_t*	   synonym;
+
+	BotFreeChatAutomaton( &synonymautomaton );
+	numchars = 0;
+	for( syn = synonyms; syn; syn = syn->next )
+	{
+		for( synonym = syn->firstsynonym; synonym; synonym = synonym->next )
+		{
+			numchars += strlen( synonym->string );
+		}
+	} // end for
+	BotInitChatAutomaton( &synonymautomaton, numchars );
+	for( syn = synonyms; syn; syn = syn->next )
+	{
+		for( synonym = syn->firstsynonym; synonym; synonym = synonym->next )
+		{
+			synonym->id = BotAddChatAutomatonString( &synonymautomaton, synonym->string );
+		}
+	} // end for
+	BotFinishChatAutomaton( &synonymautomaton );
+} // end of the function BotCompileSynonyms
+//===========================================================================
 // replace all the synonyms in the string
 //
 // Parameter:				-
@@ -858,7 +1159,10 @@ void BotReplaceSynonyms( char* string, unsigned long int context )
 {
 	bot_synonymlist_t* syn;
 	bot_synonym_t*	   synonym;
+	int				   scanned;
 
+	BotLibLock();
+	scanned = qfalse;
 	for( syn = synonyms; syn; syn = syn->next )
 	{
 		if( !( syn->context & context ) )
@@ -867,9 +1171,21 @@ void BotReplaceSynonyms( char* string, unsigned long int context )
 		}
 		for( synonym = syn->firstsynonym->next; synonym; synonym = synonym->next )
 		{
+			// find the synonyms in the string as it is now
+			if( !scanned )
+			{
+				BotScanChatAutomaton( &synonymautomaton, string );
+				scanned = qtrue;
+			} // end if
+			if( !BotChatStringFound( &synonymautomaton, synonym->id ) )
+			{
+				continue;
+			}
 			StringReplaceWords( string, synonym->string, syn->firstsynonym->string );
+			scanned = qfalse;
 		} // end for
 	} // end for
+	BotLibUnlock();
 } // end of the function BotReplaceSynonyms
 //===========================================================================
 //
@@ -882,7 +1198,10 @@ void BotReplaceWeightedSynonyms( char* string, unsigned long int context )
 	bot_synonymlist_t* syn;
 	bot_synonym_t *	   synonym, *replacement;
 	float			   weight, curweight;
+	int				   scanned;
 
+	BotLibLock();
+	scanned = qfalse;
 	for( syn = synonyms; syn; syn = syn->next )
 	{
 		if( !( syn->context & context ) )
@@ -915,9 +1234,20 @@ void BotReplaceWeightedSynonyms( char* string, unsigned long int context )
 			{
 				continue;
 			}
+			if( !scanned )
+			{
+				BotScanChatAutomaton( &synonymautomaton, string );
+				scanned = qtrue;
+			} // end if
+			if( !BotChatStringFound( &synonymautomaton, synonym->id ) )
+			{
+				continue;
+			}
 			StringReplaceWords( string, synonym->string, replacement->string );
+			scanned = qfalse;
 		} // end for
 	} // end for
+	BotLibUnlock();
 } // end of the function BotReplaceWeightedSynonyms
 //===========================================================================
 //
@@ -931,6 +1261,9 @@ void BotReplaceReplySynonyms( char* string, unsigned long int context )
 	bot_synonymlist_t* syn;
 	bot_synonym_t*	   synonym;
 
+	BotLibLock();
+	// a synonym not in the string can't be at the front of a word in it
+	BotScanChatAutomaton( &synonymautomaton, string );
 	for( str1 = string; *str1; )
 	{
 		// go to the start of the next word
@@ -951,6 +1284,10 @@ void BotReplaceReplySynonyms( char* string, unsigned long int context )
 			}
 			for( synonym = syn->firstsynonym->next; synonym; synonym = synonym->next )
 			{
+				if( !BotChatStringFound( &synonymautomaton, synonym->id ) )
+				{
+					continue;
+				}
 				str2 = synonym->string;
 				// if the synonym is not at the front of the string continue
 				str2 = StringContainsWord( str1, synonym->string, qfalse );
@@ -970,6 +1307,7 @@ void BotReplaceReplySynonyms( char* string, unsigned long int context )
 				memmove( str1 + strlen( replacement ), str1 + strlen( synonym->string ), strlen( str1 + strlen( synonym->string ) ) + 1 );
 				// append the synonum replacement
 				Com_Memcpy( str1, replacement, strlen( replacement ) );
+				BotScanChatAutomaton( &synonymautomaton, string );
 				//
 				break;
 			} // end for
@@ -989,6 +1327,7 @@ void BotReplaceReplySynonyms( char* string, unsigned long int context )
 			break;
 		}
 	} // end while
+	BotLibUnlock();
 } // end of the function BotReplaceReplySynonyms
 //===========================================================================
 //
@@ -1562,6 +1901,45 @@ bot_matchtemplate_t* BotLoadMatchTemplates( char* matchfile )
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
+void BotCompileMatchTemplates()
+{
+	int					 numchars;
+	bot_matchtemplate_t* mt;
+	bot_matchpiece_t*	 mp;
+	bot_matchstring_t*	 ms;
+
+	BotFreeChatAutomaton( &matchautomaton );
+	nummatchcache = 0;
+	numchars	  = 0;
+	for( mt = matchtemplates; mt; mt = mt->next )
+	{
+		for( mp = mt->first; mp; mp = mp->next )
+		{
+			for( ms = mp->type == MT_STRING ? mp->firststring : NULL; ms; ms = ms->next )
+			{
+				numchars += strlen( ms->string );
+			}
+		} // end for
+	} // end for
+	BotInitChatAutomaton( &matchautomaton, numchars );
+	for( mt = matchtemplates; mt; mt = mt->next )
+	{
+		for( mp = mt->first; mp; mp = mp->next )
+		{
+			for( ms = mp->type == MT_STRING ? mp->firststring : NULL; ms; ms = ms->next )
+			{
+				ms->id = strlen( ms->string ) ? BotAddChatAutomatonString( &matchautomaton, ms->string ) : -1;
+			}
+		} // end for
+	} // end for
+	BotFinishChatAutomaton( &matchautomaton );
+} // end of the function BotCompileMatchTemplates
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
 int StringsMatch( bot_matchpiece_t* pieces, bot_match_t* match )
 {
 	int				   lastvariable, index;
@@ -1640,10 +2018,85 @@ int StringsMatch( bot_matchpiece_t* pieces, bot_match_t* match )
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
+static int BotMatchTemplatePossible( bot_matchtemplate_t* mt )
+{
+	bot_matchpiece_t*  mp;
+	bot_matchstring_t* ms;
+
+	for( mp = mt->first; mp; mp = mp->next )
+	{
+		if( mp->type != MT_STRING )
+		{
+			continue;
+		}
+		// one of the strings of the piece must be in the message
+		for( ms = mp->firststring; ms; ms = ms->next )
+		{
+			if( BotChatStringFound( &matchautomaton, ms->id ) )
+			{
+				break;
+			}
+		} // end for
+		if( !ms )
+		{
+			return qfalse;
+		}
+	} // end for
+	return qtrue;
+} // end of the function BotMatchTemplatePossible
+//===========================================================================
+// every bot that reads a console message matches it, the bots thinking in
+// the same frame share the result
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static bot_matchcache_t* BotFindCachedMatch( char* string, unsigned long int context )
+{
+	int i;
+
+	for( i = 0; i < nummatchcache; i++ )
+	{
+		if( matchcache[i].context == context && !strncmp( matchcache[i].match.string, string, MAX_MESSAGE_SIZE ) )
+		{
+			return &matchcache[i];
+		}
+	} // end for
+	return NULL;
+} // end of the function BotFindCachedMatch
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static void BotCacheMatch( bot_match_t* match, unsigned long int context, int found, int tried )
+{
+	bot_matchcache_t* mc;
+
+	mc			   = &matchcache[nextmatchcache];
+	nextmatchcache = ( nextmatchcache + 1 ) % MAX_MATCHCACHE;
+	if( nummatchcache < MAX_MATCHCACHE )
+	{
+		nummatchcache++;
+	}
+	mc->context = context;
+	mc->found	= found;
+	mc->tried	= tried;
+	Com_Memcpy( &mc->match, match, sizeof( bot_match_t ) );
+} // end of the function BotCacheMatch
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
 int BotFindMatch( char* str, bot_match_t* match, unsigned long int context )
 {
-	int					 i;
-	bot_matchtemplate_t* ms;
+	int					 i, found, skipped;
+	bot_matchtemplate_t *ms, *lastms;
+	bot_matchcache_t*	 mc;
 
 	strncpy( match->string, str, MAX_MESSAGE_SIZE );
 	// remove any trailing enters
@@ -1651,6 +2104,29 @@ int BotFindMatch( char* str, bot_match_t* match, unsigned long int context )
 	{
 		match->string[strlen( match->string ) - 1] = '\0';
 	} // end while
+	//
+	BotLibLock();
+	mc = BotFindCachedMatch( match->string, context );
+	if( mc )
+	{
+		if( mc->tried )
+		{
+			Com_Memcpy( match->variables, mc->match.variables, sizeof( match->variables ) );
+		}
+		if( mc->found )
+		{
+			match->type	   = mc->match.type;
+			match->subtype = mc->match.subtype;
+		} // end if
+		found = mc->found;
+		BotLibUnlock();
+		return found;
+	} // end if
+	// find the match strings in the message
+	BotScanChatAutomaton( &matchautomaton, match->string );
+	found	= qfalse;
+	skipped = qfalse;
+	lastms	= NULL;
 	// compare the string with all the match strings
 	for( ms = matchtemplates; ms; ms = ms->next )
 	{
@@ -1658,6 +2134,13 @@ int BotFindMatch( char* str, bot_match_t* match, unsigned long int context )
 		{
 			continue;
 		}
+		lastms = ms;
+		// if a piece of the template isn't in the message
+		skipped = !BotMatchTemplatePossible( ms );
+		if( skipped )
+		{
+			continue;
+		}
 		// reset the match variable offsets
 		for( i = 0; i < MAX_MATCHVARIABLES; i++ )
 		{
@@ -1668,10 +2151,22 @@ int BotFindMatch( char* str, bot_match_t* match, unsigned long int context )
 		{
 			match->type	   = ms->type;
 			match->subtype = ms->subtype;
-			return qtrue;
+			found		   = qtrue;
+			break;
 		} // end if
 	} // end for
-	return qfalse;
+	// leave the match variables the way the last template tried leaves them
+	if( skipped )
+	{
+		for( i = 0; i < MAX_MATCHVARIABLES; i++ )
+		{
+			match->variables[i].offset = -1;
+		}
+		StringsMatch( lastms->first, match );
+	} // end if
+	BotCacheMatch( match, context, found, lastms != NULL );
+	BotLibUnlock();
+	return found;
 } // end of the function BotFindMatch
 //===========================================================================
 //
@@ -2748,6 +3243,47 @@ void BotConstructChatMessage( bot_chatstate_t* chatstate, char* message, unsigne
 	} // end if
 } // end of the function BotConstructChatMessage
 //===========================================================================
+// bots with the same chat file share the messages, so in a parallel frame
+// a message is only marked as recently used once the frame is done and the
+// other bots can't tell which thread got to it first
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotMarkChatMessageUsed( bot_chatmessage_t* m )
+{
+	if( !botlibglobals.parallel )
+	{
+		m->time = AAS_Time() + CHATMESSAGE_RECENTTIME;
+		return;
+	} // end if
+	BotLibLock();
+	if( numchatmessageuses < MAX_CHATMESSAGEUSES )
+	{
+		chatmessageuses[numchatmessageuses].message = m;
+		chatmessageuses[numchatmessageuses].time	= AAS_Time() + CHATMESSAGE_RECENTTIME;
+		numchatmessageuses++;
+	} // end if
+	BotLibUnlock();
+} // end of the function BotMarkChatMessageUsed
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotApplyChatMessageTimes()
+{
+	int i;
+
+	for( i = 0; i < numchatmessageuses; i++ )
+	{
+		chatmessageuses[i].message->time = chatmessageuses[i].time;
+	} // end for
+	numchatmessageuses = 0;
+} // end of the function BotApplyChatMessageTimes
+//===========================================================================
 // randomly chooses one of the chat message of the given type
 //
 // Parameter:				-
@@ -2805,7 +3341,7 @@ char* BotChooseInitialChatMessage( bot_chatstate_t* cs, char* type )
 					}
 					if( --n < 0 )
 					{
-						m->time = AAS_Time() + CHATMESSAGE_RECENTTIME;
+						BotMarkChatMessageUsed( m );
 						return m->chatmessage;
 					} // end if
 				} // end for
@@ -3206,7 +3742,7 @@ int BotReplyChat( int chatstate, char* message, int mcontext, int vcontext, char
 		} // end if
 		else
 		{
-			bestchatmessage->time = AAS_Time() + CHATMESSAGE_RECENTTIME;
+			BotMarkChatMessageUsed( bestchatmessage );
 			BotConstructChatMessage( cs, bestchatmessage->chatmessage, mcontext, &bestmatch, vcontext, qtrue );
 		} // end else
 		return qtrue;
@@ -3437,6 +3973,8 @@ int BotSetupChatAI()
 	randomstrings  = BotLoadRandomStrings( file );
 	file		   = LibVarString( "matchfile", "match.c" );
 	matchtemplates = BotLoadMatchTemplates( file );
+	BotCompileSynonyms();
+	BotCompileMatchTemplates();
 	//
 	if( !LibVarValue( "nochat", "0" ) )
 	{
@@ -3489,6 +4027,9 @@ void BotShutdownChatAI()
 		BotFreeMatchTemplates( matchtemplates );
 	}
 	matchtemplates = NULL;
+	nummatchcache  = 0;
+	BotFreeChatAutomaton( &matchautomaton );
+	BotFreeChatAutomaton( &synonymautomaton );
 	if( randomstrings )
 	{
 		FreeMemory( randomstrings );
@@ -3503,5 +4044,6 @@ void BotShutdownChatAI()
 	{
 		BotFreeReplyChat( replychats );
 	}
-	replychats = NULL;
+	replychats		   = NULL;
+	numchatmessageuses = 0;
 } // end of the function BotShutdownChatAI
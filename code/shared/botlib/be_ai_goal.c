@@ -155,6 +155,24 @@ typedef struct itemconfig_s
 	iteminfo_t* iteminfo;
 } itemconfig_t;
 
+// travel time from the bot area to a level item, indexed like the level item heap
+typedef struct bot_itemtime_s
+{
+	int number;		 // number of the level item, 0 if not used
+	int goalareanum; // goal area of the level item
+	int traveltime;	 // travel time from the bot area, -1 if not known
+	int mintime;	 // the travel time is at least this, -1 if the item can't be reached
+} bot_itemtime_t;
+
+// a level item worth going for
+typedef struct bot_itemcandidate_s
+{
+	levelitem_t* li;
+	float		 weight;   // weight of the item
+	float		 maxscore; // weight over the least travel time it could take
+	int			 order;	   // position in the level item list, on a tie the first wins
+} bot_itemcandidate_t;
+
 // goal state
 typedef struct bot_goalstate_s
 {
@@ -169,8 +187,24 @@ typedef struct bot_goalstate_s
 	//
 	int					   avoidgoals[MAX_AVOIDGOALS];	   // goals to avoid
 	float				   avoidgoaltimes[MAX_AVOIDGOALS]; // times to avoid the goals
+	//
+	bot_itemtime_t*		   itemtimes;		// travel times to the level items, see BotInitItemTravelTimes
+	bot_itemcandidate_t*   itemcandidates;	// items a choice is made from
+	int					   itemtimearea;	// area the travel times are from
+	vec3_t				   itemtimeorigin;	// origin of the last choice in that area
+	int					   itemtimeflags;	// travel flags used for the travel times
+	int					   itemtimerouting; // routing generation of the travel times
 } bot_goalstate_t;
 
+// item weights of one inventory, see BotItemWeight
+typedef struct bot_itemweights_s
+{
+	weightconfig_t* config;
+	int*			inventory;
+	byte			known[MAX_WEIGHTS];
+	float			weights[MAX_WEIGHTS];
+} bot_itemweights_t;
+
 bot_goalstate_t* botgoalstates[MAX_CLIENTS + 1]; // bk001206 - FIXME: init?
 // item configuration
 itemconfig_t*	 itemconfig = NULL; // bk001206 - init
@@ -179,6 +213,12 @@ levelitem_t*	 levelitemheap	= NULL; // bk001206 - init
 levelitem_t*	 freelevelitems = NULL; // bk001206 - init
 levelitem_t*	 levelitems		= NULL; // bk001206 - init
 int				 numlevelitems	= 0;
+int				 maxlevelitems	= 0;
+// item travel time statistics
+int				 numitemtimecandidates; // travel times the items chosen from asked for
+int				 numitemtimequeries;	// travel times asked from the routing
+int				 numitemtimecached;		// travel times known for the bot area
+int				 numitemtimepruned;		// items that couldn't beat the best one so far
 // map locations
 maplocation_t*	 maplocations = NULL; // bk001206 - init
 // camp spots
@@ -365,23 +405,50 @@ int* ItemWeightIndex( weightconfig_t* iwc, itemconfig_t* ic )
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
+static void BotFreeItemTravelTimes( bot_goalstate_t* gs )
+{
+	if( gs->itemtimes )
+	{
+		FreeMemory( gs->itemtimes );
+	}
+	gs->itemtimes	   = NULL;
+	gs->itemcandidates = NULL;
+} // end of the function BotFreeItemTravelTimes
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
 void InitLevelItemHeap()
 {
-	int i, max_levelitems;
+	int i;
+
+	// the travel times are indexed like the heap
+	for( i = 1; i <= MAX_CLIENTS; i++ )
+	{
+		if( botgoalstates[i] )
+		{
+			BotFreeItemTravelTimes( botgoalstates[i] );
+		}
+	} // end for
+	numitemtimecandidates = 0;
+	numitemtimequeries	  = 0;
+	numitemtimepruned	  = 0;
 
 	if( levelitemheap )
 	{
 		FreeMemory( levelitemheap );
 	}
 
-	max_levelitems = ( int )LibVarValue( "max_levelitems", "256" );
-	levelitemheap  = ( levelitem_t* )GetClearedMemory( max_levelitems * sizeof( levelitem_t ) );
+	maxlevelitems = ( int )LibVarValue( "max_levelitems", "256" );
+	levelitemheap = ( levelitem_t* )GetClearedMemory( maxlevelitems * sizeof( levelitem_t ) );
 
-	for( i = 0; i < max_levelitems - 1; i++ )
+	for( i = 0; i < maxlevelitems - 1; i++ )
 	{
 		levelitemheap[i].next = &levelitemheap[i + 1];
 	} // end for
-	levelitemheap[max_levelitems - 1].next = NULL;
+	levelitemheap[maxlevelitems - 1].next = NULL;
 	//
 	freelevelitems = levelitemheap;
 } // end of the function InitLevelItemHeap
@@ -391,6 +458,17 @@ void InitLevelItemHeap()
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
+static void BotItemTravelTimeInfo()
+{
+	botimport.Print( PRT_MESSAGE, "%d item travel times asked for, %d routing queries\n", numitemtimecandidates, numitemtimequeries );
+	botimport.Print( PRT_MESSAGE, "%d items couldn't beat the best one\n", numitemtimepruned );
+} // end of the function BotItemTravelTimeInfo
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
 levelitem_t* AllocLevelItem()
 {
 	levelitem_t* li;
@@ -1108,6 +1186,11 @@ void BotUpdateEntityItems()
 	aas_entityinfo_t entinfo;
 	itemconfig_t*	 ic;
 
+	if( bot_developer && LibVarGetValue( "showitemtimes" ) )
+	{
+		BotItemTravelTimeInfo();
+		LibVarSet( "showitemtimes", "0" );
+	} // end if
 	// timeout current entity items if necessary
 	for( li = levelitems; li; li = nextli )
 	{
@@ -1423,6 +1506,211 @@ int BotGetSecondGoal( int goalstate, bot_goal_t* goal )
 	return qtrue;
 } // end of the function BotGetSecondGoal
 //===========================================================================
+// levels have many items of the same kind, the weight of each kind is
+// evaluated once per choice
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static void BotInitItemWeights( bot_itemweights_t* iw, weightconfig_t* config, int* inventory )
+{
+	iw->config	  = config;
+	iw->inventory = inventory;
+	Com_Memset( iw->known, 0, sizeof( iw->known ) );
+} // end of the function BotInitItemWeights
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static float BotItemWeight( bot_itemweights_t* iw, int weightnum )
+{
+#ifdef UNDECIDEDFUZZY
+	// every item draws its own
+	return FuzzyWeightUndecided( iw->inventory, iw->config, weightnum );
+#else
+	if( !iw->known[weightnum] )
+	{
+		iw->weights[weightnum] = FuzzyWeight( iw->inventory, iw->config, weightnum );
+		iw->known[weightnum]   = qtrue;
+	} // end if
+	return iw->weights[weightnum];
+#endif // UNDECIDEDFUZZY
+} // end of the function BotItemWeight
+//===========================================================================
+// a bot keeps the travel times to the level items from the area it is in,
+// and a choice only asks the routing for the items that could still beat
+// the best one found so far
+//
+// when the bot moves on to another area the known travel times become
+// lower bounds: going through the new area can't be quicker than the best
+// route from the old one, so the time to an item from the new area is at
+// least the old time minus the time from the old area to the new one, less
+// the time to cross either area for where in the area the times were taken
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static void BotInitItemTravelTimes( bot_goalstate_t* gs, int areanum, vec3_t origin, int travelflags, int* numqueries )
+{
+	int				i, routing, hoptime, slack;
+	bot_itemtime_t* it;
+
+	if( !gs->itemtimes )
+	{
+		gs->itemtimes	   = ( bot_itemtime_t* )GetClearedMemory( maxlevelitems * ( sizeof( bot_itemtime_t ) + sizeof( bot_itemcandidate_t ) ) );
+		gs->itemcandidates = ( bot_itemcandidate_t* )&gs->itemtimes[maxlevelitems];
+		gs->itemtimearea   = 0;
+	} // end if
+	//
+	routing = AAS_RoutingGeneration();
+	if( gs->itemtimearea && routing == gs->itemtimerouting && travelflags == gs->itemtimeflags )
+	{
+		if( areanum == gs->itemtimearea )
+		{
+			VectorCopy( origin, gs->itemtimeorigin );
+			return;
+		} // end if
+		// routes into or out of do not enter areas use other travel flags
+		hoptime = 0;
+		if( !AAS_AreaDoNotEnter( gs->itemtimearea ) && !AAS_AreaDoNotEnter( areanum ) )
+		{
+			hoptime = AAS_AreaTravelTimeToGoalArea( gs->itemtimearea, gs->itemtimeorigin, areanum, travelflags );
+			( *numqueries )++;
+		} // end if
+		if( hoptime > 0 )
+		{
+			slack = hoptime + AAS_AreaCrossTravelTime( gs->itemtimearea ) + AAS_AreaCrossTravelTime( areanum );
+			for( i = 0; i < maxlevelitems; i++ )
+			{
+				it			   = &gs->itemtimes[i];
+				it->traveltime = -1;
+				// an item that couldn't be reached from the old area can't
+				// be reached from an area reached from there either
+				if( it->mintime > 0 )
+				{
+					it->mintime -= slack;
+					if( it->mintime < 0 )
+					{
+						it->mintime = 0;
+					}
+				} // end if
+			} // end for
+		} // end if
+		else
+		{
+			Com_Memset( gs->itemtimes, 0, maxlevelitems * sizeof( bot_itemtime_t ) );
+		} // end else
+	} // end if
+	else
+	{
+		Com_Memset( gs->itemtimes, 0, maxlevelitems * sizeof( bot_itemtime_t ) );
+	} // end else
+	gs->itemtimearea	= areanum;
+	gs->itemtimeflags	= travelflags;
+	gs->itemtimerouting = routing;
+	VectorCopy( origin, gs->itemtimeorigin );
+} // end of the function BotInitItemTravelTimes
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static bot_itemtime_t* BotItemTime( bot_goalstate_t* gs, levelitem_t* li )
+{
+	bot_itemtime_t* it;
+
+	it = &gs->itemtimes[li - levelitemheap];
+	// if the heap entry was reused or the item moved
+	if( it->number != li->number || it->goalareanum != li->goalareanum )
+	{
+		it->number		= li->number;
+		it->goalareanum = li->goalareanum;
+		it->traveltime	= -1;
+		it->mintime		= 0;
+	} // end if
+	return it;
+} // end of the function BotItemTime
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static int BotItemTravelTime( bot_goalstate_t* gs, levelitem_t* li, vec3_t origin, int travelflags, int* numqueries )
+{
+	bot_itemtime_t* it;
+
+	it = BotItemTime( gs, li );
+	if( it->traveltime < 0 )
+	{
+		it->traveltime = AAS_AreaTravelTimeToGoalArea( gs->itemtimearea, origin, li->goalareanum, travelflags );
+		it->mintime	   = it->traveltime > 0 ? it->traveltime : -1;
+		( *numqueries )++;
+	} // end if
+	return it->traveltime;
+} // end of the function BotItemTravelTime
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static void BotAddItemCandidate( bot_goalstate_t* gs, levelitem_t* li, float weight, int order, int* numcandidates )
+{
+	bot_itemtime_t*		 it;
+	bot_itemcandidate_t* c;
+	int					 mintime;
+
+	it = BotItemTime( gs, li );
+	// if the item can't be reached
+	if( it->mintime < 0 )
+	{
+		return;
+	}
+	mintime = it->mintime > 1 ? it->mintime : 1;
+	//
+	c			= &gs->itemcandidates[( *numcandidates )++];
+	c->li		= li;
+	c->weight	= weight;
+	c->maxscore = weight / ( ( float )mintime * TRAVELTIME_SCALE );
+	c->order	= order;
+} // end of the function BotAddItemCandidate
+//===========================================================================
+// the most promising items first
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static int BotCompareItemCandidates( const void* a, const void* b )
+{
+	const bot_itemcandidate_t* c1 = ( const bot_itemcandidate_t* )a;
+	const bot_itemcandidate_t* c2 = ( const bot_itemcandidate_t* )b;
+
+	if( c1->maxscore != c2->maxscore )
+	{
+		return c1->maxscore > c2->maxscore ? -1 : 1;
+	}
+	return c1->order - c2->order;
+} // end of the function BotCompareItemCandidates
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static void BotCountItemTravelTimes( int numcandidates, int numqueries, int numpruned )
+{
+	Com_AtomicAdd( &numitemtimecandidates, numcandidates );
+	Com_AtomicAdd( &numitemtimequeries, numqueries );
+	Com_AtomicAdd( &numitemtimepruned, numpruned );
+} // end of the function BotCountItemTravelTimes
+//===========================================================================
 // pops a new long term goal on the goal stack in the goalstate
 //
 // Parameter:				-
@@ -1431,13 +1719,16 @@ int BotGetSecondGoal( int goalstate, bot_goal_t* goal )
 //===========================================================================
 int BotChooseLTGItem( int goalstate, vec3_t origin, int* inventory, int travelflags )
 {
-	int				 areanum, t, weightnum;
-	float			 weight, bestweight, avoidtime;
-	iteminfo_t*		 iteminfo;
-	itemconfig_t*	 ic;
-	levelitem_t *	 li, *bestitem;
-	bot_goal_t		 goal;
-	bot_goalstate_t* gs;
+	int					 areanum, t, weightnum, i, bestorder;
+	int					 numasked, numcandidates, numqueries, numpruned;
+	float				 weight, bestweight, avoidtime;
+	iteminfo_t*			 iteminfo;
+	itemconfig_t*		 ic;
+	levelitem_t *		 li, *bestitem;
+	bot_itemcandidate_t* c;
+	bot_goal_t			 goal;
+	bot_goalstate_t*	 gs;
+	bot_itemweights_t	 itemweights;
 
 	gs = BotGoalStateFromHandle( goalstate );
 	if( !gs )
@@ -1472,7 +1763,14 @@ int BotChooseLTGItem( int goalstate, vec3_t origin, int* inventory, int travelfl
 	// best weight and item so far
 	bestweight = 0;
 	bestitem   = NULL;
+	bestorder  = 0;
 	Com_Memset( &goal, 0, sizeof( bot_goal_t ) );
+	numasked	  = 0;
+	numcandidates = 0;
+	numqueries	  = 0;
+	numpruned	  = 0;
+	BotInitItemTravelTimes( gs, areanum, origin, travelflags, &numqueries );
+	BotInitItemWeights( &itemweights, gs->itemweightconfig, inventory );
 	// go through the items in the level
 	for( li = levelitems; li; li = li->next )
 	{
@@ -1519,11 +1817,7 @@ int BotChooseLTGItem( int goalstate, vec3_t origin, int* inventory, int travelfl
 			continue;
 		}
 
-#ifdef UNDECIDEDFUZZY
-		weight = FuzzyWeightUndecided( inventory, gs->itemweightconfig, weightnum );
-#else
-		weight = FuzzyWeight( inventory, gs->itemweightconfig, weightnum );
-#endif // UNDECIDEDFUZZY
+		weight = BotItemWeight( &itemweights, weightnum );
 #ifdef DROPPEDWEIGHT
 		// HACK: to make dropped items more attractive
 		if( li->timeout )
@@ -1539,28 +1833,43 @@ int BotChooseLTGItem( int goalstate, vec3_t origin, int* inventory, int travelfl
 		//
 		if( weight > 0 )
 		{
-			// get the travel time towards the goal area
-			t = AAS_AreaTravelTimeToGoalArea( areanum, origin, li->goalareanum, travelflags );
-			// if the goal is reachable
-			if( t > 0 )
+			BotAddItemCandidate( gs, li, weight, numasked++, &numcandidates );
+		} // end if
+	} // end for
+	// go through the items that could be the best one
+	qsort( gs->itemcandidates, numcandidates, sizeof( bot_itemcandidate_t ), BotCompareItemCandidates );
+	for( i = 0; i < numcandidates; i++ )
+	{
+		c = &gs->itemcandidates[i];
+		// if this and the items after it can't beat the best one so far
+		if( c->maxscore < bestweight )
+		{
+			numpruned = numcandidates - i;
+			break;
+		} // end if
+		// get the travel time towards the goal area
+		t = BotItemTravelTime( gs, c->li, origin, travelflags, &numqueries );
+		// if the goal is reachable
+		if( t > 0 )
+		{
+			// if this item won't respawn before we get there
+			avoidtime = BotAvoidGoalTime( goalstate, c->li->number );
+			if( avoidtime - t * 0.009 > 0 )
 			{
-				// if this item won't respawn before we get there
-				avoidtime = BotAvoidGoalTime( goalstate, li->number );
-				if( avoidtime - t * 0.009 > 0 )
-				{
-					continue;
-				}
-				//
-				weight /= ( float )t * TRAVELTIME_SCALE;
-				//
-				if( weight > bestweight )
-				{
-					bestweight = weight;
-					bestitem   = li;
-				} // end if
+				continue;
+			}
+			//
+			weight = c->weight / ( ( float )t * TRAVELTIME_SCALE );
+			//
+			if( weight > bestweight || ( weight == bestweight && bestitem && c->order < bestorder ) )
+			{
+				bestweight = weight;
+				bestitem   = c->li;
+				bestorder  = c->order;
 			} // end if
 		} // end if
 	} // end for
+	BotCountItemTravelTimes( numasked, numqueries, numpruned );
 	// if no goal item found
 	if( !bestitem )
 	{
@@ -1638,13 +1947,16 @@ int BotChooseLTGItem( int goalstate, vec3_t origin, int* inventory, int travelfl
 //===========================================================================
 int BotChooseNBGItem( int goalstate, vec3_t origin, int* inventory, int travelflags, bot_goal_t* ltg, float maxtime )
 {
-	int				 areanum, t, weightnum, ltg_time;
-	float			 weight, bestweight, avoidtime;
-	iteminfo_t*		 iteminfo;
-	itemconfig_t*	 ic;
-	levelitem_t *	 li, *bestitem;
-	bot_goal_t		 goal;
-	bot_goalstate_t* gs;
+	int					 areanum, t, weightnum, ltg_time, i, bestorder;
+	int					 numasked, numcandidates, numqueries, numpruned;
+	float				 weight, bestweight, avoidtime;
+	iteminfo_t*			 iteminfo;
+	itemconfig_t*		 ic;
+	levelitem_t *		 li, *bestitem;
+	bot_itemcandidate_t* c;
+	bot_goal_t			 goal;
+	bot_goalstate_t*	 gs;
+	bot_itemweights_t	 itemweights;
 
 	gs = BotGoalStateFromHandle( goalstate );
 	if( !gs )
@@ -1688,7 +2000,14 @@ int BotChooseNBGItem( int goalstate, vec3_t origin, int* inventory, int travelfl
 	// best weight and item so far
 	bestweight = 0;
 	bestitem   = NULL;
+	bestorder  = 0;
 	Com_Memset( &goal, 0, sizeof( bot_goal_t ) );
+	numasked	  = 0;
+	numcandidates = 0;
+	numqueries	  = 0;
+	numpruned	  = 0;
+	BotInitItemTravelTimes( gs, areanum, origin, travelflags, &numqueries );
+	BotInitItemWeights( &itemweights, gs->itemweightconfig, inventory );
 	// go through the items in the level
 	for( li = levelitems; li; li = li->next )
 	{
@@ -1735,11 +2054,7 @@ int BotChooseNBGItem( int goalstate, vec3_t origin, int* inventory, int travelfl
 			continue;
 		}
 		//
-#ifdef UNDECIDEDFUZZY
-		weight = FuzzyWeightUndecided( inventory, gs->itemweightconfig, weightnum );
-#else
-		weight = FuzzyWeight( inventory, gs->itemweightconfig, weightnum );
-#endif // UNDECIDEDFUZZY
+		weight = BotItemWeight( &itemweights, weightnum );
 #ifdef DROPPEDWEIGHT
 		// HACK: to make dropped items more attractive
 		if( li->timeout )
@@ -1755,38 +2070,53 @@ int BotChooseNBGItem( int goalstate, vec3_t origin, int* inventory, int travelfl
 		//
 		if( weight > 0 )
 		{
-			// get the travel time towards the goal area
-			t = AAS_AreaTravelTimeToGoalArea( areanum, origin, li->goalareanum, travelflags );
-			// if the goal is reachable
-			if( t > 0 && t < maxtime )
+			BotAddItemCandidate( gs, li, weight, numasked++, &numcandidates );
+		} // end if
+	} // end for
+	// go through the items that could be the best one
+	qsort( gs->itemcandidates, numcandidates, sizeof( bot_itemcandidate_t ), BotCompareItemCandidates );
+	for( i = 0; i < numcandidates; i++ )
+	{
+		c = &gs->itemcandidates[i];
+		// if this and the items after it can't beat the best one so far
+		if( c->maxscore < bestweight )
+		{
+			numpruned = numcandidates - i;
+			break;
+		} // end if
+		// get the travel time towards the goal area
+		t = BotItemTravelTime( gs, c->li, origin, travelflags, &numqueries );
+		// if the goal is reachable
+		if( t > 0 && t < maxtime )
+		{
+			// if this item won't respawn before we get there
+			avoidtime = BotAvoidGoalTime( goalstate, c->li->number );
+			if( avoidtime - t * 0.009 > 0 )
+			{
+				continue;
+			}
+			//
+			weight = c->weight / ( ( float )t * TRAVELTIME_SCALE );
+			//
+			if( weight > bestweight || ( weight == bestweight && bestitem && c->order < bestorder ) )
 			{
-				// if this item won't respawn before we get there
-				avoidtime = BotAvoidGoalTime( goalstate, li->number );
-				if( avoidtime - t * 0.009 > 0 )
+				t = 0;
+				if( ltg && !c->li->timeout )
 				{
-					continue;
-				}
-				//
-				weight /= ( float )t * TRAVELTIME_SCALE;
-				//
-				if( weight > bestweight )
+					// get the travel time from the goal to the long term goal
+					t = AAS_AreaTravelTimeToGoalArea( c->li->goalareanum, c->li->goalorigin, ltg->areanum, travelflags );
+				} // end if
+				// if the travel back is possible and doesn't take too long
+				if( t <= ltg_time )
 				{
-					t = 0;
-					if( ltg && !li->timeout )
-					{
-						// get the travel time from the goal to the long term goal
-						t = AAS_AreaTravelTimeToGoalArea( li->goalareanum, li->goalorigin, ltg->areanum, travelflags );
-					} // end if
-					// if the travel back is possible and doesn't take too long
-					if( t <= ltg_time )
-					{
-						bestweight = weight;
-						bestitem   = li;
-					} // end if
+					bestweight = weight;
+					bestitem   = c->li;
+					bestorder  = c->order;
 				} // end if
 			} // end if
 		} // end if
 	} // end for
+	BotCountItemTravelTimes( numasked, numqueries, numpruned );
 	// if no goal item found
 	if( !bestitem )
 	{
@@ -2025,6 +2355,7 @@ void BotFreeGoalState( int handle )
 		return;
 	} // end if
 	BotFreeItemWeights( handle );
+	BotFreeItemTravelTimes( botgoalstates[handle] );
 	FreeMemory( botgoalstates[handle] );
 	botgoalstates[handle] = NULL;
 } // end of the function BotFreeGoalState
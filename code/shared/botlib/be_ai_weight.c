@@ -45,7 +45,6 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "be_ai_weight.h"
 
 #define MAX_INVENTORYVALUE 999999
-#define EVALUATERECURSIVELY
 
 #define MAX_WEIGHT_FILES 128
 weightconfig_t* weightFileList[MAX_WEIGHT_FILES];
@@ -176,6 +175,10 @@ void FreeWeightConfig2( weightconfig_t* config )
 			FreeMemory( config->weights[i].name );
 		}
 	} // end for
+	if( config->nodes )
+	{
+		FreeMemory( config->nodes );
+	}
 	FreeMemory( config );
 } // end of the function FreeWeightConfig2
 //===========================================================================
@@ -351,6 +354,93 @@ fuzzyseperator_t* ReadFuzzySeperators_r( source_t* source )
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
+int CountFuzzySeperators_r( fuzzyseperator_t* fs )
+{
+	int n;
+
+	for( n = 0; fs; fs = fs->next )
+	{
+		n += 1 + CountFuzzySeperators_r( fs->child );
+	} // end for
+	return n;
+} // end of the function CountFuzzySeperators_r
+//===========================================================================
+// the seperators of one switch are stored next to each other with their
+// children after them, so walking a switch doesn't jump around in memory
+//
+// Parameter:				-
+// Returns:					index of the first node
+// Changes Globals:		-
+//===========================================================================
+int CompileFuzzySeperators_r( weightconfig_t* config, fuzzyseperator_t* fs )
+{
+	fuzzyseperator_t* s;
+	fuzzynode_t*	  node;
+	int				  first, i;
+
+	first = config->numnodes;
+	for( s = fs; s; s = s->next )
+	{
+		config->numnodes++;
+	} // end for
+	for( s = fs, i = first; s; s = s->next, i++ )
+	{
+		node			= &config->nodes[i];
+		node->index		= s->index;
+		node->value		= s->value;
+		node->weight	= s->weight;
+		node->minweight = s->minweight;
+		node->range		= s->maxweight - s->minweight;
+		node->jump[0]	= s->child ? CompileFuzzySeperators_r( config, s->child ) : -1;
+		node->jump[1]	= s->next ? i + 1 : -1;
+	} // end for
+	return first;
+} // end of the function CompileFuzzySeperators_r
+//===========================================================================
+// flattens the seperator trees into one array, run again whenever the
+// weights change
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void CompileWeightConfig( weightconfig_t* config )
+{
+	int i, numnodes;
+
+	if( config->nodes )
+	{
+		FreeMemory( config->nodes );
+		config->nodes = NULL;
+	} // end if
+	numnodes = 0;
+	for( i = 0; i < config->numweights; i++ )
+	{
+		numnodes += CountFuzzySeperators_r( config->weights[i].firstseperator );
+	} // end for
+	config->numnodes = 0;
+	if( numnodes )
+	{
+		config->nodes = ( fuzzynode_t* )GetClearedMemory( numnodes * sizeof( fuzzynode_t ) );
+	} // end if
+	for( i = 0; i < config->numweights; i++ )
+	{
+		if( config->weights[i].firstseperator )
+		{
+			config->weights[i].firstnode = CompileFuzzySeperators_r( config, config->weights[i].firstseperator );
+		} // end if
+		else
+		{
+			config->weights[i].firstnode = -1;
+		} // end else
+	} // end for
+} // end of the function CompileWeightConfig
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
 weightconfig_t* ReadWeightConfig( char* filename )
 {
 	int				  newindent, avail = 0, n;
@@ -494,6 +584,7 @@ weightconfig_t* ReadWeightConfig( char* filename )
 	} // end while
 	// free the source at the end of a pass
 	FreeSource( source );
+	CompileWeightConfig( config );
 	// if the file was located in a pak file
 	botimport.Print( PRT_MESSAGE, "loaded %s\n", filename );
 #ifdef DEBUG
@@ -850,50 +941,92 @@ float FuzzyWeightUndecided_r( int* inventory, fuzzyseperator_t* fs )
 	return fs->weight;
 } // end of the function FuzzyWeightUndecided_r
 //===========================================================================
+// FuzzyWeight_r on the compiled nodes. Between two seperators it scales
+// with an integer division that always comes out 0, which leaves the weight
+// of the second one, the node the walk goes on to anyway
 //
 // Parameter:				-
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
-float FuzzyWeight( int* inventory, weightconfig_t* wc, int weightnum )
+static float FuzzyNodeWeight( int* inventory, fuzzynode_t* nodes, int n )
 {
-#ifdef EVALUATERECURSIVELY
-	return FuzzyWeight_r( inventory, wc->weights[weightnum].firstseperator );
-#else
-	fuzzyseperator_t* s;
+	fuzzynode_t* node;
 
-	s = wc->weights[weightnum].firstseperator;
-	if( !s )
+	do
 	{
-		return 0;
+		node = &nodes[n];
+		n	 = node->jump[inventory[node->index] >= node->value];
+	} while( n >= 0 );
+	return node->weight;
+} // end of the function FuzzyNodeWeight
+//===========================================================================
+// FuzzyWeightUndecided_r on the compiled nodes, it draws the same random
+// numbers in the same order
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+static float FuzzyNodeWeightUndecided_r( int* inventory, fuzzynode_t* nodes, int n )
+{
+	fuzzynode_t *node, *next;
+	float		 scale, w1, w2;
+
+	node = &nodes[n];
+	if( inventory[node->index] < node->value )
+	{
+		if( node->jump[0] >= 0 )
+		{
+			return FuzzyNodeWeightUndecided_r( inventory, nodes, node->jump[0] );
+		}
+		return node->minweight + random() * node->range;
+	} // end if
+	if( node->jump[1] < 0 )
+	{
+		return node->weight;
 	}
-	while( 1 )
+	next = &nodes[node->jump[1]];
+	if( inventory[node->index] < next->value )
 	{
-		if( inventory[s->index] < s->value )
+		// first weight
+		if( node->jump[0] >= 0 )
 		{
-			if( s->child )
-			{
-				s = s->child;
-			}
-			else
-			{
-				return s->weight;
-			}
-		} // end if
+			w1 = FuzzyNodeWeightUndecided_r( inventory, nodes, node->jump[0] );
+		}
 		else
 		{
-			if( s->next )
-			{
-				s = s->next;
-			}
-			else
-			{
-				return s->weight;
-			}
-		} // end else
+			w1 = node->minweight + random() * node->range;
+		}
+		// second weight
+		if( next->jump[0] >= 0 )
+		{
+			w2 = FuzzyNodeWeight( inventory, nodes, next->jump[0] );
+		}
+		else
+		{
+			w2 = next->minweight + random() * next->range;
+		}
+		// the scale factor
+		scale = ( inventory[node->index] - node->value ) / ( next->value - node->value );
+		// scale between the two weights
+		return scale * w1 + ( 1 - scale ) * w2;
 	} // end if
-	return 0;
-#endif
+	return FuzzyNodeWeightUndecided_r( inventory, nodes, node->jump[1] );
+} // end of the function FuzzyNodeWeightUndecided_r
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+float FuzzyWeight( int* inventory, weightconfig_t* wc, int weightnum )
+{
+	if( wc->weights[weightnum].firstnode < 0 )
+	{
+		return 0;
+	}
+	return FuzzyNodeWeight( inventory, wc->nodes, wc->weights[weightnum].firstnode );
 } // end of the function FuzzyWeight
 //===========================================================================
 //
@@ -903,43 +1036,11 @@ float FuzzyWeight( int* inventory, weightconfig_t* wc, int weightnum )
 //===========================================================================
 float FuzzyWeightUndecided( int* inventory, weightconfig_t* wc, int weightnum )
 {
-#ifdef EVALUATERECURSIVELY
-	return FuzzyWeightUndecided_r( inventory, wc->weights[weightnum].firstseperator );
-#else
-	fuzzyseperator_t* s;
-
-	s = wc->weights[weightnum].firstseperator;
-	if( !s )
+	if( wc->weights[weightnum].firstnode < 0 )
 	{
 		return 0;
 	}
-	while( 1 )
-	{
-		if( inventory[s->index] < s->value )
-		{
-			if( s->child )
-			{
-				s = s->child;
-			}
-			else
-			{
-				return s->minweight + random() * ( s->maxweight - s->minweight );
-			}
-		} // end if
-		else
-		{
-			if( s->next )
-			{
-				s = s->next;
-			}
-			else
-			{
-				return s->minweight + random() * ( s->maxweight - s->minweight );
-			}
-		} // end else
-	} // end if
-	return 0;
-#endif
+	return FuzzyNodeWeightUndecided_r( inventory, wc->nodes, wc->weights[weightnum].firstnode );
 } // end of the function FuzzyWeightUndecided
 //===========================================================================
 //
@@ -993,6 +1094,7 @@ void EvolveWeightConfig( weightconfig_t* config )
 	{
 		EvolveFuzzySeperator_r( config->weights[i].firstseperator );
 	} // end for
+	CompileWeightConfig( config );
 } // end of the function EvolveWeightConfig
 //===========================================================================
 //
@@ -1048,6 +1150,7 @@ void ScaleWeight( weightconfig_t* config, char* name, float scale )
 		if( !strcmp( name, config->weights[i].name ) )
 		{
 			ScaleFuzzySeperator_r( config->weights[i].firstseperator, scale );
+			CompileWeightConfig( config );
 			break;
 		} // end if
 	} // end for
@@ -1102,6 +1205,7 @@ void ScaleFuzzyBalanceRange( weightconfig_t* config, float scale )
 	{
 		ScaleFuzzySeperatorBalanceRange_r( config->weights[i].firstseperator, scale );
 	} // end for
+	CompileWeightConfig( config );
 } // end of the function ScaleFuzzyBalanceRange
 //===========================================================================
 //
@@ -1174,6 +1278,7 @@ void InterbreedWeightConfigs( weightconfig_t* config1, weightconfig_t* config2,
 	{
 		InterbreedFuzzySeperator_r( config1->weights[i].firstseperator, config2->weights[i].firstseperator, configout->weights[i].firstseperator );
 	} // end for
+	CompileWeightConfig( configout );
 } // end of the function InterbreedWeightConfigs
 //===========================================================================
 //
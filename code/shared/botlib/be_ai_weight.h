@@ -45,23 +45,39 @@ typedef struct fuzzyseperator_s
 	struct fuzzyseperator_s* next;
 } fuzzyseperator_t;
 
+// fuzzy seperator compiled into the weight configuration's node array
+typedef struct fuzzynode_s
+{
+	int	  index;
+	int	  value;
+	int	  jump[2]; // node when the inventory is below the value and when it isn't, -1 for this node's weight
+	float weight;
+	float minweight;
+	float range; // maxweight - minweight
+} fuzzynode_t;
+
 // fuzzy weight
 typedef struct weight_s
 {
 	char*					 name;
 	struct fuzzyseperator_s* firstseperator;
+	int						 firstnode; // -1 without seperators
 } weight_t;
 
 // weight configuration
 typedef struct weightconfig_s
 {
-	int		 numweights;
-	weight_t weights[MAX_WEIGHTS];
-	char	 filename[MAX_QPATH];
+	int			 numweights;
+	weight_t	 weights[MAX_WEIGHTS];
+	char		 filename[MAX_QPATH];
+	fuzzynode_t* nodes; // the seperators of all weights, see CompileWeightConfig
+	int			 numnodes;
 } weightconfig_t;
 
 // reads a weight configuration
 weightconfig_t* ReadWeightConfig( char* filename );
+// flattens the seperators for evaluation, done when the config is read and when its weights change
+void			CompileWeightConfig( weightconfig_t* config );
 // free a weight configuration
 void			FreeWeightConfig( weightconfig_t* config );
 // writes a weight configuration, returns true if successfull
@@ -62,6 +62,15 @@ int				 bot_developer;
 // qtrue if the library is setup
 int				 botlibsetup = qfalse;
 
+// see BotLibLock
+static volatile int		 botliblockowner;
+static volatile int		 botlibthreads;
+static Q_THREADLOCAL int botlibthread;
+static Q_THREADLOCAL int botliblockdepth;
+// the bot thinking on this thread, see Export_BotLibThinkBegin
+static Q_THREADLOCAL int botlibthinkclient; // client + 1
+static Q_THREADLOCAL int botlibthinkseed;
+
 //===========================================================================
 //
 // several functions used by the exported functions
@@ -84,6 +93,82 @@ int				 Sys_MilliSeconds()
 // Returns:					-
 // Changes Globals:		-
 //===========================================================================
+void BotLibLock()
+{
+	int spins;
+
+	if( !botlibglobals.parallel )
+	{
+		return;
+	}
+	if( !botlibthread )
+	{
+		botlibthread = Com_AtomicAdd( &botlibthreads, 1 );
+	}
+	if( botliblockowner == botlibthread )
+	{
+		botliblockdepth++;
+		return;
+	}
+	spins = 0;
+	while( Com_AtomicCompareExchange( &botliblockowner, botlibthread, 0 ) != 0 )
+	{
+		if( ++spins > 64 )
+		{
+			botimport.Yield();
+			spins = 0;
+		}
+	}
+	botliblockdepth = 1;
+} // end of the function BotLibLock
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void BotLibUnlock()
+{
+	if( !botlibglobals.parallel )
+	{
+		return;
+	}
+	if( --botliblockdepth <= 0 )
+	{
+		botliblockdepth = 0;
+		Com_AtomicCompareExchange( &botliblockowner, 0, botlibthread );
+	}
+} // end of the function BotLibUnlock
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+int BotLibThinkClient()
+{
+	return botlibthinkclient - 1;
+} // end of the function BotLibThinkClient
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+float BotLibRandom()
+{
+	if( botlibthinkclient )
+	{
+		return Q_random( &botlibthinkseed );
+	}
+	return ( rand() & 0x7fff ) / ( ( float )0x7fff );
+} // end of the function BotLibRandom
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
 qboolean ValidClientNumber( int num, char* str )
 {
 	if( num < 0 || num > botlibglobals.maxclients )
@@ -215,6 +300,8 @@ int Export_BotLibShutdown()
 
 	// dump all allocated memory
 	//	DumpMemory();
+	// all blocks should be freed by now, release the memory pools
+	FreeMemoryPools();
 #ifdef DEBUG
 	PrintMemoryLabels();
 #endif
@@ -324,6 +411,56 @@ int Export_BotLibUpdateEntity( int ent, bot_entitystate_t* state )
 	return AAS_UpdateEntity( ent, state );
 } // end of the function Export_BotLibUpdateEntity
 //===========================================================================
+// bots think on job workers between BotLibParallelFrame( qtrue ) and
+// BotLibParallelFrame( qfalse ). Whatever a thinking bot changes that the
+// other bots could see is held back until the frame ends and then made in
+// client order: routing areas it enables or disables are only enabled or
+// disabled for its own routing (see AAS_EnableRoutingArea), chat messages
+// it picks are only marked as recently used (see BotChooseInitialChatMessage).
+// Its random numbers come from the seed given to BotLibThinkBegin. That way
+// the result of a frame doesn't depend on which thread ran which bot.
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void Export_BotLibParallelFrame( int begin )
+{
+	if( begin )
+	{
+		botlibglobals.parallel = qtrue;
+		return;
+	}
+	botlibglobals.parallel = qfalse;
+	botliblockowner		   = 0;
+	botliblockdepth		   = 0;
+	//
+	AAS_ApplyRoutingAreaChanges();
+	BotApplyChatMessageTimes();
+} // end of the function Export_BotLibParallelFrame
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void Export_BotLibThinkBegin( int client, int seed )
+{
+	botlibthinkclient = client + 1;
+	botlibthinkseed	  = seed;
+} // end of the function Export_BotLibThinkBegin
+//===========================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//===========================================================================
+void Export_BotLibThinkEnd()
+{
+	AAS_EndThinkRoutingAreas( botlibthinkclient - 1 );
+	botlibthinkclient = 0;
+} // end of the function Export_BotLibThinkEnd
+//===========================================================================
 //
 // Parameter:				-
 // Returns:					-
@@ -937,8 +1074,11 @@ botlib_export_t* GetBotLibAPI( int apiVersion, botlib_import_t* import )
 
 	be_botlib_export.BotLibStartFrame	= Export_BotLibStartFrame;
 	be_botlib_export.BotLibLoadMap		= Export_BotLibLoadMap;
-	be_botlib_export.BotLibUpdateEntity = Export_BotLibUpdateEntity;
-	be_botlib_export.Test				= BotExportTest;
+	be_botlib_export.BotLibUpdateEntity	 = Export_BotLibUpdateEntity;
+	be_botlib_export.BotLibParallelFrame = Export_BotLibParallelFrame;
+	be_botlib_export.BotLibThinkBegin	 = Export_BotLibThinkBegin;
+	be_botlib_export.BotLibThinkEnd		 = Export_BotLibThinkEnd;
+	be_botlib_export.Test				 = BotExportTest;
 
 	return &be_botlib_export;
 }
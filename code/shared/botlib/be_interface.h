@@ -39,6 +39,7 @@ typedef struct botlib_globals_s
 	int	  maxentities; // maximum number of entities
 	int	  maxclients;  // maximum number of clients
 	float time;		   // the global time
+	int	  parallel;	   // bots are thinking on job workers, see BotLibParallelFrame
 #ifdef DEBUG
 	qboolean debug; // true if debug is on
 	int		 goalareanum;
@@ -53,3 +54,14 @@ extern int				bot_developer; // true if developer is on
 
 //
 int						Sys_MilliSeconds();
+
+// shared botlib state touched by bots thinking on job workers is changed
+// under this lock, it only locks during a parallel frame and can be nested
+void					BotLibLock();
+void					BotLibUnlock();
+// the client thinking on this thread in a parallel frame, -1 if none
+int						BotLibThinkClient();
+// a bot thinking in a parallel frame draws from its own seed
+float					BotLibRandom();
+#undef random
+#define random() BotLibRandom()
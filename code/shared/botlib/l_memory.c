@@ -345,9 +345,224 @@ void DumpMemory()
 	totalmemorysize = 0;
 	allocatedmemory = 0;
 } // end of the function DumpMemory
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void FreeMemoryPools()
+{
+} // end of the function FreeMemoryPools
 
 #else
 
+	#define POOL_ID				 0x5a5a0000l // pool blocks store POOL_ID + the pool index
+	#define NUM_MEMORYPOOLS		 24
+	#define MAX_MEMORYPOOLSIZE	 2048 // larger blocks are allocated from the zone
+	#define MEMORYPOOL_CHUNKSIZE 16384
+
+// pool with memory blocks of the same size, the small blocks botlib allocates
+// in huge numbers (tokens, defines, chat messages) are carved from large chunks
+// instead of being separate zone allocations
+typedef struct memorypool_s
+{
+	int	  size;		  // block size including the block id
+	void* freeblocks; // free blocks, linked through the block memory
+	int	  numblocks;  // number of blocks in use
+} memorypool_t;
+
+// chunk of zone memory the pool blocks are carved from
+typedef struct memorychunk_s
+{
+	struct memorychunk_s* next; // next chunk in the list with all chunks
+	int					  size; // size of the chunk in bytes
+} memorychunk_t;
+
+static int			  memorypoolsizes[NUM_MEMORYPOOLS] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024, 1280, 1536, 1792, 2048 };
+static memorypool_t	  memorypools[NUM_MEMORYPOOLS];
+// pool index for every block size in steps of 16 bytes
+static unsigned char  memorypoolindex[MAX_MEMORYPOOLSIZE / 16 + 1];
+static int			  memorypoolsinitialized;
+static memorychunk_t* memorychunks;
+static volatile int	  memorypoollock;
+
+//===========================================================================
+// the pools are used from bots thinking on job workers
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void LockMemoryPools()
+{
+	int spins;
+
+	spins = 0;
+	while( Com_AtomicCompareExchange( &memorypoollock, 1, 0 ) != 0 )
+	{
+		if( ++spins > 64 )
+		{
+			botimport.Yield();
+			spins = 0;
+		} // end if
+	} // end while
+} // end of the function LockMemoryPools
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void UnlockMemoryPools()
+{
+	Com_AtomicCompareExchange( &memorypoollock, 0, 1 );
+} // end of the function UnlockMemoryPools
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void InitMemoryPools()
+{
+	int i, pool;
+
+	pool = 0;
+	for( i = 0; i <= MAX_MEMORYPOOLSIZE / 16; i++ )
+	{
+		while( memorypoolsizes[pool] < i * 16 )
+		{
+			pool++;
+		} // end while
+		memorypoolindex[i] = pool;
+	} // end for
+	for( i = 0; i < NUM_MEMORYPOOLS; i++ )
+	{
+		memorypools[i].size		  = memorypoolsizes[i];
+		memorypools[i].freeblocks = NULL;
+		memorypools[i].numblocks  = 0;
+	} // end for
+	memorypoolsinitialized = qtrue;
+} // end of the function InitMemoryPools
+//===========================================================================
+// carves a new chunk of zone memory into free blocks of the pool
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static int AllocMemoryChunk( int poolnum )
+{
+	memorypool_t*	   pool;
+	memorychunk_t*	   chunk;
+	unsigned long int* memid;
+	char*			   ptr;
+	int				   i, numblocks, headersize;
+
+	pool	   = &memorypools[poolnum];
+	headersize = ( sizeof( memorychunk_t ) + 15 ) & ~15;
+	numblocks  = ( MEMORYPOOL_CHUNKSIZE - headersize ) / pool->size;
+	chunk	   = ( memorychunk_t* )botimport.GetMemory( headersize + numblocks * pool->size );
+	if( !chunk )
+	{
+		return qfalse;
+	} // end if
+	chunk->size	 = headersize + numblocks * pool->size;
+	chunk->next	 = memorychunks;
+	memorychunks = chunk;
+	//
+	ptr = ( char* )chunk + headersize;
+	for( i = 0; i < numblocks; i++, ptr += pool->size )
+	{
+		memid					 = ( unsigned long int* )ptr;
+		*memid					 = POOL_ID + poolnum;
+		*( void** )( memid + 1 ) = pool->freeblocks;
+		pool->freeblocks		 = memid;
+	} // end for
+	return qtrue;
+} // end of the function AllocMemoryChunk
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void* GetPoolMemory( unsigned long size )
+{
+	memorypool_t*	   pool;
+	unsigned long int* memid;
+	int				   poolnum;
+
+	LockMemoryPools();
+	if( !memorypoolsinitialized )
+	{
+		InitMemoryPools();
+	} // end if
+	poolnum = memorypoolindex[( size + sizeof( unsigned long int ) + 15 ) >> 4];
+	pool	= &memorypools[poolnum];
+	if( !pool->freeblocks && !AllocMemoryChunk( poolnum ) )
+	{
+		UnlockMemoryPools();
+		return NULL;
+	} // end if
+	memid			 = ( unsigned long int* )pool->freeblocks;
+	pool->freeblocks = *( void** )( memid + 1 );
+	pool->numblocks++;
+	UnlockMemoryPools();
+	return memid + 1;
+} // end of the function GetPoolMemory
+//===========================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+static void FreePoolMemory( unsigned long int* memid )
+{
+	memorypool_t* pool;
+
+	LockMemoryPools();
+	pool					 = &memorypools[*memid - POOL_ID];
+	*( void** )( memid + 1 ) = pool->freeblocks;
+	pool->freeblocks		 = memid;
+	pool->numblocks--;
+	UnlockMemoryPools();
+} // end of the function FreePoolMemory
+//===========================================================================
+// returns the pool chunks to the zone, only done when no pool block is in use
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//===========================================================================
+void FreeMemoryPools()
+{
+	memorychunk_t* chunk;
+	int			   i;
+
+	LockMemoryPools();
+	for( i = 0; i < NUM_MEMORYPOOLS; i++ )
+	{
+		if( memorypools[i].numblocks )
+		{
+			UnlockMemoryPools();
+			return;
+		} // end if
+	} // end for
+	while( memorychunks )
+	{
+		chunk		 = memorychunks;
+		memorychunks = memorychunks->next;
+		botimport.FreeMemory( chunk );
+	} // end while
+	for( i = 0; i < NUM_MEMORYPOOLS; i++ )
+	{
+		memorypools[i].freeblocks = NULL;
+	} // end for
+	UnlockMemoryPools();
+} // end of the function FreeMemoryPools
+
 	//===========================================================================
 	//
 	// Parameter:			-
@@ -363,6 +578,11 @@ void* GetMemory( unsigned long size )
 	void*			   ptr;
 	unsigned long int* memid;
 
+	// small blocks are allocated from the memory pools
+	if( size + sizeof( unsigned long int ) <= MAX_MEMORYPOOLSIZE )
+	{
+		return GetPoolMemory( size );
+	} // end if
 	ptr = botimport.GetMemory( size + sizeof( unsigned long int ) );
 	if( !ptr )
 	{
@@ -454,6 +674,10 @@ void FreeMemory( void* ptr )
 	{
 		botimport.FreeMemory( memid );
 	} // end if
+	else if( *memid >= POOL_ID && *memid < POOL_ID + NUM_MEMORYPOOLS )
+	{
+		FreePoolMemory( memid );
+	} // end else if
 } // end of the function FreeMemory
 //===========================================================================
 //
@@ -473,6 +697,25 @@ int AvailableMemory()
 //===========================================================================
 void PrintUsedMemorySize()
 {
+	memorychunk_t* chunk;
+	int			   size, numchunks, numblocks, i;
+
+	size	  = 0;
+	numchunks = 0;
+	numblocks = 0;
+	LockMemoryPools();
+	for( chunk = memorychunks; chunk; chunk = chunk->next )
+	{
+		size += chunk->size;
+		numchunks++;
+	} // end for
+	for( i = 0; i < NUM_MEMORYPOOLS; i++ )
+	{
+		numblocks += memorypools[i].numblocks;
+	} // end for
+	UnlockMemoryPools();
+	botimport.Print( PRT_MESSAGE, "total pool memory: %d KB in %d chunks\n", size >> 10, numchunks );
+	botimport.Print( PRT_MESSAGE, "total pool blocks: %d\n", numblocks );
 } // end of the function PrintUsedMemorySize
 //===========================================================================
 //
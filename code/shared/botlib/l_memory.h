@@ -74,3 +74,5 @@ void PrintMemoryLabels();
 int	 MemoryByteSize( void* ptr );
 // free all allocated memory
 void DumpMemory();
+// return the memory pools to the zone when no pool block is in use
+void FreeMemoryPools();
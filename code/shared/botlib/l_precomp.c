@@ -64,6 +64,7 @@ typedef enum
 	#include "l_script.h"
 	#include "l_precomp.h"
 	#include "l_log.h"
+	#include "l_libvar.h"
 #endif // BOTLIB
 
 #ifdef MEQCC
@@ -123,6 +124,102 @@ token_t *freetokens;					//free tokens from the heap
 // list with global defines added to every source loaded
 define_t*  globaldefines;
 
+#ifdef BOTLIB
+	#define PCCACHE_IDENT	  ( ( 'C' << 24 ) + ( 'C' << 16 ) + ( 'P' << 8 ) + 'P' )
+	#define PCCACHE_VERSION	  1
+	#define PCCACHE_HASHBASIS 2166136261u
+	#define MAX_PCCACHEFILES  64
+
+// header of a precompiled source, the token stream and the table with
+// the files the source was compiled from follow the header
+typedef struct pc_cacheheader_s
+{
+	int			 ident;		 // PCCACHE_IDENT
+	int			 version;	 // PCCACHE_VERSION
+	int			 tokensize;	 // size of a cached token record
+	unsigned int definehash; // hash of the global defines
+	unsigned int folderhash; // hash of the base folder
+	int			 numtokens;	 // number of tokens in the stream
+	int			 numfiles;	 // number of files in the file table
+	int			 files;		 // offset of the file table
+	int			 size;		 // size of the whole cache
+} pc_cacheheader_t;
+
+// cached token, followed by the zero terminated token string
+typedef struct pc_cachedtoken_s
+{
+	int type;		  // token type
+	int subtype;	  // token sub type
+	int line;		  // line the token was on
+	int linescrossed; // lines crossed in white space
+	int file;		  // index in the file table
+	int length;		  // length of the token string
+	#ifdef NUMBERVALUE
+	unsigned long int intvalue;	  // integer value
+	long double		  floatvalue; // floating point value
+	#endif // NUMBERVALUE
+} pc_cachedtoken_t;
+
+// precompiled source being recorded
+typedef struct pc_cacherecord_s
+{
+	char*		 data;							// cache being written
+	int			 size;							// bytes written
+	int			 maxsize;						// bytes allocated
+	int			 numtokens;						// number of recorded tokens
+	int			 numfiles;						// number of recorded files
+	int			 overflow;						// true if too many files were included
+	char*		 filenames[MAX_PCCACHEFILES];	// names of the recorded files
+	unsigned int filehashes[MAX_PCCACHEFILES];	// hashes of the file contents
+	int			 filelengths[MAX_PCCACHEFILES]; // lengths of the file contents
+	script_t*	 lastscript;					// script of the last recorded token
+	int			 lastfile;						// file index of the last script
+} pc_cacherecord_t;
+
+// precompiled source being recorded, NULL if not recording
+static pc_cacherecord_t* pc_cacherecord;
+// number of source errors printed so far
+static int				 pc_numerrors;
+#endif // BOTLIB
+
+//============================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+void PC_SourcePosition( source_t* source, char** filename, int* line )
+{
+#ifdef BOTLIB
+	char* name;
+	int	  i;
+#endif // BOTLIB
+
+	if( source->scriptstack )
+	{
+		*filename = source->scriptstack->filename;
+		*line	  = source->scriptstack->line;
+		return;
+	} // end if
+	*filename = source->filename;
+	*line	  = source->token.line;
+#ifdef BOTLIB
+	// find the file of the last token read from the precompiled source
+	if( source->cache )
+	{
+		name = source->cache + source->cachefiles;
+		for( i = 0; i < source->cachefile && name < source->cache + source->cacheend; i++ )
+		{
+			name += 2 * sizeof( int );
+			name += strlen( name ) + 1;
+		} // end for
+		if( name < source->cache + source->cacheend )
+		{
+			*filename = name + 2 * sizeof( int );
+		}
+	} // end if
+#endif // BOTLIB
+} // end of the function PC_SourcePosition
 //============================================================================
 //
 // Parameter:				-
@@ -132,19 +229,23 @@ define_t*  globaldefines;
 void QDECL SourceError( source_t* source, char* str, ... )
 {
 	char	text[1024];
+	char*	filename;
+	int		line;
 	va_list ap;
 
 	va_start( ap, str );
 	vsprintf( text, str, ap );
 	va_end( ap );
+	PC_SourcePosition( source, &filename, &line );
 #ifdef BOTLIB
-	botimport.Print( PRT_ERROR, "file %s, line %d: %s\n", source->scriptstack->filename, source->scriptstack->line, text );
+	pc_numerrors++;
+	botimport.Print( PRT_ERROR, "file %s, line %d: %s\n", filename, line, text );
 #endif // BOTLIB
 #ifdef MEQCC
-	printf( "error: file %s, line %d: %s\n", source->scriptstack->filename, source->scriptstack->line, text );
+	printf( "error: file %s, line %d: %s\n", filename, line, text );
 #endif // MEQCC
 #ifdef BSPC
-	Log_Print( "error: file %s, line %d: %s\n", source->scriptstack->filename, source->scriptstack->line, text );
+	Log_Print( "error: file %s, line %d: %s\n", filename, line, text );
 #endif // BSPC
 } // end of the function SourceError
 //===========================================================================
@@ -156,19 +257,22 @@ void QDECL SourceError( source_t* source, char* str, ... )
 void QDECL SourceWarning( source_t* source, char* str, ... )
 {
 	char	text[1024];
+	char*	filename;
+	int		line;
 	va_list ap;
 
 	va_start( ap, str );
 	vsprintf( text, str, ap );
 	va_end( ap );
+	PC_SourcePosition( source, &filename, &line );
 #ifdef BOTLIB
-	botimport.Print( PRT_WARNING, "file %s, line %d: %s\n", source->scriptstack->filename, source->scriptstack->line, text );
+	botimport.Print( PRT_WARNING, "file %s, line %d: %s\n", filename, line, text );
 #endif // BOTLIB
 #ifdef MEQCC
-	printf( "warning: file %s, line %d: %s\n", source->scriptstack->filename, source->scriptstack->line, text );
+	printf( "warning: file %s, line %d: %s\n", filename, line, text );
 #endif // MEQCC
 #ifdef BSPC
-	Log_Print( "warning: file %s, line %d: %s\n", source->scriptstack->filename, source->scriptstack->line, text );
+	Log_Print( "warning: file %s, line %d: %s\n", filename, line, text );
 #endif // BSPC
 } // end of the function ScriptWarning
 //============================================================================
@@ -220,6 +324,46 @@ void PC_PopIndent( source_t* source, int* type, int* skip )
 	source->skip -= indent->skip;
 	FreeMemory( indent );
 } // end of the function PC_PopIndent
+#ifdef BOTLIB
+//============================================================================
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+static unsigned int PC_CacheHash( const char* data, int length, unsigned int hash )
+{
+	int i;
+
+	for( i = 0; i < length; i++ )
+	{
+		hash ^= ( unsigned char )data[i];
+		hash *= 16777619u;
+	} // end for
+	return hash;
+} // end of the function PC_CacheHash
+//============================================================================
+// records a file the precompiled source is compiled from
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+static void PC_RecordCacheFile( pc_cacherecord_t* record, script_t* script )
+{
+	if( record->numfiles >= MAX_PCCACHEFILES )
+	{
+		record->overflow = qtrue;
+		return;
+	} // end if
+	record->filenames[record->numfiles] = ( char* )GetMemory( strlen( script->filename ) + 1 );
+	strcpy( record->filenames[record->numfiles], script->filename );
+	record->filehashes[record->numfiles]  = PC_CacheHash( script->buffer, script->length, PCCACHE_HASHBASIS );
+	record->filelengths[record->numfiles] = script->length;
+	record->numfiles++;
+	record->lastscript = NULL;
+} // end of the function PC_RecordCacheFile
+#endif // BOTLIB
 //============================================================================
 //
 // Parameter:				-
@@ -238,6 +382,12 @@ void PC_PushScript( source_t* source, script_t* script )
 			return;
 		} // end if
 	} // end for
+#ifdef BOTLIB
+	if( pc_cacherecord )
+	{
+		PC_RecordCacheFile( pc_cacherecord, script );
+	} // end if
+#endif // BOTLIB
 	// push the script on the script stack
 	script->next		= source->scriptstack;
 	source->scriptstack = script;
@@ -3097,6 +3247,52 @@ int QuakeCMacro( source_t* source )
 	return qtrue;
 } // end of the function QuakeCMacro
 #endif // QUAKEC
+#ifdef BOTLIB
+//============================================================================
+// reads the next token from a precompiled source
+//
+// Parameter:				-
+// Returns:					-
+// Changes Globals:		-
+//============================================================================
+static int PC_ReadCachedToken( source_t* source, token_t* token )
+{
+	pc_cachedtoken_t cached;
+
+	// first read the tokens that were unread
+	if( source->tokens )
+	{
+		return PC_ReadSourceToken( source, token );
+	} // end if
+	if( source->cachepos + ( int )sizeof( pc_cachedtoken_t ) > source->cacheend )
+	{
+		return qfalse;
+	} // end if
+	Com_Memcpy( &cached, source->cache + source->cachepos, sizeof( pc_cachedtoken_t ) );
+	if( cached.length < 0 || cached.length >= MAX_TOKEN || source->cachepos + ( int )sizeof( pc_cachedtoken_t ) + cached.length + 1 > source->cacheend )
+	{
+		source->cachepos = source->cacheend;
+		return qfalse;
+	} // end if
+	source->cachepos += sizeof( pc_cachedtoken_t );
+	Com_Memcpy( token->string, source->cache + source->cachepos, cached.length );
+	token->string[cached.length] = '\0';
+	source->cachepos += cached.length + 1;
+	token->type	   = cached.type;
+	token->subtype = cached.subtype;
+#ifdef NUMBERVALUE
+	token->intvalue	  = cached.intvalue;
+	token->floatvalue = cached.floatvalue;
+#endif // NUMBERVALUE
+	token->whitespace_p	   = NULL;
+	token->endwhitespace_p = NULL;
+	token->line			   = cached.line;
+	token->linescrossed	   = cached.linescrossed;
+	token->next			   = NULL;
+	source->cachefile	   = cached.file;
+	return qtrue;
+} // end of the function PC_ReadCachedToken
+#endif // BOTLIB
 //============================================================================
 //
 // Parameter:				-
@@ -3107,6 +3303,18 @@ int PC_ReadToken( source_t* source, token_t* token )
 {
 	define_t* define;
 
+#ifdef BOTLIB
+	// the precompiled token stream already has all directives and defines resolved
+	if( source->cache )
+	{
+		if( !PC_ReadCachedToken( source, token ) )
+		{
+			return qfalse;
+		}
+		Com_Memcpy( &source->token, token, sizeof( token_t ) );
+		return qtrue;
+	} // end if
+#endif // BOTLIB
 	while( 1 )
 	{
 		if( !PC_ReadSourceToken( source, token ) )
@@ -3439,6 +3647,321 @@ void PC_SetPunctuations( source_t* source, punctuation_t* p )
 {
 	source->punctuations = p;
 } // end of the function PC_SetPunctuations
+#ifdef BOTLIB
+//============================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//============================================================================
+static void PC_CacheFileName( const char* filename, char* path, int size )
+{
+	unsigned int hash;
+
+	hash = PC_CacheHash( basefolder, strlen( basefolder ), PCCACHE_HASHBASIS );
+	hash = PC_CacheHash( filename, strlen( filename ), hash );
+	Com_sprintf( path, size, "pccache/%08x.pcc", hash );
+} // end of the function PC_CacheFileName
+//============================================================================
+// hash of the global defines which are added to every source
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//============================================================================
+static unsigned int PC_GlobalDefinesHash()
+{
+	define_t*	 define;
+	token_t*	 token;
+	unsigned int hash;
+
+	hash = PCCACHE_HASHBASIS;
+	for( define = globaldefines; define; define = define->next )
+	{
+		hash = PC_CacheHash( define->name, strlen( define->name ) + 1, hash );
+		hash = PC_CacheHash( ( char* )&define->numparms, sizeof( int ), hash );
+		for( token = define->parms; token; token = token->next )
+		{
+			hash = PC_CacheHash( token->string, strlen( token->string ) + 1, hash );
+		} // end for
+		for( token = define->tokens; token; token = token->next )
+		{
+			hash = PC_CacheHash( token->string, strlen( token->string ) + 1, hash );
+		} // end for
+	} // end for
+	return hash;
+} // end of the function PC_GlobalDefinesHash
+//============================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//============================================================================
+static void PC_WriteCache( pc_cacherecord_t* record, const void* data, int size )
+{
+	char* newdata;
+
+	if( record->size + size > record->maxsize )
+	{
+		record->maxsize = ( record->maxsize + size ) * 2;
+		newdata			= ( char* )GetMemory( record->maxsize );
+		if( record->data )
+		{
+			Com_Memcpy( newdata, record->data, record->size );
+			FreeMemory( record->data );
+		} // end if
+		record->data = newdata;
+	} // end if
+	Com_Memcpy( record->data + record->size, data, size );
+	record->size += size;
+} // end of the function PC_WriteCache
+//============================================================================
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//============================================================================
+static void PC_RecordCacheToken( pc_cacherecord_t* record, source_t* source, token_t* token )
+{
+	pc_cachedtoken_t cached;
+	int				 i;
+
+	// find the file the token was read from
+	if( source->scriptstack != record->lastscript )
+	{
+		record->lastscript = source->scriptstack;
+		record->lastfile   = 0;
+		for( i = 0; i < record->numfiles; i++ )
+		{
+			if( !strcmp( record->filenames[i], source->scriptstack->filename ) )
+			{
+				record->lastfile = i;
+				break;
+			} // end if
+		} // end for
+	} // end if
+	Com_Memset( &cached, 0, sizeof( pc_cachedtoken_t ) );
+	cached.type			= token->type;
+	cached.subtype		= token->subtype;
+	cached.line			= token->line;
+	cached.linescrossed = token->linescrossed;
+	cached.file			= record->lastfile;
+	cached.length		= strlen( token->string );
+#ifdef NUMBERVALUE
+	cached.intvalue	  = token->intvalue;
+	cached.floatvalue = token->floatvalue;
+#endif // NUMBERVALUE
+	PC_WriteCache( record, &cached, sizeof( pc_cachedtoken_t ) );
+	PC_WriteCache( record, token->string, cached.length + 1 );
+	record->numtokens++;
+} // end of the function PC_RecordCacheToken
+//============================================================================
+// reads all tokens from the freshly loaded source and turns it into a
+// precompiled source, the token stream is written to disk when the
+// whole source was compiled without errors
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//============================================================================
+static void PC_CacheSource( source_t* source )
+{
+	pc_cacherecord_t record;
+	pc_cacheheader_t header;
+	token_t			 token;
+	script_t*		 script;
+	indent_t*		 indent;
+	token_t*		 t;
+	fileHandle_t	 fp;
+	char			 path[MAX_QPATH];
+	int				 numerrors, numscripterrorsbefore, complete, i;
+
+	if( LibVarGetValue( "nopccache" ) )
+	{
+		return;
+	} // end if
+	Com_Memset( &record, 0, sizeof( pc_cacherecord_t ) );
+	Com_Memset( &header, 0, sizeof( pc_cacheheader_t ) );
+	PC_WriteCache( &record, &header, sizeof( pc_cacheheader_t ) );
+	PC_RecordCacheFile( &record, source->scriptstack );
+	numerrors			  = pc_numerrors;
+	numscripterrorsbefore = numscripterrors;
+	// read the whole source while recording the included files
+	pc_cacherecord = &record;
+	while( PC_ReadToken( source, &token ) )
+	{
+		PC_RecordCacheToken( &record, source, &token );
+	} // end while
+	pc_cacherecord = NULL;
+	// the stream is only complete when the end of the source was reached without errors
+	complete = !record.overflow && !source->tokens && !source->scriptstack->next && EndOfScript( source->scriptstack ) && pc_numerrors == numerrors && numscripterrors == numscripterrorsbefore;
+	// free everything used to compile the source
+	while( source->scriptstack )
+	{
+		script				= source->scriptstack;
+		source->scriptstack = source->scriptstack->next;
+		FreeScript( script );
+	} // end while
+	while( source->tokens )
+	{
+		t			   = source->tokens;
+		source->tokens = source->tokens->next;
+		PC_FreeToken( t );
+	} // end while
+	while( source->indentstack )
+	{
+		indent				= source->indentstack;
+		source->indentstack = source->indentstack->next;
+		FreeMemory( indent );
+	} // end while
+	source->skip = 0;
+	// write the file table
+	header.files = record.size;
+	for( i = 0; i < record.numfiles; i++ )
+	{
+		PC_WriteCache( &record, &record.filehashes[i], sizeof( int ) );
+		PC_WriteCache( &record, &record.filelengths[i], sizeof( int ) );
+		PC_WriteCache( &record, record.filenames[i], strlen( record.filenames[i] ) + 1 );
+		FreeMemory( record.filenames[i] );
+	} // end for
+	header.ident	  = PCCACHE_IDENT;
+	header.version	  = PCCACHE_VERSION;
+	header.tokensize  = sizeof( pc_cachedtoken_t );
+	header.definehash = PC_GlobalDefinesHash();
+	header.folderhash = PC_CacheHash( basefolder, strlen( basefolder ), PCCACHE_HASHBASIS );
+	header.numtokens  = record.numtokens;
+	header.numfiles	  = record.numfiles;
+	header.size		  = record.size;
+	Com_Memcpy( record.data, &header, sizeof( pc_cacheheader_t ) );
+	// read the rest of the source from the recorded token stream
+	source->cache	   = record.data;
+	source->cachepos   = sizeof( pc_cacheheader_t );
+	source->cacheend   = header.files;
+	source->cachefile  = 0;
+	source->cachefiles = header.files;
+	//
+	if( !complete )
+	{
+		return;
+	} // end if
+	PC_CacheFileName( source->filename, path, sizeof( path ) );
+	botimport.FS_FOpenFile( path, &fp, FS_WRITE );
+	if( !fp )
+	{
+		return;
+	} // end if
+	botimport.FS_Write( record.data, record.size, fp );
+	botimport.FS_FCloseFile( fp );
+} // end of the function PC_CacheSource
+//============================================================================
+// checks if all the files a precompiled source was compiled from are unchanged
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//============================================================================
+static int PC_CheckCachedFiles( char* cache, pc_cacheheader_t* header, const char* filename )
+{
+	script_t*	 script;
+	char*		 name;
+	unsigned int hash;
+	int			 offset, length, i, valid;
+
+	offset = header->files;
+	for( i = 0; i < header->numfiles; i++ )
+	{
+		if( offset + 2 * ( int )sizeof( int ) >= header->size )
+		{
+			return qfalse;
+		} // end if
+		Com_Memcpy( &hash, cache + offset, sizeof( int ) );
+		Com_Memcpy( &length, cache + offset + sizeof( int ), sizeof( int ) );
+		name = cache + offset + 2 * sizeof( int );
+		if( !memchr( name, '\0', header->size - offset - 2 * sizeof( int ) ) )
+		{
+			return qfalse;
+		} // end if
+		// the first file is the source itself
+		if( !i && strcmp( name, filename ) )
+		{
+			return qfalse;
+		} // end if
+		script = LoadScriptFile( name );
+		if( !script )
+		{
+			return qfalse;
+		} // end if
+		valid = script->length == length && PC_CacheHash( script->buffer, script->length, PCCACHE_HASHBASIS ) == hash;
+		FreeScript( script );
+		if( !valid )
+		{
+			return qfalse;
+		} // end if
+		offset += 2 * sizeof( int ) + strlen( name ) + 1;
+	} // end for
+	return offset == header->size;
+} // end of the function PC_CheckCachedFiles
+//============================================================================
+// loads the precompiled token stream of a source if none of the files
+// the source was compiled from changed
+//
+// Parameter:			-
+// Returns:				-
+// Changes Globals:		-
+//============================================================================
+static source_t* PC_LoadCachedSource( const char* filename )
+{
+	pc_cacheheader_t header;
+	source_t*		 source;
+	fileHandle_t	 fp;
+	char			 path[MAX_QPATH];
+	char*			 cache;
+	int				 length;
+
+	if( LibVarGetValue( "nopccache" ) )
+	{
+		return NULL;
+	} // end if
+	PC_CacheFileName( filename, path, sizeof( path ) );
+	length = botimport.FS_FOpenFile( path, &fp, FS_READ );
+	if( !fp )
+	{
+		return NULL;
+	} // end if
+	if( length < ( int )sizeof( pc_cacheheader_t ) )
+	{
+		botimport.FS_FCloseFile( fp );
+		return NULL;
+	} // end if
+	cache = ( char* )GetMemory( length );
+	botimport.FS_Read( cache, length, fp );
+	botimport.FS_FCloseFile( fp );
+	//
+	Com_Memcpy( &header, cache, sizeof( pc_cacheheader_t ) );
+	if( header.ident != PCCACHE_IDENT || header.version != PCCACHE_VERSION || header.tokensize != sizeof( pc_cachedtoken_t ) || header.size != length ||
+		header.files < ( int )sizeof( pc_cacheheader_t ) || header.files > length || header.definehash != PC_GlobalDefinesHash() ||
+		header.folderhash != PC_CacheHash( basefolder, strlen( basefolder ), PCCACHE_HASHBASIS ) || !PC_CheckCachedFiles( cache, &header, filename ) )
+	{
+		FreeMemory( cache );
+		return NULL;
+	} // end if
+	//
+	source = ( source_t* )GetMemory( sizeof( source_t ) );
+	Com_Memset( source, 0, sizeof( source_t ) );
+
+	strncpy( source->filename, filename, MAX_PATH );
+	source->cache	   = cache;
+	source->cachepos   = sizeof( pc_cacheheader_t );
+	source->cacheend   = header.files;
+	source->cachefiles = header.files;
+
+#if DEFINEHASHING
+	source->definehash = GetClearedMemory( DEFINEHASHSIZE * sizeof( define_t* ) );
+#endif // DEFINEHASHING
+	PC_AddGlobalDefinesToSource( source );
+	return source;
+} // end of the function PC_LoadCachedSource
+#endif // BOTLIB
 //============================================================================
 //
 // Parameter:			-
@@ -3452,6 +3975,15 @@ source_t* LoadSourceFile( const char* filename )
 
 	PC_InitTokenHeap();
 
+#ifdef BOTLIB
+	// use the precompiled token stream if the source didn't change
+	source = PC_LoadCachedSource( filename );
+	if( source )
+	{
+		return source;
+	} // end if
+#endif // BOTLIB
+
 	script = LoadScriptFile( filename );
 	if( !script )
 	{
@@ -3474,6 +4006,9 @@ source_t* LoadSourceFile( const char* filename )
 	source->definehash = GetClearedMemory( DEFINEHASHSIZE * sizeof( define_t* ) );
 #endif // DEFINEHASHING
 	PC_AddGlobalDefinesToSource( source );
+#ifdef BOTLIB
+	PC_CacheSource( source );
+#endif // BOTLIB
 	return source;
 } // end of the function LoadSourceFile
 //============================================================================
@@ -3567,6 +4102,13 @@ void FreeSource( source_t* source )
 		source->indentstack = source->indentstack->next;
 		FreeMemory( indent );
 	} // end for
+#ifdef BOTLIB
+	// free the precompiled token stream
+	if( source->cache )
+	{
+		FreeMemory( source->cache );
+	}
+#endif // BOTLIB
 #if DEFINEHASHING
 	//
 	if( source->definehash )
@@ -3674,6 +4216,8 @@ int PC_ReadTokenHandle( int handle, pc_token_t* pc_token )
 //============================================================================
 int PC_SourceFileAndLine( int handle, char* filename, int* line )
 {
+	char* name;
+
 	if( handle < 1 || handle >= MAX_SOURCEFILES )
 	{
 		return qfalse;
@@ -3684,9 +4228,9 @@ int PC_SourceFileAndLine( int handle, char* filename, int* line )
 	}
 
 	strcpy( filename, sourceFiles[handle]->filename );
-	if( sourceFiles[handle]->scriptstack )
+	if( sourceFiles[handle]->scriptstack || sourceFiles[handle]->cache )
 	{
-		*line = sourceFiles[handle]->scriptstack->line;
+		PC_SourcePosition( sourceFiles[handle], &name, line );
 	}
 	else
 	{
@@ -3719,7 +4263,7 @@ void PC_CheckOpenSourceHandles()
 		if( sourceFiles[i] )
 		{
 #ifdef BOTLIB
-			botimport.Print( PRT_ERROR, "file %s still open in precompiler\n", sourceFiles[i]->scriptstack->filename );
+			botimport.Print( PRT_ERROR, "file %s still open in precompiler\n", sourceFiles[i]->filename );
 #endif // BOTLIB
 		} // end if
 	} // end for
@@ -103,6 +103,11 @@ typedef struct source_s
 	indent_t*	   indentstack;		  // stack with indents
 	int			   skip;			  // > 0 if skipping conditional code
 	token_t		   token;			  // last read token
+	char*		   cache;			  // precompiled token stream
+	int			   cachepos;		  // read position in the token stream
+	int			   cacheend;		  // end of the token stream
+	int			   cachefiles;		  // offset of the file table of the token stream
+	int			   cachefile;		  // file index of the last read cached token
 } source_t;
 
 // read a token from the source
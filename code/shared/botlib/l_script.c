@@ -168,6 +168,8 @@ char basefolder[MAX_PATH];
 char basefolder[MAX_QPATH];
 #endif
 
+int	 numscripterrors;
+
 //===========================================================================
 //
 // Parameter:				-
@@ -256,6 +258,7 @@ void QDECL ScriptError( script_t* script, char* str, ... )
 	{
 		return;
 	}
+	numscripterrors++;
 
 	va_start( ap, str );
 	vsprintf( text, str, ap );
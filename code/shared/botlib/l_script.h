@@ -242,3 +242,8 @@ void			PS_SetBaseFolder( char* path );
 void QDECL		ScriptError( script_t* script, char* str, ... );
 // print a script warning with filename and line number
 void QDECL		ScriptWarning( script_t* script, char* str, ... );
+
+// number of script errors printed so far
+extern int		numscripterrors;
+// the folder files are loaded from
+extern char		basefolder[];
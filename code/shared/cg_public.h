@@ -170,6 +170,12 @@ typedef enum
 
 	CG_R_REGISTERCUSTOMMODEL,
 
+	CG_CVAR_SET_HANDLE,
+	CG_CVAR_MODIFICATION_COUNT,
+
+	CG_PROFILE_BEGIN,
+	CG_PROFILE_END,
+
 	/*
 	CG_LOADCAMERA,
 	CG_STARTCAMERA,
@@ -187,7 +193,14 @@ typedef enum
 	CG_CEIL,
 	CG_TESTPRINTINT,
 	CG_TESTPRINTFLOAT,
-	CG_ACOS
+	CG_ACOS,
+
+	// engine job system, native modules only
+	// jobs run on other threads and must not call any trap
+	CG_JOB_ADD,
+	CG_JOB_WAIT,
+	CG_JOB_PARALLEL_FOR,
+	CG_JOB_NUM_WORKERS
 } cgameImport_t;
 
 /*
@@ -227,6 +227,24 @@ typedef enum
 	// 1.32
 	G_FS_SEEK,
 
+	G_CVAR_SET_HANDLE,		   // ( cvarHandle_t handle, const char *value );
+	G_CVAR_MODIFICATION_COUNT, // ();
+							   // changes whenever any cvar changes
+
+	G_PROFILE_BEGIN, // ( const char *name );
+	G_PROFILE_END,	 // ();
+					 // zones for profile_capture
+
+	// engine job system, native modules only
+	// jobs run on other threads and must not call any trap
+	G_JOB_ADD,			// ( const char *name, jobFunc_t func, void *data, jobCounter_t *signal );
+	G_JOB_WAIT,			// ( jobCounter_t *counter );
+	G_JOB_PARALLEL_FOR, // ( const char *name, int count, int minBatch, jobRangeFunc_t func, void *data );
+	G_JOB_NUM_WORKERS,	// ();
+
+	G_LOG_WRITE, // ( const void *buffer, int len, fileHandle_t f );
+				 // like G_FS_WRITE, but written by the engine's log thread
+
 	BOTLIB_SETUP = 200, // ();
 	BOTLIB_SHUTDOWN,	// ();
 	BOTLIB_LIBVAR_SET,
@@ -240,6 +258,9 @@ typedef enum
 	BOTLIB_GET_SNAPSHOT_ENTITY, // ( int client, int ent );
 	BOTLIB_GET_CONSOLE_MESSAGE, // ( int client, char *message, int size );
 	BOTLIB_USER_COMMAND,		// ( int client, usercmd_t *ucmd );
+	BOTLIB_PARALLEL_FRAME,		// ( qboolean begin );
+	BOTLIB_THINK_BEGIN,			// ( int client, int seed );
+	BOTLIB_THINK_END,			// ();
 
 	BOTLIB_AAS_ENABLE_ROUTING_AREA = 300,
 	BOTLIB_AAS_BBOX_AREAS,
@@ -423,3 +444,41 @@ typedef enum
 
 	BOTAI_START_FRAME // ( int time );
 } gameExport_t;
+
+//===============================================================
+
+// typed call tables for a native game, traded through dllGetAPI when the
+// game knows this version, everything else still goes through the syscalls
+// and vmMain
+#define GAME_DIRECT_API_VERSION 1
+
+typedef struct
+{
+	vmApiHeader_t header;
+
+	int ( *Milliseconds )();
+	void ( *Cvar_Update )( vmCvar_t* vmCvar );
+	int ( *Cvar_VariableIntegerValue )( const char* var_name );
+
+	void ( *Trace )( trace_t* results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask, int capsule );
+	int ( *PointContents )( const vec3_t point, int passEntityNum );
+	qboolean ( *InPVS )( const vec3_t p1, const vec3_t p2 );
+	qboolean ( *InPVSIgnorePortals )( const vec3_t p1, const vec3_t p2 );
+	qboolean ( *AreasConnected )( int area1, int area2 );
+
+	void ( *LinkEntity )( sharedEntity_t* ent );
+	void ( *UnlinkEntity )( sharedEntity_t* ent );
+	int ( *EntitiesInBox )( const vec3_t mins, const vec3_t maxs, int* list, int maxcount );
+	qboolean ( *EntityContact )( const vec3_t mins, const vec3_t maxs, const sharedEntity_t* ent, int capsule );
+
+	void ( *GetUsercmd )( int clientNum, usercmd_t* cmd );
+} gameImportTable_t;
+
+typedef struct
+{
+	vmApiHeader_t header;
+
+	void ( *ClientThink )( int clientNum );
+	void ( *RunFrame )( int levelTime );
+	int ( *BotAIStartFrame )( int time );
+} gameExportTable_t;
@@ -23,6 +23,12 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 // q_math.c -- stateless support routines that are included in each code module
 #include "q_shared.h"
 
+#if idsse
+	#include <xmmintrin.h>
+#elif idneon
+	#include <arm_neon.h>
+#endif
+
 vec3_t vec3_origin	  = { 0, 0, 0 };
 vec3_t axisDefault[3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
 
@@ -865,8 +871,9 @@ int BoxOnPlaneSide2 (vec3_t emins, vec3_t emaxs, struct cplane_s *p)
 
 int BoxOnPlaneSide( vec3_t emins, vec3_t emaxs, struct cplane_s* p )
 {
-	float dist1, dist2;
-	int	  sides;
+	float  dist1, dist2;
+	int	   sides, bits;
+	float* corners[2];
 
 	// fast axial cases
 	if( p->type < 3 )
@@ -882,45 +889,14 @@ int BoxOnPlaneSide( vec3_t emins, vec3_t emaxs, struct cplane_s* p )
 		return 3;
 	}
 
-	// general case
-	switch( p->signbits )
-	{
-		case 0:
-			dist1 = p->normal[0] * emaxs[0] + p->normal[1] * emaxs[1] + p->normal[2] * emaxs[2];
-			dist2 = p->normal[0] * emins[0] + p->normal[1] * emins[1] + p->normal[2] * emins[2];
-			break;
-		case 1:
-			dist1 = p->normal[0] * emins[0] + p->normal[1] * emaxs[1] + p->normal[2] * emaxs[2];
-			dist2 = p->normal[0] * emaxs[0] + p->normal[1] * emins[1] + p->normal[2] * emins[2];
-			break;
-		case 2:
-			dist1 = p->normal[0] * emaxs[0] + p->normal[1] * emins[1] + p->normal[2] * emaxs[2];
-			dist2 = p->normal[0] * emins[0] + p->normal[1] * emaxs[1] + p->normal[2] * emins[2];
-			break;
-		case 3:
-			dist1 = p->normal[0] * emins[0] + p->normal[1] * emins[1] + p->normal[2] * emaxs[2];
-			dist2 = p->normal[0] * emaxs[0] + p->normal[1] * emaxs[1] + p->normal[2] * emins[2];
-			break;
-		case 4:
-			dist1 = p->normal[0] * emaxs[0] + p->normal[1] * emaxs[1] + p->normal[2] * emins[2];
-			dist2 = p->normal[0] * emins[0] + p->normal[1] * emins[1] + p->normal[2] * emaxs[2];
-			break;
-		case 5:
-			dist1 = p->normal[0] * emins[0] + p->normal[1] * emaxs[1] + p->normal[2] * emins[2];
-			dist2 = p->normal[0] * emaxs[0] + p->normal[1] * emins[1] + p->normal[2] * emaxs[2];
-			break;
-		case 6:
-			dist1 = p->normal[0] * emaxs[0] + p->normal[1] * emins[1] + p->normal[2] * emins[2];
-			dist2 = p->normal[0] * emins[0] + p->normal[1] * emaxs[1] + p->normal[2] * emaxs[2];
-			break;
-		case 7:
-			dist1 = p->normal[0] * emins[0] + p->normal[1] * emins[1] + p->normal[2] * emins[2];
-			dist2 = p->normal[0] * emaxs[0] + p->normal[1] * emaxs[1] + p->normal[2] * emaxs[2];
-			break;
-		default:
-			dist1 = dist2 = 0; // shut up compiler
-			break;
-	}
+	// general case, each sign bit picks the corner furthest along
+	// the normal on that axis for dist1 and the nearest for dist2
+	corners[0] = emaxs;
+	corners[1] = emins;
+	bits	   = p->signbits;
+
+	dist1 = p->normal[0] * corners[bits & 1][0] + p->normal[1] * corners[( bits >> 1 ) & 1][1] + p->normal[2] * corners[( bits >> 2 ) & 1][2];
+	dist2 = p->normal[0] * corners[~bits & 1][0] + p->normal[1] * corners[( ~bits >> 1 ) & 1][1] + p->normal[2] * corners[( ~bits >> 2 ) & 1][2];
 
 	sides = 0;
 	if( dist1 >= p->dist )
@@ -1172,6 +1148,90 @@ __declspec( naked ) int BoxOnPlaneSide( vec3_t emins, vec3_t emaxs, struct cplan
 	#endif
 #endif
 
+/*
+=================
+PointsOnPlaneSide
+
+Returns 1 if any of the points is in front of the plane, 2 if any is on or
+behind it, 1 + 2 for both. Four points are tested at once where there is a
+vector unit, with the same float operations as DotProduct so the results
+don't differ from the scalar loop
+=================
+*/
+int PointsOnPlaneSide( const vec3_t* points, int numPoints, const vec3_t normal, vec_t dist )
+{
+	int i, front, back;
+#if idsse
+	__m128 nx, ny, nz, d;
+	__m128 a, b, c, x, y, z, t1, t2;
+	int	   mask;
+
+	nx = _mm_set1_ps( normal[0] );
+	ny = _mm_set1_ps( normal[1] );
+	nz = _mm_set1_ps( normal[2] );
+	d  = _mm_set1_ps( dist );
+
+	front = back = 0;
+	for( i = 0; i + 4 <= numPoints; i += 4 )
+	{
+		// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+		a = _mm_loadu_ps( points[i] );
+		b = _mm_loadu_ps( points[i] + 4 );
+		c = _mm_loadu_ps( points[i] + 8 );
+
+		t1 = _mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 1, 2, 2 ) );
+		x  = _mm_shuffle_ps( a, t1, _MM_SHUFFLE( 2, 0, 3, 0 ) );
+		t1 = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) );
+		t2 = _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) );
+		y  = _mm_shuffle_ps( t1, t2, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+		t1 = _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) );
+		t2 = _mm_shuffle_ps( c, c, _MM_SHUFFLE( 3, 3, 0, 0 ) );
+		z  = _mm_shuffle_ps( t1, t2, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+		x	 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, nx ), _mm_mul_ps( y, ny ) ), _mm_mul_ps( z, nz ) );
+		mask = _mm_movemask_ps( _mm_cmpgt_ps( x, d ) );
+		front |= mask;
+		back |= mask ^ 15;
+	}
+#elif idneon
+	float32x4_t	  nx, ny, nz, d, dot;
+	float32x4x3_t p;
+	uint32x4_t	  gt;
+
+	nx = vdupq_n_f32( normal[0] );
+	ny = vdupq_n_f32( normal[1] );
+	nz = vdupq_n_f32( normal[2] );
+	d  = vdupq_n_f32( dist );
+
+	front = back = 0;
+	for( i = 0; i + 4 <= numPoints; i += 4 )
+	{
+		p	= vld3q_f32( points[i] );
+		dot = vaddq_f32( vaddq_f32( vmulq_f32( p.val[0], nx ), vmulq_f32( p.val[1], ny ) ), vmulq_f32( p.val[2], nz ) );
+		gt	= vcgtq_f32( dot, d );
+		front |= vmaxvq_u32( gt ) != 0;
+		back |= vminvq_u32( gt ) == 0;
+	}
+#else
+	front = back = 0;
+	i			 = 0;
+#endif
+
+	for( ; i < numPoints; i++ )
+	{
+		if( DotProduct( points[i], normal ) > dist )
+		{
+			front = 1;
+		}
+		else
+		{
+			back = 1;
+		}
+	}
+
+	return ( front ? 1 : 0 ) | ( back ? 2 : 0 );
+}
+
 /*
 =================
 RadiusFromBounds
@@ -1375,7 +1435,7 @@ void MatrixMultiply( float in1[3][3], float in2[3][3], float out[3][3] )
 void AngleVectors( const vec3_t angles, vec3_t forward, vec3_t right, vec3_t up )
 {
 	float		 angle;
-	static float sr, sp, sy, cr, cp, cy;
+	static Q_THREADLOCAL float sr, sp, sy, cr, cp, cy;
 	// static to help MS compiler fp bugs
 
 	angle = angles[YAW] * ( M_PI * 2 / 360 );
@@ -1009,8 +1009,8 @@ FIXME: make this buffer size safe someday
 char* QDECL va( char* format, ... )
 {
 	va_list		argptr;
-	static char string[2][32000]; // in case va is called by nested functions
-	static int	index = 0;
+	static Q_THREADLOCAL char string[2][32000]; // in case va is called by nested functions
+	static Q_THREADLOCAL int  index = 0;
 	char*		buf;
 
 	buf = string[index & 1];
@@ -1031,34 +1031,438 @@ char* QDECL va( char* format, ... )
 =====================================================================
 */
 
+/*
+===============
+InfoMap_HashKey
+===============
+*/
+static int InfoMap_HashKey( const char* key )
+{
+	unsigned int hash;
+	int			 c;
+
+	hash = 0;
+	while( *key )
+	{
+		c = *key++;
+		if( c >= 'A' && c <= 'Z' )
+		{
+			c += 'a' - 'A';
+		}
+		hash = hash * 31 + c;
+	}
+	return hash & ( INFO_HASH_SIZE - 1 );
+}
+
+/*
+===============
+InfoMap_Rehash
+
+Earlier pairs end up first in their chain, so a key that is in the
+string twice finds the same value Info_ValueForKey does
+===============
+*/
+static void InfoMap_Rehash( infoMap_t* map )
+{
+	int i, hash;
+
+	for( i = 0; i < INFO_HASH_SIZE; i++ )
+	{
+		map->hashTable[i] = -1;
+	}
+	for( i = map->numPairs - 1; i >= 0; i-- )
+	{
+		hash				 = InfoMap_HashKey( map->text + map->pairs[i].key );
+		map->pairs[i].next	 = map->hashTable[hash];
+		map->hashTable[hash] = i;
+	}
+}
+
+/*
+===============
+InfoMap_Find
+===============
+*/
+static int InfoMap_Find( const infoMap_t* map, const char* key )
+{
+	int i;
+
+	for( i = map->hashTable[InfoMap_HashKey( key )]; i >= 0; i = map->pairs[i].next )
+	{
+		if( !Q_stricmp( map->text + map->pairs[i].key, key ) )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+===============
+InfoMap_AddText
+
+Returns the offset of the copy or -1 when the text buffer is full
+===============
+*/
+static int InfoMap_AddText( infoMap_t* map, const char* s, int length )
+{
+	int offset;
+
+	if( map->textUsed + length + 1 > ( int )sizeof( map->text ) )
+	{
+		return -1;
+	}
+
+	offset = map->textUsed;
+	memcpy( map->text + offset, s, length );
+	map->text[offset + length] = 0;
+	map->textUsed += length + 1;
+	return offset;
+}
+
+/*
+===============
+InfoMap_Clear
+===============
+*/
+void InfoMap_Clear( infoMap_t* map, int maxLength )
+{
+	map->maxLength = maxLength;
+	map->length	   = 0;
+	map->numPairs  = 0;
+	map->textUsed  = 0;
+	map->dirty	   = qfalse;
+	map->string[0] = 0;
+	InfoMap_Rehash( map );
+}
+
+/*
+===============
+InfoMap_Parse
+
+Returns qfalse if the string doesn't fit, the map is left empty then
+===============
+*/
+qboolean InfoMap_Parse( infoMap_t* map, const char* s, int maxLength )
+{
+	const char* start;
+	const char* key;
+	int			keyLength, length;
+	infoPair_t* pair;
+
+	InfoMap_Clear( map, maxLength );
+
+	length = strlen( s );
+	if( length >= maxLength )
+	{
+		return qfalse;
+	}
+	start = s;
+
+	if( *s == '\\' )
+	{
+		s++;
+	}
+	while( *s )
+	{
+		key = s;
+		while( *s != '\\' )
+		{
+			if( !*s )
+			{
+				// a key without a value is ignored, as Info_ValueForKey does
+				break;
+			}
+			s++;
+		}
+		if( !*s )
+		{
+			break;
+		}
+		keyLength = s - key;
+		s++;
+
+		if( map->numPairs == MAX_INFO_PAIRS )
+		{
+			InfoMap_Clear( map, maxLength );
+			return qfalse;
+		}
+
+		pair		= &map->pairs[map->numPairs];
+		pair->key	= InfoMap_AddText( map, key, keyLength );
+		key			= s;
+		while( *s != '\\' && *s )
+		{
+			s++;
+		}
+		pair->value = InfoMap_AddText( map, key, s - key );
+		if( pair->key < 0 || pair->value < 0 )
+		{
+			InfoMap_Clear( map, maxLength );
+			return qfalse;
+		}
+		map->numPairs++;
+
+		if( *s )
+		{
+			s++;
+		}
+	}
+
+	// the string form is the original, byte for byte
+	memcpy( map->string, start, length + 1 );
+	map->length = length;
+
+	InfoMap_Rehash( map );
+	return qtrue;
+}
+
+/*
+===============
+InfoMap_ValueForKey
+
+Returns an empty string if the key isn't set, the pointer stays valid
+until the map is changed
+===============
+*/
+const char* InfoMap_ValueForKey( const infoMap_t* map, const char* key )
+{
+	int i;
+
+	if( !key )
+	{
+		return "";
+	}
+
+	i = InfoMap_Find( map, key );
+	if( i < 0 )
+	{
+		return "";
+	}
+	return map->text + map->pairs[i].value;
+}
+
+/*
+===============
+InfoMap_RemoveKey
+===============
+*/
+void InfoMap_RemoveKey( infoMap_t* map, const char* key )
+{
+	infoPair_t* pair;
+	int			i;
+
+	i = InfoMap_Find( map, key );
+	if( i < 0 )
+	{
+		return;
+	}
+
+	pair = &map->pairs[i];
+	map->length -= 2 + strlen( map->text + pair->key ) + strlen( map->text + pair->value );
+
+	memmove( pair, pair + 1, ( map->numPairs - i - 1 ) * sizeof( *pair ) );
+	map->numPairs--;
+	map->dirty = qtrue;
+
+	InfoMap_Rehash( map );
+}
+
+/*
+===============
+InfoMap_Compact
+
+Drops the text of removed and replaced pairs
+===============
+*/
+static void InfoMap_Compact( infoMap_t* map )
+{
+	char text[BIG_INFO_STRING];
+	int	 i;
+
+	memcpy( text, map->text, map->textUsed );
+	map->textUsed = 0;
+	for( i = 0; i < map->numPairs; i++ )
+	{
+		map->pairs[i].key	= InfoMap_AddText( map, text + map->pairs[i].key, strlen( text + map->pairs[i].key ) );
+		map->pairs[i].value = InfoMap_AddText( map, text + map->pairs[i].value, strlen( text + map->pairs[i].value ) );
+	}
+}
+
+/*
+===============
+InfoMap_SetValueForKey
+
+Changes or adds a key/value pair, an empty value removes the key.
+Like Info_SetValueForKey the pair moves to the front of the string
+===============
+*/
+qboolean InfoMap_SetValueForKey( infoMap_t* map, const char* key, const char* value )
+{
+	infoPair_t* pair;
+	int			keyLength, valueLength;
+
+	if( !value )
+	{
+		value = "";
+	}
+
+	if( strchr( key, '\\' ) || strchr( value, '\\' ) )
+	{
+		Com_Printf( "Can't use keys or values with a \\\n" );
+		return qfalse;
+	}
+
+	if( strchr( key, ';' ) || strchr( value, ';' ) )
+	{
+		Com_Printf( "Can't use keys or values with a semicolon\n" );
+		return qfalse;
+	}
+
+	if( strchr( key, '\"' ) || strchr( value, '\"' ) )
+	{
+		Com_Printf( "Can't use keys or values with a \"\n" );
+		return qfalse;
+	}
+
+	InfoMap_RemoveKey( map, key );
+	if( !value[0] )
+	{
+		return qtrue;
+	}
+
+	keyLength	= strlen( key );
+	valueLength = strlen( value );
+	if( map->length + 2 + keyLength + valueLength >= map->maxLength || map->numPairs == MAX_INFO_PAIRS )
+	{
+		Com_Printf( "Info string length exceeded\n" );
+		return qfalse;
+	}
+
+	if( map->textUsed + keyLength + valueLength + 2 > ( int )sizeof( map->text ) )
+	{
+		InfoMap_Compact( map );
+	}
+
+	memmove( map->pairs + 1, map->pairs, map->numPairs * sizeof( *pair ) );
+	map->numPairs++;
+
+	pair		= &map->pairs[0];
+	pair->key	= InfoMap_AddText( map, key, keyLength );
+	pair->value = InfoMap_AddText( map, value, valueLength );
+
+	map->length += 2 + keyLength + valueLength;
+	map->dirty = qtrue;
+
+	InfoMap_Rehash( map );
+	return qtrue;
+}
+
+/*
+===============
+InfoMap_String
+
+The string form, rebuilt here if the map changed
+===============
+*/
+const char* InfoMap_String( infoMap_t* map )
+{
+	char* o;
+	int	  i;
+
+	if( !map->dirty )
+	{
+		return map->string;
+	}
+
+	o = map->string;
+	for( i = 0; i < map->numPairs; i++ )
+	{
+		*o++ = '\\';
+		strcpy( o, map->text + map->pairs[i].key );
+		o += strlen( o );
+		*o++ = '\\';
+		strcpy( o, map->text + map->pairs[i].value );
+		o += strlen( o );
+	}
+	*o = 0;
+
+	map->dirty = qfalse;
+	return map->string;
+}
+
 /*
 ===============
 Info_ValueForKey
 
 Searches the string for the given
 key and returns the associated value, or an empty string.
-FIXME: overflow check?
+
+A string that is looked at twice in a row is parsed and kept, the callers
+tend to read many keys from the same userinfo or configstring in a row.
+Callers alternating between strings only pay for a copy of the string on top
+of the plain scan
 ===============
 */
 char* Info_ValueForKey( const char* s, const char* key )
 {
-	char		pkey[BIG_INFO_KEY];
-	static char value[2][BIG_INFO_VALUE]; // use two buffers so compares
-	// work without stomping on each other
-	static int	valueindex = 0;
-	char*		o;
+	char						   pkey[BIG_INFO_KEY];
+	static Q_THREADLOCAL char	   value[2][BIG_INFO_VALUE]; // use two buffers so compares
+	// work without stomping on each other, per thread as bots think on job workers
+	static Q_THREADLOCAL int	   valueindex = 0;
+	static Q_THREADLOCAL infoMap_t cache;
+	static Q_THREADLOCAL qboolean  cacheValid;
+	static Q_THREADLOCAL char	   lastString[BIG_INFO_STRING]; // last string looked at
+	static Q_THREADLOCAL qboolean  lastParsed;
+	char*						   o;
+	int							   length;
+	qboolean					   cached;
 
 	if( !s || !key )
 	{
 		return "";
 	}
 
-	if( strlen( s ) >= BIG_INFO_STRING )
+	length = strlen( s );
+	if( length >= BIG_INFO_STRING )
 	{
 		Com_Error( ERR_DROP, "Info_ValueForKey: oversize infostring" );
 	}
 
 	valueindex ^= 1;
+
+	if( !cacheValid || strcmp( s, cache.string ) )
+	{
+		if( strcmp( s, lastString ) )
+		{
+			// first time in a row, parse it if it's asked for again
+			memcpy( lastString, s, length + 1 );
+			lastParsed = qfalse;
+			cached	   = qfalse;
+		}
+		else if( !lastParsed )
+		{
+			// a string with too many pairs for a map isn't tried again
+			lastParsed = qtrue;
+			cacheValid = InfoMap_Parse( &cache, s, BIG_INFO_STRING );
+			cached	   = cacheValid;
+		}
+		else
+		{
+			cached = qfalse;
+		}
+	}
+	else
+	{
+		cached = qtrue;
+	}
+	if( cached )
+	{
+		Q_strncpyz( value[valueindex], InfoMap_ValueForKey( &cache, key ), sizeof( value[valueindex] ) );
+		return value[valueindex];
+	}
+
+	// not parsed or too many pairs for a map
 	if( *s == '\\' )
 	{
 		s++;
@@ -1199,7 +1603,7 @@ void Info_RemoveKey( char* s, const char* key )
 
 		if( !strcmp( key, pkey ) )
 		{
-			strcpy( start, s ); // remove this part
+			memmove( start, s, strlen( s ) + 1 ); // remove this part
 			return;
 		}
 
@@ -1264,7 +1668,7 @@ void Info_RemoveKey_Big( char* s, const char* key )
 
 		if( !strcmp( key, pkey ) )
 		{
-			strcpy( start, s ); // remove this part
+			memmove( start, s, strlen( s ) + 1 ); // remove this part
 			return;
 		}
 
@@ -115,6 +115,19 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 	#define idppc_altivec 0
 #endif
 
+// vector units for the batched math routines, every x86-64 cpu has SSE
+#if !defined( Q3_VM ) && !defined( C_ONLY ) && ( defined( _M_X64 ) || defined( __x86_64__ ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 ) || defined( __SSE__ ) )
+	#define idsse 1
+#else
+	#define idsse 0
+#endif
+
+#if !defined( Q3_VM ) && !defined( C_ONLY ) && defined( __aarch64__ ) && defined( __ARM_NEON )
+	#define idneon 1
+#else
+	#define idneon 0
+#endif
+
 // for windows fastcall option
 
 #define QDECL
@@ -503,6 +516,71 @@ typedef enum
 	h_dontcare
 } ha_pref;
 
+// memory telemetry counter, defined in qcommon.h
+typedef struct memStat_s memStat_t;
+
+// thread local storage and the few atomics the engine and native modules need
+#ifdef Q3_VM
+	// a QVM has a single thread
+	#define Q_THREADLOCAL
+
+static int Com_AtomicAdd( volatile int* value, int add )
+{
+	return *value += add;
+}
+
+static int Com_AtomicCompareExchange( volatile int* value, int exchange, int comparand )
+{
+	int old;
+
+	old = *value;
+	if( old == comparand )
+	{
+		*value = exchange;
+	}
+	return old;
+}
+#else
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define Q_THREADLOCAL __declspec( thread )
+	#else
+		#define Q_THREADLOCAL __thread
+	#endif
+
+// returns the new value
+static ID_INLINE int Com_AtomicAdd( volatile int* value, int add )
+{
+	#ifdef _MSC_VER
+	return _InterlockedExchangeAdd( ( volatile long* )value, add ) + add;
+	#else
+	return __sync_add_and_fetch( value, add );
+	#endif
+}
+
+// returns the old value, exchange is only stored if that was comparand
+static ID_INLINE int Com_AtomicCompareExchange( volatile int* value, int exchange, int comparand )
+{
+	#ifdef _MSC_VER
+	return _InterlockedCompareExchange( ( volatile long* )value, exchange, comparand );
+	#else
+	return __sync_val_compare_and_swap( value, comparand, exchange );
+	#endif
+}
+#endif
+
+// job system, see qcommon/jobs.c
+// a counter is 0 filled by its owner and counts the jobs still to finish
+typedef struct jobCounter_s
+{
+	volatile int		 count;
+	struct job_s* volatile waiters; // jobs added after this counter, waiting for it
+	volatile int		 lock;
+} jobCounter_t;
+
+typedef void ( *jobFunc_t )( void* data );
+typedef void ( *jobRangeFunc_t )( void* data, int start, int end );
+
 #ifdef HUNK_DEBUG
 	#define Hunk_Alloc( size, preference ) Hunk_AllocDebug( size, preference, #size, __FILE__, __LINE__ )
 void* Hunk_AllocDebug( int size, ha_pref preference, char* label, char* file, int line );
@@ -835,6 +913,7 @@ void	 AxisCopy( vec3_t in[3], vec3_t out[3] );
 
 void	 SetPlaneSignbits( struct cplane_s* out );
 int		 BoxOnPlaneSide( vec3_t emins, vec3_t emaxs, struct cplane_s* plane );
+int		 PointsOnPlaneSide( const vec3_t* points, int numPoints, const vec3_t normal, vec_t dist );
 
 float	 AngleMod( float a );
 float	 LerpAngle( float from, float to, float frac );
@@ -992,6 +1071,39 @@ void		Info_SetValueForKey_Big( char* s, const char* key, const char* value );
 qboolean	Info_Validate( const char* s );
 void		Info_NextPair( const char** s, char* key, char* value );
 
+// a parsed info string, lookups hash the key instead of scanning the string
+// and the string form is only rebuilt when it is asked for after a change.
+// keys compare without case, pairs keep the order Info_SetValueForKey gives
+#define MAX_INFO_PAIRS 256
+#define INFO_HASH_SIZE 64
+
+typedef struct
+{
+	short key; // offsets into text
+	short value;
+	short next; // hash chain, -1 ends it
+} infoPair_t;
+
+typedef struct
+{
+	int		   maxLength; // MAX_INFO_STRING or BIG_INFO_STRING
+	int		   length;	  // of the string form
+	int		   numPairs;
+	infoPair_t pairs[MAX_INFO_PAIRS];
+	short	   hashTable[INFO_HASH_SIZE];
+	int		   textUsed;
+	char	   text[BIG_INFO_STRING];
+	qboolean   dirty; // string is out of date
+	char	   string[BIG_INFO_STRING];
+} infoMap_t;
+
+void		InfoMap_Clear( infoMap_t* map, int maxLength );
+qboolean	InfoMap_Parse( infoMap_t* map, const char* s, int maxLength );
+const char* InfoMap_ValueForKey( const infoMap_t* map, const char* key );
+qboolean	InfoMap_SetValueForKey( infoMap_t* map, const char* key, const char* value );
+void		InfoMap_RemoveKey( infoMap_t* map, const char* key );
+const char* InfoMap_String( infoMap_t* map );
+
 // this is only here so the functions in q_shared.c and bg_*.c can link
 void QDECL	Com_Error( int level, const char* error, ... );
 void QDECL	Com_Printf( const char* msg, ... );
@@ -1060,6 +1172,15 @@ typedef struct
 	char		 string[MAX_CVAR_VALUE_STRING];
 } vmCvar_t;
 
+// a native module and the engine can trade tables of typed function
+// pointers for the calls that are too frequent for the syscall dispatch,
+// every such table starts with this header
+typedef struct
+{
+	int version;
+	int size; // of the whole table, so later versions can append
+} vmApiHeader_t;
+
 /*
 ==============================================================
 
@@ -127,6 +127,9 @@ typedef enum
 	UI_FS_SEEK,
 	UI_SET_PBCLSTATUS,
 
+	UI_CVAR_SET_HANDLE,
+	UI_CVAR_MODIFICATION_COUNT,
+
 	UI_MEMSET = 100,
 	UI_MEMCPY,
 	UI_STRNCPY,
@@ -191,15 +191,23 @@ project "Quake3RTX"
 		"../code/engine/sound/*.c", "../code/engine/sound/*.h",
 		
 		"../code/engine/qcommon/**.h", 
+		"../code/engine/qcommon/arena.c",
 		"../code/engine/qcommon/cmd.c",
 		"../code/engine/qcommon/common.c",
 		"../code/engine/qcommon/cvar.c",
 		"../code/engine/qcommon/files.c",
 		"../code/engine/qcommon/huffman.c",
 		"../code/engine/qcommon/md4.c",
+		"../code/engine/qcommon/memstats.c",
 		--"../code/engine/qcommon/md5.c",
 		"../code/engine/qcommon/msg.c",
+		"../code/engine/qcommon/profile.c",
+		"../code/engine/qcommon/jobs.c",
+		"../code/engine/qcommon/journal.c",
+		"../code/engine/qcommon/logsink.c",
 		"../code/engine/qcommon/vm.c",
+		"../code/engine/qcommon/vm_interpreted.c",
+		"../code/engine/qcommon/vm_x86_64.c",
 		"../code/engine/qcommon/net_*.c",
 		"../code/engine/qcommon/unzip.c",
 		--"../code/engine/qcommon/parse.c",  -- by Tremulous to avoid botlib dependency